@@ -83,19 +83,18 @@ std::unique_ptr<Vector> GaussianSolver::solve(const Matrix& A_orig, const Vector
 bool GaussianSolver::forward_elimination(Matrix& A, Vector& b) {
     const size_t n = A.rows();
 
-    auto& A_data = A.get_mutable_raw_data(); // 优化：获取可修改的底层数据引用
-
     for (size_t i = 0; i < n - 1; ++i) {
         // ===== 部分选主元策略 =====
-        // 使用std::max_element和Lambda表达式优化主元查找
-        auto max_iter = std::max_element(
-            A_data.begin() + i, A_data.end(),
-            [i](const std::vector<double>& row1, const std::vector<double>& row2) {
-                return std::abs(row1[i]) < std::abs(row2[i]);
+        // 在第i列的对角线及以下部分查找绝对值最大的元素（列视图，不复制）
+        ConstColumnView col_i = A.col(i);
+        size_t max_row = i;
+        double max_val = std::abs(col_i[i]);
+        for (size_t k = i + 1; k < n; ++k) {
+            if (std::abs(col_i[k]) > max_val) {
+                max_val = std::abs(col_i[k]);
+                max_row = k;
             }
-        );
-        size_t max_row = std::distance(A_data.begin(), max_iter);
-        double max_val = std::abs((*max_iter)[i]);
+        }
 
         // 检查主元是否接近零
         if (max_val < 1e-10) {
@@ -104,27 +103,24 @@ bool GaussianSolver::forward_elimination(Matrix& A, Vector& b) {
 
         // 如果需要，交换行以获得最大主元
         if (max_row != i) {
-            // 优化：直接交换底层vector，避免多次调用at
-            std::swap_ranges(
-                A_data[i].begin(), A_data[i].end(),
-                A_data[max_row].begin()
-            );
+            // 两行都是连续内存，直接交换元素
+            A.swap_rows(i, max_row);
             std::swap(b.at(i), b.at(max_row));
         }
 
         // ===== 消元过程 =====
         // 对第i列下方的所有行进行消元
-        // 优化：消元时只更新必要的元素，避免不必要的循环
-        const double pivot = A.at(i, i);
+        // 优化：消元时只更新必要的元素，内层循环通过行视图连续访问，不检查边界
+        const double pivot = A(i, i);
+        const RowView row_i = A.row(i);
+        const double b_i = b.at(i);
         for (size_t k = i + 1; k < n; ++k) {
-            double factor = A.at(k, i) / pivot;
-            // 优化：利用指针批量操作
-            auto row_k = A_data[k].begin();
-            auto row_i = A_data[i].begin();
+            RowView row_k = A.row(k);
+            double factor = row_k[i] / pivot;
             for (size_t j = i; j < n; ++j) {
                 row_k[j] -= factor * row_i[j];
             }
-            b.at(k) -= factor * b.at(i);
+            b.at(k) -= factor * b_i;
         }
     }
 
@@ -167,12 +163,13 @@ void GaussianSolver::back_substitution(const Matrix& A, const Vector& b, Vector&
         // 开始时将常数项赋值给x[i]
         x.at(i) = b.at(i);
 
-        // 减去已求解变量的影响
+        // 减去已求解变量的影响（第i行为连续存储的行视图）
+        ConstRowView row_i = A.row(i);
         for (size_t j = i + 1; j < n; ++j) {
-            x.at(i) -= A.at(i, j) * x.at(j);
+            x.at(i) -= row_i[j] * x.at(j);
         }
 
         // 除以主对角元素得到最终解
-        x.at(i) /= A.at(i, i);
+        x.at(i) /= row_i[i];
     }
 }
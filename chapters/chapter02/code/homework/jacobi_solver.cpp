@@ -9,30 +9,28 @@ JacobiSolver::JacobiSolver(double tolerance, size_t max_iterations)
 std::unique_ptr<Vector> JacobiSolver::solve(const Matrix& A, const Vector& b) {
 
     size_t n = A.rows();
-    auto x = std::make_unique<Vector>(n, 0.0);  // 初始解
-    auto x_new = std::make_unique<Vector>(n);
+    const auto& b_data = b.get_raw_data();
+
+    // 迭代在连续的std::vector上进行，收敛后才构造结果Vector
+    std::vector<double> x_vec(n, 0.0);  // 初始解
+    std::vector<double> x_new_vec(n, 0.0);
 
     for (size_t iter = 0; iter < m_max_iterations; ++iter) {
-        // 计算新解
+        // 计算新解（第i行为连续存储的行视图，对角元两侧分别做点积）
         for (size_t i = 0; i < n; ++i) {
-            double sum = 0.0;
-            for (size_t j = 0; j < n; ++j) {
-                if (j != i) {
-                    sum += A.at(i, j) * x->at(j);
-                }
-            }
-            if (std::abs(A.at(i, i)) < 1e-10) {
+            ConstRowView A_i = A.row(i);
+            if (std::abs(A_i[i]) < 1e-10) {
                 return nullptr; // 矩阵对角元素为0，无法使用雅可比迭代法
             }
-            x_new->at(i) = (b.at(i) - sum) / A.at(i, i);
+            double sum = std::inner_product(A_i.begin(), A_i.begin() + i, x_vec.begin(), 0.0)
+                         + std::inner_product(A_i.begin() + i + 1, A_i.end(), x_vec.begin() + i + 1, 0.0);
+            x_new_vec[i] = (b_data[i] - sum) / A_i[i];
         }
 
         // 检查收敛性 - 使用传统循环实现
         double error = 0.0;
-        auto x_new_data = x_new->get_raw_data();
-        auto x_data = x->get_raw_data();
-        for (size_t i = 0; i < x->size(); ++i) {
-            double diff = x_new_data[i] - x_data[i];
+        for (size_t i = 0; i < n; ++i) {
+            double diff = x_new_vec[i] - x_vec[i];
             error += diff * diff;
         }
         error = std::sqrt(error);
@@ -42,11 +40,11 @@ std::unique_ptr<Vector> JacobiSolver::solve(const Matrix& A, const Vector& b) {
         }
 
         if (error < m_tolerance) {
-            return x_new;
+            return std::make_unique<Vector>(std::move(x_new_vec));
         }
 
-        // 交换指针
-        std::swap(x, x_new);
+        // 交换新旧解
+        std::swap(x_vec, x_new_vec);
     }
 
     return nullptr; //雅可比迭代法未在最大迭代次数内收敛
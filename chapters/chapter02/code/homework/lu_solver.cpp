@@ -1,6 +1,7 @@
 #include "lu_solver.h"
 #include <algorithm>
 #include <cmath>
+#include <numeric>      // 用于std::inner_product
 
 std::unique_ptr<Vector> LUSolver::solve(const Matrix& A_orig, const Vector& b_orig) {
 
@@ -30,32 +31,38 @@ std::unique_ptr<Vector> LUSolver::solve(const Matrix& A_orig, const Vector& b_or
 bool LUSolver::lu_decomposition(const Matrix& A, Matrix& L, Matrix& U) {
     size_t n = A.rows();
 
+    std::vector<double> u_col;  // U第i列对角线以上部分的连续副本（O(n)临时空间）
+
     for (size_t i = 0; i < n; ++i) {
-        // 计算U的第i行 - 使用Lambda表达式优化
-        for (size_t j = i; j < n; ++j) {
-            // 使用Lambda表达式计算前i个元素的和
-            double sum = 0.0;
-            for (size_t k = 0; k < i; ++k) {
-                sum += L.at(i, k) * U.at(k, j);
+        // 计算U的第i行：U(i, j) = A(i, j) - Σ L(i, k) * U(k, j)
+        // 按行累加（U的第k行和第i行都是连续存储），内层循环不检查边界
+        ConstRowView A_i = A.row(i);
+        ConstRowView L_i = L.row(i);
+        RowView U_i = U.row(i);
+        std::copy(A_i.begin() + i, A_i.end(), U_i.begin() + i);
+        for (size_t k = 0; k < i; ++k) {
+            const double l_ik = L_i[k];
+            ConstRowView U_k = U.row(k);
+            for (size_t j = i; j < n; ++j) {
+                U_i[j] -= l_ik * U_k[j];
             }
-            U.at(i, j) = A.at(i, j) - sum;
         }
 
-        // 计算L的第i列 - 使用Lambda表达式优化
-        for (size_t j = i; j < n; ++j) {
-            if (i == j) {
-                L.at(i, i) = 1.0; // 对角元素设为1
-            } else {
-                // 使用Lambda表达式计算前i个元素的和
-                double sum = 0.0;
-                for (size_t k = 0; k < i; ++k) {
-                    sum += L.at(j, k) * U.at(k, i);
-                }
-                if (std::abs(U.at(i, i)) < 1e-10) {
-                    return false; // 矩阵奇异（LU分解中出现零主元）
-                }
-                L.at(j, i) = (A.at(j, i) - sum) / U.at(i, i);
-            }
+        // 计算L的第i列：L(j, i) = (A(j, i) - Σ L(j, k) * U(k, i)) / U(i, i)
+        L(i, i) = 1.0; // 对角元素设为1
+        if (i + 1 < n && std::abs(U_i[i]) < 1e-10) {
+            return false; // 矩阵奇异（LU分解中出现零主元）
+        }
+        // U的第i列是跨步访问，先复制成连续数组，再与L的各行做连续的点积
+        ConstColumnView U_col_i = U.col(i);
+        u_col.resize(i);
+        for (size_t k = 0; k < i; ++k) {
+            u_col[k] = U_col_i[k];
+        }
+        for (size_t j = i + 1; j < n; ++j) {
+            ConstRowView L_j = L.row(j);
+            double sum = std::inner_product(L_j.begin(), L_j.begin() + i, u_col.begin(), 0.0);
+            L(j, i) = (A(j, i) - sum) / U_i[i];
         }
     }
     return true;
@@ -66,11 +73,12 @@ void LUSolver::forward_substitution(const Matrix& L, const Vector& b, Vector& y)
 
     // 前向替代 - 使用传统循环实现
     for (size_t i = 0; i < n; ++i) {
+        ConstRowView L_i = L.row(i);
         double sum = 0.0;
         for (size_t j = 0; j < i; ++j) {
-            sum += L.at(i, j) * y.at(j);
+            sum += L_i[j] * y.at(j);
         }
-        y.at(i) = (b.at(i) - sum) / L.at(i, i);
+        y.at(i) = (b.at(i) - sum) / L_i[i];
     }
 }
 
@@ -79,10 +87,11 @@ void LUSolver::back_substitution(const Matrix& U, const Vector& y, Vector& x) {
 
     // 后向替代 - 使用传统循环实现
     for (int i = n - 1; i >= 0; --i) {
+        ConstRowView U_i = U.row(i);
         double sum = 0.0;
         for (size_t j = i + 1; j < n; ++j) {
-            sum += U.at(i, j) * x.at(j);
+            sum += U_i[j] * x.at(j);
         }
-        x.at(i) = (y.at(i) - sum) / U.at(i, i);
+        x.at(i) = (y.at(i) - sum) / U_i[i];
     }
 }
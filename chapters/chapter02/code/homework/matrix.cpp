@@ -17,17 +17,16 @@
 /**
  * @brief 默认构造函数实现
  *
- * 算法：使用std::vector的resize和构造函数初始化所有元素
+ * 算法：一次分配rows*cols个元素的连续对齐缓冲区并初始化
  * 时间复杂度：O(rows * cols)
  * 空间复杂度：O(rows * cols)
  */
-Matrix::Matrix(size_t rows, size_t cols, double value) : m_rows(rows), m_cols(cols) {
-    // 创建rows个行向量，每个行向量包含cols个初始值为value的元素
-    m_data.resize(rows, std::vector<double>(cols, value));
+Matrix::Matrix(size_t rows, size_t cols, double value)
+    : m_rows(rows), m_cols(cols), m_data(rows * cols, value) {
 }
 
 /**
- * @brief 拷贝构造函数实现
+ * @brief 由二维向量填充连续存储
  *
  * @param data 输入的二维向量
  *
@@ -36,45 +35,46 @@ Matrix::Matrix(size_t rows, size_t cols, double value) : m_rows(rows), m_cols(co
  * - 验证所有行的列数是否相同
  * - 抛出异常如果数据无效
  */
-Matrix::Matrix(const std::vector<std::vector<double>>& data) : m_data(data) {
+void Matrix::assign_rows(const std::vector<std::vector<double>>& data) {
     if (data.empty()) {
         m_rows = 0;
         m_cols = 0;
-    } else {
-        m_rows = data.size();
-        m_cols = data[0].size();
-        // 验证所有行具有相同的列数
-        for (const auto& row : data) {
-            if (row.size() != m_cols) {
-                throw std::invalid_argument("All rows must have the same number of columns");
-            }
+        return;
+    }
+    m_rows = data.size();
+    m_cols = data[0].size();
+    // 验证所有行具有相同的列数
+    for (const auto& row : data) {
+        if (row.size() != m_cols) {
+            throw std::invalid_argument("All rows must have the same number of columns");
         }
     }
+    m_data.resize(m_rows * m_cols);
+    for (size_t i = 0; i < m_rows; ++i) {
+        std::copy(data[i].begin(), data[i].end(), m_data.begin() + i * m_cols);
+    }
+}
+
+/**
+ * @brief 拷贝构造函数实现
+ *
+ * @param data 输入的二维向量（逐行复制到连续存储）
+ */
+Matrix::Matrix(const std::vector<std::vector<double>>& data) : m_rows(0), m_cols(0) {
+    assign_rows(data);
 }
 
 /**
- * @brief 移动构造函数实现
+ * @brief 右值构造函数实现
  *
  * @param data 右值引用的二维向量
  *
- * 演示C++11的移动语义：
- * - 使用std::move避免拷贝
- * - 提高性能，特别是对于大型矩阵
+ * 二维向量的各行分散在堆上，无法直接接管为连续存储，
+ * 复制完成后清空data，尽早释放原数据占用的内存
  */
-Matrix::Matrix(std::vector<std::vector<double>>&& data) : m_data(std::move(data)) {
-    if (m_data.empty()) {
-        m_rows = 0;
-        m_cols = 0;
-    } else {
-        m_rows = m_data.size();
-        m_cols = m_data[0].size();
-        // 验证所有行具有相同的列数
-        for (const auto& row : m_data) {
-            if (row.size() != m_cols) {
-                throw std::invalid_argument("All rows must have the same number of columns");
-            }
-        }
-    }
+Matrix::Matrix(std::vector<std::vector<double>>&& data) : m_rows(0), m_cols(0) {
+    assign_rows(data);
+    std::vector<std::vector<double>>().swap(data);
 }
 
 /**
@@ -93,7 +93,7 @@ double& Matrix::at(size_t row, size_t col) {
     if (row >= m_rows || col >= m_cols) {
         throw std::out_of_range("Matrix indices out of range");
     }
-    return m_data[row][col];
+    return m_data[row * m_cols + col];
 }
 
 /**
@@ -112,7 +112,7 @@ double Matrix::at(size_t row, size_t col) const {
     if (row >= m_rows || col >= m_cols) {
         throw std::out_of_range("Matrix indices out of range");
     }
-    return m_data[row][col];
+    return m_data[row * m_cols + col];
 }
 
 /**
@@ -142,25 +142,89 @@ std::unique_ptr<std::vector<double>> Matrix::multiply(const std::vector<double>&
     auto result = std::make_unique<std::vector<double>>(m_rows, 0.0);
 
     // 矩阵-向量乘法：result[i] = Σ(j) A[i][j] * vec[j]
-    // 使用Lambda表达式优化计算过程
     for (size_t i = 0; i < m_rows; ++i) {
-        // 使用std::inner_product计算第i行的点积
-        auto row_begin = m_data[i].begin();
-        auto row_end = m_data[i].end();
-        auto vec_begin = vec.begin();
-        (*result)[i] = std::inner_product(row_begin, row_end, vec_begin, 0.0);
+        // 使用std::inner_product计算第i行的点积（行视图为连续存储）
+        ConstRowView row_i = row(i);
+        (*result)[i] = std::inner_product(row_i.begin(), row_i.end(), vec.begin(), 0.0);
     }
 
-    // for (size_t i = 0; i < m_rows; ++i) {
-    //     for (size_t j = 0; j < m_cols; ++j) {
-    //         (*result)[i] += m_data[i][j] * vec[j];
-    //     }
-    // }
     return result;
 }
 
 
 
+/**
+ * @brief 获取行视图
+ *
+ * 行优先存储中一行是连续的cols()个元素，视图只保存首地址和长度
+ */
+RowView Matrix::row(size_t row) {
+    if (row >= m_rows) {
+        throw std::out_of_range("Matrix row out of range");
+    }
+    return RowView(m_data.data() + row * m_cols, m_cols);
+}
+
+ConstRowView Matrix::row(size_t row) const {
+    if (row >= m_rows) {
+        throw std::out_of_range("Matrix row out of range");
+    }
+    return ConstRowView(m_data.data() + row * m_cols, m_cols);
+}
+
+/**
+ * @brief 获取列视图
+ *
+ * 同一列相邻元素相隔cols()个元素
+ */
+ColumnView Matrix::col(size_t col) {
+    if (col >= m_cols) {
+        throw std::out_of_range("Matrix column out of range");
+    }
+    return ColumnView(m_data.data() + col, m_rows, m_cols);
+}
+
+ConstColumnView Matrix::col(size_t col) const {
+    if (col >= m_cols) {
+        throw std::out_of_range("Matrix column out of range");
+    }
+    return ConstColumnView(m_data.data() + col, m_rows, m_cols);
+}
+
+/**
+ * @brief 获取子块视图
+ *
+ * 子块的行跨度仍为整个矩阵的列数
+ */
+BlockView Matrix::block(size_t row, size_t col, size_t rows, size_t cols) {
+    if (row + rows > m_rows || col + cols > m_cols) {
+        throw std::out_of_range("Matrix block out of range");
+    }
+    return BlockView(m_data.data() + row * m_cols + col, rows, cols, m_cols);
+}
+
+ConstBlockView Matrix::block(size_t row, size_t col, size_t rows, size_t cols) const {
+    if (row + rows > m_rows || col + cols > m_cols) {
+        throw std::out_of_range("Matrix block out of range");
+    }
+    return ConstBlockView(m_data.data() + row * m_cols + col, rows, cols, m_cols);
+}
+
+/**
+ * @brief 交换两行
+ *
+ * 两行都是连续内存，std::swap_ranges逐元素交换，不分配临时行
+ */
+void Matrix::swap_rows(size_t i, size_t j) {
+    if (i >= m_rows || j >= m_rows) {
+        throw std::out_of_range("Matrix row out of range");
+    }
+    if (i != j) {
+        RowView row_i = row(i);
+        std::swap_ranges(row_i.begin(), row_i.end(), row(j).begin());
+    }
+}
+
 /**
  * @brief 打印矩阵到控制台
  *
@@ -171,13 +235,14 @@ std::unique_ptr<std::vector<double>> Matrix::multiply(const std::vector<double>&
  * - 嵌套循环的遍历模式
  */
 void Matrix::print() const {
-    // 使用嵌套的std::for_each和Lambda表达式打印矩阵
-    std::for_each(m_data.begin(), m_data.end(), [](const auto& row) {
-        std::for_each(row.begin(), row.end(), [](double x) {
+    // 逐行取视图，用std::for_each和Lambda表达式打印
+    for (size_t i = 0; i < m_rows; ++i) {
+        ConstRowView row_i = row(i);
+        std::for_each(row_i.begin(), row_i.end(), [](double x) {
             std::cout << x << " ";
         });
         std::cout << std::endl;
-    });
+    }
     std::cout << std::flush;  // 确保输出立即显示
 }
 
@@ -233,26 +298,27 @@ bool Matrix::is_singular() const {
  */
 double Matrix::determinant() const {
     size_t n = m_rows;
+    const Matrix& A = *this;  // 元素访问使用不检查边界的A(i, j)
 
     if (n == 1) {
-        return m_data[0][0];
+        return A(0, 0);
     } else if (n == 2) {
         // 2x2矩阵行列式：ad - bc
-        return m_data[0][0] * m_data[1][1] - m_data[0][1] * m_data[1][0];
+        return A(0, 0) * A(1, 1) - A(0, 1) * A(1, 0);
     } else if (n == 3) {
         // 3x3矩阵行列式：使用Sarrus法则
-        return m_data[0][0] * m_data[1][1] * m_data[2][2] +
-               m_data[0][1] * m_data[1][2] * m_data[2][0] +
-               m_data[0][2] * m_data[1][0] * m_data[2][1] -
-               m_data[0][2] * m_data[1][1] * m_data[2][0] -
-               m_data[0][1] * m_data[1][0] * m_data[2][2] -
-               m_data[0][0] * m_data[1][2] * m_data[2][1];
+        return A(0, 0) * A(1, 1) * A(2, 2) +
+               A(0, 1) * A(1, 2) * A(2, 0) +
+               A(0, 2) * A(1, 0) * A(2, 1) -
+               A(0, 2) * A(1, 1) * A(2, 0) -
+               A(0, 1) * A(1, 0) * A(2, 2) -
+               A(0, 0) * A(1, 2) * A(2, 1);
     } else {
         // 对于4x4及以上的矩阵，使用简化的检查方法
         // 使用简单的对角元素检查作为替代
         // 这是为了避免递归算法的指数级复杂度
         for (size_t i = 0; i < n; ++i) {
-            if (std::abs(m_data[i][i]) < 1e-12) {
+            if (std::abs(A(i, i)) < 1e-12) {
                 std::cerr << "检测到零对角元素，矩阵可能奇异" << std::endl;
                 return 0.0;
             }
@@ -4,6 +4,9 @@
  *
  * 核心特性：
  * - 二维数值矩阵存储和操作
+ * - 单块连续、64字节对齐的行优先存储
+ * - 不检查边界的元素访问（用于求解器内层循环）
+ * - 非拥有的行、列和子块视图
  * - 多种构造函数（默认、数据、复制）
  * - 矩阵-向量乘法运算
  * - 数值稳定性保证
@@ -18,6 +21,215 @@
 #include <functional>    // 用于Lambda表达式
 #include <memory>        // 用于智能指针
 #include <algorithm>     // 用于std::for_each等算法
+#include <cstddef>       // 用于size_t
+#include <new>           // 用于对齐的operator new
+#include <stdexcept>     // 用于视图的边界检查
+
+/**
+ * @class AlignedAllocator
+ * @brief 按指定字节数对齐的分配器
+ *
+ * 矩阵缓冲区的首地址对齐到64字节（一个缓存行，也是AVX-512向量的宽度），
+ * 编译器向量化内层循环时不会因为首元素跨缓存行而多访问一次内存。
+ * 使用C++17的对齐operator new，不需要平台相关的_aligned_malloc/posix_memalign。
+ *
+ * @tparam T 元素类型
+ * @tparam Alignment 对齐字节数（2的幂）
+ */
+template <typename T, std::size_t Alignment>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/**
+ * @class BasicRowView
+ * @brief 矩阵行（或子块行）的非拥有视图 - 连续存储
+ *
+ * 只保存首元素指针和长度，不复制数据；矩阵被销毁或重新分配后视图失效。
+ * 连续存储，可以直接用begin()/end()交给std::inner_product等算法。
+ *
+ * @tparam T double（可修改）或const double（只读）
+ */
+template <typename T>
+class BasicRowView {
+private:
+    T* m_data;
+    size_t m_size;
+
+public:
+    BasicRowView(T* data, size_t size) : m_data(data), m_size(size) {}
+
+    /**
+     * @brief 只读视图可以由可修改视图隐式转换
+     */
+    template <typename U>
+    BasicRowView(const BasicRowView<U>& other) : m_data(other.data()), m_size(other.size()) {}
+
+    size_t size() const { return m_size; }
+    T* data() const { return m_data; }
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+
+    /**
+     * @brief 不检查边界的元素访问（内层循环使用）
+     */
+    T& operator[](size_t i) const { return m_data[i]; }
+
+    /**
+     * @brief 检查边界的元素访问
+     */
+    T& at(size_t i) const {
+        if (i >= m_size) {
+            throw std::out_of_range("Row view index out of range");
+        }
+        return m_data[i];
+    }
+};
+
+/**
+ * @class BasicColumnView
+ * @brief 矩阵列（或子块列）的非拥有视图 - 跨步存储
+ *
+ * 行优先存储中同一列的相邻元素相隔一行（stride个元素），
+ * 按列遍历时每次访问都跨过一行，比按行遍历慢，热点循环应尽量改为按行访问。
+ *
+ * @tparam T double（可修改）或const double（只读）
+ */
+template <typename T>
+class BasicColumnView {
+private:
+    T* m_data;
+    size_t m_size;
+    size_t m_stride;
+
+public:
+    BasicColumnView(T* data, size_t size, size_t stride) : m_data(data), m_size(size), m_stride(stride) {}
+
+    template <typename U>
+    BasicColumnView(const BasicColumnView<U>& other)
+        : m_data(other.data()), m_size(other.size()), m_stride(other.stride()) {}
+
+    size_t size() const { return m_size; }
+    size_t stride() const { return m_stride; }
+    T* data() const { return m_data; }
+
+    /**
+     * @brief 不检查边界的元素访问（内层循环使用）
+     */
+    T& operator[](size_t i) const { return m_data[i * m_stride]; }
+
+    /**
+     * @brief 检查边界的元素访问
+     */
+    T& at(size_t i) const {
+        if (i >= m_size) {
+            throw std::out_of_range("Column view index out of range");
+        }
+        return m_data[i * m_stride];
+    }
+};
+
+/**
+ * @class BasicBlockView
+ * @brief 矩阵子块的非拥有视图
+ *
+ * 保存左上角元素指针、子块大小和行跨度（所在矩阵的列数），
+ * 分块算法（如分块LU、子矩阵更新）可以直接在原矩阵的存储上操作，不复制子矩阵。
+ *
+ * @tparam T double（可修改）或const double（只读）
+ */
+template <typename T>
+class BasicBlockView {
+private:
+    T* m_data;
+    size_t m_rows;
+    size_t m_cols;
+    size_t m_stride;
+
+public:
+    BasicBlockView(T* data, size_t rows, size_t cols, size_t stride)
+        : m_data(data), m_rows(rows), m_cols(cols), m_stride(stride) {}
+
+    template <typename U>
+    BasicBlockView(const BasicBlockView<U>& other)
+        : m_data(other.data()), m_rows(other.rows()), m_cols(other.cols()), m_stride(other.stride()) {}
+
+    size_t rows() const { return m_rows; }
+    size_t cols() const { return m_cols; }
+    size_t stride() const { return m_stride; }
+    T* data() const { return m_data; }
+
+    /**
+     * @brief 不检查边界的元素访问（内层循环使用）
+     */
+    T& operator()(size_t row, size_t col) const { return m_data[row * m_stride + col]; }
+
+    /**
+     * @brief 检查边界的元素访问
+     */
+    T& at(size_t row, size_t col) const {
+        if (row >= m_rows || col >= m_cols) {
+            throw std::out_of_range("Block view indices out of range");
+        }
+        return m_data[row * m_stride + col];
+    }
+
+    BasicRowView<T> row(size_t row) const {
+        if (row >= m_rows) {
+            throw std::out_of_range("Block view row out of range");
+        }
+        return BasicRowView<T>(m_data + row * m_stride, m_cols);
+    }
+
+    BasicColumnView<T> col(size_t col) const {
+        if (col >= m_cols) {
+            throw std::out_of_range("Block view column out of range");
+        }
+        return BasicColumnView<T>(m_data + col, m_rows, m_stride);
+    }
+
+    /**
+     * @brief 子块的子块（行跨度不变）
+     */
+    BasicBlockView<T> block(size_t row, size_t col, size_t rows, size_t cols) const {
+        if (row + rows > m_rows || col + cols > m_cols) {
+            throw std::out_of_range("Block view sub-block out of range");
+        }
+        return BasicBlockView<T>(m_data + row * m_stride + col, rows, cols, m_stride);
+    }
+};
+
+using RowView = BasicRowView<double>;
+using ConstRowView = BasicRowView<const double>;
+using ColumnView = BasicColumnView<double>;
+using ConstColumnView = BasicColumnView<const double>;
+using BlockView = BasicBlockView<double>;
+using ConstBlockView = BasicBlockView<const double>;
 
 /**
  * @class Matrix
@@ -25,7 +237,10 @@
  *
  * 设计特点：
  * - 二维double数据存储
- * - 行优先存储布局
+ * - 行优先存储布局：元素(i, j)位于data()[i * cols() + j]，整个矩阵一块连续内存
+ * - 缓冲区首地址64字节对齐
+ * - at()检查边界，operator()不检查（求解器内层循环使用）
+ * - row()/col()/block()返回非拥有视图，不复制数据
  * - const正确性保证
  * - 数值精度控制（1e-10）
  * - 异常安全的数据访问
@@ -35,13 +250,22 @@
  * Matrix A(3, 3);  // 3x3零矩阵
  * Matrix B(data);  // 从数据构造
  * auto x = A.multiply_vector(b);  // Ax = b
+ * ConstRowView r = A.row(0);       // 第0行，不复制
+ * double s = A(1, 2);              // 不检查边界
  * @endcode
  */
 class Matrix {
 private:
+    static constexpr size_t ALIGNMENT = 64;          // 缓冲区对齐字节数（一个缓存行）
+
     size_t m_rows;                                   // 矩阵行数
     size_t m_cols;                                   // 矩阵列数
-    std::vector<std::vector<double>> m_data;        // 存储矩阵数据的二维向量
+    std::vector<double, AlignedAllocator<double, ALIGNMENT>> m_data;  // 行优先的连续存储（rows*cols个元素）
+
+    /**
+     * @brief 由二维向量填充连续存储（校验各行列数相同）
+     */
+    void assign_rows(const std::vector<std::vector<double>>& data);
 
 public:
     /**
@@ -63,10 +287,10 @@ public:
     Matrix(const std::vector<std::vector<double>>& data);
 
     /**
-     * @brief 移动构造函数 - 高效转移数据所有权
+     * @brief 构造函数 - 从右值二维向量创建矩阵
      * @param data 右值引用的二维向量
      *
-     * 演示C++11的移动语义，避免不必要的拷贝
+     * 各行不连续，仍需复制到连续存储中；复制后立即释放原数据
      */
     Matrix(std::vector<std::vector<double>>&& data);
 
@@ -102,6 +326,65 @@ public:
      */
     double at(size_t row, size_t col) const;
 
+    /**
+     * @brief 访问矩阵元素（不检查边界，可修改）
+     * @param row 行索引
+     * @param col 列索引
+     * @return 元素的引用
+     *
+     * 用于求解器的内层循环：只有一次乘加寻址，没有分支和二次间接寻址。
+     * 索引越界是未定义行为，调用方负责保证索引有效。
+     */
+    double& operator()(size_t row, size_t col) { return m_data[row * m_cols + col]; }
+
+    /**
+     * @brief 访问矩阵元素（不检查边界，只读）
+     */
+    double operator()(size_t row, size_t col) const { return m_data[row * m_cols + col]; }
+
+    // ===== 连续存储和视图 =====
+
+    /**
+     * @brief 获取连续存储的首地址（64字节对齐，行优先，行跨度为cols()）
+     * @return 数据指针
+     */
+    double* data() { return m_data.data(); }
+    const double* data() const { return m_data.data(); }
+
+    /**
+     * @brief 获取第row行的视图（连续存储，检查行索引）
+     * @param row 行索引
+     * @return 行视图（不复制数据）
+     */
+    RowView row(size_t row);
+    ConstRowView row(size_t row) const;
+
+    /**
+     * @brief 获取第col列的视图（跨步为cols()，检查列索引）
+     * @param col 列索引
+     * @return 列视图（不复制数据）
+     */
+    ColumnView col(size_t col);
+    ConstColumnView col(size_t col) const;
+
+    /**
+     * @brief 获取子块视图（检查子块是否在矩阵内）
+     * @param row 左上角行索引
+     * @param col 左上角列索引
+     * @param rows 子块行数
+     * @param cols 子块列数
+     * @return 子块视图（不复制数据）
+     */
+    BlockView block(size_t row, size_t col, size_t rows, size_t cols);
+    ConstBlockView block(size_t row, size_t col, size_t rows, size_t cols) const;
+
+    /**
+     * @brief 交换两行（部分选主元使用）
+     * @param i 行索引
+     * @param j 行索引
+     */
+    void swap_rows(size_t i, size_t j);
+
     // ===== 矩阵运算 =====
 
     /**
@@ -122,21 +405,6 @@ public:
      */
     void print() const;
 
-    // ===== 性能优化接口 =====
-    // 以下方法仅用于内部性能优化，外部使用应避免直接访问
-
-    /**
-     * @brief 获取原始数据引用（仅用于内部优化）
-     * @return 内部数据引用
-     */
-    const std::vector<std::vector<double>>& get_raw_data() const { return m_data; }
-
-    /**
-     * @brief 获取可修改的原始数据引用（仅用于内部优化）
-     * @return 内部数据引用
-     */
-    std::vector<std::vector<double>>& get_mutable_raw_data() { return m_data; }
-
     // ===== 辅助功能 =====
 
     /**
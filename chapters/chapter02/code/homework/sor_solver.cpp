@@ -11,7 +11,6 @@ std::unique_ptr<Vector> SORSolver::solve(const Matrix& A, const Vector& b) {
     auto x = std::make_unique<Vector>(n, 0.0);  // 初始解
 
     // 预先获取底层数据指针，减少函数调用开销
-    const auto& A_data = A.get_raw_data();
     const auto& b_data = b.get_raw_data();
 
     std::vector<double> x_vec(n, 0.0);
@@ -22,21 +21,24 @@ std::unique_ptr<Vector> SORSolver::solve(const Matrix& A, const Vector& b) {
         std::copy(x_vec.begin(), x_vec.end(), x_new_vec.begin());
 
         for (size_t i = 0; i < n; ++i) {
+            // 第i行为连续存储的行视图，不复制
+            ConstRowView A_i = A.row(i);
+
             // 使用std::inner_product和Lambda表达式优化sum1和sum2计算
             double sum1 = std::inner_product(
-                A_data[i].begin(), A_data[i].begin() + i,
+                A_i.begin(), A_i.begin() + i,
                 x_new_vec.begin(), 0.0
             );
             double sum2 = std::inner_product(
-                A_data[i].begin() + i + 1, A_data[i].end(),
+                A_i.begin() + i + 1, A_i.end(),
                 x_vec.begin() + i + 1, 0.0
             );
 
-            if (std::abs(A_data[i][i]) < 1e-10) {
+            if (std::abs(A_i[i]) < 1e-10) {
                 return nullptr; // 矩阵对角元素为0，无法使用SOR方法
             }
 
-            x_new_vec[i] = (1 - m_omega) * x_vec[i] + m_omega * (b_data[i] - sum1 - sum2) / A_data[i][i];
+            x_new_vec[i] = (1 - m_omega) * x_vec[i] + m_omega * (b_data[i] - sum1 - sum2) / A_i[i];
         }
 
         // 使用std::inner_product和Lambda表达式优化误差计算
@@ -51,7 +53,7 @@ std::unique_ptr<Vector> SORSolver::solve(const Matrix& A, const Vector& b) {
         }
 
         if (error < m_tolerance) {
-            return std::make_unique<Vector>(x_new_vec);
+            return std::make_unique<Vector>(std::move(x_new_vec));
         }
 
         std::swap(x_vec, x_new_vec);  // 更新解
@@ -0,0 +1,137 @@
+#ifndef MT_BOUNDED_QUEUE_H
+#define MT_BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+/**
+ * MT有界无锁队列模块
+ * 多生产者多消费者环形队列（Vyukov算法），容量固定，入队/出队不加锁
+ *
+ * 每个槽位保存一个序号：序号等于写位置时可写，等于读位置+1时可读。
+ * 生产者和消费者只通过CAS竞争位置计数器，因此不会相互阻塞；
+ * 队列满或空时tryPush/tryPop立即返回false，由调用方决定如何等待。
+ */
+namespace MT {
+
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * 构造函数
+     * @param capacity 队列容量（向上取整为2的幂，至少为2）
+     */
+    explicit BoundedQueue(size_t capacity)
+        : m_enqueuePos(0), m_dequeuePos(0) {
+        size_t n = 2;
+        while (n < capacity) {
+            n <<= 1;
+        }
+        m_mask = n - 1;
+        m_cells = std::vector<Cell>(n);
+        for (size_t i = 0; i < n; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * 尝试入队（队列满时返回false，value保持不变）
+     * @param value 入队元素
+     * @return 是否成功
+     */
+    bool tryPush(T&& value) {
+        Cell* cell;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列已满
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * 尝试出队（队列空时返回false）
+     * @param value 输出元素
+     * @return 是否成功
+     */
+    bool tryPop(T& value) {
+        Cell* cell;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列为空
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->data = T();  // 及时释放槽位中的大块内存
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * 获取队列容量
+     * @return 容量
+     */
+    size_t capacity() const { return m_mask + 1; }
+
+    /**
+     * 估计当前元素个数（并发下只是近似值，用于监控）
+     * @return 元素个数
+     */
+    size_t sizeApprox() const {
+        size_t enq = m_enqueuePos.load(std::memory_order_relaxed);
+        size_t deq = m_dequeuePos.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+
+        Cell() : sequence(0), data() {}
+        Cell(Cell&& other) noexcept
+            : sequence(other.sequence.load(std::memory_order_relaxed)), data(std::move(other.data)) {}
+        Cell& operator=(Cell&& other) noexcept {
+            sequence.store(other.sequence.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            data = std::move(other.data);
+            return *this;
+        }
+    };
+
+    std::vector<Cell> m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueuePos;  // 生产者位置（独占缓存行，避免伪共享）
+    alignas(64) std::atomic<size_t> m_dequeuePos;  // 消费者位置
+};
+
+} // namespace MT
+
+#endif // MT_BOUNDED_QUEUE_H
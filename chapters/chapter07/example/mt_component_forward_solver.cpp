@@ -0,0 +1,35 @@
+#include "mt_component_forward_solver.h"
+#include <stdexcept>
+
+namespace MT {
+
+ComponentForwardSolver::ComponentForwardSolver(ForwardSolver* backend,
+                                               const std::vector<DataComponent>& components)
+    : m_backend(backend)
+    , m_components(components) {
+    if (!m_backend) {
+        throw std::invalid_argument("ComponentForwardSolver: backend must not be null");
+    }
+    if (m_components.empty()) {
+        throw std::invalid_argument("ComponentForwardSolver: at least one data component is required");
+    }
+}
+
+ComponentForwardSolver::~ComponentForwardSolver() {
+}
+
+void ComponentForwardSolver::solve(const std::vector<double>& mLogRho,
+                                   const std::vector<double>& omega,
+                                   const std::vector<double>& layerThicknesses,
+                                   std::vector<double>& dataOut) {
+    m_backend->solveComponents(mLogRho, omega, layerThicknesses, m_components, dataOut);
+}
+
+void ComponentForwardSolver::computeImpedance(const std::vector<double>& mLogRho,
+                                              const std::vector<double>& omega,
+                                              const std::vector<double>& layerThicknesses,
+                                              std::vector<MKL_Complex16>& Z) {
+    m_backend->computeImpedance(mLogRho, omega, layerThicknesses, Z);
+}
+
+} // namespace MT
@@ -0,0 +1,56 @@
+#ifndef MT_COMPONENT_FORWARD_SOLVER_H
+#define MT_COMPONENT_FORWARD_SOLVER_H
+
+#include "mt_forward_solver.h"
+#include <vector>
+
+/**
+ * MT多分量正演适配器
+ * 包装任意正演后端，把solve()的输出换成按分量优先存储的多分量数据（data[c * nFreq + f]）。
+ * 所有分量由后端的一次computeImpedance()得到；Jacobian计算、λ搜索和残差计算把数据当作
+ * 普通向量处理，因此无需修改即可反演多分量数据。
+ */
+namespace MT {
+
+class ComponentForwardSolver : public ForwardSolver {
+public:
+    /**
+     * 构造函数
+     * @param backend 正演后端（必须有效，生命周期由调用方保证）
+     * @param components 数据分量（不能为空）
+     */
+    ComponentForwardSolver(ForwardSolver* backend, const std::vector<DataComponent>& components);
+    ~ComponentForwardSolver() override;
+
+    using ForwardSolver::solve;
+
+    /**
+     * 执行正演计算
+     * @param mLogRho 模型参数（log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param dataOut 输出数据（按分量优先存储：dataOut[c * nFreq + f]）
+     */
+    void solve(const std::vector<double>& mLogRho,
+               const std::vector<double>& omega,
+               const std::vector<double>& layerThicknesses,
+               std::vector<double>& dataOut) override;
+
+    /**
+     * 计算各频率的地表阻抗（交给正演后端）
+     */
+    void computeImpedance(const std::vector<double>& mLogRho,
+                          const std::vector<double>& omega,
+                          const std::vector<double>& layerThicknesses,
+                          std::vector<MKL_Complex16>& Z) override;
+
+    const std::vector<DataComponent>& getComponents() const { return m_components; }
+
+private:
+    ForwardSolver* m_backend;
+    std::vector<DataComponent> m_components;
+};
+
+} // namespace MT
+
+#endif // MT_COMPONENT_FORWARD_SOLVER_H
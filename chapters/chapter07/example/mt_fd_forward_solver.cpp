@@ -0,0 +1,300 @@
+#include "mt_fd_forward_solver.h"
+#include "mt_thread_policy.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace MT {
+
+namespace {
+
+// 10^(-log10(ρ)) = σ
+inline double conductivity(double logRho) {
+    return pow(10.0, -logRho);
+}
+
+} // namespace
+
+FiniteDifferenceForwardSolver::FiniteDifferenceForwardSolver(Profile profile,
+                                                             double pointsPerSkinDepth,
+                                                             int nThreads)
+    : m_profile(profile)
+    , m_pointsPerSkinDepth(20.0)
+    , m_nThreads(0)
+    , m_lastCellCount(0) {
+    setPointsPerSkinDepth(pointsPerSkinDepth);
+    setThreadCount(nThreads);
+}
+
+FiniteDifferenceForwardSolver::~FiniteDifferenceForwardSolver() {
+}
+
+void FiniteDifferenceForwardSolver::setPointsPerSkinDepth(double pointsPerSkinDepth) {
+    if (!(pointsPerSkinDepth >= 1.0) || !std::isfinite(pointsPerSkinDepth)) {
+        throw std::invalid_argument("Points per skin depth must be at least 1");
+    }
+    m_pointsPerSkinDepth = pointsPerSkinDepth;
+}
+
+void FiniteDifferenceForwardSolver::setThreadCount(int nThreads) {
+    if (nThreads < 0) {
+        throw std::invalid_argument("Thread count must be non-negative");
+    }
+    m_nThreads = nThreads;
+}
+
+double FiniteDifferenceForwardSolver::cellSize(double z, double sigma, double omegaMax) const {
+    // 最高频率下的趋肤深度δ = sqrt(2/(ωμ₀σ))；深度z处只需分辨δ >= z/3的频率
+    double skinDepth = sqrt(2.0 / (omegaMax * MU0 * sigma));
+    return std::max(skinDepth, z / 3.0) / m_pointsPerSkinDepth;
+}
+
+void FiniteDifferenceForwardSolver::buildLayeredGrid(const std::vector<double>& mLogRho,
+                                                     const std::vector<double>& layerThicknesses,
+                                                     double omegaMax,
+                                                     Grid& grid) const {
+    int M = static_cast<int>(mLogRho.size());
+    grid.h.clear();
+    grid.sigma.clear();
+    grid.sigmaHalfSpace = conductivity(mLogRho[M - 1]);
+
+    double top = 0.0;
+    for (int i = 0; i < M - 1; i++) {
+        // 层厚度数组大小不匹配时与递推解析法一致，取默认层厚100米
+        double d = layerThicknesses.size() == static_cast<size_t>(M) ? layerThicknesses[i] : 100.0;
+        if (!(d > 0.0) || !std::isfinite(d)) {
+            continue;  // 跳过无效层
+        }
+        double sigma = conductivity(mLogRho[i]);
+        double bottom = top + d;
+        double z = top;
+        while (bottom - z > 1e-9 * bottom) {
+            double h = cellSize(z, sigma, omegaMax);
+            // 最后一个单元吸收余量，避免出现很薄的单元
+            if (z + 1.5 * h >= bottom) {
+                h = bottom - z;
+            }
+            grid.h.push_back(h);
+            grid.sigma.push_back(sigma);
+            z += h;
+            if (static_cast<int>(grid.h.size()) > MAX_CELLS) {
+                throw std::runtime_error("Finite-difference grid exceeds the maximum cell count");
+            }
+        }
+        top = bottom;
+    }
+}
+
+void FiniteDifferenceForwardSolver::buildProfileGrid(const std::vector<double>& nodeDepths,
+                                                     const std::vector<double>& nodeLogRho,
+                                                     double omegaMax,
+                                                     Grid& grid) const {
+    const int n = static_cast<int>(nodeDepths.size());
+    auto logRhoAt = [&](double z) {
+        if (z <= nodeDepths[0]) {
+            return nodeLogRho[0];
+        }
+        if (z >= nodeDepths[n - 1]) {
+            return nodeLogRho[n - 1];
+        }
+        int k = static_cast<int>(std::upper_bound(nodeDepths.begin(), nodeDepths.end(), z) -
+                                 nodeDepths.begin()) - 1;
+        double t = (z - nodeDepths[k]) / (nodeDepths[k + 1] - nodeDepths[k]);
+        return nodeLogRho[k] + t * (nodeLogRho[k + 1] - nodeLogRho[k]);
+    };
+
+    grid.h.clear();
+    grid.sigma.clear();
+    grid.sigmaHalfSpace = conductivity(nodeLogRho[n - 1]);
+
+    const double bottom = nodeDepths[n - 1];
+    double z = 0.0;
+    while (bottom - z > 1e-9 * bottom) {
+        // 单元两端取较小的目标尺寸，保证梯度带内的分辨率
+        double h = cellSize(z, conductivity(logRhoAt(z)), omegaMax);
+        h = std::min(h, cellSize(z, conductivity(logRhoAt(z + h)), omegaMax));
+        if (z + 1.5 * h >= bottom) {
+            h = bottom - z;
+        }
+        grid.h.push_back(h);
+        grid.sigma.push_back(conductivity(logRhoAt(z + 0.5 * h)));
+        z += h;
+        if (static_cast<int>(grid.h.size()) > MAX_CELLS) {
+            throw std::runtime_error("Finite-difference grid exceeds the maximum cell count");
+        }
+    }
+}
+
+void FiniteDifferenceForwardSolver::computeImpedance(const std::vector<double>& mLogRho,
+                                                     const std::vector<double>& omega,
+                                                     const std::vector<double>& layerThicknesses,
+                                                     std::vector<MKL_Complex16>& Z) {
+    int M = static_cast<int>(mLogRho.size());
+    if (M == 0) {
+        throw std::invalid_argument("Finite-difference forward model has no layers");
+    }
+    double omegaMax = 0.0;
+    for (double w : omega) {
+        if (std::isfinite(w)) {
+            omegaMax = std::max(omegaMax, w);
+        }
+    }
+    if (!(omegaMax > 0.0)) {
+        omegaMax = 1.0;
+    }
+
+    Grid grid;
+    if (m_profile == Profile::LAYERED) {
+        buildLayeredGrid(mLogRho, layerThicknesses, omegaMax, grid);
+    } else {
+        // 节点取各层中点，底部半空间取其顶面
+        std::vector<double> nodeDepths, nodeLogRho;
+        double top = 0.0;
+        for (int i = 0; i < M - 1; i++) {
+            double d = layerThicknesses.size() == static_cast<size_t>(M) ? layerThicknesses[i] : 100.0;
+            if (!(d > 0.0) || !std::isfinite(d)) {
+                continue;
+            }
+            nodeDepths.push_back(top + 0.5 * d);
+            nodeLogRho.push_back(mLogRho[i]);
+            top += d;
+        }
+        nodeDepths.push_back(top);
+        nodeLogRho.push_back(mLogRho[M - 1]);
+        buildProfileGrid(nodeDepths, nodeLogRho, omegaMax, grid);
+    }
+    solveGrid(grid, omega, Z);
+}
+
+void FiniteDifferenceForwardSolver::computeProfileImpedance(const std::vector<double>& nodeDepths,
+                                                            const std::vector<double>& nodeLogRho,
+                                                            const std::vector<double>& omega,
+                                                            std::vector<MKL_Complex16>& Z) {
+    if (nodeDepths.empty() || nodeDepths.size() != nodeLogRho.size()) {
+        throw std::invalid_argument("Profile depths and resistivities must be non-empty and of equal size");
+    }
+    for (size_t k = 0; k < nodeDepths.size(); k++) {
+        if (!std::isfinite(nodeDepths[k]) || nodeDepths[k] < 0.0 ||
+            (k > 0 && !(nodeDepths[k] > nodeDepths[k - 1]))) {
+            throw std::invalid_argument("Profile depths must be non-negative and strictly increasing");
+        }
+    }
+    double omegaMax = 0.0;
+    for (double w : omega) {
+        if (std::isfinite(w)) {
+            omegaMax = std::max(omegaMax, w);
+        }
+    }
+    if (!(omegaMax > 0.0)) {
+        omegaMax = 1.0;
+    }
+
+    Grid grid;
+    buildProfileGrid(nodeDepths, nodeLogRho, omegaMax, grid);
+    solveGrid(grid, omega, Z);
+}
+
+void FiniteDifferenceForwardSolver::solveGrid(const Grid& grid, const std::vector<double>& omega,
+                                              std::vector<MKL_Complex16>& Z) {
+    const int nFreq = static_cast<int>(omega.size());
+    Z.resize(nFreq);
+    m_lastCellCount = static_cast<int>(grid.h.size());
+    if (nFreq == 0) {
+        return;
+    }
+
+    // 线程数：自动模式按计算量和外层并行占用后剩余的核数决定，不超过频率数
+    int nThreads = m_nThreads;
+    if (nThreads == 0) {
+        long long work = static_cast<long long>(grid.h.size() + 1) * nFreq;
+        int nCores = ThreadPolicy::availableThreads();
+        nThreads = static_cast<int>(std::min<long long>(nCores, work / MIN_WORK_PER_THREAD));
+    }
+    nThreads = std::max(1, std::min(nThreads, nFreq));
+
+    if (nThreads == 1) {
+        eliminate(grid, omega, 0, nFreq, Z);
+        return;
+    }
+
+    // 按频率分块，各线程写入Z的不同区间；第一块在当前线程中求解
+    int blockSize = (nFreq + nThreads - 1) / nThreads;
+    std::vector<std::thread> workers;
+    for (int f0 = blockSize; f0 < nFreq; f0 += blockSize) {
+        int f1 = std::min(nFreq, f0 + blockSize);
+        workers.emplace_back([&grid, &omega, &Z, f0, f1]() {
+            ParallelTaskScope task;  // 占用的核心计入活动任务
+            eliminate(grid, omega, f0, f1, Z);
+        });
+    }
+    eliminate(grid, omega, 0, std::min(nFreq, blockSize), Z);
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+void FiniteDifferenceForwardSolver::eliminate(const Grid& grid, const std::vector<double>& omega,
+                                              int f0, int f1, std::vector<MKL_Complex16>& Z) {
+    const int B = f1 - f0;
+    const int N = static_cast<int>(grid.h.size());
+    const double* h = grid.h.data();
+    const double* sigma = grid.sigma.data();
+
+    // ωμ₀按频率连续存储；非正角频率按ωμ₀ = μ₀计算，最后替换为默认值
+    std::vector<double> w(B), gr(B), gi(B);
+    for (int f = 0; f < B; f++) {
+        double wf = omega[f0 + f];
+        w[f] = (wf > 0.0 && std::isfinite(wf)) ? wf * MU0 : MU0;
+    }
+
+    if (N == 0) {
+        // 均匀半空间：Z = (1+i) * sqrt(ωμ₀/(2σ))
+        for (int f = 0; f < B; f++) {
+            double a = sqrt(w[f] / (2.0 * grid.sigmaHalfSpace));
+            gr[f] = a;
+            gi[f] = a;
+        }
+    } else {
+        // 底部节点N：d_N = -1/h_{N-1} - k_b - iωμ₀ σ_{N-1}h_{N-1}/2，k_b = (1+i)*sqrt(ωμ₀σ_b/2)
+        const double oBottom = 1.0 / h[N - 1];
+        const double sBottom = 0.5 * sigma[N - 1] * h[N - 1];
+        for (int f = 0; f < B; f++) {
+            double kb = sqrt(0.5 * w[f] * grid.sigmaHalfSpace);
+            gr[f] = -oBottom - kb;
+            gi[f] = -kb - w[f] * sBottom;
+        }
+
+        // 向上消元：g_j = d_j - o_j² / g_{j+1}，o_j = 1/h_j为节点j与j+1的耦合系数
+        for (int j = N - 1; j >= 0; j--) {
+            const double o = 1.0 / h[j];
+            const double o2 = o * o;
+            const double oAbove = j > 0 ? 1.0 / h[j - 1] : 0.0;
+            const double s = 0.5 * (sigma[j] * h[j] + (j > 0 ? sigma[j - 1] * h[j - 1] : 0.0));
+            const double dr = -(o + oAbove);
+            for (int f = 0; f < B; f++) {
+                const double scale = o2 / (gr[f] * gr[f] + gi[f] * gi[f]);
+                gr[f] = dr - gr[f] * scale;
+                gi[f] = -w[f] * s + gi[f] * scale;
+            }
+        }
+
+        // E_0 = -iωμ₀ / g_0，Z = E_0
+        for (int f = 0; f < B; f++) {
+            const double inv = w[f] / (gr[f] * gr[f] + gi[f] * gi[f]);
+            const double zr = -gi[f] * inv;
+            const double zi = -gr[f] * inv;
+            gr[f] = zr;
+            gi[f] = zi;
+        }
+    }
+
+    for (int f = 0; f < B; f++) {
+        const double wf = omega[f0 + f];
+        const bool valid = wf > 0.0 && std::isfinite(wf);
+        Z[f0 + f].real = valid ? gr[f] : 1e-10;
+        Z[f0 + f].imag = valid ? gi[f] : 1e-10;
+    }
+}
+
+} // namespace MT
@@ -1,5 +1,6 @@
 #include "mt_forward_solver.h"
 #include <mkl.h>
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -19,12 +20,41 @@ void ForwardSolver::solve(const std::vector<double>& mLogRho,
                           const std::vector<double>& omega,
                           const std::vector<double>& layerThicknesses,
                           std::vector<double>& dataOut) {
-    int M = static_cast<int>(mLogRho.size());
     int nFreq = static_cast<int>(omega.size());
     int nData = nFreq * 2;
 
     dataOut.resize(nData);
 
+    // 对每个频率进行正演（默认使用向上递推阻抗的解析法，派生类可重写computeImpedance()）
+    std::vector<MKL_Complex16> Z;
+    computeImpedance(mLogRho, omega, layerThicknesses, Z);
+
+    for (int ifreq = 0; ifreq < nFreq; ifreq++) {
+        // 计算相位：φ = atan2(Im(Z), Re(Z))
+        double phase_rad = atan2(Z[ifreq].imag, Z[ifreq].real);
+        double phase = phase_rad * 180.0 / M_PI;
+
+        // 输出：log10(视电阻率)和相位（度）
+        int idx_rho = ifreq * 2;
+        int idx_phase = ifreq * 2 + 1;
+        dataOut[idx_rho] = logApparentResistivity(Z[ifreq].real, Z[ifreq].imag, omega[ifreq]);
+        dataOut[idx_phase] = phase;
+    }
+}
+
+void ForwardSolver::computeImpedance(const std::vector<double>& mLogRho,
+                                     const std::vector<double>& omega,
+                                     const std::vector<double>& layerThicknesses,
+                                     std::vector<MKL_Complex16>& Z) {
+    computeSurfaceImpedances(mLogRho, omega, layerThicknesses, Z);
+}
+
+void ForwardSolver::computeSurfaceImpedances(const std::vector<double>& mLogRho,
+                                             const std::vector<double>& omega,
+                                             const std::vector<double>& layerThicknesses,
+                                             std::vector<MKL_Complex16>& Z) {
+    int M = static_cast<int>(mLogRho.size());
+
     // 计算电导率
     std::vector<double> sigma(M);
     computeConductivity(mLogRho, sigma);
@@ -40,39 +70,91 @@ void ForwardSolver::solve(const std::vector<double>& mLogRho,
         }
     }
 
-    // 对每个频率进行正演（使用向上递推阻抗的解析法）
-    for (int ifreq = 0; ifreq < nFreq; ifreq++) {
-        double w = omega[ifreq];
-        
-        // 使用向上递推阻抗法计算地表阻抗
-        MKL_Complex16 Z_surface;
-        computeRecursiveImpedance(M, w, sigma, dz, Z_surface);
-
-        // 计算视电阻率：ρ_a = |Z|² / (ωμ₀)
-        double Z_mag2 = Z_surface.real * Z_surface.real + Z_surface.imag * Z_surface.imag;
-        double denom = w * MU0;
-        double rho_a;  // 声明视电阻率变量
-        // 检查除零和无效值
-        if (denom <= 0.0 || !std::isfinite(denom) || !std::isfinite(Z_mag2)) {
-            rho_a = 1e-10;  // 默认值
-        } else {
-            rho_a = Z_mag2 / denom;
-        }
-        
-        // 检查NaN和Inf
-        if (!std::isfinite(rho_a) || rho_a <= 0.0) {
-            rho_a = 1e-10;
-        }
+    // 使用向上递推阻抗法计算各频率的地表阻抗（所有频率一起递推）
+    computeRecursiveImpedance(omega, sigma, dz, Z);
+}
 
-        // 计算相位：φ = atan2(Im(Z), Re(Z))
-        double phase_rad = atan2(Z_surface.imag, Z_surface.real);
-        double phase = phase_rad * 180.0 / M_PI;
+double ForwardSolver::logApparentResistivity(double re, double im, double w) {
+    // 计算视电阻率：ρ_a = |Z|² / (ωμ₀)
+    double Z_mag2 = re * re + im * im;
+    double denom = w * MU0;
+    double rho_a;
+    // 检查除零和无效值
+    if (denom <= 0.0 || !std::isfinite(denom) || !std::isfinite(Z_mag2)) {
+        rho_a = 1e-10;  // 默认值
+    } else {
+        rho_a = Z_mag2 / denom;
+    }
 
-        // 输出：log10(视电阻率)和相位（度）
-        int idx_rho = ifreq * 2;
-        int idx_phase = ifreq * 2 + 1;
-        dataOut[idx_rho] = log10(rho_a);
-        dataOut[idx_phase] = phase;
+    // 检查NaN和Inf
+    if (!std::isfinite(rho_a) || rho_a <= 0.0) {
+        rho_a = 1e-10;
+    }
+    return log10(rho_a);
+}
+
+void ForwardSolver::solveComponents(const std::vector<double>& mLogRho,
+                                    const std::vector<double>& omega,
+                                    const std::vector<double>& layerThicknesses,
+                                    const std::vector<DataComponent>& components,
+                                    std::vector<double>& dataOut) {
+    std::vector<MKL_Complex16> Z;
+    computeImpedance(mLogRho, omega, layerThicknesses, Z);
+    impedanceToComponents(Z, omega, components, dataOut);
+}
+
+void ForwardSolver::impedanceToComponents(const std::vector<MKL_Complex16>& Z,
+                                          const std::vector<double>& omega,
+                                          const std::vector<DataComponent>& components,
+                                          std::vector<double>& dataOut) {
+    const int nFreq = static_cast<int>(std::min(Z.size(), omega.size()));
+    const int nComp = static_cast<int>(components.size());
+    dataOut.resize(static_cast<size_t>(nComp) * nFreq);
+
+    // 一维阻抗张量：Z_xy = Z，Z_yx = -Z，Z_xx = Z_yy = 0
+    // 行列式不变量Z_det = sqrt(Z_xx*Z_yy - Z_xy*Z_yx)在一维时等于Z_xy
+    for (int c = 0; c < nComp; c++) {
+        double* out = dataOut.data() + static_cast<size_t>(c) * nFreq;
+        switch (components[c]) {
+            case DataComponent::LOG_RHO_XY:
+            case DataComponent::LOG_RHO_YX:
+            case DataComponent::LOG_RHO_DET:
+                for (int f = 0; f < nFreq; f++) {
+                    out[f] = logApparentResistivity(Z[f].real, Z[f].imag, omega[f]);
+                }
+                break;
+            case DataComponent::PHASE_XY:
+            case DataComponent::PHASE_DET:
+                for (int f = 0; f < nFreq; f++) {
+                    out[f] = atan2(Z[f].imag, Z[f].real) * 180.0 / M_PI;
+                }
+                break;
+            case DataComponent::PHASE_YX:
+                for (int f = 0; f < nFreq; f++) {
+                    out[f] = atan2(-Z[f].imag, -Z[f].real) * 180.0 / M_PI;
+                }
+                break;
+            case DataComponent::RE_ZXY:
+                for (int f = 0; f < nFreq; f++) {
+                    out[f] = Z[f].real;
+                }
+                break;
+            case DataComponent::IM_ZXY:
+                for (int f = 0; f < nFreq; f++) {
+                    out[f] = Z[f].imag;
+                }
+                break;
+            case DataComponent::RE_ZYX:
+                for (int f = 0; f < nFreq; f++) {
+                    out[f] = -Z[f].real;
+                }
+                break;
+            case DataComponent::IM_ZYX:
+                for (int f = 0; f < nFreq; f++) {
+                    out[f] = -Z[f].imag;
+                }
+                break;
+        }
     }
 }
 
@@ -82,6 +164,16 @@ void ForwardSolver::solve(const ModelParams& model,
     solve(model.mLogRho, omega, model.layerThicknesses, dataOut);
 }
 
+void ForwardSolver::solveBatch(const std::vector<std::vector<double>>& models,
+                               const std::vector<double>& omega,
+                               const std::vector<double>& layerThicknesses,
+                               std::vector<std::vector<double>>& dataOut) {
+    dataOut.resize(models.size());
+    for (size_t k = 0; k < models.size(); k++) {
+        solve(models[k], omega, layerThicknesses, dataOut[k]);
+    }
+}
+
 void ForwardSolver::computeConductivity(const std::vector<double>& mLogRho,
                                          std::vector<double>& sigma) {
     int M = static_cast<int>(mLogRho.size());
@@ -101,140 +193,95 @@ void ForwardSolver::computeConductivity(const std::vector<double>& mLogRho,
     vdInv(M, rho.data(), sigma.data());
 }
 
-void ForwardSolver::computeRecursiveImpedance(int M, double w,
+void ForwardSolver::computeRecursiveImpedance(const std::vector<double>& omega,
                                                const std::vector<double>& sigma,
                                                const std::vector<double>& dz,
-                                               MKL_Complex16& Z_surface) {
-    // 向上递推阻抗的解析法
-    // 从最底层（半空间）开始，向上递推到地表
-    
-    // 最底层（第M-1层）的阻抗：Z_bottom = sqrt(iωμ₀/σ_bottom)
-    // sqrt(i) = (1+i)/sqrt(2)，所以 sqrt(iωμ₀/σ) = (1+i) * sqrt(ωμ₀/(2σ))
-    // 检查参数有效性
-    if (M <= 0 || sigma.empty() || sigma[M - 1] <= 0.0 || w <= 0.0) {
-        Z_surface.real = 1e-10;
-        Z_surface.imag = 1e-10;
+                                               std::vector<MKL_Complex16>& Z) {
+    // 向上递推阻抗的解析法（反射系数形式）
+    // 从最底层（半空间）开始，向上递推到地表；外层循环为层，内层循环为频率
+    const int M = static_cast<int>(sigma.size());
+    const int nFreq = static_cast<int>(omega.size());
+    Z.resize(nFreq);
+    if (nFreq == 0) {
         return;
     }
-    double denom = 2.0 * sigma[M - 1];
-    if (denom <= 0.0 || !std::isfinite(denom)) {
-        Z_surface.real = 1e-10;
-        Z_surface.imag = 1e-10;
+
+    // 检查参数有效性（无效时地表阻抗取1e-10）
+    if (M <= 0 || !(sigma[M - 1] > 0.0) || !std::isfinite(sigma[M - 1])) {
+        for (int f = 0; f < nFreq; f++) {
+            Z[f].real = 1e-10;
+            Z[f].imag = 1e-10;
+        }
         return;
     }
-    double sqrt_wmu0_2sigma = sqrt(w * MU0 / denom);
-    if (!std::isfinite(sqrt_wmu0_2sigma)) {
-        sqrt_wmu0_2sigma = 1e-10;
+    // sqrt(ωμ₀)各层共用；非正角频率按ωμ₀ = μ₀参与递推，最后再替换为默认值，使内层循环无分支
+    std::vector<double> sqrtWmu(nFreq);
+    for (int f = 0; f < nFreq; f++) {
+        sqrtWmu[f] = sqrt((omega[f] > 0.0 && std::isfinite(omega[f])) ? omega[f] * MU0 : MU0);
+    }
+
+    // 阻抗按实部、虚部分开存储
+    std::vector<double> zr(nFreq), zi(nFreq);
+    std::vector<double> a(nFreq), t(nFreq), decay(nFreq), s(nFreq), c(nFreq);
+
+    // 最底层（第M-1层）的阻抗：Z_bottom = sqrt(iωμ₀/σ) = (1+i) * sqrt(ωμ₀/(2σ))
+    const double sqrtHalfRhoBottom = sqrt(0.5 / sigma[M - 1]);
+    for (int f = 0; f < nFreq; f++) {
+        zr[f] = sqrtWmu[f] * sqrtHalfRhoBottom;
+        zi[f] = zr[f];
     }
-    
-    MKL_Complex16 Z_current;
-    Z_current.real = sqrt_wmu0_2sigma;
-    Z_current.imag = sqrt_wmu0_2sigma;
-    
-    // 从底层向上递推到地表
+
+    // 第i层：Z_0i = (1+i)*a，k_i = (1+i)*sqrt(ωμ₀σ_i/2)
+    //   Z_i = Z_0i * (1 - r*e) / (1 + r*e)，r = (Z_0i - Z_{i+1}) / (Z_0i + Z_{i+1})，e = exp(-2*k_i*d_i)
+    // 与tanh形式等价，但只用到衰减的指数：|e| <= 1，且Z_0i和Z_{i+1}实部为正，|r| <= 1，
+    // 分母|1 + r*e| >= 1 - |e| > 0，厚的高导层e下溢为0，Z_i = Z_0i，不会出现inf/NaN。
+    // 令t = -2*Re(k_i*d_i)，则e = exp(t) * (cos(t) + i*sin(t))。
     for (int i = M - 2; i >= 0; i--) {
-        // 检查数组边界和参数有效性
-        if (i < 0 || i >= static_cast<int>(sigma.size()) || i >= static_cast<int>(dz.size()) || 
-            sigma[i] <= 0.0 || dz[i] <= 0.0) {
-            continue;  // 跳过无效层
-        }
-        
-        // 第i层的特征阻抗：Z_0i = sqrt(iωμ₀/σ_i) = (1+i) * sqrt(ωμ₀/(2σ_i))
-        double denom_i = 2.0 * sigma[i];
-        if (denom_i <= 0.0 || !std::isfinite(denom_i)) {
-            continue;  // 跳过无效层
+        // 跳过无效层（每层判断一次，与频率无关）
+        if (i >= static_cast<int>(dz.size()) || !(sigma[i] > 0.0) || !std::isfinite(sigma[i]) ||
+            !(dz[i] > 0.0) || !std::isfinite(dz[i])) {
+            continue;
         }
-        double sqrt_wmu0_2sigma_i = sqrt(w * MU0 / denom_i);
-        if (!std::isfinite(sqrt_wmu0_2sigma_i)) {
-            sqrt_wmu0_2sigma_i = 1e-10;
+        const double sqrtHalfRho = sqrt(0.5 / sigma[i]);
+        const double minus2dSqrtHalfSigma = -2.0 * dz[i] * sqrt(0.5 * sigma[i]);
+        for (int f = 0; f < nFreq; f++) {
+            a[f] = sqrtWmu[f] * sqrtHalfRho;
+            t[f] = sqrtWmu[f] * minus2dSqrtHalfSigma;
         }
-        MKL_Complex16 Z0_i;
-        Z0_i.real = sqrt_wmu0_2sigma_i;
-        Z0_i.imag = sqrt_wmu0_2sigma_i;
-        
-        // 第i层的波数：k_i = sqrt(iωμ₀σ_i) = (1+i) * sqrt(ωμ₀σ_i/2)
-        double sqrt_wmu0_sigma_2 = sqrt(w * MU0 * sigma[i] / 2.0);
-        if (!std::isfinite(sqrt_wmu0_sigma_2)) {
-            sqrt_wmu0_sigma_2 = 1e-10;
-        }
-        MKL_Complex16 k_i;
-        k_i.real = sqrt_wmu0_sigma_2;
-        k_i.imag = sqrt_wmu0_sigma_2;
-        
-        // 计算 k_i * d_i
-        double d_i = dz[i];
-        if (!std::isfinite(d_i) || d_i <= 0.0) {
-            continue;  // 跳过无效层
-        }
-        MKL_Complex16 kd;
-        kd.real = k_i.real * d_i;
-        kd.imag = k_i.imag * d_i;
-        
-        // 使用递推公式：Z_i = Z_0i * (Z_{i+1} + Z_0i * tanh(k_i * d_i)) / (Z_0i + Z_{i+1} * tanh(k_i * d_i))
-        // 首先计算 tanh(k_i * d_i)
-        double exp_real = exp(kd.real);
-        double exp_minus_real = 1.0 / exp_real;
-        double cos_imag = cos(kd.imag);
-        double sin_imag = sin(kd.imag);
-        
-        MKL_Complex16 exp_kd, exp_minus_kd;
-        exp_kd.real = exp_real * cos_imag;
-        exp_kd.imag = exp_real * sin_imag;
-        exp_minus_kd.real = exp_minus_real * cos_imag;
-        exp_minus_kd.imag = -exp_minus_real * sin_imag;
-        
-        MKL_Complex16 sinh_kd, cosh_kd;
-        sinh_kd.real = 0.5 * (exp_kd.real - exp_minus_kd.real);
-        sinh_kd.imag = 0.5 * (exp_kd.imag - exp_minus_kd.imag);
-        cosh_kd.real = 0.5 * (exp_kd.real + exp_minus_kd.real);
-        cosh_kd.imag = 0.5 * (exp_kd.imag + exp_minus_kd.imag);
-        
-        double cosh_mag2 = cosh_kd.real * cosh_kd.real + cosh_kd.imag * cosh_kd.imag;
-        MKL_Complex16 tanh_kd;
-        if (cosh_mag2 > 1e-20) {
-            tanh_kd.real = (sinh_kd.real * cosh_kd.real + sinh_kd.imag * cosh_kd.imag) / cosh_mag2;
-            tanh_kd.imag = (sinh_kd.imag * cosh_kd.real - sinh_kd.real * cosh_kd.imag) / cosh_mag2;
-        } else {
-            tanh_kd.real = 1.0;
-            tanh_kd.imag = 0.0;
-        }
-        
-        // 计算 Z_0i * tanh(k_i * d_i)
-        MKL_Complex16 Z0_tanh;
-        Z0_tanh.real = Z0_i.real * tanh_kd.real - Z0_i.imag * tanh_kd.imag;
-        Z0_tanh.imag = Z0_i.real * tanh_kd.imag + Z0_i.imag * tanh_kd.real;
-        
-        // 计算 Z_{i+1} + Z_0i * tanh(k_i * d_i)
-        MKL_Complex16 numerator;
-        numerator.real = Z_current.real + Z0_tanh.real;
-        numerator.imag = Z_current.imag + Z0_tanh.imag;
-        
-        // 计算 Z_0i + Z_{i+1} * tanh(k_i * d_i)
-        MKL_Complex16 Z_current_tanh;
-        Z_current_tanh.real = Z_current.real * tanh_kd.real - Z_current.imag * tanh_kd.imag;
-        Z_current_tanh.imag = Z_current.real * tanh_kd.imag + Z_current.imag * tanh_kd.real;
-        
-        MKL_Complex16 denominator;
-        denominator.real = Z0_i.real + Z_current_tanh.real;
-        denominator.imag = Z0_i.imag + Z_current_tanh.imag;
-        
-        // 计算 Z_i = Z_0i * numerator / denominator
-        double denom_mag2 = denominator.real * denominator.real + denominator.imag * denominator.imag;
-        MKL_Complex16 ratio;
-        if (denom_mag2 > 1e-20) {
-            ratio.real = (numerator.real * denominator.real + numerator.imag * denominator.imag) / denom_mag2;
-            ratio.imag = (numerator.imag * denominator.real - numerator.real * denominator.imag) / denom_mag2;
-        } else {
-            ratio.real = 1.0;
-            ratio.imag = 0.0;
+        vdExp(nFreq, t.data(), decay.data());
+        vdSinCos(nFreq, t.data(), s.data(), c.data());
+
+        for (int f = 0; f < nFreq; f++) {
+            const double er = decay[f] * c[f];
+            const double ei = decay[f] * s[f];
+            // n = Z_0i - Z_{i+1}，p = Z_0i + Z_{i+1}，r = n / p
+            const double nr = a[f] - zr[f];
+            const double ni = a[f] - zi[f];
+            const double pr = a[f] + zr[f];
+            const double pi = a[f] + zi[f];
+            // q = n * e
+            const double qr = nr * er - ni * ei;
+            const double qi = nr * ei + ni * er;
+            // (1 - r*e) / (1 + r*e) = (p - q) / (p + q)
+            const double numr = pr - qr;
+            const double numi = pi - qi;
+            const double denr = pr + qr;
+            const double deni = pi + qi;
+            const double invDen = 1.0 / (denr * denr + deni * deni);
+            const double ratior = (numr * denr + numi * deni) * invDen;
+            const double ratioi = (numi * denr - numr * deni) * invDen;
+            // Z_i = (1+i)*a * ratio
+            zr[f] = a[f] * (ratior - ratioi);
+            zi[f] = a[f] * (ratior + ratioi);
         }
-        
-        Z_current.real = Z0_i.real * ratio.real - Z0_i.imag * ratio.imag;
-        Z_current.imag = Z0_i.real * ratio.imag + Z0_i.imag * ratio.real;
     }
-    
+
     // 返回地表阻抗
-    Z_surface = Z_current;
+    for (int f = 0; f < nFreq; f++) {
+        const bool valid = omega[f] > 0.0 && std::isfinite(omega[f]);
+        Z[f].real = valid ? zr[f] : 1e-10;
+        Z[f].imag = valid ? zi[f] : 1e-10;
+    }
 }
 
 } // namespace MT
@@ -14,19 +14,19 @@ namespace MT {
 class ForwardSolver {
 public:
     ForwardSolver();
-    ~ForwardSolver();
+    virtual ~ForwardSolver();
 
     /**
-     * 执行正演计算
+     * 执行正演计算（由computeImpedance()的阻抗换算；派生类可重写以提供其他正演后端）
      * @param mLogRho 模型参数（log10(ρ)）
      * @param omega 角频率数组
      * @param layerThicknesses 层厚度数组
      * @param dataOut 输出的MT响应数据（log10(ρ_a)和相位）
      */
-    void solve(const std::vector<double>& mLogRho,
-               const std::vector<double>& omega,
-               const std::vector<double>& layerThicknesses,
-               std::vector<double>& dataOut);
+    virtual void solve(const std::vector<double>& mLogRho,
+                       const std::vector<double>& omega,
+                       const std::vector<double>& layerThicknesses,
+                       std::vector<double>& dataOut);
 
     /**
      * 执行正演计算（使用模型参数结构）
@@ -38,7 +38,72 @@ public:
                const std::vector<double>& omega,
                std::vector<double>& dataOut);
 
+    /**
+     * 批量正演多个模型（层厚度和频率相同，如Occam搜索中不同λ的候选模型）
+     * 默认逐个调用solve()，派生类可重写以共享各模型间的公共计算
+     * @param models 模型参数数组（每个为log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param dataOut 输出的MT响应数据（与models一一对应）
+     */
+    virtual void solveBatch(const std::vector<std::vector<double>>& models,
+                            const std::vector<double>& omega,
+                            const std::vector<double>& layerThicknesses,
+                            std::vector<std::vector<double>>& dataOut);
+
+    /**
+     * 计算各频率的地表阻抗Z_xy（一维模型Z_yx = -Z_xy，Z_xx = Z_yy = 0）
+     * 派生类可重写以提供其他正演后端的阻抗
+     * @param mLogRho 模型参数（log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param Z 输出的地表阻抗（nFreq个）
+     */
+    virtual void computeImpedance(const std::vector<double>& mLogRho,
+                                  const std::vector<double>& omega,
+                                  const std::vector<double>& layerThicknesses,
+                                  std::vector<MKL_Complex16>& Z);
+
+    /**
+     * 执行正演计算并输出多个数据分量（所有分量由同一次阻抗计算得到）
+     * @param mLogRho 模型参数（log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param components 数据分量
+     * @param dataOut 输出数据（按分量优先存储：dataOut[c * nFreq + f]）
+     */
+    void solveComponents(const std::vector<double>& mLogRho,
+                         const std::vector<double>& omega,
+                         const std::vector<double>& layerThicknesses,
+                         const std::vector<DataComponent>& components,
+                         std::vector<double>& dataOut);
+
+    /**
+     * 由地表阻抗计算数据分量
+     * @param Z 各频率的地表阻抗Z_xy
+     * @param omega 角频率数组
+     * @param components 数据分量
+     * @param dataOut 输出数据（按分量优先存储：dataOut[c * nFreq + f]）
+     */
+    static void impedanceToComponents(const std::vector<MKL_Complex16>& Z,
+                                      const std::vector<double>& omega,
+                                      const std::vector<DataComponent>& components,
+                                      std::vector<double>& dataOut);
+
 private:
+    /**
+     * 用递推解析法计算各频率的地表阻抗（solve()和computeImpedance()共用）
+     */
+    void computeSurfaceImpedances(const std::vector<double>& mLogRho,
+                                  const std::vector<double>& omega,
+                                  const std::vector<double>& layerThicknesses,
+                                  std::vector<MKL_Complex16>& Z);
+
+    /**
+     * 由阻抗计算log10(ρ_a)，无效值取1e-10 Ω·m
+     */
+    static double logApparentResistivity(double re, double im, double w);
+
     /**
      * 计算电导率
      * @param mLogRho 模型参数（log10(ρ)）
@@ -48,17 +113,18 @@ private:
                              std::vector<double>& sigma);
 
     /**
-     * 使用向上递推阻抗的解析法计算地表阻抗
-     * @param M 模型层数
-     * @param w 角频率
-     * @param sigma 电导率数组
+     * 使用向上递推阻抗的解析法计算所有频率的地表阻抗
+     * 采用反射系数形式，只计算exp(-2kd)（模长不超过1），厚的高导层不会溢出；
+     * 内层循环沿频率方向，无数据相关分支，便于向量化
+     * @param omega 角频率数组
+     * @param sigma 电导率数组（各层）
      * @param dz 层厚度数组
-     * @param Z_surface 输出的地表阻抗
+     * @param Z 输出的地表阻抗（nFreq个）
      */
-    void computeRecursiveImpedance(int M, double w,
+    void computeRecursiveImpedance(const std::vector<double>& omega,
                                    const std::vector<double>& sigma,
                                    const std::vector<double>& dz,
-                                   MKL_Complex16& Z_surface);
+                                   std::vector<MKL_Complex16>& Z);
 };
 
 } // namespace MT
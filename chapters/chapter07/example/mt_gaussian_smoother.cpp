@@ -0,0 +1,166 @@
+#include "mt_gaussian_smoother.h"
+#include <mkl.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace MT {
+
+GaussianSmoother::GaussianSmoother(double sigma, int halfWidth, Method method)
+    : m_sigma(sigma)
+    , m_halfWidth(std::max(0, halfWidth))
+    , m_method(method)
+    , m_B(1.0), m_a1(0.0), m_a2(0.0), m_a3(0.0) {
+    if (!(sigma > 0.0)) {
+        throw std::invalid_argument("GaussianSmoother: sigma必须为正数");
+    }
+
+    // 递推公式只适用于σ >= 0.5
+    if (m_method == Method::RECURSIVE && sigma < 0.5) {
+        m_method = Method::TRUNCATED;
+    }
+
+    if (m_method == Method::TRUNCATED) {
+        // 一次性用vdExp计算所有权重
+        int width = 2 * m_halfWidth + 1;
+        std::vector<double> args(width);
+        for (int j = -m_halfWidth; j <= m_halfWidth; j++) {
+            args[j + m_halfWidth] = -(j * j) / (2.0 * sigma * sigma);
+        }
+        m_kernel.resize(width);
+        vdExp(width, args.data(), m_kernel.data());
+
+        m_prefix.assign(width + 1, 0.0);
+        for (int k = 0; k < width; k++) {
+            m_prefix[k + 1] = m_prefix[k] + m_kernel[k];
+        }
+    } else {
+        // Young & van Vliet (1995) 系数
+        double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330
+                                : 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+        double q2 = q * q;
+        double q3 = q2 * q;
+        double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+        double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+        double b2 = -(1.4281 * q2 + 1.26661 * q3);
+        double b3 = 0.422205 * q3;
+        m_a1 = b1 / b0;
+        m_a2 = b2 / b0;
+        m_a3 = b3 / b0;
+        m_B = 1.0 - (m_a1 + m_a2 + m_a3);
+    }
+}
+
+GaussianSmoother::~GaussianSmoother() {
+}
+
+void GaussianSmoother::smooth(const std::vector<double>& in, std::vector<double>& out) const {
+    out.resize(in.size());
+    smooth(in.data(), out.data(), static_cast<int>(in.size()));
+}
+
+void GaussianSmoother::smooth(const double* in, double* out, int n) const {
+    smoothBatch(in, out, n, 1);
+}
+
+void GaussianSmoother::recursiveNormalization(int n, std::vector<double>& norm) const {
+    // 零延拓下滤波全1序列，得到各点实际参与的权重和
+    std::vector<double> w(n);
+    double w1 = 0.0, w2 = 0.0, w3 = 0.0;
+    for (int i = 0; i < n; i++) {
+        double v = m_B + m_a1 * w1 + m_a2 * w2 + m_a3 * w3;
+        w[i] = v;
+        w3 = w2; w2 = w1; w1 = v;
+    }
+    norm.resize(n);
+    double y1 = 0.0, y2 = 0.0, y3 = 0.0;
+    for (int i = n - 1; i >= 0; i--) {
+        double v = m_B * w[i] + m_a1 * y1 + m_a2 * y2 + m_a3 * y3;
+        norm[i] = v;
+        y3 = y2; y2 = y1; y1 = v;
+    }
+}
+
+void GaussianSmoother::smoothBatch(const double* in, double* out, int n, int nProfiles) const {
+    if (n <= 0 || nProfiles <= 0) {
+        return;
+    }
+    const int K = nProfiles;
+
+    if (m_method == Method::TRUNCATED) {
+        const int h = m_halfWidth;
+        const double* kernel = m_kernel.data() + h;  // kernel[j], j ∈ [-h, h]
+
+        for (int i = 0; i < n; i++) {
+            int jMin = std::max(-h, -i);
+            int jMax = std::min(h, n - 1 - i);
+            double invSum = 1.0 / truncatedWeightSum(i, n);
+
+            double* y = out + static_cast<size_t>(i) * K;
+            for (int p = 0; p < K; p++) {
+                y[p] = 0.0;
+            }
+            // 内层循环沿剖面方向连续
+            for (int j = jMin; j <= jMax; j++) {
+                const double w = kernel[j];
+                const double* x = in + static_cast<size_t>(i + j) * K;
+                for (int p = 0; p < K; p++) {
+                    y[p] += w * x[p];
+                }
+            }
+            for (int p = 0; p < K; p++) {
+                y[p] *= invSum;
+            }
+        }
+        return;
+    }
+
+    // 递推：前向一遍写入out，后向一遍在out上原地完成（零延拓，再除以归一化系数）
+    std::vector<double> norm;
+    recursiveNormalization(n, norm);
+
+    const double B = m_B, a1 = m_a1, a2 = m_a2, a3 = m_a3;
+    for (int i = 0; i < n; i++) {
+        const double* x = in + static_cast<size_t>(i) * K;
+        double* w = out + static_cast<size_t>(i) * K;
+        const double* w1 = i >= 1 ? w - K : nullptr;
+        const double* w2 = i >= 2 ? w - 2 * K : nullptr;
+        const double* w3 = i >= 3 ? w - 3 * K : nullptr;
+        if (w3) {
+            for (int p = 0; p < K; p++) {
+                w[p] = B * x[p] + a1 * w1[p] + a2 * w2[p] + a3 * w3[p];
+            }
+        } else {
+            for (int p = 0; p < K; p++) {
+                w[p] = B * x[p] + (w1 ? a1 * w1[p] : 0.0) + (w2 ? a2 * w2[p] : 0.0);
+            }
+        }
+    }
+
+    // 后向递推：处理第i行时out[i]仍是前向结果，out[i+1..i+3]已是后向结果
+    for (int i = n - 1; i >= 0; i--) {
+        double* y = out + static_cast<size_t>(i) * K;
+        const double* y1 = i + 1 < n ? y + K : nullptr;
+        const double* y2 = i + 2 < n ? y + 2 * K : nullptr;
+        const double* y3 = i + 3 < n ? y + 3 * K : nullptr;
+        if (y3) {
+            for (int p = 0; p < K; p++) {
+                y[p] = B * y[p] + a1 * y1[p] + a2 * y2[p] + a3 * y3[p];
+            }
+        } else {
+            for (int p = 0; p < K; p++) {
+                y[p] = B * y[p] + (y1 ? a1 * y1[p] : 0.0) + (y2 ? a2 * y2[p] : 0.0);
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        double* y = out + static_cast<size_t>(i) * K;
+        const double invNorm = 1.0 / norm[i];
+        for (int p = 0; p < K; p++) {
+            y[p] *= invNorm;
+        }
+    }
+}
+
+} // namespace MT
@@ -0,0 +1,97 @@
+#ifndef MT_GAUSSIAN_SMOOTHER_H
+#define MT_GAUSSIAN_SMOOTHER_H
+
+#include <vector>
+
+/**
+ * MT高斯平滑模块
+ * 对一维对数电阻率剖面做归一化高斯平滑：y[i] = Σ w_j x[i+j] / Σ w_j，
+ * 只对落在剖面内的点求和（边界处权重重新归一化）
+ *
+ * - 截断核（TRUNCATED）：窗口[-halfWidth, halfWidth]内的高斯权重在构造时用vdExp一次算好，
+ *   内部点不做边界判断，边界点的权重和由前缀和直接得到，每个输出点2*halfWidth+1次乘加
+ * - 递推（RECURSIVE）：Young–van Vliet三阶IIR近似（不截断的高斯），正反两遍递推，
+ *   每个输出点约14次乘加，与σ无关；边界归一化通过同样滤波一个全1序列得到。
+ *   脉冲响应与精确高斯核的峰值相对误差为百分之几，适合σ很大（数百层）的蒙特卡洛建模
+ *
+ * 批量接口按层优先存储多个剖面：data[i * nProfiles + p]，最内层循环沿剖面方向连续，便于向量化。
+ * 对象构造后只读，可在多个线程中同时使用。
+ */
+namespace MT {
+
+class GaussianSmoother {
+public:
+    /**
+     * 平滑方法
+     */
+    enum class Method {
+        TRUNCATED,  // 预计算截断核的直接卷积
+        RECURSIVE   // Young–van Vliet递推高斯滤波
+    };
+
+    /**
+     * 构造函数
+     * @param sigma 高斯标准差（以层为单位）
+     * @param halfWidth 截断核的半宽（RECURSIVE方法忽略）
+     * @param method 平滑方法（σ < 0.5时递推公式不适用，自动使用截断核）
+     */
+    GaussianSmoother(double sigma, int halfWidth, Method method = Method::TRUNCATED);
+    ~GaussianSmoother();
+
+    /**
+     * 平滑单个剖面
+     * @param in 输入剖面（n个点）
+     * @param out 输出剖面（n个点，不能与in相同）
+     * @param n 点数
+     */
+    void smooth(const double* in, double* out, int n) const;
+
+    /**
+     * 平滑单个剖面
+     * @param in 输入剖面
+     * @param out 输出剖面（自动调整大小）
+     */
+    void smooth(const std::vector<double>& in, std::vector<double>& out) const;
+
+    /**
+     * 批量平滑多个等长剖面（层优先存储：data[i * nProfiles + p]）
+     * @param in 输入数据（n * nProfiles个点）
+     * @param out 输出数据（n * nProfiles个点，不能与in相同）
+     * @param n 每个剖面的点数
+     * @param nProfiles 剖面个数
+     */
+    void smoothBatch(const double* in, double* out, int n, int nProfiles) const;
+
+    double getSigma() const { return m_sigma; }
+    int getHalfWidth() const { return m_halfWidth; }
+    Method getMethod() const { return m_method; }
+
+private:
+    /**
+     * 计算某输出点的截断核权重和（边界处只含剖面内的点）
+     */
+    double truncatedWeightSum(int i, int n) const {
+        int jMin = i < m_halfWidth ? -i : -m_halfWidth;
+        int jMax = (n - 1 - i) < m_halfWidth ? (n - 1 - i) : m_halfWidth;
+        return m_prefix[jMax + m_halfWidth + 1] - m_prefix[jMin + m_halfWidth];
+    }
+
+    /**
+     * 递推滤波全1序列，得到各点的归一化系数
+     */
+    void recursiveNormalization(int n, std::vector<double>& norm) const;
+
+    double m_sigma;
+    int m_halfWidth;
+    Method m_method;
+
+    std::vector<double> m_kernel;   // 截断核权重（2*halfWidth+1个）
+    std::vector<double> m_prefix;   // 权重前缀和（2*halfWidth+2个）
+
+    // Young–van Vliet系数：w[n] = B*x[n] + (b1*w[n-1] + b2*w[n-2] + b3*w[n-3]) / b0
+    double m_B, m_a1, m_a2, m_a3;   // a_k = b_k / b0
+};
+
+} // namespace MT
+
+#endif // MT_GAUSSIAN_SMOOTHER_H
@@ -1,4 +1,12 @@
 #include "mt_inversion_core.h"
+#include "mt_gaussian_smoother.h"
+#include "mt_lateral_inversion.h"
+#include "mt_layer_pruner.h"
+#include "mt_component_forward_solver.h"
+#include "mt_model_parameterization.h"
+#include "mt_occam_search.h"
+#include "mt_resolution_analysis.h"
+#include "mt_trust_region_solver.h"
 #include <mkl_vsl.h>
 #include <mkl_vml.h>
 #include <cmath>
@@ -9,15 +17,75 @@
 #include <exception>
 #include <stdexcept>
 #include <limits>
+#include <memory>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+
+// 随机模型平滑：截断核半宽超过该值时改用递推高斯滤波（每点约30次乘加，与窗口无关），
+// 使大M的蒙特卡洛建模保持O(M)
+const int RECURSIVE_SMOOTHING_HALF_WIDTH = 16;
+
+MT::GaussianSmoother randomModelSmoother(double sigma, int halfWidth) {
+    return MT::GaussianSmoother(sigma, halfWidth,
+                                halfWidth > RECURSIVE_SMOOTHING_HALF_WIDTH
+                                ? MT::GaussianSmoother::Method::RECURSIVE
+                                : MT::GaussianSmoother::Method::TRUNCATED);
+}
+
+/**
+ * 信赖域引擎的迭代记录：把接受点换算为与内置循环相同的历史和回调
+ * （第k步的残差为步前模型的残差，更新范数为相邻接受点层模型之差的范数）
+ */
+struct TrustRegionProgress {
+    MTInversionCore::ProgressCallback progressCallback = nullptr;
+    void* progressUserData = nullptr;
+    MTInversionCore::ModelCallback modelCallback = nullptr;
+    void* modelUserData = nullptr;
+    const MT::ModelParameterization* parameterization = nullptr;
+    MT::InversionResult* result = nullptr;
+    std::vector<double> previousLayers;
+    double previousResidual = 0.0;
+    std::vector<double> layers;
+};
+
+void onTrustRegionIterate(int iteration, double residual, const std::vector<double>& m,
+                          const std::vector<double>& dSyn, void* userData) {
+    TrustRegionProgress* progress = static_cast<TrustRegionProgress*>(userData);
+    if (progress->parameterization) {
+        progress->parameterization->toModel(m, progress->layers);
+    } else {
+        progress->layers = m;
+    }
+    if (iteration > 0) {
+        std::vector<double> dm(progress->layers.size());
+        vdSub(static_cast<int>(dm.size()), progress->layers.data(), progress->previousLayers.data(), dm.data());
+        double dmNorm = cblas_dnrm2(static_cast<int>(dm.size()), dm.data(), 1);
+        progress->result->residualHistory.push_back(progress->previousResidual);
+        progress->result->dmNormHistory.push_back(dmNorm);
+        if (progress->progressCallback) {
+            progress->progressCallback(iteration, progress->previousResidual, dmNorm, progress->progressUserData);
+        }
+    }
+    if (progress->modelCallback) {
+        progress->modelCallback(iteration + 1, residual, progress->layers, dSyn, progress->modelUserData);
+    }
+    progress->previousLayers.swap(progress->layers);
+    progress->previousResidual = residual;
+}
+
+} // namespace
+
 MTInversionCore::MTInversionCore()
     : m_jacobianCalculator(&m_forwardSolver)
+    , m_activeForwardSolver(&m_forwardSolver)
     , m_progressCallback(nullptr)
-    , m_progressUserData(nullptr) {
+    , m_progressUserData(nullptr)
+    , m_modelCallback(nullptr)
+    , m_modelUserData(nullptr) {
 }
 
 MTInversionCore::~MTInversionCore() {
@@ -33,7 +101,7 @@ void MTInversionCore::forwardFDM(const std::vector<double>& mLogRho,
                                 const std::vector<double>& omega,
                                 const std::vector<double>& layerThicknesses,
                                 std::vector<double>& dataOut) {
-    m_forwardSolver.solve(mLogRho, omega, layerThicknesses, dataOut);
+    m_fdForwardSolver.solve(mLogRho, omega, layerThicknesses, dataOut);
 }
 
 void MTInversionCore::computeJacobian(const std::vector<double>& m,
@@ -45,94 +113,217 @@ void MTInversionCore::computeJacobian(const std::vector<double>& m,
     m_jacobianCalculator.compute(m, omega, dSyn, layerThicknesses, epsilon, J);
 }
 
-MTInversionCore::InversionResult MTInversionCore::invert(const InversionParams& params) {
-    InversionResult result;
+void MTInversionCore::prepareInversion(const InversionParams& params, InversionResult& result) {
+    int M = params.M;
+    int nFreq = params.nFreq;
+    int nComponents = params.components.empty() ? 2 : static_cast<int>(params.components.size());
+    int nData = nFreq * nComponents;
+    result.components = params.components;
+
+    // 1. 生成或使用提供的频率数组
+    if (!params.periods.empty() && !params.omega.empty() && 
+        params.periods.size() == nFreq && params.omega.size() == nFreq) {
+        result.periods = params.periods;
+        result.omega = params.omega;
+    } else {
+        m_frequencyGenerator.generate(nFreq, result.periods, result.omega);
+    }
 
-    try {
-        int M = params.M;
-        int nFreq = params.nFreq;
-        int nData = nFreq * 2;
-
-        // 1. 生成或使用提供的频率数组
-        if (!params.periods.empty() && !params.omega.empty() && 
-            params.periods.size() == nFreq && params.omega.size() == nFreq) {
-            result.periods = params.periods;
-            result.omega = params.omega;
-        } else {
-            m_frequencyGenerator.generate(nFreq, result.periods, result.omega);
-        }
+    // 2. 计算或使用提供的层厚度
+    if (!params.layerThicknesses.empty() && !params.layerDepths.empty() &&
+        params.layerThicknesses.size() == M && params.layerDepths.size() == M) {
+        result.layerThicknesses = params.layerThicknesses;
+        result.layerDepths = params.layerDepths;
+    } else {
+        computeLayerThicknesses(M, params.firstLayerThickness, params.thicknessGrowth,
+                                result.layerThicknesses, result.layerDepths);
+    }
 
-        // 2. 计算或使用提供的层厚度
-        if (!params.layerThicknesses.empty() && !params.layerDepths.empty() &&
-            params.layerThicknesses.size() == M && params.layerDepths.size() == M) {
-            result.layerThicknesses = params.layerThicknesses;
-            result.layerDepths = params.layerDepths;
-        } else {
-            computeLayerThicknesses(M, params.firstLayerThickness, params.thicknessGrowth,
-                                    result.layerThicknesses, result.layerDepths);
+    // 3. 设置真实模型：如果提供了观测数据，使用提供的数据（野外测站没有真实模型）；否则使用默认模型
+    if (!params.dObs.empty() && params.dObs.size() == nData) {
+        // 使用提供的观测数据
+        result.dObs = params.dObs;
+        // 验证频率数组是否匹配
+        if (params.periods.size() != nFreq || params.omega.size() != nFreq) {
+            throw std::runtime_error("提供的频率数组大小与nFreq不匹配");
         }
-
-        // 3. 设置真实模型：如果提供了观测数据，使用提供的真实模型；否则使用默认模型
-        if (!params.dObs.empty() && params.dObs.size() == nData && 
-            !params.mTrue.empty() && params.mTrue.size() == M) {
-            // 使用提供的观测数据和真实模型
+        if (!params.mTrue.empty() && params.mTrue.size() == M) {
+            // 合成数据：真实模型必须与层厚度数组一致
             result.mTrue = params.mTrue;
-            result.dObs = params.dObs;
-            // 验证频率数组和层厚度数组是否匹配
-            if (params.periods.size() != nFreq || params.omega.size() != nFreq) {
-                throw std::runtime_error("提供的频率数组大小与nFreq不匹配");
-            }
             if (params.layerThicknesses.size() != M || params.layerDepths.size() != M) {
                 throw std::runtime_error("提供的层厚度数组大小与M不匹配");
             }
-        } else {
-            // 使用默认的真实模型
-            result.mTrue.resize(M);
-            int nLayers1 = std::min(5, M / 4);
-            int nLayers2 = std::min(10, M / 2);
-            
-            for (int i = 0; i < nLayers1; i++) {
-                result.mTrue[i] = log10(100.0);  // 前几层：100 Ω·m
-            }
-            for (int i = nLayers1; i < nLayers1 + nLayers2 && i < M; i++) {
-                result.mTrue[i] = log10(10.0);   // 中间层：10 Ω·m
-            }
-            for (int i = nLayers1 + nLayers2; i < M; i++) {
-                result.mTrue[i] = log10(1000.0);  // 最后层：1000 Ω·m
-            }
+        }
+    } else {
+        // 使用默认的真实模型
+        result.mTrue.resize(M);
+        int nLayers1 = std::min(5, M / 4);
+        int nLayers2 = std::min(10, M / 2);
+        
+        for (int i = 0; i < nLayers1; i++) {
+            result.mTrue[i] = log10(100.0);  // 前几层：100 Ω·m
+        }
+        for (int i = nLayers1; i < nLayers1 + nLayers2 && i < M; i++) {
+            result.mTrue[i] = log10(10.0);   // 中间层：10 Ω·m
+        }
+        for (int i = nLayers1 + nLayers2; i < M; i++) {
+            result.mTrue[i] = log10(1000.0);  // 最后层：1000 Ω·m
+        }
 
-            // 4. 生成合成观测数据（加2%高斯噪声）
+        // 4. 生成合成观测数据（加高斯噪声，噪声流由种子和测站ID决定，与线程调度无关）
+        //    合成数据始终使用内置的递推解析法，不受正演后端切换影响
+        if (params.components.empty()) {
             m_forwardSolver.solve(result.mTrue, result.omega, result.layerThicknesses, result.dObs);
-            srand(12345);
-            for (int i = 0; i < nData; i++) {
-                double noiseLevel = 0.02;  // 2%
-                double noise = gaussianRandom(0.0, noiseLevel * fabs(result.dObs[i]));
-                result.dObs[i] += noise;
-            }
+        } else {
+            m_forwardSolver.solveComponents(result.mTrue, result.omega, result.layerThicknesses,
+                                            params.components, result.dObs);
         }
+        MT::NoiseGenerator noiseGenerator(params.noiseSeed);
+        noiseGenerator.addRelativeNoise(params.stationId, params.noiseLevel, result.dObs);
+    }
 
-        // 5. 设置初始模型
-        result.mInit.resize(M);
-        std::vector<double> mCurrent(M);
-        for (int i = 0; i < M; i++) {
-            result.mInit[i] = log10(100.0);  // 均匀模型：100 Ω·m
-            mCurrent[i] = result.mInit[i];
+    // 5. 设置初始模型
+    result.mInit.resize(M);
+    for (int i = 0; i < M; i++) {
+        result.mInit[i] = log10(100.0);  // 均匀模型：100 Ω·m
+    }
+}
+
+MTInversionCore::InversionResult MTInversionCore::invert(const InversionParams& params) {
+    InversionResult result;
+    result.stationId = params.stationId;
+
+    // 多分量数据：正演输出换成按分量优先存储的分量数组，Jacobian和残差计算不变
+    std::unique_ptr<MT::ComponentForwardSolver> componentSolver;
+    // 降维参数化：在系数空间中反演，正演适配器把系数映射为层模型
+    std::unique_ptr<MT::ModelParameterization> parameterization;
+    std::unique_ptr<MT::ParameterizedForwardSolver> parameterizedSolver;
+    MT::ForwardSolver* forwardSolver = m_activeForwardSolver;
+
+    try {
+        int M = params.M;
+        int nComponents = params.components.empty() ? 2 : static_cast<int>(params.components.size());
+        int nData = params.nFreq * nComponents;
+
+        if (!params.components.empty()) {
+            componentSolver.reset(new MT::ComponentForwardSolver(m_activeForwardSolver, params.components));
+            forwardSolver = componentSolver.get();
+            m_jacobianCalculator.setForwardSolver(forwardSolver);
         }
 
-        // 6. 构建正则化矩阵L和L^T*L
+        // 1-5. 准备频率、层厚度、观测数据和初始模型
+        prepareInversion(params, result);
+        std::vector<double> mCurrent = result.mInit;
+
+        // 降维参数化：mCurrent为nParams维系数，初始模型取其在基函数空间中的投影
+        int nParams = M;
+        if (params.modelBasis != MT::ModelBasis::LAYERS) {
+            if (params.adaptivePruning) {
+                throw std::runtime_error("降维参数化不支持自适应层裁剪");
+            }
+            parameterization.reset(new MT::ModelParameterization());
+            bool success = params.modelBasis == MT::ModelBasis::BSPLINE
+                           ? parameterization->setupBSpline(result.layerDepths, result.layerThicknesses,
+                                                            params.nBasis)
+                           : parameterization->setupPCA(params.priorModels, params.nBasis);
+            if (!success || parameterization->getLayerCount() != M
+                || !parameterization->project(result.mInit, mCurrent)) {
+                throw std::runtime_error("模型参数化失败（检查基函数个数和先验模型样本）");
+            }
+            parameterization->toModel(mCurrent, result.mInit);
+            parameterizedSolver.reset(new MT::ParameterizedForwardSolver(forwardSolver, parameterization.get()));
+            forwardSolver = parameterizedSolver.get();
+            m_jacobianCalculator.setForwardSolver(forwardSolver);
+            nParams = parameterization->getParameterCount();
+        }
+        const std::vector<double> mStart = mCurrent;
+        std::vector<double> mLayers;  // 系数映射得到的层模型（降维参数化时）
+
+        // 6. 构建正则化矩阵L和L^T*L（降维参数化时变换为B^T*L^T*L*B）
         std::vector<std::vector<double>> L;
         m_regularization.buildLMatrix(M, L);
         std::vector<std::vector<double>> LTL;
         m_regularization.computeLTL(L, LTL);
+        if (parameterization) {
+            std::vector<std::vector<double>> reducedLTL;
+            parameterization->reduceMatrix(LTL, reducedLTL);
+            LTL.swap(reducedLTL);
+        }
 
         // 7. 反演循环
         result.residualHistory.clear();
         result.dmNormHistory.clear();
+        result.activeLayerHistory.clear();
+        result.lambdaHistory.clear();
+        MT::LayerPruner pruner(params.pruneThreshold, params.pruneRecheckInterval);
+        pruner.setMode(params.pruneMergeLayers ? MT::LayerPruner::Mode::MERGE
+                                               : MT::LayerPruner::Mode::FREEZE);
+
+        // Occam反演：每次迭代只算一次Jacobian和一次分解，λ搜索只需候选模型的正演
+        MT::OccamSearch occam;
+        double targetMisfit = 0.0;
+        if (params.occam) {
+            occam.setLambdaRange(params.occamLambdaMin, params.occamLambdaMax);
+            targetMisfit = params.targetMisfit > 0.0
+                           ? params.targetMisfit
+                           : MT::OccamSearch::expectedNoiseNorm(result.dObs, params.noiseLevel);
+        }
+        std::vector<double> dSynNext;  // Occam搜索已算出的更新后模型的合成数据
+        // 层合并：Jacobian按块扰动，L^T*L每次迭代按当前块合并（LTLSolve指向求解用的矩阵）
+        m_jacobianCalculator.setMergeFrozenLayers(params.adaptivePruning && params.pruneMergeLayers);
+        std::vector<std::vector<double>> LTLMerged;
+        const std::vector<std::vector<double>>* LTLSolve = &LTL;
+        bool occamReached = false;     // 本次迭代是否达到目标拟合差
+        double lastRoughness = -1.0;   // 上一次达到目标时的模型粗糙度m^T*L^T*L*m
+
+        // 信赖域引擎：MKL dtrnlsp完成整个迭代（数据残差与λ^(1/2)*L*m堆叠），不进入内置循环
+        const bool trustRegion = params.engine == MT::InversionEngine::TRUST_REGION;
+        if (trustRegion) {
+            if (params.occam || params.adaptivePruning) {
+                throw std::runtime_error("信赖域引擎不支持Occam反演和自适应层裁剪");
+            }
+            // 降维参数化时正则化算子为L*B（作用于系数；PCA时约束的是相对先验均值的粗糙度）
+            std::vector<std::vector<double>> R;
+            if (parameterization) {
+                const std::vector<double>& B = parameterization->getBasis();
+                R.assign(L.size(), std::vector<double>(nParams, 0.0));
+                for (size_t i = 0; i < L.size(); i++) {
+                    cblas_dgemv(CblasRowMajor, CblasTrans, M, nParams, 1.0, B.data(), nParams,
+                                L[i].data(), 1, 0.0, R[i].data(), 1);
+                }
+            } else {
+                R = L;
+            }
+            TrustRegionProgress progress;
+            progress.progressCallback = m_progressCallback;
+            progress.progressUserData = m_progressUserData;
+            progress.modelCallback = m_modelCallback;
+            progress.modelUserData = m_modelUserData;
+            progress.parameterization = parameterization.get();
+            progress.result = &result;
+
+            MT::TrustRegionSolver solver(forwardSolver, &m_jacobianCalculator);
+            solver.setJacobianSource(params.trustRegionJacobian);
+            solver.setIterationLimits(params.maxIter, 100);
+            solver.setTolerances(params.tolDm, 1e-10);
+            solver.setIterationCallback(onTrustRegionIterate, &progress);
+            MT::TrustRegionReport report;
+            std::string solverError;
+            if (!solver.solve(result.omega, result.layerThicknesses, result.dObs, R, params.lambda,
+                              params.epsilon, mCurrent, report, solverError)) {
+                throw std::runtime_error("信赖域求解失败: " + solverError);
+            }
+            result.nIterations = report.nIterations;
+        }
 
-        for (int iter = 0; iter < params.maxIter; iter++) {
-            // 7.1 正演计算合成数据
+        for (int iter = 0; !trustRegion && iter < params.maxIter; iter++) {
+            // 7.1 正演计算合成数据（Occam搜索已算出时直接使用）
             std::vector<double> dSyn;
-            m_forwardSolver.solve(mCurrent, result.omega, result.layerThicknesses, dSyn);
+            if (!dSynNext.empty()) {
+                dSyn.swap(dSynNext);
+            } else {
+                forwardSolver->solve(mCurrent, result.omega, result.layerThicknesses, dSyn);
+            }
 
             // 7.2 计算残差
             std::vector<double> r(nData);
@@ -152,10 +343,40 @@ MTInversionCore::InversionResult MTInversionCore::invert(const InversionParams&
             }
             result.residualHistory.push_back(residualNorm);
 
-            // 7.3 计算Jacobian矩阵
+            // 发布当前模型快照（模型与合成数据一一对应）
+            if (m_modelCallback) {
+                if (parameterization) {
+                    parameterization->toModel(mCurrent, mLayers);
+                    m_modelCallback(iter + 1, residualNorm, mLayers, dSyn, m_modelUserData);
+                } else {
+                    m_modelCallback(iter + 1, residualNorm, mCurrent, dSyn, m_modelUserData);
+                }
+            }
+
+            // 7.3 计算Jacobian矩阵（自适应裁剪时定期用完整Jacobian重新确定活动层）
             std::vector<std::vector<double>> J;
-            m_jacobianCalculator.compute(mCurrent, result.omega, dSyn, 
-                                        result.layerThicknesses, params.epsilon, J);
+            if (params.adaptivePruning && pruner.needsRecheck(iter)) {
+                m_jacobianCalculator.setActiveLayers(std::vector<bool>());
+                m_jacobianCalculator.compute(mCurrent, result.omega, dSyn,
+                                            result.layerThicknesses, params.epsilon, J);
+                pruner.update(mCurrent, result.omega, result.layerThicknesses, J);
+                m_jacobianCalculator.setActiveLayers(pruner.getActiveLayers());
+                m_optimizer.setActiveParameters(pruner.getActiveLayers());
+            } else {
+                m_jacobianCalculator.compute(mCurrent, result.omega, dSyn,
+                                            result.layerThicknesses, params.epsilon, J);
+            }
+            if (params.adaptivePruning) {
+                result.activeLayerHistory.push_back(pruner.getActiveCount());
+            }
+            LTLSolve = &LTL;
+            if (params.adaptivePruning && pruner.isMerging()) {
+                // 最深活动层与其下的冻结层作为一个参数：J*P、P^T*L^T*L*P
+                pruner.mergeJacobian(J);
+                LTLMerged = LTL;
+                pruner.mergeMatrix(LTLMerged);
+                LTLSolve = &LTLMerged;
+            }
 
             // 7.4 计算J^T*J和J^T*r
             std::vector<std::vector<double>> JTJ;
@@ -163,23 +384,57 @@ MTInversionCore::InversionResult MTInversionCore::invert(const InversionParams&
             std::vector<double> JTr;
             m_optimizer.computeJTr(J, r, JTr);
 
-            // 7.5 求解正规方程
+            // 7.5 求解正规方程（Occam模式下搜索λ，取达到目标拟合差的最光滑模型）
             std::vector<double> dm;
-            bool success = m_optimizer.solve(JTJ, LTL, params.lambda, JTr, dm);
-            if (!success) {
-                result.errorMessage = "优化求解器失败";
-                break;
+            if (params.occam) {
+                MT::OccamStep step;
+                std::vector<double> roughnessGradient;
+                if (LTLSolve != &LTL) {
+                    roughnessGradient.resize(nParams);
+                    for (int i = 0; i < nParams; i++) {
+                        roughnessGradient[i] = cblas_ddot(nParams, LTL[i].data(), 1, mCurrent.data(), 1);
+                    }
+                    pruner.mergeVector(roughnessGradient);
+                }
+                bool success = occam.factorize(JTJ, *LTLSolve, JTr, mCurrent,
+                                               params.adaptivePruning ? pruner.getActiveLayers()
+                                                                      : std::vector<bool>(),
+                                               roughnessGradient)
+                               && occam.search(forwardSolver, mCurrent, result.omega,
+                                               result.layerThicknesses, result.dObs, targetMisfit,
+                                               params.adaptivePruning ? &pruner : nullptr, step);
+                if (!success) {
+                    result.errorMessage = "Occam λ搜索失败";
+                    break;
+                }
+                dm.swap(step.dm);
+                dSynNext.swap(step.dSyn);
+                occamReached = step.targetReached;
+                result.lambdaHistory.push_back(step.lambda);
+            } else {
+                bool success = m_optimizer.solve(JTJ, *LTLSolve, params.lambda, JTr, dm);
+                if (!success) {
+                    result.errorMessage = "优化求解器失败";
+                    break;
+                }
+                pruner.applyMerge(dm);
             }
 
-            // 7.6 计算模型更新范数
+            // 7.6 计算模型更新范数（降维参数化时取层模型的更新范数||B*dp||）
             // 使用cblas_dnrm2计算dm的范数
-            for (int i = 0; i < M; i++) {
+            for (int i = 0; i < nParams; i++) {
                 // 检查NaN和Inf
                 if (!std::isfinite(dm[i])) {
                     dm[i] = 0.0;
                 }
             }
-            double dmNorm = cblas_dnrm2(M, dm.data(), 1);
+            double dmNorm;
+            if (parameterization) {
+                parameterization->toModel(dm, mLayers);
+                dmNorm = cblas_dnrm2(M, mLayers.data(), 1);
+            } else {
+                dmNorm = cblas_dnrm2(M, dm.data(), 1);
+            }
             // 检查结果
             if (!std::isfinite(dmNorm)) {
                 dmNorm = 0.0;
@@ -192,11 +447,12 @@ MTInversionCore::InversionResult MTInversionCore::invert(const InversionParams&
             }
 
             // 7.7 更新模型
-            for (int i = 0; i < M; i++) {
+            for (int i = 0; i < nParams; i++) {
                 mCurrent[i] += dm[i];
                 // 检查更新后的值是否有效
                 if (!std::isfinite(mCurrent[i])) {
-                    mCurrent[i] = result.mInit[i];  // 如果无效，恢复初始值
+                    mCurrent[i] = mStart[i];  // 如果无效，恢复初始值
+                    dSynNext.clear();
                 }
             }
 
@@ -206,12 +462,63 @@ MTInversionCore::InversionResult MTInversionCore::invert(const InversionParams&
                 break;
             }
 
+            // Occam：达到目标拟合差后，模型粗糙度变化小于1%时收敛
+            if (params.occam) {
+                if (occamReached) {
+                    double roughness = 0.0;
+                    for (int i = 0; i < nParams; i++) {
+                        roughness += mCurrent[i] * cblas_ddot(nParams, LTL[i].data(), 1, mCurrent.data(), 1);
+                    }
+                    if (lastRoughness >= 0.0 && fabs(roughness - lastRoughness) <= 0.01 * lastRoughness) {
+                        result.nIterations = iter + 1;
+                        break;
+                    }
+                    lastRoughness = roughness;
+                } else {
+                    lastRoughness = -1.0;
+                }
+            }
+
             result.nIterations = iter + 1;
         }
 
-        // 8. 保存最终结果
-        result.mFinal = mCurrent;
-        m_forwardSolver.solve(result.mFinal, result.omega, result.layerThicknesses, result.dSyn);
+        // 8. 保存最终结果（mCurrent之后不再使用）
+        if (!dSynNext.empty()) {
+            result.dSyn.swap(dSynNext);
+        } else {
+            forwardSolver->solve(mCurrent, result.omega, result.layerThicknesses, result.dSyn);
+        }
+        if (parameterization) {
+            parameterization->toModel(mCurrent, result.mFinal);
+        } else {
+            result.mFinal.swap(mCurrent);
+        }
+
+        // 9. 反演后分析：复用最后一次迭代的分解，只求A^-1在L^T*L带宽内的元素
+        //    （降维参数化时分解在系数空间中，不给出逐层的分辨率；信赖域引擎不保留分解）
+        if (params.computeResolution && result.nIterations > 0 && !parameterization && !trustRegion) {
+            int bandwidth = MT::ResolutionAnalysis::bandwidth(LTL);
+            std::vector<double> inverseBand;
+            bool haveInverse = false;
+            double lambda = params.lambda;
+            if (params.occam) {
+                if (!result.lambdaHistory.empty()) {
+                    lambda = result.lambdaHistory.back();
+                    haveInverse = occam.selectedInverse(lambda, bandwidth, inverseBand);
+                }
+            } else if (m_optimizer.hasFactorization()) {
+                haveInverse = m_optimizer.selectedInverse(bandwidth, inverseBand);
+            }
+            if (haveInverse) {
+                MT::ResolutionAnalysis analysis(params.doiThreshold);
+                analysis.compute(inverseBand, bandwidth, *LTLSolve, lambda,
+                                 params.adaptivePruning ? pruner.getActiveLayers() : std::vector<bool>(),
+                                 MT::OccamSearch::residualNorm(result.dObs, result.dSyn), nData,
+                                 result.resolutionDiag, result.posteriorStd);
+                result.doi = analysis.estimateDOI(result.resolutionDiag, result.layerDepths,
+                                                  result.layerThicknesses);
+            }
+        }
         result.success = true;
 
     } catch (const std::exception& e) {
@@ -219,9 +526,103 @@ MTInversionCore::InversionResult MTInversionCore::invert(const InversionParams&
         result.success = false;
     }
 
+    // 恢复所有层活动和正演后端，避免影响下一次反演
+    if (params.adaptivePruning) {
+        m_jacobianCalculator.setActiveLayers(std::vector<bool>());
+        m_jacobianCalculator.setMergeFrozenLayers(false);
+        m_optimizer.setActiveParameters(std::vector<bool>());
+    }
+    if (componentSolver || parameterizedSolver) {
+        m_jacobianCalculator.setForwardSolver(m_activeForwardSolver);
+    }
+
     return result;
 }
 
+MTInversionCore::SharedInversionResult MTInversionCore::invertShared(const InversionParams& params) {
+    return std::make_shared<const InversionResult>(invert(params));
+}
+
+std::vector<MTInversionCore::InversionResult> MTInversionCore::invertProfile(
+    const std::vector<InversionParams>& stations, double lateralLambda) {
+    std::vector<InversionResult> results(stations.size());
+    if (stations.empty()) {
+        return results;
+    }
+
+    std::string errorMessage;
+    std::unique_ptr<MT::ComponentForwardSolver> componentSolver;
+    MT::ForwardSolver* forwardSolver = m_activeForwardSolver;
+    try {
+        // 1. 逐站准备频率、层厚度、观测数据和初始模型
+        int M = stations[0].M;
+        for (size_t k = 0; k < stations.size(); k++) {
+            results[k].stationId = stations[k].stationId;
+            if (stations[k].M != M) {
+                throw std::runtime_error("横向约束反演要求所有测站使用相同的层数");
+            }
+            if (stations[k].components != stations[0].components) {
+                throw std::runtime_error("横向约束反演要求所有测站使用相同的数据分量");
+            }
+            if (stations[k].modelBasis != MT::ModelBasis::LAYERS) {
+                throw std::runtime_error("横向约束反演不支持降维参数化");
+            }
+            // 联合反演只有一组设置：λ、迭代控制和Jacobian步长必须与第一个测站一致
+            if (stations[k].lambda != stations[0].lambda || stations[k].maxIter != stations[0].maxIter ||
+                stations[k].tolDm != stations[0].tolDm || stations[k].epsilon != stations[0].epsilon) {
+                throw std::runtime_error("横向约束反演要求所有测站使用相同的λ、迭代次数、收敛容差和扰动步长");
+            }
+            prepareInversion(stations[k], results[k]);
+            if (results[k].layerThicknesses != results[0].layerThicknesses) {
+                throw std::runtime_error("横向约束反演要求所有测站使用相同的层厚度");
+            }
+        }
+
+        // 多分量数据使用分量正演适配器
+        if (!stations[0].components.empty()) {
+            componentSolver.reset(new MT::ComponentForwardSolver(m_activeForwardSolver, stations[0].components));
+            forwardSolver = componentSolver.get();
+            m_jacobianCalculator.setForwardSolver(forwardSolver);
+        }
+
+        // 2. 构建垂向正则化矩阵（所有测站共用）
+        std::vector<std::vector<double>> L;
+        m_regularization.buildLMatrix(M, L);
+        std::vector<std::vector<double>> LTL;
+        m_regularization.computeLTL(L, LTL);
+
+        // 3. 联合反演（反演设置取第一个测站）
+        MT::LateralInversion lateral(forwardSolver, &m_jacobianCalculator, &m_optimizer);
+        lateral.setProgressCallback(m_progressCallback, m_progressUserData);
+        if (!lateral.invert(results, LTL, stations[0], lateralLambda)) {
+            errorMessage = lateral.getErrorMessage();
+        }
+    } catch (const std::exception& e) {
+        errorMessage = std::string("异常: ") + e.what();
+    }
+    if (componentSolver) {
+        m_jacobianCalculator.setForwardSolver(m_activeForwardSolver);
+    }
+
+    if (!errorMessage.empty()) {
+        for (InversionResult& result : results) {
+            result.errorMessage = errorMessage;
+            result.success = false;
+        }
+    }
+    return results;
+}
+
+void MTInversionCore::setModelCallback(ModelCallback callback, void* userData) {
+    m_modelCallback = callback;
+    m_modelUserData = userData;
+}
+
+void MTInversionCore::setForwardSolver(MT::ForwardSolver* forwardSolver) {
+    m_activeForwardSolver = forwardSolver ? forwardSolver : &m_forwardSolver;
+    m_jacobianCalculator.setForwardSolver(m_activeForwardSolver);
+}
+
 void MTInversionCore::setProgressCallback(ProgressCallback callback, void* userData) {
     m_progressCallback = callback;
     m_progressUserData = userData;
@@ -245,11 +646,18 @@ void MTInversionCore::computeLayerThicknesses(int M, double firstThickness, doub
 
 void MTInversionCore::generateRandomModel(int M, double minRho, double maxRho, 
                                          double filterCutoff, std::vector<double>& mLogRho) {
+    generateRandomModel(M, minRho, maxRho, filterCutoff,
+                        static_cast<unsigned int>(time(nullptr)), mLogRho);
+}
+
+void MTInversionCore::generateRandomModel(int M, double minRho, double maxRho,
+                                         double filterCutoff, unsigned int seed,
+                                         std::vector<double>& mLogRho) {
     mLogRho.resize(M);
 
     // 使用MKL VSL随机数生成器生成均匀分布的随机数
     VSLStreamStatePtr stream;
-    int errcode = vslNewStream(&stream, VSL_BRNG_MT19937, static_cast<unsigned int>(time(nullptr)));
+    int errcode = vslNewStream(&stream, VSL_BRNG_MT19937, seed);
 
     std::vector<double> uniform(M);
     if (errcode == VSL_STATUS_OK) {
@@ -258,7 +666,7 @@ void MTInversionCore::generateRandomModel(int M, double minRho, double maxRho,
         vslDeleteStream(&stream);
     } else {
         // 如果MKL VSL失败，使用标准库随机数生成器作为后备
-        srand(static_cast<unsigned int>(time(nullptr)));
+        srand(seed);
         for (int i = 0; i < M; i++) {
             uniform[i] = static_cast<double>(rand()) / RAND_MAX;
         }
@@ -279,58 +687,13 @@ void MTInversionCore::generateRandomModel(int M, double minRho, double maxRho,
         if (windowSize < 3) windowSize = 3;  // 最小窗口为3
         if (windowSize > M) windowSize = M;
         
-        // 使用高斯加权而不是简单平均
-        std::vector<double> filtered(M);
+        // 高斯加权平均：第一次使用完整窗口，第二次使用较小的窗口进一步平滑
+        // （窗口较小时用预计算的截断核，开销为O(M*windowSize)；窗口较大时用递推滤波，开销为O(M)）
         double sigma = windowSize / 3.0;  // 高斯标准差
-        
-        for (int i = 0; i < M; i++) {
-            double sum = 0.0;
-            double weightSum = 0.0;
-            int halfWindow = windowSize / 2;
-            
-            for (int j = -halfWindow; j <= halfWindow; j++) {
-                int idx = i + j;
-                if (idx >= 0 && idx < M) {
-                    // 高斯权重
-                    double weight = exp(-(j * j) / (2.0 * sigma * sigma));
-                    sum += rawLogRho[idx] * weight;
-                    weightSum += weight;
-                }
-            }
-            
-            if (weightSum > 1e-10) {
-                filtered[i] = sum / weightSum;
-            } else {
-                filtered[i] = rawLogRho[i];
-            }
-        }
-        
-        // 应用第二次滤波以进一步平滑（可选）
-        std::vector<double> smoothed(M);
-        for (int i = 0; i < M; i++) {
-            double sum = 0.0;
-            double weightSum = 0.0;
-            int halfWindow = windowSize / 4;  // 第二次使用较小的窗口
-            
-            for (int j = -halfWindow; j <= halfWindow; j++) {
-                int idx = i + j;
-                if (idx >= 0 && idx < M) {
-                    // 使用VML的vdexp向量化计算权重
-                    double arg = -(j * j) / (2.0 * sigma * sigma);
-                    double weight;
-                    int n_one = 1;
-                    vdExp(n_one, &arg, &weight);
-                    sum += filtered[idx] * weight;
-                    weightSum += weight;
-                }
-            }
-            
-            if (weightSum > 1e-10) {
-                smoothed[i] = sum / weightSum;
-            } else {
-                smoothed[i] = filtered[i];
-            }
-        }
+        std::vector<double> filtered;
+        std::vector<double> smoothed;
+        randomModelSmoother(sigma, windowSize / 2).smooth(rawLogRho, filtered);
+        randomModelSmoother(sigma, windowSize / 4).smooth(filtered, smoothed);
         
         // 适度调整滤波后的数据范围，避免过度压缩或过度放大
         double smoothedMin = smoothed[0];
@@ -387,11 +750,26 @@ void MTInversionCore::generateRandomModelAndForward(int M, int nFreq,
                                                     std::vector<double>& periods,
                                                     std::vector<double>& omega,
                                                     std::vector<double>& dataOut) {
+    generateRandomModelAndForward(M, nFreq, minRho, maxRho, firstThickness, growthFactor,
+                                  filterCutoff, static_cast<unsigned int>(time(nullptr)),
+                                  mLogRho, layerThicknesses, layerDepths, periods, omega, dataOut);
+}
+
+void MTInversionCore::generateRandomModelAndForward(int M, int nFreq,
+                                                    double minRho, double maxRho,
+                                                    double firstThickness, double growthFactor,
+                                                    double filterCutoff, unsigned int seed,
+                                                    std::vector<double>& mLogRho,
+                                                    std::vector<double>& layerThicknesses,
+                                                    std::vector<double>& layerDepths,
+                                                    std::vector<double>& periods,
+                                                    std::vector<double>& omega,
+                                                    std::vector<double>& dataOut) {
     // 计算层厚度
     computeLayerThicknesses(M, firstThickness, growthFactor, layerThicknesses, layerDepths);
 
     // 生成随机模型（带滤波）
-    generateRandomModel(M, minRho, maxRho, filterCutoff, mLogRho);
+    generateRandomModel(M, minRho, maxRho, filterCutoff, seed, mLogRho);
 
     // 生成频率数组
     m_frequencyGenerator.generate(nFreq, periods, omega);
@@ -399,23 +777,3 @@ void MTInversionCore::generateRandomModelAndForward(int M, int nFreq,
     // 正演计算
     m_forwardSolver.solve(mLogRho, omega, layerThicknesses, dataOut);
 }
-
-double MTInversionCore::gaussianRandom(double mean, double stddev) {
-    static bool hasSpare = false;
-    static double spare;
-
-    if (hasSpare) {
-        hasSpare = false;
-        return mean + stddev * spare;
-    }
-
-    hasSpare = true;
-    double u1 = static_cast<double>(rand()) / RAND_MAX;
-    double u2 = static_cast<double>(rand()) / RAND_MAX;
-
-    if (u1 < 1e-10) u1 = 1e-10;
-
-    double mag = stddev * sqrt(-2.0 * log(u1));
-    spare = mag * cos(2.0 * M_PI * u2);
-    return mean + mag * sin(2.0 * M_PI * u2);
-}
@@ -4,9 +4,11 @@
 #include "mt_model.h"
 #include "mt_frequency_generator.h"
 #include "mt_forward_solver.h"
+#include "mt_fd_forward_solver.h"
 #include "mt_jacobian_calculator.h"
 #include "mt_regularization.h"
 #include "mt_optimizer.h"
+#include "mt_noise_generator.h"
 #include <vector>
 #include <string>
 
@@ -33,6 +35,9 @@ public:
     // 结构体：反演结果（保持向后兼容）
     using InversionResult = MT::InversionResult;
 
+    // 共享的只读反演结果
+    using SharedInversionResult = MT::SharedInversionResult;
+
     // 构造函数
     MTInversionCore();
     ~MTInversionCore();
@@ -40,7 +45,7 @@ public:
     // 生成频率数组（保持向后兼容）
     void generateFrequencies(std::vector<double>& periods, std::vector<double>& omega, int n);
 
-    // 1D有限差分法正演MT响应（保持向后兼容）
+    // 1D有限差分法正演MT响应（离散Helmholtz方程，与setForwardSolver()设置的正演后端无关）
     void forwardFDM(const std::vector<double>& mLogRho,
                     const std::vector<double>& omega,
                     const std::vector<double>& layerThicknesses,
@@ -57,9 +62,24 @@ public:
     // 执行反演
     InversionResult invert(const InversionParams& params);
 
+    // 执行反演并返回共享的只读结果（结果由invert()的返回值移动构造，不复制数据数组），
+    // 用于跨线程传递结果
+    SharedInversionResult invertShared(const InversionParams& params);
+
+    // 执行横向约束反演（拟二维剖面）：相邻测站通过横向平滑参数lateralLambda耦合，
+    // 所有测站的层数M、层厚度、λ、maxIter、tolDm和epsilon必须相同且逐层参数化（modelBasis为LAYERS），
+    // 否则所有结果标记为失败；lateralLambda = 0时每次迭代与逐站调用invert相同
+    // （所有测站都收敛才停止，因此各站的迭代次数取最慢的测站）
+    std::vector<InversionResult> invertProfile(const std::vector<InversionParams>& stations,
+                                               double lateralLambda);
+
     // 生成随机模型（使用MKL随机数生成器，带高频滤波）
     void generateRandomModel(int M, double minRho, double maxRho, 
                             double filterCutoff, std::vector<double>& mLogRho);
+
+    // 生成随机模型（指定随机种子，相同种子得到相同模型；并行生成多个候选模型时使用不同种子）
+    void generateRandomModel(int M, double minRho, double maxRho,
+                            double filterCutoff, unsigned int seed, std::vector<double>& mLogRho);
     
     // 计算层厚度数组
     void computeLayerThicknesses(int M, double firstThickness, double growthFactor,
@@ -77,33 +97,64 @@ public:
                                        std::vector<double>& omega,
                                        std::vector<double>& dataOut);
 
+    // 生成随机模型并正演计算响应（指定随机种子）
+    void generateRandomModelAndForward(int M, int nFreq,
+                                       double minRho, double maxRho,
+                                       double firstThickness, double growthFactor,
+                                       double filterCutoff, unsigned int seed,
+                                       std::vector<double>& mLogRho,
+                                       std::vector<double>& layerThicknesses,
+                                       std::vector<double>& layerDepths,
+                                       std::vector<double>& periods,
+                                       std::vector<double>& omega,
+                                       std::vector<double>& dataOut);
+
     // 获取进度回调函数类型
     typedef void (*ProgressCallback)(int iteration, double residual, double dmNorm, void* userData);
 
     // 设置进度回调函数
     void setProgressCallback(ProgressCallback callback, void* userData = nullptr);
 
+    // 模型快照回调函数类型：每次迭代提供当前模型及其合成数据（引用只在回调期间有效）
+    typedef void (*ModelCallback)(int iteration, double residual,
+                                  const std::vector<double>& mCurrent,
+                                  const std::vector<double>& dSyn, void* userData);
+
+    // 设置模型快照回调函数
+    void setModelCallback(ModelCallback callback, void* userData = nullptr);
+
+    // 设置正演后端（如查表正演求解器）；传入nullptr恢复内置的递推解析法
+    // 调用方负责保证求解器的生命周期长于反演核心的使用期
+    void setForwardSolver(MT::ForwardSolver* forwardSolver);
+
     // 获取各个模块的指针（用于高级定制）
-    MT::ForwardSolver* getForwardSolver() { return &m_forwardSolver; }
+    MT::ForwardSolver* getForwardSolver() { return m_activeForwardSolver; }
     MT::JacobianCalculator* getJacobianCalculator() { return &m_jacobianCalculator; }
     MT::Regularization* getRegularization() { return &m_regularization; }
     MT::Optimizer* getOptimizer() { return &m_optimizer; }
     MT::FrequencyGenerator* getFrequencyGenerator() { return &m_frequencyGenerator; }
+    MT::FiniteDifferenceForwardSolver* getFDForwardSolver() { return &m_fdForwardSolver; }
 
 private:
-    // 生成高斯随机数（用于添加噪声）
-    double gaussianRandom(double mean, double stddev);
+    // 准备反演输入：频率、层厚度、观测数据（或合成数据）和初始模型
+    void prepareInversion(const InversionParams& params, InversionResult& result);
 
     // 模块化组件
     MT::FrequencyGenerator m_frequencyGenerator;
     MT::ForwardSolver m_forwardSolver;
+    MT::FiniteDifferenceForwardSolver m_fdForwardSolver;  // forwardFDM()使用的有限差分正演
     MT::JacobianCalculator m_jacobianCalculator;
     MT::Regularization m_regularization;
     MT::Optimizer m_optimizer;
+    MT::ForwardSolver* m_activeForwardSolver;  // 当前使用的正演后端（默认指向m_forwardSolver）
 
     // 进度回调
     ProgressCallback m_progressCallback;
     void* m_progressUserData;
+
+    // 模型快照回调
+    ModelCallback m_modelCallback;
+    void* m_modelUserData;
 };
 
 #endif // MT_INVERSION_CORE_H
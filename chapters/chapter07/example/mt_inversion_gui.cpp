@@ -8,6 +8,9 @@
 #include <QColor>
 #include <QFont>
 #include <QDateTime>
+#include <QScopedValueRollback>
+#include <QRandomGenerator>
+#include <QtConcurrent/QtConcurrentMap>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QScatterSeries>
 #include <QtCharts/QValueAxis>
@@ -15,10 +18,121 @@
 #include <QtCharts/QLegend>
 #include <QtCharts/QLegendMarker>
 #include <QtCharts/QCategoryAxis>
+#include <QtCharts/QXYSeries>
 #include <cmath>
 #include <limits>
 #include <QDebug>
 
+namespace {
+
+// 清除图表中的所有series和坐标轴
+void clearChart(QChart* chart) {
+    if (!chart) {
+        return;
+    }
+    QList<QAbstractSeries*> series = chart->series();
+    for (QAbstractSeries* s : series) {
+        chart->removeSeries(s);
+        delete s;  // 显式删除series
+    }
+    QList<QAbstractAxis*> axes = chart->axes();
+    for (QAbstractAxis* axis : axes) {
+        chart->removeAxis(axis);
+        delete axis;
+    }
+}
+
+// 数据有变化时才用replace()原位替换序列的点，返回是否有变化
+bool replaceIfChanged(QXYSeries* series, const QList<QPointF>& points) {
+    if (series->points() == points) {
+        return false;
+    }
+    series->replace(points);
+    return true;
+}
+
+// 视电阻率或相位曲线在数据中的位置：第i个周期的值为data[offset + i * stride] + shift
+// 未指定分量时两者交替存储；多分量时按分量优先存储，依次取XY、行列式、YX分量（YX相位加180°），
+// 没有相应分量时返回false
+bool curveLayout(const MT::InversionResult& result, bool phase,
+                 size_t& offset, size_t& stride, double& shift) {
+    shift = 0.0;
+    if (result.components.empty()) {
+        offset = phase ? 1 : 0;
+        stride = 2;
+        return true;
+    }
+    const MT::DataComponent xy = phase ? MT::DataComponent::PHASE_XY : MT::DataComponent::LOG_RHO_XY;
+    const MT::DataComponent det = phase ? MT::DataComponent::PHASE_DET : MT::DataComponent::LOG_RHO_DET;
+    const MT::DataComponent yx = phase ? MT::DataComponent::PHASE_YX : MT::DataComponent::LOG_RHO_YX;
+    for (MT::DataComponent wanted : { xy, det, yx }) {
+        for (size_t c = 0; c < result.components.size(); c++) {
+            if (result.components[c] == wanted) {
+                offset = c * result.periods.size();
+                stride = 1;
+                shift = (phase && wanted == yx) ? 180.0 : 0.0;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 绘图区在指定方向上的像素数（控件尚未布局时按800像素估计）
+int plotPixels(const QChart* chart, Qt::Orientation orientation) {
+    QRectF area = chart->plotArea();
+    int pixels = static_cast<int>(orientation == Qt::Horizontal ? area.width() : area.height());
+    return pixels > 0 ? pixels : 800;
+}
+
+// 降采样点列：bucketOnY表示沿纵轴分桶（模型剖面的深度轴），
+// rangeMin/rangeMax为分桶轴的可见范围，对数轴在log10空间中分桶
+QList<QPointF> downsamplePoints(const QList<QPointF>& points, bool stair, bool bucketOnY,
+                                bool logBucket, bool logValue,
+                                double rangeMin, double rangeMax, int pixels) {
+    int n = points.size();
+    if (n <= 2) {
+        return points;
+    }
+    std::vector<double> u(n), v(n);
+    for (int i = 0; i < n; i++) {
+        double a = bucketOnY ? points[i].y() : points[i].x();
+        double b = bucketOnY ? points[i].x() : points[i].y();
+        u[i] = logBucket ? log10(a) : a;
+        v[i] = logValue ? log10(b) : b;
+    }
+    if (logBucket) {
+        rangeMin = log10(rangeMin);
+        rangeMax = log10(rangeMax);
+    }
+
+    int first, last;
+    MT::PlotDownsampler::visibleRange(u, rangeMin, rangeMax, first, last);
+    std::vector<int> indices = stair ? MT::PlotDownsampler::minMax(u, v, first, last, pixels)
+                                     : MT::PlotDownsampler::lttb(u, v, first, last, pixels);
+
+    QList<QPointF> result;
+    result.reserve(static_cast<int>(indices.size()));
+    for (int i : indices) {
+        result << points[i];
+    }
+    return result;
+}
+
+// 隐藏指定series的图例
+void hideLegendMarker(QChart* chart, QAbstractSeries* series) {
+    QLegend* legend = chart->legend();
+    if (!legend) {
+        return;
+    }
+    const QList<QLegendMarker*> markers = legend->markers(series);
+    for (QLegendMarker* marker : markers) {
+        marker->setVisible(false);
+    }
+}
+
+} // namespace
+
 MTInversionGUI::MTInversionGUI(QWidget *parent)
     : QWidget(parent)
     , m_core(new MTInversionCore())
@@ -26,12 +140,48 @@ MTInversionGUI::MTInversionGUI(QWidget *parent)
     , m_plotTimer(new QTimer(this))
     , m_residualChart(nullptr)
     , m_residualChartView(nullptr)
+    , m_persistentSeries(true)
+    , m_modelSeriesTrue(nullptr)
+    , m_modelSeriesInit(nullptr)
+    , m_modelSeriesFinal(nullptr)
+    , m_modelAxisY(nullptr)
+    , m_residualSeries(nullptr)
+    , m_dmNormSeries(nullptr)
+    , m_residualAxisX(nullptr)
+    , m_residualAxisY(nullptr)
+    , m_downsampling(true)
+    , m_updatingCharts(false)
+    , m_lodTimer(new QTimer(this))
+    , m_randomWatcher(new QFutureWatcher<RandomModelCandidate>(this))
+    , m_randomDebounceTimer(new QTimer(this))
+    , m_currentResult(std::make_shared<const MTInversionCore::InversionResult>())
+    , m_inversionRunning(false)
+    , m_runningM(0)
 {
+    qRegisterMetaType<MT::SharedInversionResult>("MT::SharedInversionResult");
     setupUI();
 
     // 连接绘图定时器
     connect(m_plotTimer, &QTimer::timeout, this, &MTInversionGUI::updatePlot);
 
+    // 随机模型在后台生成，参数连续变化时防抖
+    connect(m_randomWatcher, &QFutureWatcher<RandomModelCandidate>::finished,
+            this, &MTInversionGUI::onRandomModelsReady);
+    m_randomDebounceTimer->setSingleShot(true);
+    m_randomDebounceTimer->setInterval(RANDOM_DEBOUNCE_MS);
+    connect(m_randomDebounceTimer, &QTimer::timeout, this, &MTInversionGUI::onGenerateRandomModel);
+
+    // 缩放/框选结束后重新降采样
+    m_lodTimer->setSingleShot(true);
+    m_lodTimer->setInterval(PLOT_FRAME_INTERVAL_MS);
+    connect(m_lodTimer, &QTimer::timeout, this, [this]() {
+        if (hasDisplayableResult()) {
+            updateModelChart();
+            updateResistivityChart();
+            updatePhaseChart();
+        }
+    });
+
     // 设置初始状态
     m_btnStop->setEnabled(false);
     m_statusLabel->setText("就绪");
@@ -42,6 +192,10 @@ MTInversionGUI::~MTInversionGUI() {
     if (m_plotTimer) {
         m_plotTimer->stop();
     }
+
+    // 取消尚未开始的随机模型生成任务，等待正在生成的任务结束
+    m_randomWatcher->cancel();
+    m_randomWatcher->waitForFinished();
     
     // 优雅停止工作线程
     if (m_workerThread && m_workerThread->isRunning()) {
@@ -135,7 +289,14 @@ void MTInversionGUI::setupParameterPanel() {
     m_spinLambda->setValue(1.0);
     m_spinLambda->setDecimals(2);
     m_spinLambda->setSingleStep(0.1);
-    layout->addWidget(m_spinLambda, 2, 1);
+    // Occam反演每次迭代自动搜索λ，此时固定λ不再使用
+    m_chkOccam = new QCheckBox("Occam");
+    m_chkOccam->setToolTip("每次迭代自动搜索λ，取拟合差达到噪声水平的最光滑模型");
+    connect(m_chkOccam, &QCheckBox::toggled, m_spinLambda, &QWidget::setDisabled);
+    QHBoxLayout* lambdaLayout = new QHBoxLayout();
+    lambdaLayout->addWidget(m_spinLambda);
+    lambdaLayout->addWidget(m_chkOccam);
+    layout->addLayout(lambdaLayout, 2, 1);
 
     // Jacobian扰动步长
     layout->addWidget(new QLabel("扰动步长ε:"), 3, 0);
@@ -204,32 +365,57 @@ void MTInversionGUI::setupParameterPanel() {
     btnLayout1->addWidget(m_btnStart);
     layout->addLayout(btnLayout1, 10, 0, 1, 2);
 
+    QHBoxLayout* randomLayout = new QHBoxLayout();
+    m_spinCandidates = new QSpinBox();
+    m_spinCandidates->setRange(1, 16);
+    m_spinCandidates->setValue(1);
+    m_spinCandidates->setToolTip("大于1时并行生成多个候选模型并排预览");
+    m_chkAutoPreview = new QCheckBox("参数变化时自动生成");
+    randomLayout->addWidget(new QLabel("候选模型数:"));
+    randomLayout->addWidget(m_spinCandidates);
+    randomLayout->addWidget(m_chkAutoPreview);
+    layout->addLayout(randomLayout, 11, 0, 1, 2);
+
     QHBoxLayout* btnLayout2 = new QHBoxLayout();
     m_btnStop = new QPushButton("停止");
     btnLayout2->addWidget(m_btnStop);
-    layout->addLayout(btnLayout2, 11, 0, 1, 2);
+    m_btnSurvey = new QPushButton("测区批量反演");
+    btnLayout2->addWidget(m_btnSurvey);
+    layout->addLayout(btnLayout2, 12, 0, 1, 2);
 
     // 进度条
     m_progressBar = new QProgressBar();
     m_progressBar->setRange(0, 100);
     m_progressBar->setValue(0);
-    layout->addWidget(m_progressBar, 12, 0, 1, 2);
+    layout->addWidget(m_progressBar, 13, 0, 1, 2);
 
     // 状态标签
     m_statusLabel = new QLabel("就绪");
-    layout->addWidget(m_statusLabel, 13, 0, 1, 2);
+    layout->addWidget(m_statusLabel, 14, 0, 1, 2);
 
     // 连接信号
     connect(m_btnGenerateRandom, &QPushButton::clicked, this, &MTInversionGUI::onGenerateRandomModel);
     connect(m_btnStart, &QPushButton::clicked, this, &MTInversionGUI::onStartInversion);
     connect(m_btnStop, &QPushButton::clicked, this, &MTInversionGUI::onStopInversion);
+    connect(m_btnSurvey, &QPushButton::clicked, this, &MTInversionGUI::onOpenSurveyDashboard);
+
+    // 随机模型参数变化时（启用自动生成）防抖后重新生成
+    for (QSpinBox* spin : {m_spinMLayers, m_spinNFreq}) {
+        connect(spin, QOverload<int>::of(&QSpinBox::valueChanged),
+                this, &MTInversionGUI::onRandomParametersChanged);
+    }
+    for (QDoubleSpinBox* spin : {m_spinMinRho, m_spinMaxRho, m_spinFirstThickness, m_spinThicknessGrowth}) {
+        connect(spin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+                this, &MTInversionGUI::onRandomParametersChanged);
+    }
 }
 
 void MTInversionGUI::setupResultPanel() {
     // 结果表格
     m_resultTable = new QTableWidget();
-    m_resultTable->setColumnCount(5);
-    m_resultTable->setHorizontalHeaderLabels(QStringList() << "层号" << "层厚度(m)" << "真实模型" << "初始模型" << "反演结果");
+    m_resultTable->setColumnCount(7);
+    m_resultTable->setHorizontalHeaderLabels(QStringList() << "层号" << "层厚度(m)" << "真实模型" << "初始模型" << "反演结果"
+                                                           << "分辨率" << "后验标准差(log10ρ)");
     m_resultTable->horizontalHeader()->setStretchLastSection(true);
     m_resultTable->setAlternatingRowColors(true);
     m_resultTable->setMaximumHeight(200);
@@ -252,6 +438,7 @@ void MTInversionGUI::setupPlotPanel() {
     m_modelChart->setTitle("模型对比（电阻率随深度变化）");
     m_modelChartView = new QChartView(m_modelChart);
     m_modelChartView->setRenderHint(QPainter::Antialiasing);
+    m_modelChartView->setRubberBand(QChartView::VerticalRubberBand);  // 沿深度框选放大，右键缩小
     chartLayout->addWidget(m_modelChartView, 1);  // 占1份空间
 
     // 2. 视电阻率曲线
@@ -259,6 +446,7 @@ void MTInversionGUI::setupPlotPanel() {
     m_resistivityChart->setTitle("视电阻率曲线");
     m_resistivityChartView = new QChartView(m_resistivityChart);
     m_resistivityChartView->setRenderHint(QPainter::Antialiasing);
+    m_resistivityChartView->setRubberBand(QChartView::HorizontalRubberBand);
     chartLayout->addWidget(m_resistivityChartView, 1);  // 占1份空间
 
     // 3. 相位曲线
@@ -266,8 +454,14 @@ void MTInversionGUI::setupPlotPanel() {
     m_phaseChart->setTitle("相位曲线");
     m_phaseChartView = new QChartView(m_phaseChart);
     m_phaseChartView->setRenderHint(QPainter::Antialiasing);
+    m_phaseChartView->setRubberBand(QChartView::HorizontalRubberBand);
     chartLayout->addWidget(m_phaseChartView, 1);  // 占1份空间
 
+    // 绘图区尺寸变化（窗口缩放）后按新的像素数重新降采样
+    for (QChart* chart : {m_modelChart, m_resistivityChart, m_phaseChart}) {
+        connect(chart, &QChart::plotAreaChanged, this, &MTInversionGUI::onChartViewportChanged);
+    }
+
     // 初始化空图表
     clearCharts();
 }
@@ -292,6 +486,7 @@ void MTInversionGUI::onStartInversion() {
     params.M = m_spinMLayers->value();
     params.nFreq = m_spinNFreq->value();
     params.lambda = m_spinLambda->value();
+    params.occam = m_chkOccam->isChecked();
     params.epsilon = m_spinEpsilon->value();
     params.maxIter = m_spinMaxIter->value();
     params.tolDm = m_spinTolDm->value();
@@ -299,26 +494,26 @@ void MTInversionGUI::onStartInversion() {
     params.thicknessGrowth = m_spinThicknessGrowth->value();
 
     // 如果已经生成了随机模型，使用其观测数据、真实模型等信息
-    if (m_currentResult.success && !m_currentResult.dObs.empty() && 
-        !m_currentResult.mTrue.empty()) {
+    if (m_currentResult->success && !m_currentResult->dObs.empty() && 
+        !m_currentResult->mTrue.empty()) {
         // 检查参数是否匹配
-        if (m_currentResult.dObs.size() != params.nFreq * 2 ||
-            m_currentResult.mTrue.size() != params.M) {
+        if (m_currentResult->dObs.size() != params.nFreq * 2 ||
+            m_currentResult->mTrue.size() != params.M) {
             QMessageBox::warning(this, "参数不匹配", 
                 QString("已生成的模型参数（M=%1, nFreq=%2）与当前设置（M=%3, nFreq=%4）不匹配。\n"
                         "请重新生成随机模型或调整参数。")
-                .arg(m_currentResult.mTrue.size())
-                .arg(m_currentResult.dObs.size() / 2)
+                .arg(m_currentResult->mTrue.size())
+                .arg(m_currentResult->dObs.size() / 2)
                 .arg(params.M)
                 .arg(params.nFreq));
             m_logText->append("参数不匹配，使用默认模型进行反演");
         } else {
-            params.dObs = m_currentResult.dObs;
-            params.mTrue = m_currentResult.mTrue;
-            params.periods = m_currentResult.periods;
-            params.omega = m_currentResult.omega;
-            params.layerThicknesses = m_currentResult.layerThicknesses;
-            params.layerDepths = m_currentResult.layerDepths;
+            params.dObs = m_currentResult->dObs;
+            params.mTrue = m_currentResult->mTrue;
+            params.periods = m_currentResult->periods;
+            params.omega = m_currentResult->omega;
+            params.layerThicknesses = m_currentResult->layerThicknesses;
+            params.layerDepths = m_currentResult->layerDepths;
             m_logText->append("使用已生成的随机模型数据进行反演");
         }
     } else {
@@ -332,6 +527,9 @@ void MTInversionGUI::onStartInversion() {
     m_progressBar->setMaximum(params.maxIter);
     m_statusLabel->setText("正在反演...");
 
+    // 准备实时显示的结果（收敛历史在进度回调中逐次追加，模型和合成数据由快照更新）
+    prepareLiveResult(params);
+
     // 清空日志
     m_logText->clear();
     m_logText->append(QString("开始反演 - %1").arg(QDateTime::currentDateTime().toString()));
@@ -354,8 +552,10 @@ void MTInversionGUI::onStartInversion() {
                 }
             });
 
+    m_inversionRunning = true;
+    m_runningM = params.M;
     m_workerThread->start();
-    m_plotTimer->start(100);  // 每100ms更新一次图表
+    m_plotTimer->start(PLOT_FRAME_INTERVAL_MS);  // 按固定帧率拉取模型快照并更新图表
 }
 
 void MTInversionGUI::onStopInversion() {
@@ -375,66 +575,161 @@ void MTInversionGUI::onStopInversion() {
         m_statusLabel->setText("已停止");
         m_logText->append("反演已停止");
         m_plotTimer->stop();
+        m_inversionRunning = false;
     }
 
     m_btnStart->setEnabled(true);
     m_btnStop->setEnabled(false);
 }
 
+void MTInversionGUI::onOpenSurveyDashboard() {
+    // 以当前界面参数作为各测站的反演参数模板
+    MTInversionCore::InversionParams params;
+    params.M = m_spinMLayers->value();
+    params.nFreq = m_spinNFreq->value();
+    params.lambda = m_spinLambda->value();
+    params.occam = m_chkOccam->isChecked();
+    params.epsilon = m_spinEpsilon->value();
+    params.maxIter = m_spinMaxIter->value();
+    params.tolDm = m_spinTolDm->value();
+    params.firstLayerThickness = m_spinFirstThickness->value();
+    params.thicknessGrowth = m_spinThicknessGrowth->value();
+
+    if (!m_surveyDashboard) {
+        m_surveyDashboard = new SurveyDashboard(params, this);
+        m_surveyDashboard->setWindowFlags(Qt::Window);
+        connect(m_surveyDashboard, &SurveyDashboard::stationResultSelected,
+                this, &MTInversionGUI::onSurveyResultSelected);
+    } else {
+        m_surveyDashboard->setBaseParams(params);
+    }
+    m_surveyDashboard->show();
+    m_surveyDashboard->raise();
+    m_surveyDashboard->activateWindow();
+}
+
+void MTInversionGUI::onSurveyResultSelected(const MT::SharedInversionResult& result) {
+    // 在主窗口中查看测区面板里选中的测站结果
+    if (!result) {
+        return;
+    }
+    if (m_workerThread && m_workerThread->isRunning()) {
+        QMessageBox::information(this, "提示", "请先停止当前反演");
+        return;
+    }
+    updateResultTable(*result);
+    updatePlotData(result);
+    m_statusLabel->setText(QString("测站 %1：%2次迭代")
+                               .arg(QString::fromStdString(result->stationId))
+                               .arg(result->nIterations));
+}
+
 void MTInversionGUI::onGenerateRandomModel() {
     // 如果反演正在进行，先停止
     if (m_workerThread && m_workerThread->isRunning()) {
         QMessageBox::warning(this, "警告", "反演正在进行中，请先停止当前任务。");
         return;
     }
-    
+    m_randomDebounceTimer->stop();
+
     // 停止定时器（如果正在运行）
     if (m_plotTimer->isActive()) {
         m_plotTimer->stop();
     }
     
-    int M = m_spinMLayers->value();
-    int nFreq = m_spinNFreq->value();
-    double minRho = m_spinMinRho->value();
-    double maxRho = m_spinMaxRho->value();
-    double firstThickness = m_spinFirstThickness->value();
-    double growthFactor = m_spinThicknessGrowth->value();
+    RandomModelRequest request;
+    request.M = m_spinMLayers->value();
+    request.nFreq = m_spinNFreq->value();
+    request.minRho = m_spinMinRho->value();
+    request.maxRho = m_spinMaxRho->value();
+    request.firstThickness = m_spinFirstThickness->value();
+    request.growthFactor = m_spinThicknessGrowth->value();
+    request.filterCutoff = 0.2;  // 使用更大的滤波参数使模型更光滑
+    int nCandidates = m_spinCandidates->value();
 
     m_logText->append(QString("生成随机模型 - %1").arg(QDateTime::currentDateTime().toString()));
     m_logText->append(QString("参数: M=%1, nFreq=%2, 电阻率范围=[%3, %4] Ω·m")
-                     .arg(M).arg(nFreq).arg(minRho).arg(maxRho));
+                     .arg(request.M).arg(request.nFreq).arg(request.minRho).arg(request.maxRho));
     m_logText->append(QString("第一层厚度=%1 m, 厚度增长系数=%2")
-                     .arg(firstThickness).arg(growthFactor));
-
-    // 生成随机模型并正演（使用0.3作为滤波截止频率，过滤高频变化）
-    std::vector<double> mRandom;
-    std::vector<double> layerThicknesses;
-    std::vector<double> layerDepths;
-    std::vector<double> periods;
-    std::vector<double> omega;
-    std::vector<double> dataRandom;
-
-    // 使用更大的滤波参数（0.3）使模型更光滑
-    m_core->generateRandomModelAndForward(M, nFreq, minRho, maxRho,
-                                          firstThickness, growthFactor, 0.2,
-                                          mRandom, layerThicknesses, layerDepths,
-                                          periods, omega, dataRandom);
+                     .arg(request.firstThickness).arg(request.growthFactor));
+
+    // 上一次生成尚未完成时取消（未开始的候选不再计算，已完成的结果被丢弃）
+    if (m_randomWatcher->isRunning()) {
+        m_randomWatcher->cancel();
+        m_logText->append("已取消上一次随机模型生成");
+    }
+
+    // 每个候选模型使用不同的随机种子，在全局线程池中并行生成并正演
+    QList<RandomModelRequest> requests;
+    unsigned int baseSeed = QRandomGenerator::global()->generate();
+    for (int i = 0; i < nCandidates; i++) {
+        request.seed = baseSeed + static_cast<unsigned int>(i);
+        requests.append(request);
+    }
+    m_randomWatcher->setFuture(QtConcurrent::mapped(requests, generateRandomModelCandidate));
+    m_statusLabel->setText(nCandidates > 1 ? QString("正在生成%1个候选模型...").arg(nCandidates)
+                                           : QString("正在生成随机模型..."));
+}
+
+void MTInversionGUI::onRandomParametersChanged() {
+    if (m_chkAutoPreview->isChecked()) {
+        m_randomDebounceTimer->start();  // 重新计时，参数停止变化后才生成
+    }
+}
+
+void MTInversionGUI::onRandomModelsReady() {
+    QFuture<RandomModelCandidate> future = m_randomWatcher->future();
+    if (future.isCanceled()) {
+        return;
+    }
+    QList<RandomModelCandidate> candidates = future.results();
+    if (candidates.isEmpty()) {
+        return;
+    }
+
+    if (candidates.size() == 1) {
+        applyRandomCandidate(candidates.first());
+        return;
+    }
+
+    // 多个候选模型：在预览窗口中并排显示，由用户选用
+    if (!m_randomPreview) {
+        m_randomPreview = new RandomModelPreview(this);
+        m_randomPreview->setWindowFlags(Qt::Window);
+        connect(m_randomPreview, &RandomModelPreview::candidateSelected,
+                this, &MTInversionGUI::applyRandomCandidate);
+    }
+    m_randomPreview->setCandidates(QVector<RandomModelCandidate>(candidates.begin(), candidates.end()));
+    m_randomPreview->show();
+    m_randomPreview->raise();
+
+    m_logText->append(QString("已生成%1个候选模型，请在预览窗口中选用").arg(candidates.size()));
+    m_statusLabel->setText("候选模型已生成");
+}
+
+void MTInversionGUI::applyRandomCandidate(const RandomModelCandidate& candidate) {
+    if (m_workerThread && m_workerThread->isRunning()) {
+        QMessageBox::warning(this, "警告", "反演正在进行中，请先停止当前任务。");
+        return;
+    }
+    int M = static_cast<int>(candidate.mLogRho.size());
 
     // 更新当前结果（用于显示）
-    m_currentResult.mTrue = mRandom;
+    MTInversionCore::InversionResult& live = editableResult();
+    live.mTrue = candidate.mLogRho;
     // 初始模型始终是100 Ω·m（log10(100) = 2.0）
-    m_currentResult.mInit.resize(M);
+    live.mInit.resize(M);
     for (int i = 0; i < M; i++) {
-        m_currentResult.mInit[i] = log10(100.0);  // 100 Ω·m
+        live.mInit[i] = log10(100.0);  // 100 Ω·m
     }
-    m_currentResult.mFinal = mRandom; // 暂时相同（随机模型作为最终结果用于显示）
-    m_currentResult.layerThicknesses = layerThicknesses;
-    m_currentResult.layerDepths = layerDepths;
-    m_currentResult.periods = periods;
-    m_currentResult.omega = omega;
-    m_currentResult.dObs = dataRandom;
-    m_currentResult.dSyn = dataRandom;
-    m_currentResult.success = true;
+    live.mFinal = candidate.mLogRho; // 暂时相同（随机模型作为最终结果用于显示）
+    live.layerThicknesses = candidate.layerThicknesses;
+    live.layerDepths = candidate.layerDepths;
+    live.periods = candidate.periods;
+    live.omega = candidate.omega;
+    live.dObs = candidate.data;
+    live.dSyn = candidate.data;
+    live.success = true;
 
     // 更新图表
     updateModelChart();
@@ -443,13 +738,17 @@ void MTInversionGUI::onGenerateRandomModel() {
     updateResidualChart();  // 更新残差图表（初始时可能为空）
 
     // 更新结果表格
-    updateResultTable(m_currentResult);
+    updateResultTable(*m_currentResult);
 
-    m_logText->append("随机模型生成完成！");
+    m_logText->append(QString("随机模型生成完成！（种子 %1）").arg(candidate.seed));
     m_statusLabel->setText("随机模型已生成");
 }
 
 void MTInversionGUI::onProgressUpdated(int iteration, double residual, double dmNorm) {
+    MTInversionCore::InversionResult& live = editableResult();
+    live.residualHistory.push_back(residual);
+    live.dmNormHistory.push_back(dmNorm);
+
     m_progressBar->setValue(iteration);
     m_statusLabel->setText(QString("迭代 %1/%2 - 残差: %3, 更新: %4")
                           .arg(iteration).arg(m_progressBar->maximum())
@@ -465,23 +764,37 @@ void MTInversionGUI::onProgressUpdated(int iteration, double residual, double dm
     }
 }
 
-void MTInversionGUI::onInversionFinished(const MTInversionCore::InversionResult& result) {
+void MTInversionGUI::onInversionFinished(const MT::SharedInversionResult& result) {
     m_plotTimer->stop();
-    m_currentResult = result;
-
-    if (result.success) {
-        m_statusLabel->setText(QString("反演完成 - 迭代次数: %1").arg(result.nIterations));
-        m_logText->append(QString("反演成功完成！迭代次数: %1").arg(result.nIterations));
+    m_inversionRunning = false;
+    if (!result) {
+        return;
+    }
+    setCurrentResult(result);
+
+    if (result->success) {
+        m_statusLabel->setText(QString("反演完成 - 迭代次数: %1").arg(result->nIterations));
+        m_logText->append(QString("反演成功完成！迭代次数: %1").arg(result->nIterations));
+        if (!result->lambdaHistory.empty()) {
+            QStringList lambdas;
+            for (double lambda : result->lambdaHistory) {
+                lambdas << QString::number(lambda, 'g', 3);
+            }
+            m_logText->append(QString("Occam各次迭代选用的λ: %1").arg(lambdas.join(", ")));
+        }
+        if (!result->resolutionDiag.empty()) {
+            m_logText->append(QString("由分辨率估计的探测深度: %1 m").arg(result->doi, 0, 'f', 1));
+        }
 
         // 更新结果表格
-        updateResultTable(result);
+        updateResultTable(*result);
 
         // 更新图表
         updatePlotData(result);
     } else {
         m_statusLabel->setText("反演失败");
-        m_logText->append(QString("反演失败: %1").arg(QString::fromStdString(result.errorMessage)));
-        QMessageBox::critical(this, "错误", QString::fromStdString(result.errorMessage));
+        m_logText->append(QString("反演失败: %1").arg(QString::fromStdString(result->errorMessage)));
+        QMessageBox::critical(this, "错误", QString::fromStdString(result->errorMessage));
     }
 
     // 注意：线程指针的清理在finished信号的处理中完成
@@ -547,6 +860,20 @@ void MTInversionGUI::updateResultTable(const MTInversionCore::InversionResult& r
         item = m_resultTable->item(i, 4);
         if (item) delete item;
         m_resultTable->setItem(i, 4, new QTableWidgetItem(QString::number(rhoFinal, 'f', 2)));
+
+        // 反演后分析（未计算时留空）
+        QString resolution, posteriorStd;
+        if (i < static_cast<int>(result.resolutionDiag.size()) && i < static_cast<int>(result.posteriorStd.size())) {
+            resolution = QString::number(result.resolutionDiag[i], 'f', 3);
+            posteriorStd = QString::number(result.posteriorStd[i], 'f', 3);
+        }
+        item = m_resultTable->item(i, 5);
+        if (item) delete item;
+        m_resultTable->setItem(i, 5, new QTableWidgetItem(resolution));
+
+        item = m_resultTable->item(i, 6);
+        if (item) delete item;
+        m_resultTable->setItem(i, 6, new QTableWidgetItem(posteriorStd));
     }
 }
 
@@ -557,101 +884,187 @@ void MTInversionGUI::updatePlot() {
         m_plotTimer->stop();
     }
     
+    // 拉取工作线程发布的最新模型快照（只取最新一帧，跳过的中间迭代不会积压）
+    if (m_workerThread) {
+        const MT::InversionSnapshot* snapshot = nullptr;
+        if (m_inversionRunning && m_workerThread->latestSnapshot(snapshot) &&
+            snapshot->mCurrent.size() == static_cast<size_t>(m_runningM)) {
+            MTInversionCore::InversionResult& live = editableResult();
+            live.mFinal = snapshot->mCurrent;
+            live.dSyn = snapshot->dSyn;
+        }
+    }
+
     // 即使反演未完成，也更新残差图表（如果有数据）
-    if (!m_currentResult.residualHistory.empty() || !m_currentResult.dmNormHistory.empty()) {
+    if (!m_currentResult->residualHistory.empty() || !m_currentResult->dmNormHistory.empty()) {
         updateResidualChart();
     }
     
-    if (!m_currentResult.success || m_currentResult.mFinal.empty()) {
+    if (!hasDisplayableResult() || m_currentResult->mFinal.empty()) {
         return;
     }
 
     updatePlotData(m_currentResult);
 }
 
-void MTInversionGUI::updatePlotData(const MTInversionCore::InversionResult& result) {
-    m_currentResult = result;
+void MTInversionGUI::updatePlotData(const MT::SharedInversionResult& result) {
+    if (result != m_currentResult) {
+        setCurrentResult(result);
+    }
     updateModelChart();
     updateResistivityChart();
     updatePhaseChart();
     updateResidualChart();
 }
 
-void MTInversionGUI::clearCharts() {
-    // 清除模型图表
-    QList<QAbstractSeries*> series = m_modelChart->series();
-    for (QAbstractSeries* s : series) {
-        m_modelChart->removeSeries(s);
-        delete s;  // 显式删除series
-    }
-    QList<QAbstractAxis*> axes = m_modelChart->axes();
-    for (QAbstractAxis* axis : axes) {
-        m_modelChart->removeAxis(axis);
-        delete axis;
+void MTInversionGUI::setCurrentResult(const MT::SharedInversionResult& result) {
+    m_currentResult = result ? result : std::make_shared<const MTInversionCore::InversionResult>();
+    m_editableResult.reset();
+}
+
+MTInversionCore::InversionResult& MTInversionGUI::editableResult() {
+    if (!m_editableResult || m_editableResult != m_currentResult) {
+        m_editableResult = std::make_shared<MTInversionCore::InversionResult>(*m_currentResult);
+        m_currentResult = m_editableResult;
     }
+    return *m_editableResult;
+}
 
-    // 清除视电阻率图表
-    series = m_resistivityChart->series();
-    for (QAbstractSeries* s : series) {
-        m_resistivityChart->removeSeries(s);
-        delete s;  // 显式删除series
+bool MTInversionGUI::hasDisplayableResult() const {
+    return m_currentResult->success || m_inversionRunning;
+}
+
+void MTInversionGUI::prepareLiveResult(const MTInversionCore::InversionParams& params) {
+    MTInversionCore::InversionResult& live = editableResult();
+    live.residualHistory.clear();
+    live.dmNormHistory.clear();
+    live.mInit.clear();
+    live.mFinal.clear();
+    live.dSyn.clear();
+    live.components = params.components;
+    live.mTrue = params.mTrue;
+    live.dObs = params.dObs;
+
+    // 与反演核心相同的频率和层网格（未提供时按相同规则生成；工作线程尚未启动）
+    if (!params.periods.empty() && params.periods.size() == static_cast<size_t>(params.nFreq)) {
+        live.periods = params.periods;
+        live.omega = params.omega;
+    } else {
+        m_core->generateFrequencies(live.periods, live.omega, params.nFreq);
     }
-    axes = m_resistivityChart->axes();
-    for (QAbstractAxis* axis : axes) {
-        m_resistivityChart->removeAxis(axis);
-        delete axis;
+    if (!params.layerThicknesses.empty() && params.layerThicknesses.size() == static_cast<size_t>(params.M)) {
+        live.layerThicknesses = params.layerThicknesses;
+        live.layerDepths = params.layerDepths;
+    } else {
+        m_core->computeLayerThicknesses(params.M, params.firstLayerThickness, params.thicknessGrowth,
+                                        live.layerThicknesses, live.layerDepths);
     }
+}
 
-    // 清除相位图表
-    series = m_phaseChart->series();
-    for (QAbstractSeries* s : series) {
-        m_phaseChart->removeSeries(s);
-        delete s;  // 显式删除series
-    }
-    axes = m_phaseChart->axes();
-    for (QAbstractAxis* axis : axes) {
-        m_phaseChart->removeAxis(axis);
-        delete axis;
+void MTInversionGUI::setPersistentSeries(bool enabled) {
+    if (m_persistentSeries == enabled) {
+        return;
     }
+    m_persistentSeries = enabled;
+    clearCharts();
+    updatePlotData(m_currentResult);
+}
 
-    // 清除残差图表（如果已创建）
-    if (m_residualChart) {
-        series = m_residualChart->series();
-        for (QAbstractSeries* s : series) {
-            m_residualChart->removeSeries(s);
-            delete s;  // 显式删除series
-        }
-        axes = m_residualChart->axes();
-        for (QAbstractAxis* axis : axes) {
-            m_residualChart->removeAxis(axis);
-            delete axis;
-        }
+void MTInversionGUI::setDownsampling(bool enabled) {
+    if (m_downsampling == enabled) {
+        return;
     }
+    m_downsampling = enabled;
+    m_lodTimer->start();
 }
 
-void MTInversionGUI::updateModelChart() {
-    if (m_currentResult.mTrue.empty() || !m_currentResult.success) {
+void MTInversionGUI::onChartViewportChanged() {
+    // 图表更新过程中坐标范围的变化由更新本身引起，不需要再次降采样
+    if (!m_downsampling || m_updatingCharts) {
         return;
     }
+    m_lodTimer->start();
+}
 
-    // 清除现有series和轴
-    QList<QAbstractSeries*> series = m_modelChart->series();
-    for (QAbstractSeries* s : series) {
-        m_modelChart->removeSeries(s);
-        delete s;  // 显式删除series
+void MTInversionGUI::clearCharts() {
+    clearChart(m_modelChart);
+    m_modelSeriesTrue = nullptr;
+    m_modelSeriesInit = nullptr;
+    m_modelSeriesFinal = nullptr;
+    m_modelAxisY = nullptr;
+
+    clearChart(m_resistivityChart);
+    m_resistivityCurves = CurveSeries();
+
+    clearChart(m_phaseChart);
+    m_phaseCurves = CurveSeries();
+
+    // 清除残差图表（如果已创建）
+    clearChart(m_residualChart);
+    m_residualSeries = nullptr;
+    m_dmNormSeries = nullptr;
+    m_residualAxisX = nullptr;
+    m_residualAxisY = nullptr;
+}
+
+void MTInversionGUI::createModelSeries() {
+    // 创建阶梯状序列（每层内部电阻率不变）
+    m_modelSeriesTrue = new QLineSeries();
+    m_modelSeriesInit = new QLineSeries();
+    m_modelSeriesFinal = new QLineSeries();
+
+    m_modelSeriesTrue->setName("真实模型");
+    m_modelSeriesInit->setName("初始模型");
+    m_modelSeriesFinal->setName("反演结果");
+
+    m_modelSeriesTrue->setPen(QPen(Qt::red, 2));
+    m_modelSeriesInit->setPen(QPen(Qt::blue, 2, Qt::DashLine));
+    m_modelSeriesFinal->setPen(QPen(Qt::green, 2));
+
+    m_modelChart->addSeries(m_modelSeriesTrue);
+    m_modelChart->addSeries(m_modelSeriesInit);
+    m_modelChart->addSeries(m_modelSeriesFinal);
+
+    // 设置坐标轴：深度在Y轴（垂直），电阻率在X轴（水平），深度向下（0在上）
+    QLogValueAxis* axisX = new QLogValueAxis();
+    axisX->setTitleText("电阻率 (Ω·m)");
+    axisX->setLabelFormat("%.1e");
+    axisX->setBase(10.0);
+    axisX->setRange(0.1, 10000.0);  // 固定范围：0.1 Ω·m 到 10000 Ω·m
+    m_modelChart->addAxis(axisX, Qt::AlignBottom);
+
+    m_modelAxisY = new QLogValueAxis();
+    m_modelAxisY->setTitleText("深度 (m)");
+    m_modelAxisY->setLabelFormat("%.0f");
+    m_modelAxisY->setBase(10.0);
+    m_modelAxisY->setReverse(true);  // 反转Y轴，使深度0在上方，深度值向下增加
+    m_modelChart->addAxis(m_modelAxisY, Qt::AlignLeft);
+
+    for (QLineSeries* s : {m_modelSeriesTrue, m_modelSeriesInit, m_modelSeriesFinal}) {
+        s->attachAxis(axisX);
+        s->attachAxis(m_modelAxisY);
     }
-    QList<QAbstractAxis*> axes = m_modelChart->axes();
-    for (QAbstractAxis* axis : axes) {
-        m_modelChart->removeAxis(axis);
-        delete axis;
+    connect(m_modelAxisY, &QLogValueAxis::rangeChanged, this, &MTInversionGUI::onChartViewportChanged);
+
+    m_modelChart->legend()->setVisible(true);
+    m_modelChart->legend()->setAlignment(Qt::AlignBottom);
+}
+
+void MTInversionGUI::updateModelChart() {
+    // 反演进行中且未提供真实模型时只绘制当前模型
+    const std::vector<double>& mLayers = m_currentResult->mTrue.empty() ? m_currentResult->mFinal
+                                                                        : m_currentResult->mTrue;
+    if (mLayers.empty() || !hasDisplayableResult()) {
+        return;
     }
 
-    int M = static_cast<int>(m_currentResult.mTrue.size());
+    QScopedValueRollback<bool> updating(m_updatingCharts, true);
+    int M = static_cast<int>(mLayers.size());
 
     // 使用层厚度和深度信息
-    std::vector<double> layerThicknesses = m_currentResult.layerThicknesses;
-    std::vector<double> layerDepths = m_currentResult.layerDepths;
-    
+    std::vector<double> layerThicknesses = m_currentResult->layerThicknesses;
+    std::vector<double> layerDepths = m_currentResult->layerDepths;
+
     // 如果没有层厚度信息，使用默认值
     if (layerThicknesses.empty() || layerDepths.empty()) {
         layerThicknesses.resize(M);
@@ -665,47 +1078,26 @@ void MTInversionGUI::updateModelChart() {
         }
     }
 
-    // 创建阶梯状序列（每层内部电阻率不变）
-    QLineSeries* seriesTrue = new QLineSeries();
-    QLineSeries* seriesInit = new QLineSeries();
-    QLineSeries* seriesFinal = new QLineSeries();
-
-    seriesTrue->setName("真实模型");
-    seriesInit->setName("初始模型");
-    seriesFinal->setName("反演结果");
-
-    QPen penTrue(Qt::red, 2);
-    QPen penInit(Qt::blue, 2, Qt::DashLine);
-    QPen penFinal(Qt::green, 2);
-
-    seriesTrue->setPen(penTrue);
-    seriesInit->setPen(penInit);
-    seriesFinal->setPen(penFinal);
-
     // 计算总深度
     double totalDepth = 0.0;
     for (int i = 0; i < M; i++) {
         totalDepth += layerThicknesses[i];
     }
 
+    // 对数坐标下电阻率的有效值
+    auto toRho = [](double logRho) {
+        double rho = pow(10.0, logRho);
+        // 检查NaN和Inf，确保电阻率值为正数
+        if (!std::isfinite(rho) || rho <= 0.0) rho = 0.1;
+        return rho;
+    };
+
     // 创建阶梯状曲线：每层内部电阻率不变，在层边界处跳跃
-    double minRho = 1e10;  // 用于确定电阻率范围
-    double maxRho = 1e-10;
-    
+    QList<QPointF> pointsTrue, pointsInit, pointsFinal;
+    pointsTrue.reserve(2 * M);
+    pointsInit.reserve(2 * M);
+    pointsFinal.reserve(2 * M);
     for (int i = 0; i < M; i++) {
-        // 检查数组边界
-        if (i >= static_cast<int>(m_currentResult.mTrue.size())) {
-            continue;  // 跳过无效索引
-        }
-        
-        double rhoTrue = pow(10.0, m_currentResult.mTrue[i]);
-        // 检查NaN和Inf
-        if (!std::isfinite(rhoTrue)) rhoTrue = 0.1;
-        // 确保电阻率值为正数
-        if (rhoTrue <= 0.0) rhoTrue = 0.1;
-        if (rhoTrue < minRho) minRho = rhoTrue;
-        if (rhoTrue > maxRho) maxRho = rhoTrue;
-        
         // 确保深度值为正数（最小深度为0.01米，用于对数坐标）
         double depthTop = std::max(0.01, layerDepths[i]);
         double thickness = layerThicknesses[i];
@@ -713,303 +1105,287 @@ void MTInversionGUI::updateModelChart() {
             thickness = 100.0;  // 默认厚度
         }
         double depthBottom = std::max(0.01, depthTop + thickness);
-        
+
         // 阶梯状：在层顶部和底部都添加点，保持水平
-        seriesTrue->append(rhoTrue, depthTop);
-        seriesTrue->append(rhoTrue, depthBottom);
-        
-        if (!m_currentResult.mInit.empty() && i < static_cast<int>(m_currentResult.mInit.size())) {
-            double rhoInit = pow(10.0, m_currentResult.mInit[i]);
-            if (!std::isfinite(rhoInit)) rhoInit = 0.1;
-            if (rhoInit <= 0.0) rhoInit = 0.1;
-            if (rhoInit < minRho) minRho = rhoInit;
-            if (rhoInit > maxRho) maxRho = rhoInit;
-            seriesInit->append(rhoInit, depthTop);
-            seriesInit->append(rhoInit, depthBottom);
+        if (i < static_cast<int>(m_currentResult->mTrue.size())) {
+            double rhoTrue = toRho(m_currentResult->mTrue[i]);
+            pointsTrue << QPointF(rhoTrue, depthTop) << QPointF(rhoTrue, depthBottom);
         }
 
-        if (!m_currentResult.mFinal.empty() && i < static_cast<int>(m_currentResult.mFinal.size())) {
-            double rhoFinal = pow(10.0, m_currentResult.mFinal[i]);
-            if (!std::isfinite(rhoFinal)) rhoFinal = 0.1;
-            if (rhoFinal <= 0.0) rhoFinal = 0.1;
-            if (rhoFinal < minRho) minRho = rhoFinal;
-            if (rhoFinal > maxRho) maxRho = rhoFinal;
-            seriesFinal->append(rhoFinal, depthTop);
-            seriesFinal->append(rhoFinal, depthBottom);
+        if (i < static_cast<int>(m_currentResult->mInit.size())) {
+            double rhoInit = toRho(m_currentResult->mInit[i]);
+            pointsInit << QPointF(rhoInit, depthTop) << QPointF(rhoInit, depthBottom);
+        }
+        if (i < static_cast<int>(m_currentResult->mFinal.size())) {
+            double rhoFinal = toRho(m_currentResult->mFinal[i]);
+            pointsFinal << QPointF(rhoFinal, depthTop) << QPointF(rhoFinal, depthBottom);
         }
     }
-    
-    // 确保范围有效
-    if (minRho <= 0.0) minRho = 0.1;
-    if (maxRho <= minRho) maxRho = minRho * 10.0;
 
-    m_modelChart->addSeries(seriesTrue);
-    if (!m_currentResult.mInit.empty()) {
-        m_modelChart->addSeries(seriesInit);
+    // 非持久化模式：每次刷新都重建series和坐标轴
+    if (!m_persistentSeries) {
+        clearChart(m_modelChart);
+        m_modelSeriesTrue = nullptr;
     }
-    if (!m_currentResult.mFinal.empty()) {
-        m_modelChart->addSeries(seriesFinal);
+    if (!m_modelSeriesTrue) {
+        createModelSeries();
     }
 
-    // 设置坐标轴：深度在Y轴（垂直），电阻率在X轴（水平），深度向下（0在上）
-    QLogValueAxis* axisX = new QLogValueAxis();
-    axisX->setTitleText("电阻率 (Ω·m)");
-    axisX->setLabelFormat("%.1e");
-    axisX->setBase(10.0);
-    axisX->setRange(0.1, 10000.0);  // 固定范围：0.1 Ω·m 到 10000 Ω·m
-    m_modelChart->addAxis(axisX, Qt::AlignBottom);
-    seriesTrue->attachAxis(axisX);
-    if (!m_currentResult.mInit.empty()) seriesInit->attachAxis(axisX);
-    if (!m_currentResult.mFinal.empty()) seriesFinal->attachAxis(axisX);
-
-    QLogValueAxis* axisY = new QLogValueAxis();
-    axisY->setTitleText("深度 (m)");
-    axisY->setLabelFormat("%.0f");
-    axisY->setBase(10.0);
-    // 反转Y轴，使深度0在上方，深度值向下增加
     // 确保最小深度为正数（对数坐标不能为0），使用很小的正数
     double minDepth = 0.01;
     double maxDepth = std::max(1.0, totalDepth);
-    if (maxDepth < minDepth) maxDepth = minDepth * 10.0;
-    axisY->setRange(maxDepth, minDepth);  // 从最大深度到最小深度（反转）
-    axisY->setReverse(true);  // 明确设置反向显示
-    m_modelChart->addAxis(axisY, Qt::AlignLeft);
-    seriesTrue->attachAxis(axisY);
-    if (!m_currentResult.mInit.empty()) seriesInit->attachAxis(axisY);
-    if (!m_currentResult.mFinal.empty()) seriesFinal->attachAxis(axisY);
 
-    m_modelChart->legend()->setVisible(true);
-    m_modelChart->legend()->setAlignment(Qt::AlignBottom);
-}
-
-void MTInversionGUI::updateResistivityChart() {
-    if (m_currentResult.periods.empty() || !m_currentResult.success) {
-        return;
+    if (m_downsampling) {
+        // 沿深度方向按像素行做最小最大值降采样，层边界的跳变不会丢失；
+        // 框选放大后只抽稀可见深度范围
+        double visibleMin = minDepth, visibleMax = maxDepth;
+        if (m_modelChart->isZoomed()) {
+            visibleMin = m_modelAxisY->min();
+            visibleMax = m_modelAxisY->max();
+        }
+        int pixels = plotPixels(m_modelChart, Qt::Vertical);
+        pointsTrue = downsamplePoints(pointsTrue, true, true, true, true, visibleMin, visibleMax, pixels);
+        pointsInit = downsamplePoints(pointsInit, true, true, true, true, visibleMin, visibleMax, pixels);
+        pointsFinal = downsamplePoints(pointsFinal, true, true, true, true, visibleMin, visibleMax, pixels);
     }
 
-    // 清除现有series和轴
-    QList<QAbstractSeries*> series = m_resistivityChart->series();
-    for (QAbstractSeries* s : series) {
-        m_resistivityChart->removeSeries(s);
-        delete s;  // 显式删除series
-    }
-    QList<QAbstractAxis*> axes = m_resistivityChart->axes();
-    for (QAbstractAxis* axis : axes) {
-        m_resistivityChart->removeAxis(axis);
-        delete axis;
-    }
+    bool changed = replaceIfChanged(m_modelSeriesTrue, pointsTrue);
+    changed |= replaceIfChanged(m_modelSeriesInit, pointsInit);
+    changed |= replaceIfChanged(m_modelSeriesFinal, pointsFinal);
+    m_modelSeriesInit->setVisible(!pointsInit.isEmpty());
+    m_modelSeriesFinal->setVisible(!pointsFinal.isEmpty());
 
-    int nFreq = static_cast<int>(m_currentResult.periods.size());
+    // 放大状态下保持用户选择的深度范围
+    if (changed && !m_modelChart->isZoomed()) {
+        m_modelAxisY->setRange(minDepth, maxDepth);
+    }
+}
 
-    QLineSeries* seriesObs = new QLineSeries();
-    QLineSeries* seriesSyn = new QLineSeries();
-    QScatterSeries* scatterObs = new QScatterSeries();
-    QScatterSeries* scatterSyn = new QScatterSeries();
+void MTInversionGUI::createCurveSeries(QChart* chart, CurveSeries& curves,
+                                       QAbstractAxis* axisY) {
+    curves.obsLine = new QLineSeries();
+    curves.synLine = new QLineSeries();
+    curves.obsScatter = new QScatterSeries();
+    curves.synScatter = new QScatterSeries();
 
-    seriesObs->setName("观测数据");
-    seriesSyn->setName("合成数据");
-    scatterObs->setName("观测数据（散点）");
-    scatterSyn->setName("合成数据（散点）");
+    curves.obsLine->setName("观测数据");
+    curves.synLine->setName("合成数据");
+    curves.obsScatter->setName("观测数据（散点）");
+    curves.synScatter->setName("合成数据（散点）");
 
     // 使用更鲜明的颜色和不同的线条样式来区分曲线
     // 观测数据：深红色实线，较粗
     QPen penObs(QColor(200, 0, 0), 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
     // 合成数据：深蓝色虚线，较粗
     QPen penSyn(QColor(0, 0, 200), 3, Qt::DashLine, Qt::RoundCap, Qt::RoundJoin);
-    seriesObs->setPen(penObs);
-    seriesSyn->setPen(penSyn);
+    curves.obsLine->setPen(penObs);
+    curves.synLine->setPen(penSyn);
 
     // 观测数据：空心方框，稍大
-    scatterObs->setMarkerSize(6);
-    scatterObs->setMarkerShape(QScatterSeries::MarkerShapeRectangle);
-    scatterObs->setColor(Qt::white);  // 填充白色（看起来像空心）
-    scatterObs->setPen(QPen(QColor(200, 0, 0), 2));  // 边框为深红色，2像素宽
+    curves.obsScatter->setMarkerSize(6);
+    curves.obsScatter->setMarkerShape(QScatterSeries::MarkerShapeRectangle);
+    curves.obsScatter->setColor(Qt::white);  // 填充白色（看起来像空心）
+    curves.obsScatter->setPen(QPen(QColor(200, 0, 0), 2));  // 边框为深红色，2像素宽
     // 拟合数据：实心圆，稍小
-    scatterSyn->setMarkerSize(4);
-    scatterSyn->setMarkerShape(QScatterSeries::MarkerShapeCircle);
-    scatterSyn->setColor(QColor(0, 0, 200));  // 实心，填充深蓝色
-    scatterSyn->setPen(QPen(QColor(0, 0, 200), 1));  // 边框也为深蓝色
+    curves.synScatter->setMarkerSize(4);
+    curves.synScatter->setMarkerShape(QScatterSeries::MarkerShapeCircle);
+    curves.synScatter->setColor(QColor(0, 0, 200));  // 实心，填充深蓝色
+    curves.synScatter->setPen(QPen(QColor(0, 0, 200), 1));  // 边框也为深蓝色
 
-    for (int i = 0; i < nFreq; i++) {
-        if (i >= static_cast<int>(m_currentResult.periods.size())) break;
-        double period = m_currentResult.periods[i];
-        
-        // 检查数据索引是否有效
-        int idxRho = i * 2;
-        if (idxRho >= static_cast<int>(m_currentResult.dObs.size()) || 
-            idxRho >= static_cast<int>(m_currentResult.dSyn.size())) break;
-        
-        // 正演输出是log10(视电阻率)，需要转换为线性值
-        double rhoObs = pow(10.0, m_currentResult.dObs[idxRho]);
-        double rhoSyn = pow(10.0, m_currentResult.dSyn[idxRho]);
-        
-        // 检查NaN和Inf
-        if (!std::isfinite(rhoObs)) rhoObs = 0.1;
-        if (!std::isfinite(rhoSyn)) rhoSyn = 0.1;
-        // 确保值为正数
-        if (rhoObs <= 0.0) rhoObs = 0.1;
-        if (rhoSyn <= 0.0) rhoSyn = 0.1;
-
-        seriesObs->append(period, rhoObs);
-        seriesSyn->append(period, rhoSyn);
-        scatterObs->append(period, rhoObs);
-        scatterSyn->append(period, rhoSyn);
-    }
-
-    m_resistivityChart->addSeries(seriesObs);
-    m_resistivityChart->addSeries(seriesSyn);
-    m_resistivityChart->addSeries(scatterObs);
-    m_resistivityChart->addSeries(scatterSyn);
+    chart->addSeries(curves.obsLine);
+    chart->addSeries(curves.synLine);
+    chart->addSeries(curves.obsScatter);
+    chart->addSeries(curves.synScatter);
 
     // 设置坐标轴（对数坐标，固定范围）
     QLogValueAxis* axisX = new QLogValueAxis();
+    curves.axisX = axisX;
     axisX->setTitleText("周期 (s)");
     axisX->setLabelFormat("%.3f");
     axisX->setBase(10.0);
     axisX->setRange(0.001, 1000.0);  // 固定范围：0.001s 到 1000s
-    m_resistivityChart->addAxis(axisX, Qt::AlignBottom);
-    seriesObs->attachAxis(axisX);
-    seriesSyn->attachAxis(axisX);
-    scatterObs->attachAxis(axisX);
-    scatterSyn->attachAxis(axisX);
-
-    QLogValueAxis* axisY = new QLogValueAxis();
-    axisY->setTitleText("视电阻率 (Ω·m)");
-    axisY->setLabelFormat("%.1e");
-    axisY->setBase(10.0);
-    axisY->setRange(0.1, 10000.0);  // 固定范围：0.1 Ω·m 到 10000 Ω·m
-    m_resistivityChart->addAxis(axisY, Qt::AlignLeft);
-    seriesObs->attachAxis(axisY);
-    seriesSyn->attachAxis(axisY);
-    scatterObs->attachAxis(axisY);
-    scatterSyn->attachAxis(axisY);
-
-    m_resistivityChart->legend()->setVisible(true);
-    m_resistivityChart->legend()->setAlignment(Qt::AlignBottom);
-    
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+
+    for (QXYSeries* s : {static_cast<QXYSeries*>(curves.obsLine), static_cast<QXYSeries*>(curves.synLine),
+                         static_cast<QXYSeries*>(curves.obsScatter), static_cast<QXYSeries*>(curves.synScatter)}) {
+        s->attachAxis(axisX);
+        s->attachAxis(axisY);
+    }
+
+    connect(axisX, &QLogValueAxis::rangeChanged, this, &MTInversionGUI::onChartViewportChanged);
+
+    chart->legend()->setVisible(true);
+    chart->legend()->setAlignment(Qt::AlignBottom);
+
     // 隐藏散点图的图例，只显示线条图例
-    QLegend* legend = m_resistivityChart->legend();
-    if (legend) {
-        QList<QLegendMarker*> markers = legend->markers();
-        for (QLegendMarker* marker : markers) {
-            if (marker->series() == scatterObs || marker->series() == scatterSyn) {
-                marker->setVisible(false);
-            }
-        }
+    hideLegendMarker(chart, curves.obsScatter);
+    hideLegendMarker(chart, curves.synScatter);
+}
+
+void MTInversionGUI::updateCurveSeries(QChart* chart, CurveSeries& curves,
+                                       QList<QPointF> obs, QList<QPointF> syn, bool logY) {
+    if (m_downsampling) {
+        // 在周期轴的可见范围内按像素列做LTTB降采样
+        int pixels = plotPixels(chart, Qt::Horizontal);
+        double visibleMin = curves.axisX->min();
+        double visibleMax = curves.axisX->max();
+        obs = downsamplePoints(obs, false, false, true, logY, visibleMin, visibleMax, pixels);
+        syn = downsamplePoints(syn, false, false, true, logY, visibleMin, visibleMax, pixels);
     }
+
+    // 折线和散点使用相同的数据
+    replaceIfChanged(curves.obsLine, obs);
+    replaceIfChanged(curves.obsScatter, obs);
+    replaceIfChanged(curves.synLine, syn);
+    replaceIfChanged(curves.synScatter, syn);
 }
 
-void MTInversionGUI::updatePhaseChart() {
-    if (m_currentResult.periods.empty() || !m_currentResult.success) {
+void MTInversionGUI::updateResistivityChart() {
+    if (m_currentResult->periods.empty() || !hasDisplayableResult()) {
         return;
     }
 
-    // 清除现有series和轴
-    QList<QAbstractSeries*> series = m_phaseChart->series();
-    for (QAbstractSeries* s : series) {
-        m_phaseChart->removeSeries(s);
-        delete s;  // 显式删除series
-    }
-    QList<QAbstractAxis*> axes = m_phaseChart->axes();
-    for (QAbstractAxis* axis : axes) {
-        m_phaseChart->removeAxis(axis);
-        delete axis;
+    QScopedValueRollback<bool> updating(m_updatingCharts, true);
+    int nFreq = static_cast<int>(m_currentResult->periods.size());
+
+    // 数据中没有视电阻率分量（如只有阻抗实部/虚部）时清空并禁用该图
+    size_t offset = 0, stride = 0;
+    double shift = 0.0;
+    bool available = curveLayout(*m_currentResult, false, offset, stride, shift);
+    m_resistivityChartView->setEnabled(available);
+    if (!available) {
+        clearChart(m_resistivityChart);
+        m_resistivityCurves = CurveSeries();
+        return;
     }
 
-    int nFreq = static_cast<int>(m_currentResult.periods.size());
+    QList<QPointF> pointsObs, pointsSyn;
+    pointsObs.reserve(nFreq);
+    pointsSyn.reserve(nFreq);
+    for (int i = 0; i < nFreq; i++) {
+        double period = m_currentResult->periods[i];
 
-    QLineSeries* seriesObs = new QLineSeries();
-    QLineSeries* seriesSyn = new QLineSeries();
-    QScatterSeries* scatterObs = new QScatterSeries();
-    QScatterSeries* scatterSyn = new QScatterSeries();
+        // 检查数据索引是否有效（反演进行中且未提供观测数据时只有合成数据）
+        size_t idxRho = offset + i * stride;
+        if (idxRho >= m_currentResult->dSyn.size()) break;
 
-    seriesObs->setName("观测数据");
-    seriesSyn->setName("合成数据");
-    scatterObs->setName("观测数据（散点）");
-    scatterSyn->setName("合成数据（散点）");
+        // 正演输出是log10(视电阻率)，需要转换为线性值
+        double rhoSyn = pow(10.0, m_currentResult->dSyn[idxRho]);
+        // 检查NaN和Inf，确保值为正数
+        if (!std::isfinite(rhoSyn) || rhoSyn <= 0.0) rhoSyn = 0.1;
+        pointsSyn << QPointF(period, rhoSyn);
+
+        if (idxRho < m_currentResult->dObs.size()) {
+            double rhoObs = pow(10.0, m_currentResult->dObs[idxRho]);
+            if (!std::isfinite(rhoObs) || rhoObs <= 0.0) rhoObs = 0.1;
+            pointsObs << QPointF(period, rhoObs);
+        }
+    }
 
-    // 使用更鲜明的颜色和不同的线条样式来区分曲线
-    // 观测数据：深红色实线，较粗
-    QPen penObs(QColor(200, 0, 0), 3, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
-    // 合成数据：深蓝色虚线，较粗
-    QPen penSyn(QColor(0, 0, 200), 3, Qt::DashLine, Qt::RoundCap, Qt::RoundJoin);
-    seriesObs->setPen(penObs);
-    seriesSyn->setPen(penSyn);
+    // 非持久化模式：每次刷新都重建series和坐标轴
+    if (!m_persistentSeries) {
+        clearChart(m_resistivityChart);
+        m_resistivityCurves = CurveSeries();
+    }
+    if (!m_resistivityCurves.obsLine) {
+        QLogValueAxis* axisY = new QLogValueAxis();
+        axisY->setTitleText("视电阻率 (Ω·m)");
+        axisY->setLabelFormat("%.1e");
+        axisY->setBase(10.0);
+        axisY->setRange(0.1, 10000.0);  // 固定范围：0.1 Ω·m 到 10000 Ω·m
+        createCurveSeries(m_resistivityChart, m_resistivityCurves, axisY);
+    }
+    updateCurveSeries(m_resistivityChart, m_resistivityCurves, pointsObs, pointsSyn, true);
+}
 
-    // 观测数据：空心方框，稍大
-    scatterObs->setMarkerSize(6);
-    scatterObs->setMarkerShape(QScatterSeries::MarkerShapeRectangle);
-    scatterObs->setColor(Qt::white);  // 填充白色（看起来像空心）
-    scatterObs->setPen(QPen(QColor(200, 0, 0), 2));  // 边框为深红色，2像素宽
-    // 拟合数据：实心圆，稍小
-    scatterSyn->setMarkerSize(4);
-    scatterSyn->setMarkerShape(QScatterSeries::MarkerShapeCircle);
-    scatterSyn->setColor(QColor(0, 0, 200));  // 实心，填充深蓝色
-    scatterSyn->setPen(QPen(QColor(0, 0, 200), 1));  // 边框也为深蓝色
+void MTInversionGUI::updatePhaseChart() {
+    if (m_currentResult->periods.empty() || !hasDisplayableResult()) {
+        return;
+    }
 
+    QScopedValueRollback<bool> updating(m_updatingCharts, true);
+    int nFreq = static_cast<int>(m_currentResult->periods.size());
+
+    // 数据中没有相位分量时清空并禁用该图
+    size_t offset = 0, stride = 0;
+    double shift = 0.0;
+    bool available = curveLayout(*m_currentResult, true, offset, stride, shift);
+    m_phaseChartView->setEnabled(available);
+    if (!available) {
+        clearChart(m_phaseChart);
+        m_phaseCurves = CurveSeries();
+        return;
+    }
+
+    QList<QPointF> pointsObs, pointsSyn;
+    pointsObs.reserve(nFreq);
+    pointsSyn.reserve(nFreq);
     for (int i = 0; i < nFreq; i++) {
-        if (i >= static_cast<int>(m_currentResult.periods.size())) break;
-        double period = m_currentResult.periods[i];
-        
-        // 检查数据索引是否有效
-        int idxPhase = i * 2 + 1;
-        if (idxPhase >= static_cast<int>(m_currentResult.dObs.size()) || 
-            idxPhase >= static_cast<int>(m_currentResult.dSyn.size())) break;
-        
-        // 正演输出相位是度数
-        double phaseObs = m_currentResult.dObs[idxPhase];
-        double phaseSyn = m_currentResult.dSyn[idxPhase];
-        
-        // 检查NaN和Inf
-        if (!std::isfinite(phaseObs)) phaseObs = 0.0;
+        double period = m_currentResult->periods[i];
+
+        // 检查数据索引是否有效（反演进行中且未提供观测数据时只有合成数据）
+        size_t idxPhase = offset + i * stride;
+        if (idxPhase >= m_currentResult->dSyn.size()) break;
+
+        // 正演输出相位是度数；检查NaN和Inf
+        double phaseSyn = m_currentResult->dSyn[idxPhase] + shift;
         if (!std::isfinite(phaseSyn)) phaseSyn = 0.0;
+        pointsSyn << QPointF(period, phaseSyn);
 
-        seriesObs->append(period, phaseObs);
-        seriesSyn->append(period, phaseSyn);
-        scatterObs->append(period, phaseObs);
-        scatterSyn->append(period, phaseSyn);
+        if (idxPhase < m_currentResult->dObs.size()) {
+            double phaseObs = m_currentResult->dObs[idxPhase] + shift;
+            if (!std::isfinite(phaseObs)) phaseObs = 0.0;
+            pointsObs << QPointF(period, phaseObs);
+        }
     }
 
-    m_phaseChart->addSeries(seriesObs);
-    m_phaseChart->addSeries(seriesSyn);
-    m_phaseChart->addSeries(scatterObs);
-    m_phaseChart->addSeries(scatterSyn);
+    // 非持久化模式：每次刷新都重建series和坐标轴
+    if (!m_persistentSeries) {
+        clearChart(m_phaseChart);
+        m_phaseCurves = CurveSeries();
+    }
+    if (!m_phaseCurves.obsLine) {
+        QValueAxis* axisY = new QValueAxis();
+        axisY->setTitleText("相位 (度)");
+        axisY->setLabelFormat("%.1f");
+        axisY->setRange(0.0, 90.0);  // 固定范围：0° 到 90°
+        createCurveSeries(m_phaseChart, m_phaseCurves, axisY);
+    }
+    updateCurveSeries(m_phaseChart, m_phaseCurves, pointsObs, pointsSyn, false);
+}
 
-    // 设置坐标轴（固定范围）
-    QLogValueAxis* axisX = new QLogValueAxis();
-    axisX->setTitleText("周期 (s)");
-    axisX->setLabelFormat("%.3f");
-    axisX->setBase(10.0);
-    axisX->setRange(0.001, 1000.0);  // 固定范围：0.001s 到 1000s
-    m_phaseChart->addAxis(axisX, Qt::AlignBottom);
-    seriesObs->attachAxis(axisX);
-    seriesSyn->attachAxis(axisX);
-    scatterObs->attachAxis(axisX);
-    scatterSyn->attachAxis(axisX);
-
-    QValueAxis* axisY = new QValueAxis();
-    axisY->setTitleText("相位 (度)");
-    axisY->setLabelFormat("%.1f");
-    axisY->setRange(0.0, 90.0);  // 固定范围：0° 到 90°
-    m_phaseChart->addAxis(axisY, Qt::AlignLeft);
-    seriesObs->attachAxis(axisY);
-    seriesSyn->attachAxis(axisY);
-    scatterObs->attachAxis(axisY);
-    scatterSyn->attachAxis(axisY);
-
-    m_phaseChart->legend()->setVisible(true);
-    m_phaseChart->legend()->setAlignment(Qt::AlignBottom);
-    
-    // 隐藏散点图的图例，只显示线条图例
-    QLegend* legend = m_phaseChart->legend();
-    if (legend) {
-        QList<QLegendMarker*> markers = legend->markers();
-        for (QLegendMarker* marker : markers) {
-            if (marker->series() == scatterObs || marker->series() == scatterSyn) {
-                marker->setVisible(false);
-            }
-        }
+void MTInversionGUI::createResidualSeries() {
+    m_residualSeries = new QLineSeries();
+    m_residualSeries->setName("残差");
+    m_residualSeries->setPen(QPen(Qt::red, 2));
+
+    m_dmNormSeries = new QLineSeries();
+    m_dmNormSeries->setName("模型更新范数");
+    m_dmNormSeries->setPen(QPen(Qt::blue, 2, Qt::DashLine));
+
+    m_residualChart->addSeries(m_residualSeries);
+    m_residualChart->addSeries(m_dmNormSeries);
+
+    m_residualAxisX = new QValueAxis();
+    m_residualAxisX->setTitleText("迭代次数");
+    m_residualAxisX->setLabelFormat("%d");
+    m_residualChart->addAxis(m_residualAxisX, Qt::AlignBottom);
+
+    m_residualAxisY = new QLogValueAxis();
+    m_residualAxisY->setTitleText("数值");
+    m_residualAxisY->setLabelFormat("%.2e");
+    m_residualAxisY->setBase(10.0);
+    m_residualChart->addAxis(m_residualAxisY, Qt::AlignLeft);
+
+    for (QLineSeries* s : {m_residualSeries, m_dmNormSeries}) {
+        s->attachAxis(m_residualAxisX);
+        s->attachAxis(m_residualAxisY);
     }
+
+    // 设置图例
+    m_residualChart->legend()->setVisible(true);
+    m_residualChart->legend()->setAlignment(Qt::AlignTop);
 }
 
 void MTInversionGUI::updateResidualChart() {
@@ -1017,142 +1393,76 @@ void MTInversionGUI::updateResidualChart() {
     if (!m_residualChart) {
         return;
     }
-    
-    // 清除现有series和轴
-    QList<QAbstractSeries*> series = m_residualChart->series();
-    for (QAbstractSeries* s : series) {
-        m_residualChart->removeSeries(s);
-        delete s;
-    }
-    QList<QAbstractAxis*> axes = m_residualChart->axes();
-    for (QAbstractAxis* axis : axes) {
-        m_residualChart->removeAxis(axis);
-        delete axis;
-    }
-
-    // 检查是否有数据
-    if (m_currentResult.residualHistory.empty() && m_currentResult.dmNormHistory.empty()) {
-        return;
-    }
-
-    // 创建series
-    QLineSeries* seriesResidual = new QLineSeries();
-    seriesResidual->setName("残差");
-    seriesResidual->setPen(QPen(Qt::red, 2));
-    
-    QLineSeries* seriesDmNorm = new QLineSeries();
-    seriesDmNorm->setName("模型更新范数");
-    seriesDmNorm->setPen(QPen(Qt::blue, 2, Qt::DashLine));
 
     // 收集所有数据点并计算范围
     int maxIter = 0;
     double minYValue = std::numeric_limits<double>::max();
     double maxYValue = std::numeric_limits<double>::lowest();
-    bool hasAnyData = false;
+    QList<QPointF> pointsResidual, pointsDmNorm;
 
     // 处理残差数据
-    if (!m_currentResult.residualHistory.empty()) {
-        for (size_t i = 0; i < m_currentResult.residualHistory.size(); i++) {
-            double val = m_currentResult.residualHistory[i];
-            if (std::isfinite(val) && val > 0.0) {
-                int iter = static_cast<int>(i + 1);
-                seriesResidual->append(iter, val);
-                maxIter = std::max(maxIter, iter);
-                minYValue = std::min(minYValue, val);
-                maxYValue = std::max(maxYValue, val);
-                hasAnyData = true;
-            }
+    for (size_t i = 0; i < m_currentResult->residualHistory.size(); i++) {
+        double val = m_currentResult->residualHistory[i];
+        if (std::isfinite(val) && val > 0.0) {
+            int iter = static_cast<int>(i + 1);
+            pointsResidual << QPointF(iter, val);
+            maxIter = std::max(maxIter, iter);
+            minYValue = std::min(minYValue, val);
+            maxYValue = std::max(maxYValue, val);
         }
     }
 
     // 处理模型更新范数数据
-    if (!m_currentResult.dmNormHistory.empty()) {
-        for (size_t i = 0; i < m_currentResult.dmNormHistory.size(); i++) {
-            double val = m_currentResult.dmNormHistory[i];
-            if (std::isfinite(val) && val >= 0.0) {
-                int iter = static_cast<int>(i + 1);
-                seriesDmNorm->append(iter, val);
-                maxIter = std::max(maxIter, iter);
-                if (val > 0.0) {
-                    minYValue = std::min(minYValue, val);
-                }
-                maxYValue = std::max(maxYValue, val);
-                hasAnyData = true;
+    for (size_t i = 0; i < m_currentResult->dmNormHistory.size(); i++) {
+        double val = m_currentResult->dmNormHistory[i];
+        if (std::isfinite(val) && val >= 0.0) {
+            int iter = static_cast<int>(i + 1);
+            pointsDmNorm << QPointF(iter, val);
+            maxIter = std::max(maxIter, iter);
+            if (val > 0.0) {
+                minYValue = std::min(minYValue, val);
             }
+            maxYValue = std::max(maxYValue, val);
         }
     }
 
-    // 如果没有数据，清理并返回
-    if (!hasAnyData || maxIter == 0) {
-        delete seriesResidual;
-        delete seriesDmNorm;
+    // 非持久化模式：每次刷新都重建series和坐标轴
+    if (!m_persistentSeries) {
+        clearChart(m_residualChart);
+        m_residualSeries = nullptr;
+    }
+
+    // 如果没有数据，清空曲线并返回
+    if (maxIter == 0) {
+        if (m_residualSeries) {
+            replaceIfChanged(m_residualSeries, pointsResidual);
+            replaceIfChanged(m_dmNormSeries, pointsDmNorm);
+        }
         return;
     }
 
-    // 添加series到图表
-    if (seriesResidual->count() > 0) {
-        m_residualChart->addSeries(seriesResidual);
-    } else {
-        delete seriesResidual;
-        seriesResidual = nullptr;
+    if (!m_residualSeries) {
+        createResidualSeries();
     }
-    
-    if (seriesDmNorm->count() > 0) {
-        m_residualChart->addSeries(seriesDmNorm);
-    } else {
-        delete seriesDmNorm;
-        seriesDmNorm = nullptr;
+
+    bool changed = replaceIfChanged(m_residualSeries, pointsResidual);
+    changed |= replaceIfChanged(m_dmNormSeries, pointsDmNorm);
+    m_residualSeries->setVisible(!pointsResidual.isEmpty());
+    m_dmNormSeries->setVisible(!pointsDmNorm.isEmpty());
+    if (!changed) {
+        return;
     }
 
-    // 设置X轴 - 自适应范围
-    QValueAxis* axisX = new QValueAxis();
-    axisX->setTitleText("迭代次数");
-    axisX->setLabelFormat("%d");
+    // 设置X轴 - 自适应范围（添加右边距）
     int xMin = 1;
-    int xMax = maxIter;
-    if (xMax < xMin) xMax = xMin;
-    // 添加右边距
-    xMax = xMax + 1;
-    axisX->setRange(xMin, xMax);
-    axisX->setTickCount(std::min(11, std::max(3, xMax - xMin + 1)));
-    m_residualChart->addAxis(axisX, Qt::AlignBottom);
-    if (seriesResidual) seriesResidual->attachAxis(axisX);
-    if (seriesDmNorm) seriesDmNorm->attachAxis(axisX);
-
-    // 设置Y轴 - 自适应范围（对数坐标）
-    double yMin = minYValue;
-    double yMax = maxYValue;
-    
-    // // 确保范围有效
-    // if (yMin <= 0.0 || yMin < yMax * 0.001) {
-    //     yMin = yMax * 0.001;
-    // }
-    // if (yMin < 1e-10) {
-    //     yMin = 1e-10;
-    // }
-    
-    // 添加边距
-    yMax = yMax * 1.2;
-    yMin = yMin / 1.2;
-    
-    // // 确保yMax > yMin
-    // if (yMax <= yMin) {
-    //     yMax = yMin * 10.0;
-    // }
-    // qDebug() << "yMin: " << yMin << "yMax: " << yMax;
-
-    QLogValueAxis* axisY = new QLogValueAxis();
-    axisY->setTitleText("数值");
-    axisY->setLabelFormat("%.2e");
-    axisY->setBase(10.0);
-    axisY->setRange(yMin, yMax);
-    m_residualChart->addAxis(axisY, Qt::AlignLeft);
-    if (seriesResidual) seriesResidual->attachAxis(axisY);
-    if (seriesDmNorm) seriesDmNorm->attachAxis(axisY);
-
-    // 设置图例
-    m_residualChart->legend()->setVisible(true);
-    m_residualChart->legend()->setAlignment(Qt::AlignTop);
+    int xMax = std::max(xMin, maxIter) + 1;
+    m_residualAxisX->setRange(xMin, xMax);
+    m_residualAxisX->setTickCount(std::min(11, std::max(3, xMax - xMin + 1)));
+
+    // 设置Y轴 - 自适应范围（对数坐标，添加边距）
+    double yMax = maxYValue * 1.2;
+    double yMin = minYValue / 1.2;
+    m_residualAxisY->setRange(yMin, yMax);
 }
 
 // 主函数
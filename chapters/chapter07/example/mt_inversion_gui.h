@@ -19,13 +19,24 @@
 #include <QSplitter>
 #include <QTabWidget>
 #include <QPointer>
+#include <QCheckBox>
+#include <QFutureWatcher>
 #include <QtCharts/QChartView>
 #include <QtCharts/QChart>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QLogValueAxis>
 #include <QtCharts/QScatterSeries>
+#include <QList>
+#include <QPointF>
 #include "mt_inversion_core.h"
+#include "mt_snapshot_buffer.h"
+#include "mt_survey_dashboard.h"
+#include "mt_plot_downsampler.h"
+#include "mt_random_model_preview.h"
+
+// 完成信号跨线程（排队连接）传递共享结果，只复制引用计数指针
+Q_DECLARE_METATYPE(MT::SharedInversionResult)
 
 /**
  * 反演工作线程
@@ -40,7 +51,16 @@ public:
                          QObject* parent = nullptr)
         : QThread(parent), m_core(core), m_params(params), m_shouldStop(false) {}
 
-    MTInversionCore::InversionResult getResult() const { return m_result; }
+    // 获取反演结果（共享的只读结果，不复制数据；反演完成前为空）
+    MT::SharedInversionResult getResult() const { return m_result; }
+
+    // 取出最新的模型快照（只在界面线程中调用，不会阻塞工作线程）
+    // 返回是否有新快照；snapshot在下一次调用之前保持有效
+    bool latestSnapshot(const MT::InversionSnapshot*& snapshot) {
+        bool updated = m_snapshots.update();
+        snapshot = &m_snapshots.read();
+        return updated;
+    }
     
     // 请求停止线程（优雅停止）
     void requestStop() {
@@ -49,7 +69,7 @@ public:
 
 signals:
     void progressUpdated(int iteration, double residual, double dmNorm);
-    void inversionFinished(const MTInversionCore::InversionResult& result);
+    void inversionFinished(MT::SharedInversionResult result);
 
 protected:
     void run() override {
@@ -61,14 +81,32 @@ protected:
             }
         }, this);
 
-        // 执行反演
+        // 设置模型快照回调：写入三缓冲后立即返回，由界面按固定帧率拉取
+        m_core->setModelCallback([](int iter, double res, const std::vector<double>& m,
+                                    const std::vector<double>& dSyn, void* data) {
+            InversionWorkerThread* thread = static_cast<InversionWorkerThread*>(data);
+            if (thread && !thread->m_shouldStop) {
+                MT::InversionSnapshot& snapshot = thread->m_snapshots.writeBuffer();
+                snapshot.iteration = iter;
+                snapshot.residual = res;
+                snapshot.mCurrent.assign(m.begin(), m.end());  // 复用缓冲区内存
+                snapshot.dSyn.assign(dSyn.begin(), dSyn.end());
+                thread->m_snapshots.publish();
+            }
+        }, this);
+
+        // 执行反演（结果移动到共享对象中，之后只读）
         if (!m_shouldStop) {
-            m_result = m_core->invert(m_params);
+            m_result = m_core->invertShared(m_params);
         } else {
-            m_result.success = false;
-            m_result.errorMessage = "反演被用户取消";
+            MTInversionCore::InversionResult cancelled;
+            cancelled.success = false;
+            cancelled.errorMessage = "反演被用户取消";
+            m_result = std::make_shared<const MTInversionCore::InversionResult>(std::move(cancelled));
         }
 
+        m_core->setModelCallback(nullptr, nullptr);
+
         // 发送完成信号
         if (!m_shouldStop) {
             emit inversionFinished(m_result);
@@ -78,8 +116,9 @@ protected:
 private:
     MTInversionCore* m_core;
     MTInversionCore::InversionParams m_params;
-    MTInversionCore::InversionResult m_result;
+    MT::SharedInversionResult m_result;
     volatile bool m_shouldStop;  // 停止标志（使用volatile确保多线程可见性）
+    MT::SnapshotBuffer<MT::InversionSnapshot> m_snapshots;  // 每次迭代的模型快照
 };
 
 /**
@@ -92,13 +131,29 @@ public:
     explicit MTInversionGUI(QWidget *parent = nullptr);
     ~MTInversionGUI();
 
+    // 设置持久化序列模式（默认开启）：series和坐标轴只创建一次，
+    // 刷新时用replace()原位更新，且只重绘数据有变化的图表；关闭时每次刷新重建
+    void setPersistentSeries(bool enabled);
+    bool isPersistentSeries() const { return m_persistentSeries; }
+
+    // 设置绘图降采样（默认开启）：按绘图区像素尺寸抽稀模型剖面和响应曲线，
+    // 窗口缩放或框选放大后重新抽稀可见范围；关闭时绘制全部点
+    void setDownsampling(bool enabled);
+    bool isDownsampling() const { return m_downsampling; }
+
 private slots:
     void onStartInversion();
     void onStopInversion();
     void onGenerateRandomModel();
+    void onRandomParametersChanged();      // 随机模型参数变化（防抖后自动重新生成）
+    void onRandomModelsReady();            // 后台随机模型生成完成
+    void applyRandomCandidate(const RandomModelCandidate& candidate);
+    void onOpenSurveyDashboard();          // 打开测区批量反演面板
+    void onSurveyResultSelected(const MT::SharedInversionResult& result);
     void onProgressUpdated(int iteration, double residual, double dmNorm);
-    void onInversionFinished(const MTInversionCore::InversionResult& result);
+    void onInversionFinished(const MT::SharedInversionResult& result);
     void updatePlot();
+    void onChartViewportChanged();         // 绘图区尺寸或坐标范围变化
 
 private:
     void setupUI();
@@ -106,7 +161,20 @@ private:
     void setupResultPanel();
     void setupPlotPanel();
     void updateResultTable(const MTInversionCore::InversionResult& result);
-    void updatePlotData(const MTInversionCore::InversionResult& result);
+    void updatePlotData(const MT::SharedInversionResult& result);
+
+    // 设置当前显示的结果（共享，不复制）
+    void setCurrentResult(const MT::SharedInversionResult& result);
+
+    // 取得可修改的当前结果（进度历史、迭代快照、随机模型）：
+    // 当前结果是共享的只读结果时先复制一份（写时复制），之后的修改不再复制
+    MTInversionCore::InversionResult& editableResult();
+
+    // 当前结果是否可绘制：反演成功，或反演进行中（显示最新快照）
+    bool hasDisplayableResult() const;
+
+    // 反演开始时按本次参数准备实时显示的结果（频率、层网格、观测数据，清空上次的模型和合成数据）
+    void prepareLiveResult(const MTInversionCore::InversionParams& params);
 
     // 图表更新函数
     void updateModelChart();
@@ -117,11 +185,28 @@ private:
     // 清除图表
     void clearCharts();
 
+    // 观测/合成数据曲线（视电阻率和相位图表共用的结构）
+    struct CurveSeries {
+        QLineSeries* obsLine = nullptr;
+        QLineSeries* synLine = nullptr;
+        QScatterSeries* obsScatter = nullptr;
+        QScatterSeries* synScatter = nullptr;
+        QLogValueAxis* axisX = nullptr;   // 周期轴（降采样按其可见范围）
+    };
+
+    // 创建图表的series和坐标轴（持久化模式下只调用一次）
+    void createModelSeries();
+    void createCurveSeries(QChart* chart, CurveSeries& curves, QAbstractAxis* axisY);
+    void createResidualSeries();
+    void updateCurveSeries(QChart* chart, CurveSeries& curves,
+                           QList<QPointF> obs, QList<QPointF> syn, bool logY);
+
     // UI组件
     QGroupBox* m_paramGroup;
     QSpinBox* m_spinMLayers;
     QSpinBox* m_spinNFreq;
     QDoubleSpinBox* m_spinLambda;
+    QCheckBox* m_chkOccam;             // Occam反演（自动搜索λ）
     QDoubleSpinBox* m_spinEpsilon;
     QSpinBox* m_spinMaxIter;
     QDoubleSpinBox* m_spinTolDm;
@@ -129,6 +214,9 @@ private:
     QPushButton* m_btnStart;
     QPushButton* m_btnStop;
     QPushButton* m_btnGenerateRandom;
+    QPushButton* m_btnSurvey;
+    QSpinBox* m_spinCandidates;        // 并行生成的候选模型数
+    QCheckBox* m_chkAutoPreview;       // 参数变化时自动重新生成
     QProgressBar* m_progressBar;
     QLabel* m_statusLabel;
 
@@ -152,13 +240,42 @@ private:
     QChart* m_residualChart;              // 残差下降曲线图
     QChartView* m_residualChartView;       // 残差图表视图
 
+    // 持久化的series和坐标轴
+    bool m_persistentSeries;
+    QLineSeries* m_modelSeriesTrue;
+    QLineSeries* m_modelSeriesInit;
+    QLineSeries* m_modelSeriesFinal;
+    QLogValueAxis* m_modelAxisY;
+    CurveSeries m_resistivityCurves;
+    CurveSeries m_phaseCurves;
+    QLineSeries* m_residualSeries;
+    QLineSeries* m_dmNormSeries;
+    QValueAxis* m_residualAxisX;
+    QLogValueAxis* m_residualAxisY;
+
+    // 绘图降采样
+    bool m_downsampling;
+    bool m_updatingCharts;             // 正在更新图表（忽略更新过程中自身触发的范围变化）
+    QTimer* m_lodTimer;                // 合并连续的缩放/框选事件
+
     // 核心计算对象
     MTInversionCore* m_core;
     QPointer<InversionWorkerThread> m_workerThread;  // 使用QPointer自动管理线程指针
+    QPointer<SurveyDashboard> m_surveyDashboard;     // 测区批量反演面板（独立窗口）
+
+    // 随机模型异步生成
+    QFutureWatcher<RandomModelCandidate>* m_randomWatcher;
+    QTimer* m_randomDebounceTimer;                   // 参数连续变化时只生成一次
+    QPointer<RandomModelPreview> m_randomPreview;    // 候选模型预览窗口
+    static constexpr int RANDOM_DEBOUNCE_MS = 300;
 
     // 数据存储
-    MTInversionCore::InversionResult m_currentResult;
+    MT::SharedInversionResult m_currentResult;                     // 当前显示的结果（始终非空）
+    std::shared_ptr<MTInversionCore::InversionResult> m_editableResult;  // 界面自己修改的结果（与m_currentResult相同时可原位修改）
+    bool m_inversionRunning;           // 反演进行中（图表显示工作线程发布的快照）
+    int m_runningM;                    // 进行中反演的模型层数（快照大小与之一致才采用）
     QTimer* m_plotTimer;
+    static constexpr int PLOT_FRAME_INTERVAL_MS = 50;  // 图表刷新间隔（20帧/秒）
 };
 
 #endif // MT_INVERSION_GUI_H
@@ -0,0 +1,1115 @@
+#include "mt_inversion_server.h"
+#include "mt_inversion_core.h"
+#include "mt_thread_policy.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace MT {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 回送RESULT等必须送达的帧时的阻塞写超时（秒）
+const int SEND_TIMEOUT_SECONDS = 10;
+
+double elapsedMs(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+// 负载写入：定长字段直接按主机字节序（小端）拷贝
+class PayloadWriter {
+public:
+    explicit PayloadWriter(std::vector<unsigned char>& out) : m_out(out) { m_out.clear(); }
+
+    void putU32(uint32_t value) { putRaw(&value, sizeof(value)); }
+    void putU64(uint64_t value) { putRaw(&value, sizeof(value)); }
+    void putF64(double value) { putRaw(&value, sizeof(value)); }
+
+    void putString(const std::string& value) {
+        putU32(static_cast<uint32_t>(value.size()));
+        putRaw(value.data(), value.size());
+    }
+
+    void putArray(const std::vector<double>& values) {
+        putU32(static_cast<uint32_t>(values.size()));
+        putRaw(values.data(), values.size() * sizeof(double));
+    }
+
+private:
+    void putRaw(const void* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        size_t offset = m_out.size();
+        m_out.resize(offset + size);
+        memcpy(m_out.data() + offset, data, size);
+    }
+
+    std::vector<unsigned char>& m_out;
+};
+
+// 负载读取：越界时置失败标志，之后的读取都返回0/空
+class PayloadReader {
+public:
+    explicit PayloadReader(const std::vector<unsigned char>& in) : m_in(in), m_pos(0), m_ok(true) {}
+
+    uint32_t getU32() { uint32_t value = 0; getRaw(&value, sizeof(value)); return value; }
+    uint64_t getU64() { uint64_t value = 0; getRaw(&value, sizeof(value)); return value; }
+    double getF64() { double value = 0.0; getRaw(&value, sizeof(value)); return value; }
+
+    std::string getString() {
+        uint32_t size = getU32();
+        if (!m_ok || size > m_in.size() - m_pos) {
+            m_ok = false;
+            return std::string();
+        }
+        std::string value(reinterpret_cast<const char*>(m_in.data() + m_pos), size);
+        m_pos += size;
+        return value;
+    }
+
+    std::vector<double> getArray() {
+        uint32_t count = getU32();
+        if (!m_ok || count > (m_in.size() - m_pos) / sizeof(double)) {
+            m_ok = false;
+            return std::vector<double>();
+        }
+        std::vector<double> values(count);
+        getRaw(values.data(), count * sizeof(double));
+        return values;
+    }
+
+    // 全部读完且没有越界
+    bool finished() const { return m_ok && m_pos == m_in.size(); }
+
+private:
+    void getRaw(void* data, size_t size) {
+        if (!m_ok || size > m_in.size() - m_pos) {
+            m_ok = false;
+            return;
+        }
+        memcpy(data, m_in.data() + m_pos, size);
+        m_pos += size;
+    }
+
+    const std::vector<unsigned char>& m_in;
+    size_t m_pos;
+    bool m_ok;
+};
+
+bool allFinitePositive(const std::vector<double>& values) {
+    for (double v : values) {
+        if (!std::isfinite(v) || v <= 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 数据分量：uint32个数 + 每个分量的枚举值（uint32）
+void putComponents(PayloadWriter& writer, const std::vector<DataComponent>& components) {
+    writer.putU32(static_cast<uint32_t>(components.size()));
+    for (DataComponent component : components) {
+        writer.putU32(static_cast<uint32_t>(component));
+    }
+}
+
+bool getComponents(PayloadReader& reader, std::vector<DataComponent>& components) {
+    uint32_t count = reader.getU32();
+    if (count > static_cast<uint32_t>(DataComponent::PHASE_DET) + 1) {
+        return false;
+    }
+    components.resize(count);
+    for (uint32_t c = 0; c < count; c++) {
+        uint32_t value = reader.getU32();
+        if (value > static_cast<uint32_t>(DataComponent::PHASE_DET)) {
+            return false;
+        }
+        components[c] = static_cast<DataComponent>(value);
+    }
+    return true;
+}
+
+bool readFully(int fd, void* data, size_t size) {
+    unsigned char* bytes = static_cast<unsigned char*>(data);
+    while (size > 0) {
+        ssize_t n = recv(fd, bytes, size, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeFully(int fd, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    while (size > 0) {
+        ssize_t n = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        bytes += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeFrame(int fd, Protocol::MessageType type, uint32_t requestId,
+                const std::vector<unsigned char>& payload) {
+    Protocol::FrameHeader header;
+    header.type = type;
+    header.requestId = requestId;
+    header.payloadSize = static_cast<uint32_t>(payload.size());
+    unsigned char buffer[Protocol::HEADER_SIZE];
+    Protocol::encodeHeader(header, buffer);
+    return writeFully(fd, buffer, sizeof(buffer))
+           && (payload.empty() || writeFully(fd, payload.data(), payload.size()));
+}
+
+// 非阻塞写一帧：发送缓冲区放不下时一个字节都不写，返回false（帧整体丢弃，不会留下半帧）
+bool tryWriteFrame(int fd, Protocol::MessageType type, uint32_t requestId,
+                   const std::vector<unsigned char>& payload) {
+    pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, 0) != 1 || (pfd.revents & POLLOUT) == 0) {
+        return false;
+    }
+    Protocol::FrameHeader header;
+    header.type = type;
+    header.requestId = requestId;
+    header.payloadSize = static_cast<uint32_t>(payload.size());
+    std::vector<unsigned char> frame(Protocol::HEADER_SIZE + payload.size());
+    Protocol::encodeHeader(header, frame.data());
+    if (!payload.empty()) {
+        memcpy(frame.data() + Protocol::HEADER_SIZE, payload.data(), payload.size());
+    }
+    ssize_t n;
+    do {
+        n = send(fd, frame.data(), frame.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        return false;
+    }
+    // 可写时缓冲区至少能放下一个小帧，极少出现的部分写入补发剩余字节以保持帧边界
+    return static_cast<size_t>(n) == frame.size()
+           || writeFully(fd, frame.data() + n, frame.size() - static_cast<size_t>(n));
+}
+
+bool readFrameFrom(int fd, Protocol::FrameHeader& header, std::vector<unsigned char>& payload) {
+    unsigned char buffer[Protocol::HEADER_SIZE];
+    if (!readFully(fd, buffer, sizeof(buffer)) || !Protocol::decodeHeader(buffer, header)) {
+        return false;
+    }
+    payload.resize(header.payloadSize);
+    return header.payloadSize == 0 || readFully(fd, payload.data(), payload.size());
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// 协议编解码
+// ---------------------------------------------------------------------------
+
+namespace Protocol {
+
+void encodeHeader(const FrameHeader& header, unsigned char* out) {
+    uint32_t magic = MAGIC;
+    uint16_t version = VERSION;
+    uint16_t type = static_cast<uint16_t>(header.type);
+    memcpy(out, &magic, 4);
+    memcpy(out + 4, &version, 2);
+    memcpy(out + 6, &type, 2);
+    memcpy(out + 8, &header.requestId, 4);
+    memcpy(out + 12, &header.payloadSize, 4);
+}
+
+bool decodeHeader(const unsigned char* in, FrameHeader& header) {
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    uint16_t type = 0;
+    memcpy(&magic, in, 4);
+    memcpy(&version, in + 4, 2);
+    memcpy(&type, in + 6, 2);
+    memcpy(&header.requestId, in + 8, 4);
+    memcpy(&header.payloadSize, in + 12, 4);
+    header.type = static_cast<MessageType>(type);
+    return magic == MAGIC && version == VERSION && header.payloadSize <= MAX_PAYLOAD_SIZE;
+}
+
+void encodeRequest(const InversionParams& params, std::vector<unsigned char>& payload) {
+    PayloadWriter writer(payload);
+    writer.putU32(static_cast<uint32_t>(params.M));
+    writer.putU32(static_cast<uint32_t>(params.nFreq));
+    writer.putU32(static_cast<uint32_t>(params.maxIter));
+    writer.putU32((params.occam ? 1u : 0u) | (params.computeResolution ? 2u : 0u) |
+                  (params.adaptivePruning ? 4u : 0u) | (params.pruneMergeLayers ? 8u : 0u));
+    writer.putF64(params.lambda);
+    writer.putF64(params.tolDm);
+    writer.putF64(params.epsilon);
+    writer.putF64(params.firstLayerThickness);
+    writer.putF64(params.thicknessGrowth);
+    writer.putF64(params.noiseLevel);
+    writer.putU32(params.noiseSeed);
+    writer.putString(params.stationId);
+    writer.putF64(params.pruneThreshold);
+    writer.putU32(static_cast<uint32_t>(params.pruneRecheckInterval));
+    writer.putF64(params.targetMisfit);
+    writer.putF64(params.occamLambdaMin);
+    writer.putF64(params.occamLambdaMax);
+    writer.putF64(params.doiThreshold);
+    writer.putU32(static_cast<uint32_t>(params.engine));
+    writer.putU32(static_cast<uint32_t>(params.trustRegionJacobian));
+    writer.putU32(static_cast<uint32_t>(params.modelBasis));
+    writer.putU32(static_cast<uint32_t>(params.nBasis));
+    putComponents(writer, params.components);
+    writer.putU32(static_cast<uint32_t>(params.priorModels.size()));
+    for (const std::vector<double>& prior : params.priorModels) {
+        writer.putArray(prior);
+    }
+    writer.putArray(params.omega);
+    writer.putArray(params.dObs);
+    writer.putArray(params.layerThicknesses);
+}
+
+bool decodeRequest(const std::vector<unsigned char>& payload, InversionParams& params) {
+    PayloadReader reader(payload);
+    params = InversionParams();
+    uint32_t M = reader.getU32();
+    uint32_t nFreq = reader.getU32();
+    uint32_t maxIter = reader.getU32();
+    uint32_t flags = reader.getU32();
+    params.lambda = reader.getF64();
+    params.tolDm = reader.getF64();
+    params.epsilon = reader.getF64();
+    params.firstLayerThickness = reader.getF64();
+    params.thicknessGrowth = reader.getF64();
+    params.noiseLevel = reader.getF64();
+    params.noiseSeed = reader.getU32();
+    params.stationId = reader.getString();
+    params.pruneThreshold = reader.getF64();
+    uint32_t pruneRecheckInterval = reader.getU32();
+    params.targetMisfit = reader.getF64();
+    params.occamLambdaMin = reader.getF64();
+    params.occamLambdaMax = reader.getF64();
+    params.doiThreshold = reader.getF64();
+    uint32_t engine = reader.getU32();
+    uint32_t trustRegionJacobian = reader.getU32();
+    uint32_t modelBasis = reader.getU32();
+    uint32_t nBasis = reader.getU32();
+    if (!getComponents(reader, params.components)) {
+        return false;
+    }
+    uint32_t nPriors = reader.getU32();
+    if (nPriors > 100000) {
+        return false;
+    }
+    params.priorModels.resize(nPriors);
+    for (uint32_t k = 0; k < nPriors; k++) {
+        params.priorModels[k] = reader.getArray();
+    }
+    params.omega = reader.getArray();
+    params.dObs = reader.getArray();
+    params.layerThicknesses = reader.getArray();
+    if (!reader.finished()) {
+        return false;
+    }
+
+    // 范围检查（防止格式错误的请求使反演线程分配过大的内存）
+    if (M < 1 || M > 10000 || nFreq < 1 || nFreq > 100000 || maxIter > 10000 ||
+        pruneRecheckInterval < 1 || pruneRecheckInterval > 10000 || nBasis < 1 || nBasis > 10000) {
+        return false;
+    }
+    if (engine > static_cast<uint32_t>(InversionEngine::TRUST_REGION) ||
+        trustRegionJacobian > static_cast<uint32_t>(TrustRegionJacobian::MKL_DJACOBI) ||
+        modelBasis > static_cast<uint32_t>(ModelBasis::PCA) || flags > 15u) {
+        return false;
+    }
+    params.M = static_cast<int>(M);
+    params.nFreq = static_cast<int>(nFreq);
+    params.maxIter = static_cast<int>(maxIter);
+    params.occam = (flags & 1u) != 0;
+    params.computeResolution = (flags & 2u) != 0;
+    params.adaptivePruning = (flags & 4u) != 0;
+    params.pruneMergeLayers = (flags & 8u) != 0;
+    params.pruneRecheckInterval = static_cast<int>(pruneRecheckInterval);
+    params.engine = static_cast<InversionEngine>(engine);
+    params.trustRegionJacobian = static_cast<TrustRegionJacobian>(trustRegionJacobian);
+    params.modelBasis = static_cast<ModelBasis>(modelBasis);
+    params.nBasis = static_cast<int>(nBasis);
+    if (!std::isfinite(params.lambda) || params.lambda < 0.0 || !std::isfinite(params.tolDm) ||
+        !std::isfinite(params.epsilon) || params.epsilon <= 0.0 ||
+        !std::isfinite(params.firstLayerThickness) || params.firstLayerThickness <= 0.0 ||
+        !std::isfinite(params.thicknessGrowth) || params.thicknessGrowth <= 0.0 ||
+        !std::isfinite(params.noiseLevel) || params.noiseLevel < 0.0 ||
+        !std::isfinite(params.pruneThreshold) || params.pruneThreshold < 0.0 ||
+        !std::isfinite(params.targetMisfit) || !std::isfinite(params.doiThreshold) ||
+        !std::isfinite(params.occamLambdaMin) || params.occamLambdaMin <= 0.0 ||
+        !std::isfinite(params.occamLambdaMax) || params.occamLambdaMax < params.occamLambdaMin) {
+        return false;
+    }
+    // 先验模型样本：每个样本M层
+    for (const std::vector<double>& prior : params.priorModels) {
+        if (prior.size() != M) {
+            return false;
+        }
+    }
+
+    // 频率：给出omega时由其计算周期
+    if (!params.omega.empty()) {
+        if (params.omega.size() != nFreq || !allFinitePositive(params.omega)) {
+            return false;
+        }
+        params.periods.resize(nFreq);
+        for (uint32_t f = 0; f < nFreq; f++) {
+            params.periods[f] = 2.0 * M_PI / params.omega[f];
+        }
+    }
+    // 观测数据：必须同时给出频率，长度为分量数×nFreq（未给出分量时为log10(ρ_a)和相位交替存储）
+    const size_t nComponents = params.components.empty() ? 2 : params.components.size();
+    if (!params.dObs.empty() && (params.dObs.size() != nComponents * nFreq || params.omega.empty())) {
+        return false;
+    }
+    // 层网格：给出厚度时由其累加得到层顶深度
+    if (!params.layerThicknesses.empty()) {
+        if (params.layerThicknesses.size() != M || !allFinitePositive(params.layerThicknesses)) {
+            return false;
+        }
+        params.layerDepths.resize(M);
+        double depth = 0.0;
+        for (uint32_t i = 0; i < M; i++) {
+            params.layerDepths[i] = depth;
+            depth += params.layerThicknesses[i];
+        }
+    }
+    return true;
+}
+
+void encodeProgress(const Progress& progress, std::vector<unsigned char>& payload) {
+    PayloadWriter writer(payload);
+    writer.putU32(static_cast<uint32_t>(progress.iteration));
+    writer.putF64(progress.residual);
+    writer.putF64(progress.dmNorm);
+}
+
+bool decodeProgress(const std::vector<unsigned char>& payload, Progress& progress) {
+    PayloadReader reader(payload);
+    progress.iteration = static_cast<int>(reader.getU32());
+    progress.residual = reader.getF64();
+    progress.dmNorm = reader.getF64();
+    return reader.finished();
+}
+
+void encodeResult(const InversionResult& result, std::vector<unsigned char>& payload) {
+    PayloadWriter writer(payload);
+    writer.putU32(result.success ? 1u : 0u);
+    writer.putU32(static_cast<uint32_t>(result.nIterations));
+    writer.putString(result.stationId);
+    writer.putString(result.errorMessage);
+    writer.putArray(result.omega);
+    writer.putArray(result.layerThicknesses);
+    putComponents(writer, result.components);
+    writer.putArray(result.mFinal);
+    writer.putArray(result.dSyn);
+    writer.putArray(result.residualHistory);
+    writer.putF64(result.doi);
+}
+
+bool decodeResult(const std::vector<unsigned char>& payload, InversionResult& result) {
+    PayloadReader reader(payload);
+    result = InversionResult();
+    result.success = reader.getU32() != 0;
+    result.nIterations = static_cast<int>(reader.getU32());
+    result.stationId = reader.getString();
+    result.errorMessage = reader.getString();
+    result.omega = reader.getArray();
+    result.layerThicknesses = reader.getArray();
+    if (!getComponents(reader, result.components)) {
+        return false;
+    }
+    result.mFinal = reader.getArray();
+    result.dSyn = reader.getArray();
+    result.residualHistory = reader.getArray();
+    result.doi = reader.getF64();
+    if (!reader.finished()) {
+        return false;
+    }
+    result.periods.resize(result.omega.size());
+    for (size_t f = 0; f < result.omega.size(); f++) {
+        result.periods[f] = 2.0 * M_PI / result.omega[f];
+    }
+    result.layerDepths.resize(result.layerThicknesses.size());
+    double depth = 0.0;
+    for (size_t i = 0; i < result.layerThicknesses.size(); i++) {
+        result.layerDepths[i] = depth;
+        depth += result.layerThicknesses[i];
+    }
+    return true;
+}
+
+void encodeStatistics(const Statistics& stats, std::vector<unsigned char>& payload) {
+    PayloadWriter writer(payload);
+    writer.putU32(static_cast<uint32_t>(stats.queueDepth));
+    writer.putU32(static_cast<uint32_t>(stats.busyWorkers));
+    writer.putU32(static_cast<uint32_t>(stats.nWorkers));
+    writer.putU64(stats.nReceived);
+    writer.putU64(stats.nCompleted);
+    writer.putU64(stats.nFailed);
+    writer.putU64(stats.nRejected);
+    writer.putU64(stats.nBatches);
+    writer.putF64(stats.meanBatchSize);
+    writer.putF64(stats.meanQueueMs);
+    writer.putF64(stats.meanLatencyMs);
+    writer.putF64(stats.p50LatencyMs);
+    writer.putF64(stats.p95LatencyMs);
+    writer.putF64(stats.maxLatencyMs);
+}
+
+bool decodeStatistics(const std::vector<unsigned char>& payload, Statistics& stats) {
+    PayloadReader reader(payload);
+    stats.queueDepth = static_cast<int>(reader.getU32());
+    stats.busyWorkers = static_cast<int>(reader.getU32());
+    stats.nWorkers = static_cast<int>(reader.getU32());
+    stats.nReceived = reader.getU64();
+    stats.nCompleted = reader.getU64();
+    stats.nFailed = reader.getU64();
+    stats.nRejected = reader.getU64();
+    stats.nBatches = reader.getU64();
+    stats.meanBatchSize = reader.getF64();
+    stats.meanQueueMs = reader.getF64();
+    stats.meanLatencyMs = reader.getF64();
+    stats.p50LatencyMs = reader.getF64();
+    stats.p95LatencyMs = reader.getF64();
+    stats.maxLatencyMs = reader.getF64();
+    return reader.finished();
+}
+
+void encodeError(const std::string& message, std::vector<unsigned char>& payload) {
+    PayloadWriter writer(payload);
+    writer.putString(message);
+}
+
+bool decodeError(const std::vector<unsigned char>& payload, std::string& message) {
+    PayloadReader reader(payload);
+    message = reader.getString();
+    return reader.finished();
+}
+
+} // namespace Protocol
+
+// ---------------------------------------------------------------------------
+// 服务端
+// ---------------------------------------------------------------------------
+
+/**
+ * 客户端连接：接收线程读取，反演线程回送帧（写操作加锁，帧不会交错）
+ * 套接字在最后一个引用释放时关闭，已断开连接上仍在排队的请求照常执行，只是结果无法送达。
+ * 阻塞写设有超时（SEND_TIMEOUT_SECONDS），超时或出错后连接被关闭，不再写出半帧之后的数据。
+ */
+struct InversionServer::Connection {
+    int fd;
+    std::mutex writeMutex;
+    std::atomic<bool> finished;
+
+    explicit Connection(int socketFd) : fd(socketFd), finished(false) {}
+    ~Connection() { ::close(fd); }
+
+    bool send(Protocol::MessageType type, uint32_t requestId, const std::vector<unsigned char>& payload) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (writeFrame(fd, type, requestId, payload)) {
+            return true;
+        }
+        shutdown(fd, SHUT_RDWR);
+        return false;
+    }
+
+    /**
+     * 尽力发送（用于PROGRESS帧）：其他线程正在写或发送缓冲区已满时直接丢弃，
+     * 客户端读得慢不会阻塞反演线程
+     */
+    bool trySend(Protocol::MessageType type, uint32_t requestId, const std::vector<unsigned char>& payload) {
+        std::unique_lock<std::mutex> lock(writeMutex, std::try_to_lock);
+        return lock.owns_lock() && tryWriteFrame(fd, type, requestId, payload);
+    }
+};
+
+/**
+ * 排队的反演请求
+ */
+struct InversionServer::Request {
+    std::shared_ptr<Connection> connection;
+    uint32_t requestId = 0;
+    InversionParams params;
+    Clock::time_point receivedAt;
+};
+
+InversionServer::InversionServer(const Options& options)
+    : m_options(options)
+    , m_listenFd(-1)
+    , m_boundPort(0)
+    , m_running(false)
+    , m_stopped(false)
+    , m_busyWorkers(0)
+    , m_nReceived(0)
+    , m_nCompleted(0)
+    , m_nFailed(0)
+    , m_nRejected(0)
+    , m_nBatches(0)
+    , m_nBatchedRequests(0)
+    , m_totalQueueMs(0.0)
+    , m_totalLatencyMs(0.0)
+    , m_latencyNext(0) {
+    if (m_options.nWorkers <= 0) {
+        m_options.nWorkers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    m_options.maxBatchSize = std::max(1, m_options.maxBatchSize);
+    m_options.maxQueueDepth = std::max(1, m_options.maxQueueDepth);
+}
+
+InversionServer::~InversionServer() {
+    stop();
+}
+
+bool InversionServer::start(std::string& errorMessage) {
+    if (m_running.load()) {
+        errorMessage = "server is already running";
+        return false;
+    }
+
+    if (!m_options.socketPath.empty()) {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (m_options.socketPath.size() >= sizeof(address.sun_path)) {
+            errorMessage = "socket path is too long: " + m_options.socketPath;
+            return false;
+        }
+        strcpy(address.sun_path, m_options.socketPath.c_str());
+
+        // 已有服务在监听时不抢占；残留的套接字文件（上次未正常退出）直接删除
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe >= 0) {
+            bool inUse = connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+            ::close(probe);
+            if (inUse) {
+                errorMessage = "another server is listening on " + m_options.socketPath;
+                return false;
+            }
+        }
+        unlink(m_options.socketPath.c_str());
+
+        m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_listenFd < 0 || bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            errorMessage = "cannot bind " + m_options.socketPath + ": " + strerror(errno);
+            if (m_listenFd >= 0) {
+                ::close(m_listenFd);
+                m_listenFd = -1;
+            }
+            return false;
+        }
+    } else {
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(m_options.tcpPort));
+
+        m_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (m_listenFd >= 0) {
+            setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        if (m_listenFd < 0 || bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            errorMessage = "cannot bind 127.0.0.1:" + std::to_string(m_options.tcpPort) + ": " + strerror(errno);
+            if (m_listenFd >= 0) {
+                ::close(m_listenFd);
+                m_listenFd = -1;
+            }
+            return false;
+        }
+        socklen_t length = sizeof(address);
+        getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+        m_boundPort = ntohs(address.sin_port);
+    }
+
+    if (listen(m_listenFd, 64) != 0) {
+        errorMessage = std::string("listen failed: ") + strerror(errno);
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stopped = false;
+    }
+    m_running.store(true);
+    m_latencyWindow.clear();
+    m_latencyWindow.reserve(Protocol::LATENCY_WINDOW);
+    m_latencyNext = 0;
+
+    m_workerThreads.reserve(m_options.nWorkers);
+    for (int w = 0; w < m_options.nWorkers; w++) {
+        m_workerThreads.emplace_back(&InversionServer::workerLoop, this);
+    }
+    m_acceptThread = std::thread(&InversionServer::acceptLoop, this);
+    return true;
+}
+
+void InversionServer::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    // 1. 停止接收新连接（shutdown使阻塞的accept返回）
+    shutdown(m_listenFd, SHUT_RDWR);
+    if (m_acceptThread.joinable()) {
+        m_acceptThread.join();
+    }
+    ::close(m_listenFd);
+    m_listenFd = -1;
+    if (!m_options.socketPath.empty()) {
+        unlink(m_options.socketPath.c_str());
+    }
+
+    // 2. 丢弃排队请求，唤醒并等待反演线程（正在进行的反演完成后退出）
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queue.clear();
+    }
+    m_queueCondition.notify_all();
+    for (std::thread& t : m_workerThreads) {
+        t.join();
+    }
+    m_workerThreads.clear();
+
+    // 3. 关闭所有连接（shutdown使阻塞的recv返回）
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        for (const std::shared_ptr<Connection>& connection : m_connections) {
+            shutdown(connection->fd, SHUT_RDWR);
+        }
+        for (std::thread& t : m_connectionThreads) {
+            t.join();
+        }
+        m_connections.clear();
+        m_connectionThreads.clear();
+    }
+
+    requestShutdown();
+}
+
+void InversionServer::wait() {
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    m_stopCondition.wait(lock, [this]() { return m_stopped; });
+}
+
+void InversionServer::requestShutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stopped = true;
+    }
+    m_stopCondition.notify_all();
+}
+
+Protocol::Statistics InversionServer::getStatistics() const {
+    Protocol::Statistics stats;
+    std::vector<double> window;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        stats.queueDepth = static_cast<int>(m_queue.size());
+        stats.busyWorkers = m_busyWorkers;
+        stats.nWorkers = m_options.nWorkers;
+        stats.nReceived = m_nReceived;
+        stats.nCompleted = m_nCompleted;
+        stats.nFailed = m_nFailed;
+        stats.nRejected = m_nRejected;
+        stats.nBatches = m_nBatches;
+        if (m_nBatches > 0) {
+            stats.meanBatchSize = static_cast<double>(m_nBatchedRequests) / m_nBatches;
+        }
+        if (m_nCompleted > 0) {
+            stats.meanQueueMs = m_totalQueueMs / m_nCompleted;
+            stats.meanLatencyMs = m_totalLatencyMs / m_nCompleted;
+        }
+        window = m_latencyWindow;
+    }
+
+    // 分位数在锁外计算
+    if (!window.empty()) {
+        size_t n = window.size();
+        std::nth_element(window.begin(), window.begin() + n / 2, window.end());
+        stats.p50LatencyMs = window[n / 2];
+        size_t k95 = std::min(n - 1, static_cast<size_t>(0.95 * n));
+        std::nth_element(window.begin(), window.begin() + k95, window.end());
+        stats.p95LatencyMs = window[k95];
+        stats.maxLatencyMs = *std::max_element(window.begin(), window.end());
+    }
+    return stats;
+}
+
+void InversionServer::acceptLoop() {
+    while (m_running.load()) {
+        int fd = accept(m_listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;  // 监听套接字已关闭
+        }
+        if (m_options.socketPath.empty()) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        // 不读取结果的客户端最多让反演线程等待SEND_TIMEOUT_SECONDS
+        timeval sendTimeout;
+        sendTimeout.tv_sec = SEND_TIMEOUT_SECONDS;
+        sendTimeout.tv_usec = 0;
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+        reapConnections();
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        if (!m_running.load()) {
+            ::close(fd);
+            break;
+        }
+        std::shared_ptr<Connection> connection = std::make_shared<Connection>(fd);
+        m_connections.push_back(connection);
+        m_connectionThreads.emplace_back(&InversionServer::connectionLoop, this, connection);
+    }
+}
+
+void InversionServer::reapConnections() {
+    // 回收已断开连接的接收线程，常驻进程中线程对象不随连接数累积
+    std::lock_guard<std::mutex> lock(m_connectionMutex);
+    for (size_t i = 0; i < m_connections.size();) {
+        if (m_connections[i]->finished.load()) {
+            m_connectionThreads[i].join();
+            m_connectionThreads.erase(m_connectionThreads.begin() + i);
+            m_connections.erase(m_connections.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void InversionServer::connectionLoop(std::shared_ptr<Connection> connection) {
+    Protocol::FrameHeader header;
+    std::vector<unsigned char> payload;
+    while (m_running.load() && readFrameFrom(connection->fd, header, payload)) {
+        handleFrame(connection, header, payload);
+    }
+    connection->finished.store(true);
+}
+
+void InversionServer::handleFrame(const std::shared_ptr<Connection>& connection,
+                                  const Protocol::FrameHeader& header,
+                                  const std::vector<unsigned char>& payload) {
+    std::vector<unsigned char> reply;
+    switch (header.type) {
+        case Protocol::MessageType::INVERT: {
+            std::unique_ptr<Request> request(new Request());
+            request->connection = connection;
+            request->requestId = header.requestId;
+            request->receivedAt = Clock::now();
+            std::string error;
+            if (!Protocol::decodeRequest(payload, request->params)) {
+                error = "malformed inversion request";
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_queueMutex);
+                if (error.empty() && m_queue.size() >= static_cast<size_t>(m_options.maxQueueDepth)) {
+                    error = "queue full";
+                }
+                if (error.empty()) {
+                    m_nReceived++;
+                    m_queue.push_back(std::move(request));
+                } else {
+                    m_nRejected++;
+                }
+            }
+            if (error.empty()) {
+                m_queueCondition.notify_one();
+            } else {
+                Protocol::encodeError(error, reply);
+                connection->send(Protocol::MessageType::ERROR, header.requestId, reply);
+            }
+            break;
+        }
+        case Protocol::MessageType::STATS:
+            Protocol::encodeStatistics(getStatistics(), reply);
+            connection->send(Protocol::MessageType::STATS, header.requestId, reply);
+            break;
+        case Protocol::MessageType::SHUTDOWN:
+            requestShutdown();
+            break;
+        default:
+            Protocol::encodeError("unexpected message type", reply);
+            connection->send(Protocol::MessageType::ERROR, header.requestId, reply);
+            break;
+    }
+}
+
+bool InversionServer::sameBatchKey(const InversionParams& a, const InversionParams& b) {
+    if (a.M != b.M || a.nFreq != b.nFreq || a.omega != b.omega || a.layerThicknesses != b.layerThicknesses) {
+        return false;
+    }
+    // 未给出层厚度时网格由首层厚度和增长系数决定
+    return !a.layerThicknesses.empty()
+           || (a.firstLayerThickness == b.firstLayerThickness && a.thicknessGrowth == b.thicknessGrowth);
+}
+
+bool InversionServer::popBatch(std::vector<std::unique_ptr<Request>>& batch) {
+    batch.clear();
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_queueCondition.wait(lock, [this]() { return !m_queue.empty() || !m_running.load(); });
+    if (!m_running.load()) {
+        return false;
+    }
+
+    batch.push_back(std::move(m_queue.front()));
+    m_queue.pop_front();
+    m_busyWorkers++;
+    m_nBatches++;
+
+    // 还有空闲的反演线程时只取一个请求，同一网格的其余请求留给空闲线程并行执行；
+    // 所有线程都忙时才把同一频率和网格的请求一并取出（保持各自的先后顺序）
+    if (m_busyWorkers >= m_options.nWorkers) {
+        const InversionParams& key = batch.front()->params;
+        for (auto it = m_queue.begin(); it != m_queue.end()
+             && batch.size() < static_cast<size_t>(m_options.maxBatchSize);) {
+            if (sameBatchKey(key, (*it)->params)) {
+                batch.push_back(std::move(*it));
+                it = m_queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    m_nBatchedRequests += batch.size();
+    return true;
+}
+
+bool InversionServer::returnUnstarted(std::vector<std::unique_ptr<Request>>& batch, size_t next) {
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    if (next >= batch.size() || m_busyWorkers >= m_options.nWorkers) {
+        return false;
+    }
+    // 有线程空闲：未开始的请求按原顺序放回队首，由空闲线程接手
+    for (size_t i = batch.size(); i > next; i--) {
+        m_queue.push_front(std::move(batch[i - 1]));
+    }
+    m_nBatchedRequests -= batch.size() - next;
+    batch.resize(next);
+    lock.unlock();
+    m_queueCondition.notify_all();
+    return true;
+}
+
+void InversionServer::recordCompletion(double queueMs, double latencyMs, bool success) {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_nCompleted++;
+    if (!success) {
+        m_nFailed++;
+    }
+    m_totalQueueMs += queueMs;
+    m_totalLatencyMs += latencyMs;
+    if (m_latencyWindow.size() < static_cast<size_t>(Protocol::LATENCY_WINDOW)) {
+        m_latencyWindow.push_back(latencyMs);
+    } else {
+        m_latencyWindow[m_latencyNext] = latencyMs;
+        m_latencyNext = (m_latencyNext + 1) % m_latencyWindow.size();
+    }
+}
+
+void InversionServer::progressCallback(int iteration, double residual, double dmNorm, void* userData) {
+    const Request* request = static_cast<const Request*>(userData);
+    Protocol::Progress progress;
+    progress.iteration = iteration;
+    progress.residual = residual;
+    progress.dmNorm = dmNorm;
+    std::vector<unsigned char> payload;
+    Protocol::encodeProgress(progress, payload);
+    // 进度帧可丢弃：在反演线程上不做阻塞写
+    request->connection->trySend(Protocol::MessageType::PROGRESS, request->requestId, payload);
+}
+
+void InversionServer::workerLoop() {
+    // 每个反演线程持有独立的MTInversionCore（反演核心不是线程安全的）
+    MTInversionCore core;
+    std::vector<std::unique_ptr<Request>> batch;
+    std::vector<unsigned char> payload;
+
+    while (popBatch(batch)) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (!m_running.load()) {
+                break;  // 停止时丢弃本批剩余请求
+            }
+            if (i > 0 && returnUnstarted(batch, i)) {
+                break;
+            }
+            const std::unique_ptr<Request>& request = batch[i];
+            Clock::time_point startedAt = Clock::now();
+            core.setProgressCallback(&InversionServer::progressCallback, request.get());
+            InversionResult result;
+            {
+                ParallelTaskScope task;
+                result = core.invert(request->params);
+            }
+            core.setProgressCallback(nullptr, nullptr);
+
+            Protocol::encodeResult(result, payload);
+            request->connection->send(Protocol::MessageType::RESULT, request->requestId, payload);
+            Clock::time_point finishedAt = Clock::now();
+            recordCompletion(elapsedMs(request->receivedAt, startedAt),
+                             elapsedMs(request->receivedAt, finishedAt), result.success);
+        }
+        batch.clear();  // 释放对连接的引用
+
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_busyWorkers--;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 客户端
+// ---------------------------------------------------------------------------
+
+InversionClient::InversionClient() : m_fd(-1), m_nextRequestId(1) {
+}
+
+InversionClient::~InversionClient() {
+    close();
+}
+
+bool InversionClient::connectUnix(const std::string& socketPath) {
+    close();
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+    m_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_fd < 0 || connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool InversionClient::connectTcp(int port) {
+    close();
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    m_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_fd < 0 || connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    int noDelay = 1;
+    setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return true;
+}
+
+void InversionClient::close() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool InversionClient::sendRequest(uint32_t requestId, const InversionParams& params) {
+    std::vector<unsigned char> payload;
+    Protocol::encodeRequest(params, payload);
+    return m_fd >= 0 && writeFrame(m_fd, Protocol::MessageType::INVERT, requestId, payload);
+}
+
+bool InversionClient::sendControl(Protocol::MessageType type) {
+    return m_fd >= 0 && writeFrame(m_fd, type, 0, std::vector<unsigned char>());
+}
+
+bool InversionClient::readFrame(Protocol::FrameHeader& header, std::vector<unsigned char>& payload) {
+    return m_fd >= 0 && readFrameFrom(m_fd, header, payload);
+}
+
+bool InversionClient::invert(const InversionParams& params, InversionResult& result,
+                             void (*progress)(const Protocol::Progress&, void*), void* userData) {
+    uint32_t requestId = m_nextRequestId++;
+    if (!sendRequest(requestId, params)) {
+        result.errorMessage = "connection failed";
+        return false;
+    }
+
+    Protocol::FrameHeader header;
+    std::vector<unsigned char> payload;
+    while (readFrame(header, payload)) {
+        if (header.requestId != requestId) {
+            continue;  // 其他请求的帧（调用方在同一连接上异步发送的请求）
+        }
+        switch (header.type) {
+            case Protocol::MessageType::PROGRESS: {
+                Protocol::Progress p;
+                if (progress && Protocol::decodeProgress(payload, p)) {
+                    progress(p, userData);
+                }
+                break;
+            }
+            case Protocol::MessageType::RESULT:
+                return Protocol::decodeResult(payload, result);
+            case Protocol::MessageType::ERROR:
+                Protocol::decodeError(payload, result.errorMessage);
+                result.success = false;
+                return false;
+            default:
+                break;
+        }
+    }
+    result.errorMessage = "connection closed";
+    return false;
+}
+
+bool InversionClient::queryStatistics(Protocol::Statistics& stats) {
+    if (!sendControl(Protocol::MessageType::STATS)) {
+        return false;
+    }
+    Protocol::FrameHeader header;
+    std::vector<unsigned char> payload;
+    while (readFrame(header, payload)) {
+        if (header.type == Protocol::MessageType::STATS) {
+            return Protocol::decodeStatistics(payload, stats);
+        }
+    }
+    return false;
+}
+
+} // namespace MT
@@ -0,0 +1,292 @@
+#ifndef MT_INVERSION_SERVER_H
+#define MT_INVERSION_SERVER_H
+
+#include "mt_model.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <atomic>
+
+/**
+ * MT本地反演服务模块（POSIX）
+ * 常驻进程持有N个反演线程（各自一个MTInversionCore），通过Unix域套接字或本机TCP接收反演请求，
+ * 短生命周期的客户端（质检脚本、GUI）不必各自承担进程启动、MKL初始化和线程创建的开销。
+ *
+ * 帧格式（小端，本机通信）：16字节帧头 + 负载
+ *   uint32 magic ('MTIS')  uint16 version  uint16 type  uint32 requestId  uint32 payloadSize
+ * 负载中的数组为uint32个数 + 连续的double，字符串为uint32字节数 + UTF-8字节。
+ *
+ * 一个连接上可以连续发送多个请求，服务端按requestId回送PROGRESS（每次迭代）和RESULT帧，
+ * 不同请求的帧可能交错，完成顺序与发送顺序无关。PROGRESS帧尽力发送：客户端读得慢、
+ * 发送缓冲区已满时直接丢弃，反演线程不因进度回送而阻塞；RESULT帧阻塞写（有超时）。
+ *
+ * 批处理：有空闲反演线程时每个线程只取一个请求，同一网格的请求由各线程并行执行；
+ * 所有线程都忙时，取出队首请求的线程把队列中omega和层网格都相同的请求（最多maxBatchSize个）一并取出，
+ * 在同一个MTInversionCore上连续反演，每个请求完成后立即回送结果。开始下一个请求前若已有线程空闲，
+ * 本批未开始的请求放回队首，不让请求在忙碌线程上排队而空闲线程无事可做。空闲时不等待凑批。
+ * 排队请求超过maxQueueDepth时直接回送ERROR帧（背压），不无限制地占用内存。
+ */
+namespace MT {
+
+namespace Protocol {
+
+constexpr uint32_t MAGIC = 0x5349544D;  // "MTIS"
+constexpr uint16_t VERSION = 2;
+constexpr uint32_t HEADER_SIZE = 16;
+constexpr uint32_t MAX_PAYLOAD_SIZE = 64u << 20;  // 单帧负载上限（64 MiB）
+
+/**
+ * 消息类型
+ */
+enum class MessageType : uint16_t {
+    INVERT = 1,     // 客户端 → 服务端：反演请求
+    PROGRESS = 2,   // 服务端 → 客户端：迭代进度
+    RESULT = 3,     // 服务端 → 客户端：反演结果
+    STATS = 4,      // 客户端 → 服务端：查询统计（空负载）；服务端以同类型回送统计
+    ERROR = 5,      // 服务端 → 客户端：请求被拒绝（格式错误、队列已满等）
+    SHUTDOWN = 6    // 客户端 → 服务端：请求服务端退出（空负载）
+};
+
+/**
+ * 帧头
+ */
+struct FrameHeader {
+    MessageType type = MessageType::INVERT;
+    uint32_t requestId = 0;
+    uint32_t payloadSize = 0;
+};
+
+/**
+ * 迭代进度
+ */
+struct Progress {
+    int iteration = 0;
+    double residual = 0.0;
+    double dmNorm = 0.0;
+};
+
+/**
+ * 服务统计
+ */
+struct Statistics {
+    int queueDepth = 0;              // 当前排队的请求数
+    int busyWorkers = 0;             // 正在反演的线程数
+    int nWorkers = 0;                // 反演线程总数
+    uint64_t nReceived = 0;          // 接收的请求数
+    uint64_t nCompleted = 0;         // 完成的请求数（含反演失败）
+    uint64_t nFailed = 0;            // 反演失败的请求数
+    uint64_t nRejected = 0;          // 被拒绝的请求数（格式错误、队列已满）
+    uint64_t nBatches = 0;           // 取出的批次数（单个请求也计为一批）
+    double meanBatchSize = 0.0;      // 平均批大小（不含放回队列的请求）
+    double meanQueueMs = 0.0;        // 平均排队时间（毫秒）
+    double meanLatencyMs = 0.0;      // 平均端到端延迟（接收到结果发出，毫秒）
+    double p50LatencyMs = 0.0;       // 延迟中位数（最近LATENCY_WINDOW个请求）
+    double p95LatencyMs = 0.0;       // 延迟95分位数（最近LATENCY_WINDOW个请求）
+    double maxLatencyMs = 0.0;       // 最大延迟（最近LATENCY_WINDOW个请求）
+};
+
+constexpr int LATENCY_WINDOW = 1024;
+
+/**
+ * 编码/解码帧头
+ */
+void encodeHeader(const FrameHeader& header, unsigned char* out);
+bool decodeHeader(const unsigned char* in, FrameHeader& header);
+
+/**
+ * 编码/解码反演请求
+ * 编码字段：M、nFreq、maxIter、occam、computeResolution、adaptivePruning、pruneMergeLayers、lambda、
+ * tolDm、epsilon、firstLayerThickness、thicknessGrowth、noiseLevel、noiseSeed、stationId、
+ * pruneThreshold、pruneRecheckInterval、targetMisfit、occamLambdaMin、occamLambdaMax、doiThreshold、
+ * engine、trustRegionJacobian、modelBasis、nBasis、components、priorModels、omega、dObs、layerThicknesses。
+ * omega为空时由服务端生成默认频率；layerThicknesses为空时由firstLayerThickness和thicknessGrowth计算；
+ * dObs为空时服务端生成合成数据，否则长度必须为分量数×nFreq（components为空时按2个分量计）。
+ * 解码时由omega计算periods，由layerThicknesses计算layerDepths。
+ */
+void encodeRequest(const InversionParams& params, std::vector<unsigned char>& payload);
+bool decodeRequest(const std::vector<unsigned char>& payload, InversionParams& params);
+
+void encodeProgress(const Progress& progress, std::vector<unsigned char>& payload);
+bool decodeProgress(const std::vector<unsigned char>& payload, Progress& progress);
+
+/**
+ * 编码/解码反演结果
+ * 编码字段：success、nIterations、stationId、errorMessage、omega、layerThicknesses、
+ * components、mFinal、dSyn、residualHistory、doi
+ */
+void encodeResult(const InversionResult& result, std::vector<unsigned char>& payload);
+bool decodeResult(const std::vector<unsigned char>& payload, InversionResult& result);
+
+void encodeStatistics(const Statistics& stats, std::vector<unsigned char>& payload);
+bool decodeStatistics(const std::vector<unsigned char>& payload, Statistics& stats);
+
+void encodeError(const std::string& message, std::vector<unsigned char>& payload);
+bool decodeError(const std::vector<unsigned char>& payload, std::string& message);
+
+} // namespace Protocol
+
+class InversionServer {
+public:
+    /**
+     * 服务配置
+     */
+    struct Options {
+        std::string socketPath;   // Unix域套接字路径（非空时使用）
+        int tcpPort = 0;          // 本机TCP端口（socketPath为空时使用，只监听127.0.0.1）
+        int nWorkers = 0;         // 反演线程数（<=0表示按CPU核数自动选择）
+        int maxBatchSize = 8;     // 每批最多请求数
+        int maxQueueDepth = 256;  // 排队请求上限（超过时拒绝新请求）
+    };
+
+    explicit InversionServer(const Options& options);
+    ~InversionServer();
+
+    InversionServer(const InversionServer&) = delete;
+    InversionServer& operator=(const InversionServer&) = delete;
+
+    /**
+     * 创建监听套接字并启动接收线程和反演线程
+     * @param errorMessage 失败时的错误信息
+     * @return 是否成功
+     */
+    bool start(std::string& errorMessage);
+
+    /**
+     * 停止服务：关闭监听套接字和所有连接，丢弃排队请求，等待正在进行的反演结束
+     * 不能在服务自身的线程中调用；重复调用无副作用
+     */
+    void stop();
+
+    /**
+     * 阻塞直到stop()被调用或收到SHUTDOWN请求（收到SHUTDOWN后由调用方调用stop()）
+     */
+    void wait();
+
+    bool isRunning() const { return m_running.load(); }
+
+    /**
+     * 获取服务统计
+     */
+    Protocol::Statistics getStatistics() const;
+
+    /**
+     * 获取实际监听的TCP端口（tcpPort为0且未指定socketPath时由系统分配）
+     */
+    int getTcpPort() const { return m_boundPort; }
+
+private:
+    struct Connection;
+    struct Request;
+
+    void acceptLoop();
+    void reapConnections();
+    void connectionLoop(std::shared_ptr<Connection> connection);
+    void workerLoop();
+    void handleFrame(const std::shared_ptr<Connection>& connection,
+                     const Protocol::FrameHeader& header,
+                     const std::vector<unsigned char>& payload);
+    bool popBatch(std::vector<std::unique_ptr<Request>>& batch);
+    bool returnUnstarted(std::vector<std::unique_ptr<Request>>& batch, size_t next);
+    void recordCompletion(double queueMs, double latencyMs, bool success);
+    void requestShutdown();
+
+    static bool sameBatchKey(const InversionParams& a, const InversionParams& b);
+    static void progressCallback(int iteration, double residual, double dmNorm, void* userData);
+
+    Options m_options;
+    int m_listenFd;
+    int m_boundPort;
+    std::atomic<bool> m_running;
+
+    std::thread m_acceptThread;
+    std::vector<std::thread> m_workerThreads;
+    std::mutex m_connectionMutex;
+    std::vector<std::shared_ptr<Connection>> m_connections;  // 与m_connectionThreads一一对应
+    std::vector<std::thread> m_connectionThreads;
+
+    // 请求队列（反演线程按批取出）
+    mutable std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::deque<std::unique_ptr<Request>> m_queue;
+
+    // 停止通知
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition;
+    bool m_stopped;
+
+    // 统计（由m_queueMutex保护）
+    int m_busyWorkers;
+    uint64_t m_nReceived;
+    uint64_t m_nCompleted;
+    uint64_t m_nFailed;
+    uint64_t m_nRejected;
+    uint64_t m_nBatches;
+    uint64_t m_nBatchedRequests;
+    double m_totalQueueMs;
+    double m_totalLatencyMs;
+    std::vector<double> m_latencyWindow;  // 最近LATENCY_WINDOW个请求的延迟（环形缓冲）
+    size_t m_latencyNext;
+};
+
+/**
+ * 反演服务客户端（阻塞式，单线程使用）
+ */
+class InversionClient {
+public:
+    InversionClient();
+    ~InversionClient();
+
+    InversionClient(const InversionClient&) = delete;
+    InversionClient& operator=(const InversionClient&) = delete;
+
+    bool connectUnix(const std::string& socketPath);
+    bool connectTcp(int port);
+    void close();
+
+    /**
+     * 发送反演请求
+     * @param requestId 请求ID（由调用方分配，用于匹配回送的帧）
+     * @param params 反演参数
+     * @return 是否发送成功
+     */
+    bool sendRequest(uint32_t requestId, const InversionParams& params);
+
+    /**
+     * 发送空负载的控制帧（STATS或SHUTDOWN）
+     */
+    bool sendControl(Protocol::MessageType type);
+
+    /**
+     * 读取下一帧（阻塞）
+     * @param header 输出的帧头
+     * @param payload 输出的负载
+     * @return 是否成功（连接关闭或格式错误时返回false）
+     */
+    bool readFrame(Protocol::FrameHeader& header, std::vector<unsigned char>& payload);
+
+    /**
+     * 发送请求并等待结果（期间的PROGRESS帧交给回调，回调可为空）
+     * @return 是否收到结果（收到ERROR帧时返回false，错误信息写入result.errorMessage）
+     */
+    bool invert(const InversionParams& params, InversionResult& result,
+                void (*progress)(const Protocol::Progress&, void*) = nullptr,
+                void* userData = nullptr);
+
+    /**
+     * 查询服务统计
+     */
+    bool queryStatistics(Protocol::Statistics& stats);
+
+private:
+    int m_fd;
+    uint32_t m_nextRequestId;
+};
+
+} // namespace MT
+
+#endif // MT_INVERSION_SERVER_H
@@ -0,0 +1,115 @@
+#include "mt_inversion_server.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+/**
+ * MT本地反演服务
+ * 用法：mt_inversion_server [--socket PATH | --port N] [--workers N] [--max-batch N]
+ *                           [--max-queue N] [--stats-interval SECONDS]
+ * 未指定--socket时监听127.0.0.1（--port 0表示由系统分配端口）。SIGINT/SIGTERM或SHUTDOWN请求时退出。
+ */
+
+namespace {
+
+std::atomic<bool> g_signalled(false);
+
+void onSignal(int) {
+    g_signalled.store(true);
+}
+
+void printStatistics(const MT::Protocol::Statistics& stats) {
+    printf("queue=%d busy=%d/%d received=%llu completed=%llu failed=%llu rejected=%llu "
+           "batches=%llu meanBatch=%.2f meanQueue=%.1fms latency mean=%.1fms p50=%.1fms p95=%.1fms max=%.1fms\n",
+           stats.queueDepth, stats.busyWorkers, stats.nWorkers,
+           static_cast<unsigned long long>(stats.nReceived),
+           static_cast<unsigned long long>(stats.nCompleted),
+           static_cast<unsigned long long>(stats.nFailed),
+           static_cast<unsigned long long>(stats.nRejected),
+           static_cast<unsigned long long>(stats.nBatches),
+           stats.meanBatchSize, stats.meanQueueMs, stats.meanLatencyMs,
+           stats.p50LatencyMs, stats.p95LatencyMs, stats.maxLatencyMs);
+    fflush(stdout);
+}
+
+void printUsage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--socket PATH | --port N] [--workers N] [--max-batch N] [--max-queue N] "
+            "[--stats-interval SECONDS]\n", program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    MT::InversionServer::Options options;
+    double statsInterval = 0.0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--socket") {
+            options.socketPath = value;
+        } else if (arg == "--port") {
+            options.tcpPort = atoi(value);
+        } else if (arg == "--workers") {
+            options.nWorkers = atoi(value);
+        } else if (arg == "--max-batch") {
+            options.maxBatchSize = atoi(value);
+        } else if (arg == "--max-queue") {
+            options.maxQueueDepth = atoi(value);
+        } else if (arg == "--stats-interval") {
+            statsInterval = atof(value);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    MT::InversionServer server(options);
+    std::string errorMessage;
+    if (!server.start(errorMessage)) {
+        fprintf(stderr, "mt_inversion_server: %s\n", errorMessage.c_str());
+        return 1;
+    }
+    if (options.socketPath.empty()) {
+        printf("listening on 127.0.0.1:%d\n", server.getTcpPort());
+    } else {
+        printf("listening on %s\n", options.socketPath.c_str());
+    }
+    fflush(stdout);
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // 信号处理函数中不能加锁，由监视线程轮询标志后唤醒wait()
+    std::thread monitor([&]() {
+        auto lastStats = std::chrono::steady_clock::now();
+        while (server.isRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (g_signalled.load()) {
+                server.stop();
+                break;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (statsInterval > 0.0 &&
+                std::chrono::duration<double>(now - lastStats).count() >= statsInterval) {
+                printStatistics(server.getStatistics());
+                lastStats = now;
+            }
+        }
+    });
+
+    server.wait();
+    printStatistics(server.getStatistics());
+    server.stop();
+    monitor.join();
+    return 0;
+}
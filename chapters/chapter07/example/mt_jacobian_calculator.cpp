@@ -7,7 +7,7 @@
 namespace MT {
 
 JacobianCalculator::JacobianCalculator(ForwardSolver* forwardSolver)
-    : m_forwardSolver(forwardSolver), m_perturbationMethod("forward") {
+    : m_forwardSolver(forwardSolver), m_perturbationMethod("forward"), m_mergeFrozenLayers(false) {
     if (!forwardSolver) {
         throw std::invalid_argument("ForwardSolver pointer cannot be null");
     }
@@ -27,17 +27,36 @@ void JacobianCalculator::compute(const std::vector<double>& m,
 
     J.resize(nData);
     for (int i = 0; i < nData; i++) {
-        J[i].resize(M);
+        J[i].assign(M, 0.0);
     }
 
     std::vector<double> mPerturbed = m;
     std::vector<double> dPerturbed;
 
+    // 第j列扰动的层范围[j, end)：合并模式下包含紧随其后的冻结层
+    auto blockEnd = [&](int j) {
+        int end = j + 1;
+        while (m_mergeFrozenLayers && end < M && !isActive(end)) {
+            end++;
+        }
+        return end;
+    };
+    auto perturb = [&](int j, int end, double delta) {
+        for (int k = j; k < end; k++) {
+            mPerturbed[k] = m[k] + delta;
+        }
+    };
+
     if (m_perturbationMethod == "forward") {
         // 前向差分法
         for (int j = 0; j < M; j++) {
+            if (!isActive(j)) {
+                continue;  // 冻结层：列保持为零
+            }
+
             // 扰动第j个参数
-            mPerturbed[j] = m[j] + epsilon;
+            const int end = blockEnd(j);
+            perturb(j, end, epsilon);
 
             // 正演计算扰动后的数据
             m_forwardSolver->solve(mPerturbed, omega, layerThicknesses, dPerturbed);
@@ -57,18 +76,23 @@ void JacobianCalculator::compute(const std::vector<double>& m,
             }
 
             // 恢复参数
-            mPerturbed[j] = m[j];
+            perturb(j, end, 0.0);
         }
     } else if (m_perturbationMethod == "central") {
         // 中心差分法（更精确但需要两次正演）
         std::vector<double> dPerturbedNeg;
         for (int j = 0; j < M; j++) {
+            if (!isActive(j)) {
+                continue;  // 冻结层：列保持为零
+            }
+
             // 正向扰动
-            mPerturbed[j] = m[j] + epsilon;
+            const int end = blockEnd(j);
+            perturb(j, end, epsilon);
             m_forwardSolver->solve(mPerturbed, omega, layerThicknesses, dPerturbed);
 
             // 负向扰动
-            mPerturbed[j] = m[j] - epsilon;
+            perturb(j, end, -epsilon);
             m_forwardSolver->solve(mPerturbed, omega, layerThicknesses, dPerturbedNeg);
 
             // 计算中心差分：J[:,j] = (d_perturbed_pos - d_perturbed_neg) / (2*epsilon)
@@ -87,7 +111,7 @@ void JacobianCalculator::compute(const std::vector<double>& m,
             }
 
             // 恢复参数
-            mPerturbed[j] = m[j];
+            perturb(j, end, 0.0);
         }
     }
 }
@@ -108,5 +132,16 @@ void JacobianCalculator::setPerturbationMethod(const std::string& method) {
     }
 }
 
+void JacobianCalculator::setActiveLayers(const std::vector<bool>& activeLayers) {
+    m_activeLayers = activeLayers;
+}
+
+void JacobianCalculator::setForwardSolver(ForwardSolver* forwardSolver) {
+    if (!forwardSolver) {
+        throw std::invalid_argument("ForwardSolver pointer cannot be null");
+    }
+    m_forwardSolver = forwardSolver;
+}
+
 } // namespace MT
 
@@ -4,6 +4,7 @@
 #include "mt_model.h"
 #include "mt_forward_solver.h"
 #include <vector>
+#include <string>
 
 /**
  * MT Jacobian计算器模块
@@ -56,9 +57,40 @@ public:
      */
     void setPerturbationMethod(const std::string& method);
 
+    /**
+     * 设置活动层掩码（冻结层的Jacobian列置零，不做扰动正演）
+     * @param activeLayers 活动层掩码（为空表示所有层都活动）
+     */
+    void setActiveLayers(const std::vector<bool>& activeLayers);
+
+    /**
+     * 设置是否把冻结层并入其上方的活动层（层裁剪的合并模式）
+     * 启用时活动层j与紧随其后的冻结层一起扰动，J[:,j]为整块的灵敏度（即各层Jacobian列之和），
+     * 冻结层的列仍为零；正演次数不变
+     * @param merge 是否合并
+     */
+    void setMergeFrozenLayers(bool merge) { m_mergeFrozenLayers = merge; }
+
+    /**
+     * 设置正演求解器（用于切换正演后端）
+     * @param forwardSolver 正演求解器指针（必须有效）
+     */
+    void setForwardSolver(ForwardSolver* forwardSolver);
+
 private:
+    /**
+     * 判断第j层是否需要计算Jacobian列
+     * @param j 层序号
+     * @return 是否活动
+     */
+    bool isActive(int j) const {
+        return m_activeLayers.empty() || j >= static_cast<int>(m_activeLayers.size()) || m_activeLayers[j];
+    }
+
     ForwardSolver* m_forwardSolver;  // 正演求解器
     std::string m_perturbationMethod; // 扰动方法类型
+    std::vector<bool> m_activeLayers; // 活动层掩码
+    bool m_mergeFrozenLayers;         // 冻结层随其上方的活动层一起扰动
 };
 
 } // namespace MT
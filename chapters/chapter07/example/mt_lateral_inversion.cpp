@@ -0,0 +1,332 @@
+#include "mt_lateral_inversion.h"
+#include "mt_thread_policy.h"
+#include <mkl.h>
+#include <mkl_lapacke.h>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+
+namespace MT {
+
+namespace {
+
+// 测站k的相邻测站数（剖面端点为1，内部为2）
+inline int neighbourCount(int k, int K) {
+    return (k > 0 ? 1 : 0) + (k < K - 1 ? 1 : 0);
+}
+
+} // namespace
+
+LateralInversion::LateralInversion(ForwardSolver* forwardSolver,
+                                   JacobianCalculator* jacobianCalculator,
+                                   Optimizer* optimizer)
+    : m_forwardSolver(forwardSolver)
+    , m_jacobianCalculator(jacobianCalculator)
+    , m_optimizer(optimizer)
+    , m_pcgTolerance(1e-10)
+    , m_pcgMaxIterations(500)
+    , m_lastPCGIterations(0)
+    , m_progressCallback(nullptr)
+    , m_progressUserData(nullptr) {
+    if (!forwardSolver || !jacobianCalculator || !optimizer) {
+        throw std::invalid_argument("LateralInversion requires valid solver pointers");
+    }
+}
+
+LateralInversion::~LateralInversion() {
+}
+
+void LateralInversion::setPCGParameters(double tolerance, int maxIterations) {
+    if (!(tolerance > 0.0) || maxIterations <= 0) {
+        throw std::invalid_argument("PCG tolerance and iteration limit must be positive");
+    }
+    m_pcgTolerance = tolerance;
+    m_pcgMaxIterations = maxIterations;
+}
+
+void LateralInversion::setProgressCallback(ProgressCallback callback, void* userData) {
+    m_progressCallback = callback;
+    m_progressUserData = userData;
+}
+
+bool LateralInversion::invert(std::vector<InversionResult>& results,
+                              const std::vector<std::vector<double>>& LTL,
+                              const InversionParams& settings,
+                              double lateralLambda) {
+    m_errorMessage.clear();
+
+    int K = static_cast<int>(results.size());
+    if (K <= 0) {
+        m_errorMessage = "测站列表为空";
+        return false;
+    }
+    int M = static_cast<int>(results[0].mInit.size());
+    if (M <= 0 || LTL.size() != static_cast<size_t>(M)) {
+        m_errorMessage = "正则化矩阵与模型层数不匹配";
+        return false;
+    }
+    for (int k = 0; k < K; k++) {
+        if (results[k].mInit.size() != static_cast<size_t>(M) ||
+            results[k].layerThicknesses.size() != static_cast<size_t>(M)) {
+            m_errorMessage = "横向约束反演要求所有测站使用相同的层数";
+            return false;
+        }
+    }
+    if (!std::isfinite(lateralLambda) || lateralLambda < 0.0) {
+        m_errorMessage = "横向平滑参数必须为非负数";
+        return false;
+    }
+
+    // 所有测站的模型拼接为一个K*M向量：m[k*M + i]
+    std::vector<double> m(static_cast<size_t>(K) * M);
+    for (int k = 0; k < K; k++) {
+        std::copy(results[k].mInit.begin(), results[k].mInit.end(), m.begin() + static_cast<size_t>(k) * M);
+        results[k].residualHistory.clear();
+        results[k].dmNormHistory.clear();
+        results[k].nIterations = 0;
+    }
+
+    // 垂向正则化矩阵拍平为行主序
+    std::vector<double> LTL_flat(static_cast<size_t>(M) * M);
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < M; j++) {
+            LTL_flat[static_cast<size_t>(i) * M + j] = LTL[i][j];
+        }
+    }
+
+    std::vector<std::vector<double>> blocks(K);
+    std::vector<double> rhs(static_cast<size_t>(K) * M);
+    std::vector<double> dm(static_cast<size_t>(K) * M);
+
+    for (int iter = 0; iter < settings.maxIter; iter++) {
+        double totalResidual2 = 0.0;
+
+        // 1. 逐站计算正演、残差、Jacobian及正规方程的对角块
+        for (int k = 0; k < K; k++) {
+            InversionResult& res = results[k];
+            std::vector<double> mk(m.begin() + static_cast<size_t>(k) * M,
+                                   m.begin() + static_cast<size_t>(k + 1) * M);
+
+            std::vector<double> dSyn;
+            m_forwardSolver->solve(mk, res.omega, res.layerThicknesses, dSyn);
+
+            int nData = static_cast<int>(res.dObs.size());
+            std::vector<double> r(nData);
+            vdSub(nData, res.dObs.data(), dSyn.data(), r.data());
+            for (int i = 0; i < nData; i++) {
+                if (!std::isfinite(r[i])) {
+                    r[i] = 0.0;
+                }
+            }
+            double residualNorm = cblas_dnrm2(nData, r.data(), 1);
+            if (!std::isfinite(residualNorm)) {
+                residualNorm = 0.0;
+            }
+            res.residualHistory.push_back(residualNorm);
+            totalResidual2 += residualNorm * residualNorm;
+
+            std::vector<std::vector<double>> J;
+            m_jacobianCalculator->compute(mk, res.omega, dSyn, res.layerThicknesses, settings.epsilon, J);
+
+            std::vector<std::vector<double>> JTJ;
+            m_optimizer->computeJTJ(J, JTJ);
+            std::vector<double> JTr;
+            m_optimizer->computeJTr(J, r, JTr);
+
+            // A_kk = J^T*J + λ_v*L^T*L（横向项在矩阵向量乘中单独处理）
+            std::vector<double>& block = blocks[k];
+            block.resize(static_cast<size_t>(M) * M);
+            for (int i = 0; i < M; i++) {
+                for (int j = 0; j < M; j++) {
+                    block[static_cast<size_t>(i) * M + j] = JTJ[i][j];
+                }
+            }
+            cblas_daxpy(M * M, settings.lambda, LTL_flat.data(), 1, block.data(), 1);
+
+            // b_k = J^T*r - λ_h*(deg_k*m_k - m_{k-1} - m_{k+1})
+            int deg = neighbourCount(k, K);
+            for (int i = 0; i < M; i++) {
+                double lateral = deg * m[static_cast<size_t>(k) * M + i];
+                if (k > 0) lateral -= m[static_cast<size_t>(k - 1) * M + i];
+                if (k < K - 1) lateral -= m[static_cast<size_t>(k + 1) * M + i];
+                rhs[static_cast<size_t>(k) * M + i] = JTr[i] - lateralLambda * lateral;
+            }
+        }
+
+        // 2. 求解块三对角正规方程
+        if (!solvePCG(blocks, M, lateralLambda, rhs, dm)) {
+            if (m_errorMessage.empty()) {
+                m_errorMessage = "横向约束正规方程求解失败";
+            }
+            return false;
+        }
+
+        // 3. 更新模型并记录各测站的更新范数
+        double maxDmNorm = 0.0;
+        double totalDm2 = 0.0;
+        for (int k = 0; k < K; k++) {
+            double* dmk = dm.data() + static_cast<size_t>(k) * M;
+            for (int i = 0; i < M; i++) {
+                if (!std::isfinite(dmk[i])) {
+                    dmk[i] = 0.0;
+                }
+            }
+            double dmNorm = cblas_dnrm2(M, dmk, 1);
+            if (!std::isfinite(dmNorm)) {
+                dmNorm = 0.0;
+            }
+            results[k].dmNormHistory.push_back(dmNorm);
+            results[k].nIterations = iter + 1;
+            maxDmNorm = std::max(maxDmNorm, dmNorm);
+            totalDm2 += dmNorm * dmNorm;
+
+            for (int i = 0; i < M; i++) {
+                double& value = m[static_cast<size_t>(k) * M + i];
+                value += dmk[i];
+                if (!std::isfinite(value)) {
+                    value = results[k].mInit[i];  // 如果无效，恢复初始值
+                }
+            }
+        }
+
+        if (m_progressCallback) {
+            m_progressCallback(iter + 1, sqrt(totalResidual2), sqrt(totalDm2), m_progressUserData);
+        }
+
+        // 所有测站都满足收敛条件时结束
+        if (maxDmNorm < settings.tolDm) {
+            break;
+        }
+    }
+
+    // 4. 保存最终结果
+    for (int k = 0; k < K; k++) {
+        InversionResult& res = results[k];
+        res.mFinal.assign(m.begin() + static_cast<size_t>(k) * M, m.begin() + static_cast<size_t>(k + 1) * M);
+        m_forwardSolver->solve(res.mFinal, res.omega, res.layerThicknesses, res.dSyn);
+        res.success = true;
+    }
+    return true;
+}
+
+void LateralInversion::applyBlockSystem(const std::vector<std::vector<double>>& blocks, int M,
+                                        double lateralLambda,
+                                        const std::vector<double>& x, std::vector<double>& y) const {
+    int K = static_cast<int>(blocks.size());
+    for (int k = 0; k < K; k++) {
+        const double* xk = x.data() + static_cast<size_t>(k) * M;
+        double* yk = y.data() + static_cast<size_t>(k) * M;
+
+        // 对角块（对称矩阵，使用cblas_dsymv）
+        cblas_dsymv(CblasRowMajor, CblasUpper, M, 1.0, blocks[k].data(), M, xk, 1, 0.0, yk, 1);
+
+        // 横向耦合：λ_h*(deg_k*x_k - x_{k-1} - x_{k+1})
+        if (lateralLambda > 0.0) {
+            cblas_daxpy(M, lateralLambda * neighbourCount(k, K), xk, 1, yk, 1);
+            if (k > 0) {
+                cblas_daxpy(M, -lateralLambda, xk - M, 1, yk, 1);
+            }
+            if (k < K - 1) {
+                cblas_daxpy(M, -lateralLambda, xk + M, 1, yk, 1);
+            }
+        }
+    }
+}
+
+bool LateralInversion::solvePCG(const std::vector<std::vector<double>>& blocks, int M,
+                                double lateralLambda,
+                                const std::vector<double>& b, std::vector<double>& x) {
+    int K = static_cast<int>(blocks.size());
+    int n = K * M;
+    m_lastPCGIterations = 0;
+
+    // 1. 块Jacobi预条件：对每个对角块（含横向对角项）做Cholesky分解；
+    //    分解失败的块（如Jacobian出现零列）退化为对角预条件
+    std::vector<std::vector<double>> factors(K);
+    std::vector<char> isDiagonal(K, 0);
+    for (int k = 0; k < K; k++) {
+        factors[k] = blocks[k];
+        double shift = lateralLambda * neighbourCount(k, K);
+        for (int i = 0; i < M; i++) {
+            factors[k][static_cast<size_t>(i) * M + i] += shift;
+        }
+        std::vector<double> diag(M);
+        for (int i = 0; i < M; i++) {
+            diag[i] = factors[k][static_cast<size_t>(i) * M + i];
+        }
+        int info = 0;
+        {
+            MklThreadScope threads(static_cast<double>(M) * M * M / 3.0);
+            info = LAPACKE_dpotrf(LAPACK_ROW_MAJOR, 'L', M, factors[k].data(), M);
+        }
+        if (info != 0) {
+            for (int i = 0; i < M; i++) {
+                diag[i] = diag[i] > 0.0 ? 1.0 / diag[i] : 1.0;
+            }
+            factors[k] = diag;
+            isDiagonal[k] = 1;
+        }
+    }
+
+    auto applyPreconditioner = [&](const std::vector<double>& r, std::vector<double>& z) {
+        z = r;
+        for (int k = 0; k < K; k++) {
+            double* zk = z.data() + static_cast<size_t>(k) * M;
+            if (isDiagonal[k]) {
+                vdMul(M, zk, factors[k].data(), zk);
+            } else {
+                LAPACKE_dpotrs(LAPACK_ROW_MAJOR, 'L', M, 1, factors[k].data(), M, zk, 1);
+            }
+        }
+    };
+
+    // 2. 预条件共轭梯度迭代（初值为0）
+    x.assign(n, 0.0);
+    std::vector<double> r = b;
+    std::vector<double> z(n), p(n), Ap(n);
+
+    double bNorm = cblas_dnrm2(n, b.data(), 1);
+    if (!std::isfinite(bNorm)) {
+        m_errorMessage = "横向约束正规方程右端项包含无效值";
+        return false;
+    }
+    if (bNorm == 0.0) {
+        return true;
+    }
+
+    applyPreconditioner(r, z);
+    p = z;
+    double rz = cblas_ddot(n, r.data(), 1, z.data(), 1);
+
+    for (int it = 0; it < m_pcgMaxIterations; it++) {
+        applyBlockSystem(blocks, M, lateralLambda, p, Ap);
+        double pAp = cblas_ddot(n, p.data(), 1, Ap.data(), 1);
+        if (!(pAp > 0.0) || !std::isfinite(pAp)) {
+            m_errorMessage = "共轭梯度法失败（系统矩阵非正定）";
+            return false;
+        }
+
+        double alpha = rz / pAp;
+        cblas_daxpy(n, alpha, p.data(), 1, x.data(), 1);
+        cblas_daxpy(n, -alpha, Ap.data(), 1, r.data(), 1);
+        m_lastPCGIterations = it + 1;
+
+        if (cblas_dnrm2(n, r.data(), 1) <= m_pcgTolerance * bNorm) {
+            return true;
+        }
+
+        applyPreconditioner(r, z);
+        double rzNew = cblas_ddot(n, r.data(), 1, z.data(), 1);
+        double beta = rzNew / rz;
+        rz = rzNew;
+
+        // p = z + β*p
+        cblas_dscal(n, beta, p.data(), 1);
+        cblas_daxpy(n, 1.0, z.data(), 1, p.data(), 1);
+    }
+
+    // 达到最大迭代次数：返回当前近似解
+    return true;
+}
+
+} // namespace MT
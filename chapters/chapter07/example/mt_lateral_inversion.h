@@ -0,0 +1,126 @@
+#ifndef MT_LATERAL_INVERSION_H
+#define MT_LATERAL_INVERSION_H
+
+#include "mt_model.h"
+#include "mt_forward_solver.h"
+#include "mt_jacobian_calculator.h"
+#include "mt_optimizer.h"
+#include <vector>
+#include <string>
+
+/**
+ * MT横向约束反演模块（拟二维）
+ * 联合反演剖面上K个相邻测站，通过横向平滑项耦合相邻测站的模型
+ *
+ * 联合正规方程为块三对角结构（K个M×M块）：
+ *   对角块   A_kk = J_k^T J_k + λ_v L^T L + λ_h deg_k I
+ *   非对角块 A_k,k±1 = -λ_h I
+ * 右端项   b_k = J_k^T r_k - λ_h (deg_k m_k - m_{k-1} - m_{k+1})
+ * 其中deg_k为测站k的相邻测站数。垂向正则化与单测站反演一致（作用于模型更新量），
+ * 横向平滑作用于完整模型，因此λ_h = 0时与逐站独立反演完全相同。
+ *
+ * 求解使用块Jacobi预条件共轭梯度法：矩阵向量乘只访问对角块和相邻测站，
+ * 每个预条件块只做一次Cholesky分解，存储和计算量都随测站数线性增长。
+ */
+namespace MT {
+
+class LateralInversion {
+public:
+    /**
+     * 进度回调函数类型（残差和模型更新范数为所有测站的合计）
+     */
+    typedef void (*ProgressCallback)(int iteration, double residual, double dmNorm, void* userData);
+
+    /**
+     * 构造函数
+     * @param forwardSolver 正演求解器指针（必须有效）
+     * @param jacobianCalculator Jacobian计算器指针（必须有效）
+     * @param optimizer 优化求解器指针（必须有效，用于计算J^T*J和J^T*r）
+     */
+    LateralInversion(ForwardSolver* forwardSolver,
+                     JacobianCalculator* jacobianCalculator,
+                     Optimizer* optimizer);
+    ~LateralInversion();
+
+    /**
+     * 执行横向约束反演
+     * @param results 输入输出：K个测站的反演结果（调用前需准备好omega、层厚度、dObs和mInit，
+     *                所有测站的层数必须相同）
+     * @param LTL 垂向正则化矩阵L^T*L（M×M）
+     * @param settings 反演设置（使用lambda、maxIter、tolDm、epsilon）
+     * @param lateralLambda 横向平滑参数λ_h
+     * @return 是否成功
+     */
+    bool invert(std::vector<InversionResult>& results,
+                const std::vector<std::vector<double>>& LTL,
+                const InversionParams& settings,
+                double lateralLambda);
+
+    /**
+     * 设置共轭梯度法参数
+     * @param tolerance 相对残差容差
+     * @param maxIterations 最大迭代次数
+     */
+    void setPCGParameters(double tolerance, int maxIterations);
+
+    /**
+     * 设置进度回调函数
+     * @param callback 回调函数
+     * @param userData 用户数据
+     */
+    void setProgressCallback(ProgressCallback callback, void* userData = nullptr);
+
+    /**
+     * 获取最近一次共轭梯度法的迭代次数
+     * @return 迭代次数
+     */
+    int getLastPCGIterations() const { return m_lastPCGIterations; }
+
+    /**
+     * 获取错误信息
+     * @return 错误信息
+     */
+    const std::string& getErrorMessage() const { return m_errorMessage; }
+
+private:
+    /**
+     * 块三对角矩阵与向量相乘：y = A*x
+     * @param blocks 对角块（K个M×M行主序矩阵，不含横向项）
+     * @param M 每块阶数
+     * @param lateralLambda 横向平滑参数
+     * @param x 输入向量（K*M）
+     * @param y 输出向量（K*M）
+     */
+    void applyBlockSystem(const std::vector<std::vector<double>>& blocks, int M,
+                          double lateralLambda,
+                          const std::vector<double>& x, std::vector<double>& y) const;
+
+    /**
+     * 块Jacobi预条件共轭梯度法求解A*x = b
+     * @param blocks 对角块（不含横向项）
+     * @param M 每块阶数
+     * @param lateralLambda 横向平滑参数
+     * @param b 右端项（K*M）
+     * @param x 输出解（K*M）
+     * @return 是否成功
+     */
+    bool solvePCG(const std::vector<std::vector<double>>& blocks, int M,
+                  double lateralLambda,
+                  const std::vector<double>& b, std::vector<double>& x);
+
+    ForwardSolver* m_forwardSolver;
+    JacobianCalculator* m_jacobianCalculator;
+    Optimizer* m_optimizer;
+
+    double m_pcgTolerance;      // 共轭梯度法相对容差
+    int m_pcgMaxIterations;     // 共轭梯度法最大迭代次数
+    int m_lastPCGIterations;    // 最近一次共轭梯度法迭代次数
+    std::string m_errorMessage; // 错误信息
+
+    ProgressCallback m_progressCallback;
+    void* m_progressUserData;
+};
+
+} // namespace MT
+
+#endif // MT_LATERAL_INVERSION_H
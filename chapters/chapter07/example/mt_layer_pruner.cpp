@@ -0,0 +1,204 @@
+#include "mt_layer_pruner.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+namespace MT {
+
+LayerPruner::LayerPruner(double threshold, int recheckInterval)
+    : m_threshold(threshold)
+    , m_recheckInterval(recheckInterval)
+    , m_doiFactor(1.5)
+    , m_mode(Mode::FREEZE)
+    , m_activeCount(0)
+    , m_lastDOI(0.0) {
+    if (!(threshold >= 0.0 && threshold < 1.0)) {
+        throw std::invalid_argument("Pruning threshold must be in [0, 1)");
+    }
+    if (recheckInterval <= 0) {
+        throw std::invalid_argument("Recheck interval must be positive");
+    }
+}
+
+LayerPruner::~LayerPruner() {
+}
+
+void LayerPruner::setDOIFactor(double factor) {
+    if (!(factor > 0.0) || !std::isfinite(factor)) {
+        throw std::invalid_argument("DOI factor must be positive");
+    }
+    m_doiFactor = factor;
+}
+
+double LayerPruner::estimateDOI(const std::vector<double>& mLogRho,
+                                const std::vector<double>& omega,
+                                const std::vector<double>& layerThicknesses) const {
+    int M = static_cast<int>(mLogRho.size());
+    if (M == 0 || omega.empty()) {
+        return 0.0;
+    }
+
+    // 最长周期对应最小角频率
+    double wMin = *std::min_element(omega.begin(), omega.end());
+    if (!(wMin > 0.0)) {
+        return 0.0;
+    }
+
+    // 自洽迭代：δ取决于δ以上的平均电阻率
+    double rho = pow(10.0, mLogRho[0]);
+    double delta = sqrt(2.0 * rho / (wMin * MU0));
+    for (int it = 0; it < 20; it++) {
+        // δ以上各层的电导加权平均（总厚度/总电导）
+        double depth = 0.0;
+        double conductance = 0.0;
+        for (int i = 0; i < M && depth < delta; i++) {
+            double h = (i < M - 1 && i < static_cast<int>(layerThicknesses.size()))
+                       ? std::min(layerThicknesses[i], delta - depth)
+                       : delta - depth;  // 底层视为半空间
+            conductance += h / pow(10.0, mLogRho[i]);
+            depth += h;
+        }
+        if (!(conductance > 0.0) || !std::isfinite(conductance)) {
+            break;
+        }
+        double newDelta = sqrt(2.0 * (depth / conductance) / (wMin * MU0));
+        if (!std::isfinite(newDelta) || fabs(newDelta - delta) <= 1e-3 * delta) {
+            if (std::isfinite(newDelta)) delta = newDelta;
+            break;
+        }
+        delta = newDelta;
+    }
+    return delta;
+}
+
+int LayerPruner::update(const std::vector<double>& mLogRho,
+                        const std::vector<double>& omega,
+                        const std::vector<double>& layerThicknesses,
+                        const std::vector<std::vector<double>>& J) {
+    int M = static_cast<int>(mLogRho.size());
+    int nData = static_cast<int>(J.size());
+    m_activeLayers.assign(M, true);
+    m_activeCount = M;
+    m_lastDOI = estimateDOI(mLogRho, omega, layerThicknesses);
+    if (M <= 1 || nData == 0) {
+        return m_activeCount;
+    }
+
+    // 1. 各层灵敏度：Jacobian列范数平方
+    std::vector<double> sensitivity(M, 0.0);
+    for (int i = 0; i < nData; i++) {
+        for (int j = 0; j < M; j++) {
+            sensitivity[j] += J[i][j] * J[i][j];
+        }
+    }
+    double total = 0.0;
+    for (int j = 0; j < M; j++) {
+        total += sensitivity[j];
+    }
+    if (!(total > 0.0) || !std::isfinite(total)) {
+        return m_activeCount;
+    }
+
+    // 2. 自底向上累计灵敏度，找到满足条件的最浅层
+    double doiLimit = m_doiFactor * m_lastDOI;
+    double tail = 0.0;
+    double depth = 0.0;
+    std::vector<double> layerTop(M);
+    for (int j = 0; j < M; j++) {
+        layerTop[j] = depth;
+        if (j < static_cast<int>(layerThicknesses.size())) {
+            depth += layerThicknesses[j];
+        }
+    }
+    int firstFrozen = M;
+    for (int j = M - 1; j >= 1; j--) {
+        tail += sensitivity[j];
+        if (layerTop[j] <= doiLimit || tail / total >= m_threshold) {
+            break;
+        }
+        firstFrozen = j;
+    }
+
+    for (int j = firstFrozen; j < M; j++) {
+        m_activeLayers[j] = false;
+    }
+    m_activeCount = firstFrozen;
+    return m_activeCount;
+}
+
+bool LayerPruner::needsRecheck(int iteration) const {
+    return m_activeLayers.empty() || iteration % m_recheckInterval == 0;
+}
+
+bool LayerPruner::isMerging() const {
+    return m_mode == Mode::MERGE && m_activeCount > 0 &&
+           m_activeCount < static_cast<int>(m_activeLayers.size());
+}
+
+void LayerPruner::mergeJacobian(std::vector<std::vector<double>>& J) const {
+    if (!isMerging()) {
+        return;
+    }
+    const int M = static_cast<int>(m_activeLayers.size());
+    const int deepest = m_activeCount - 1;
+    for (std::vector<double>& row : J) {
+        if (row.size() != static_cast<size_t>(M)) {
+            continue;
+        }
+        for (int j = m_activeCount; j < M; j++) {
+            row[deepest] += row[j];
+            row[j] = 0.0;
+        }
+    }
+}
+
+void LayerPruner::mergeMatrix(std::vector<std::vector<double>>& A) const {
+    const int M = static_cast<int>(m_activeLayers.size());
+    if (!isMerging() || A.size() != static_cast<size_t>(M)) {
+        return;
+    }
+    const int deepest = m_activeCount - 1;
+    // 行合并：P^T*A
+    for (int i = m_activeCount; i < M; i++) {
+        for (int j = 0; j < M; j++) {
+            A[deepest][j] += A[i][j];
+        }
+        A[i].assign(M, 0.0);
+    }
+    // 列合并：(P^T*A)*P
+    for (int i = 0; i < M; i++) {
+        for (int j = m_activeCount; j < M; j++) {
+            A[i][deepest] += A[i][j];
+            A[i][j] = 0.0;
+        }
+    }
+}
+
+void LayerPruner::mergeVector(std::vector<double>& v) const {
+    const int M = static_cast<int>(m_activeLayers.size());
+    if (!isMerging() || v.size() != static_cast<size_t>(M)) {
+        return;
+    }
+    for (int j = m_activeCount; j < M; j++) {
+        v[m_activeCount - 1] += v[j];
+        v[j] = 0.0;
+    }
+}
+
+void LayerPruner::applyMerge(std::vector<double>& dm) const {
+    if (!isMerging() || m_activeLayers.size() != dm.size()) {
+        return;
+    }
+    double deepest = dm[m_activeCount - 1];
+    for (size_t j = m_activeCount; j < dm.size(); j++) {
+        dm[j] = deepest;
+    }
+}
+
+void LayerPruner::reset() {
+    m_activeLayers.clear();
+    m_activeCount = 0;
+    m_lastDOI = 0.0;
+}
+
+} // namespace MT
@@ -0,0 +1,151 @@
+#ifndef MT_LAYER_PRUNER_H
+#define MT_LAYER_PRUNER_H
+
+#include "mt_model.h"
+#include <vector>
+
+/**
+ * MT自适应层裁剪模块
+ * 根据探测深度和累计灵敏度冻结深部层，减少Jacobian有限差分的正演次数
+ *
+ * 探测深度（DOI）由当前模型在最长周期下的趋肤深度估计：
+ *   δ = sqrt(2ρ/(ωμ0))，ρ取δ以上各层的电导加权平均电阻率（迭代求自洽解）。
+ * 位于DOI以下、且自该层向下的累计灵敏度（Jacobian列范数平方之和）
+ * 占总灵敏度比例低于阈值的连续底部层被冻结，其Jacobian列不再计算。
+ * 模型变化会改变DOI，因此每隔若干次迭代用完整Jacobian重新检查。
+ *
+ * 合并模式下最深的活动层与其下的冻结层构成一个参数块 m_B = m_B0 + P*δp（P为全1列）：
+ * 求解前把冻结层的Jacobian列、L^T*L的行列和右端项并入最深活动层（J*P、P^T*L^T*L*P、P^T*g），
+ * 求得块的更新量后再复制到块内各层。
+ */
+namespace MT {
+
+class LayerPruner {
+public:
+    /**
+     * 冻结层的处理方式
+     */
+    enum class Mode {
+        FREEZE,  // 冻结：冻结层保持当前值不再更新
+        MERGE    // 合并：冻结层与最深的活动层合并，跟随其一起更新
+    };
+
+    /**
+     * 构造函数
+     * @param threshold 累计灵敏度比例阈值（低于该值的底部层被冻结）
+     * @param recheckInterval 重新检查间隔（迭代次数）
+     */
+    explicit LayerPruner(double threshold = 0.01, int recheckInterval = 3);
+    ~LayerPruner();
+
+    /**
+     * 估计探测深度
+     * @param mLogRho 当前模型（log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @return 探测深度（米）
+     */
+    double estimateDOI(const std::vector<double>& mLogRho,
+                       const std::vector<double>& omega,
+                       const std::vector<double>& layerThicknesses) const;
+
+    /**
+     * 根据完整Jacobian更新活动层掩码
+     * @param mLogRho 当前模型（log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param J 完整Jacobian矩阵（nData行×M列）
+     * @return 活动层数
+     */
+    int update(const std::vector<double>& mLogRho,
+               const std::vector<double>& omega,
+               const std::vector<double>& layerThicknesses,
+               const std::vector<std::vector<double>>& J);
+
+    /**
+     * 判断本次迭代是否需要用完整Jacobian重新检查
+     * @param iteration 迭代序号（从0开始）
+     * @return 是否需要重新检查
+     */
+    bool needsRecheck(int iteration) const;
+
+    /**
+     * 是否处于合并模式且有冻结层（此时正规方程需先合并）
+     */
+    bool isMerging() const;
+
+    /**
+     * 合并模式下把冻结层的Jacobian列加到最深活动层的列上，冻结层的列置零（J*P）
+     * 已按块扰动计算的Jacobian（冻结层列为零）不受影响
+     * @param J 输入输出：Jacobian矩阵（nData行×M列）
+     */
+    void mergeJacobian(std::vector<std::vector<double>>& J) const;
+
+    /**
+     * 合并模式下把对称矩阵的冻结层行列并入最深活动层（P^T*A*P），冻结层的行列置零
+     * @param A 输入输出：M×M对称矩阵（如L^T*L）
+     */
+    void mergeMatrix(std::vector<std::vector<double>>& A) const;
+
+    /**
+     * 合并模式下把向量的冻结层分量加到最深活动层上（P^T*v），冻结层分量置零
+     * @param v 输入输出：M维向量（如L^T*L*m）
+     */
+    void mergeVector(std::vector<double>& v) const;
+
+    /**
+     * 合并模式下把最深活动层（即整个块）的更新量复制到冻结层
+     * 更新量应由合并后的正规方程求得
+     * @param dm 输入输出：模型更新向量
+     */
+    void applyMerge(std::vector<double>& dm) const;
+
+    /**
+     * 重置为所有层活动
+     */
+    void reset();
+
+    /**
+     * 获取活动层掩码（true表示该层参与反演）
+     * @return 掩码
+     */
+    const std::vector<bool>& getActiveLayers() const { return m_activeLayers; }
+
+    /**
+     * 获取活动层数
+     * @return 活动层数
+     */
+    int getActiveCount() const { return m_activeCount; }
+
+    /**
+     * 获取最近一次估计的探测深度
+     * @return 探测深度（米）
+     */
+    double getLastDOI() const { return m_lastDOI; }
+
+    /**
+     * 设置冻结层处理方式
+     * @param mode 处理方式
+     */
+    void setMode(Mode mode) { m_mode = mode; }
+    Mode getMode() const { return m_mode; }
+
+    /**
+     * 设置DOI安全系数（冻结层顶深度必须大于DOI乘以该系数）
+     * @param factor 安全系数
+     */
+    void setDOIFactor(double factor);
+
+private:
+    double m_threshold;          // 累计灵敏度比例阈值
+    int m_recheckInterval;       // 重新检查间隔
+    double m_doiFactor;          // DOI安全系数
+    Mode m_mode;                 // 冻结层处理方式
+    std::vector<bool> m_activeLayers;  // 活动层掩码
+    int m_activeCount;           // 活动层数
+    double m_lastDOI;            // 最近一次估计的探测深度
+};
+
+} // namespace MT
+
+#endif // MT_LAYER_PRUNER_H
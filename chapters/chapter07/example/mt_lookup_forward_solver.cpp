@@ -0,0 +1,302 @@
+#include "mt_lookup_forward_solver.h"
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace MT {
+
+namespace {
+
+const double LN10 = 2.302585092994046;
+const int MAX_TABLE_NODES = 1025;      // 每个方向的最大节点数
+const int MAX_TANH_NODES = 65537;      // 一维表最大节点数
+
+// tanh((1+i)x)，x = 10^u；x很小时使用级数避免相对精度损失
+std::complex<double> exactTanh(double u) {
+    double x = pow(10.0, u);
+    std::complex<double> z(x, x);
+    if (x < 1e-3) {
+        return z - z * z * z / 3.0;
+    }
+    return std::tanh(z);
+}
+
+// 两层模型的归一化地表阻抗R = Z/Z01的复对数
+std::complex<double> exactLogImpedance(double c, double u) {
+    double q = sqrt(pow(10.0, c));  // Z02/Z01 = sqrt(ρ2/ρ1)
+    std::complex<double> t = exactTanh(u);
+    return std::log((q + t) / (1.0 + q * t));
+}
+
+// 线性插值的节点位置：返回左节点序号和权重
+inline void locate(double value, double minValue, double step, int n, int& index, double& weight) {
+    double pos = (value - minValue) / step;
+    index = std::min(std::max(static_cast<int>(pos), 0), n - 2);
+    weight = pos - index;
+}
+
+} // namespace
+
+LookupTableForwardSolver::LookupTableForwardSolver(double maxError)
+    : m_maxError(maxError)
+    , m_achievedError(0.0)
+    , m_nTanh(53)
+    , m_duTanh(0.0)
+    , m_nContrast(33)
+    , m_nRatio(33)
+    , m_dc(0.0)
+    , m_du(0.0)
+    , m_nLookups(0)
+    , m_nFallbacks(0) {
+    if (!(maxError > 0.0) || !std::isfinite(maxError)) {
+        throw std::invalid_argument("Lookup table error bound must be positive");
+    }
+    refineTables();
+}
+
+LookupTableForwardSolver::~LookupTableForwardSolver() {
+}
+
+void LookupTableForwardSolver::buildTables() {
+    // 1. 一维表：ln tanh((1+i)x)
+    m_duTanh = (RATIO_MAX - RATIO_MIN) / (m_nTanh - 1);
+    m_tanhRe.resize(m_nTanh);
+    m_tanhIm.resize(m_nTanh);
+    for (int i = 0; i < m_nTanh; i++) {
+        std::complex<double> v = std::log(exactTanh(RATIO_MIN + i * m_duTanh));
+        m_tanhRe[i] = v.real();
+        m_tanhIm[i] = v.imag();
+    }
+
+    // 2. 二维表：ln R(c, u)
+    m_dc = (CONTRAST_MAX - CONTRAST_MIN) / (m_nContrast - 1);
+    m_du = (RATIO_MAX - RATIO_MIN) / (m_nRatio - 1);
+    size_t n = static_cast<size_t>(m_nContrast) * m_nRatio;
+    m_tableRe.resize(n);
+    m_tableIm.resize(n);
+    for (int ic = 0; ic < m_nContrast; ic++) {
+        double c = CONTRAST_MIN + ic * m_dc;
+        for (int iu = 0; iu < m_nRatio; iu++) {
+            std::complex<double> v = exactLogImpedance(c, RATIO_MIN + iu * m_du);
+            m_tableRe[static_cast<size_t>(ic) * m_nRatio + iu] = v.real();
+            m_tableIm[static_cast<size_t>(ic) * m_nRatio + iu] = v.imag();
+        }
+    }
+}
+
+void LookupTableForwardSolver::refineTables() {
+    // 复对数的绝对误差即阻抗的相对误差；一维表和二维表各占一半误差预算
+    double budget = 0.5 * m_maxError;
+
+    for (;;) {
+        buildTables();
+
+        // 1. 一维表：检验相邻节点中点
+        double errTanh = 0.0;
+        for (int i = 0; i + 1 < m_nTanh; i++) {
+            double u = RATIO_MIN + (i + 0.5) * m_duTanh;
+            double re, im;
+            lookupLogTanh(u, re, im);
+            errTanh = std::max(errTanh, std::abs(std::complex<double>(re, im) - std::log(exactTanh(u))));
+        }
+
+        // 2. 二维表：分别检验两个方向的中点，误差超标的方向加密
+        double errContrast = 0.0;
+        double errRatio = 0.0;
+        for (int ic = 0; ic < m_nContrast; ic++) {
+            for (int iu = 0; iu < m_nRatio; iu++) {
+                double c = CONTRAST_MIN + ic * m_dc;
+                double u = RATIO_MIN + iu * m_du;
+                double re, im;
+                if (ic + 1 < m_nContrast) {
+                    lookupLogImpedance(c + 0.5 * m_dc, u, re, im);
+                    errContrast = std::max(errContrast, std::abs(std::complex<double>(re, im) -
+                                                                 exactLogImpedance(c + 0.5 * m_dc, u)));
+                }
+                if (iu + 1 < m_nRatio) {
+                    lookupLogImpedance(c, u + 0.5 * m_du, re, im);
+                    errRatio = std::max(errRatio, std::abs(std::complex<double>(re, im) -
+                                                           exactLogImpedance(c, u + 0.5 * m_du)));
+                }
+            }
+        }
+
+        // 双线性插值误差近似为两个方向误差之和
+        m_achievedError = std::max(errTanh, errContrast + errRatio);
+
+        bool refineTanh = errTanh > budget && m_nTanh < MAX_TANH_NODES;
+        bool refineContrast = errContrast > 0.5 * budget && m_nContrast < MAX_TABLE_NODES;
+        bool refineRatio = errRatio > 0.5 * budget && m_nRatio < MAX_TABLE_NODES;
+        if (!refineTanh && !refineContrast && !refineRatio) {
+            break;
+        }
+        if (refineTanh) m_nTanh = 2 * m_nTanh - 1;
+        if (refineContrast) m_nContrast = 2 * m_nContrast - 1;
+        if (refineRatio) m_nRatio = 2 * m_nRatio - 1;
+    }
+}
+
+void LookupTableForwardSolver::lookupLogTanh(double u, double& re, double& im) const {
+    if (u < RATIO_MIN) {
+        // 薄层：tanh级数的截断误差远小于插值误差
+        std::complex<double> v = std::log(exactTanh(u));
+        re = v.real();
+        im = v.imag();
+        return;
+    }
+    int i;
+    double w;
+    locate(u, RATIO_MIN, m_duTanh, m_nTanh, i, w);
+    re = (1.0 - w) * m_tanhRe[i] + w * m_tanhRe[i + 1];
+    im = (1.0 - w) * m_tanhIm[i] + w * m_tanhIm[i + 1];
+}
+
+void LookupTableForwardSolver::lookupLogImpedance(double c, double u, double& re, double& im) const {
+    if (u < RATIO_MIN) {
+        std::complex<double> v = exactLogImpedance(c, u);
+        re = v.real();
+        im = v.imag();
+        return;
+    }
+    int ic, iu;
+    double wc, wu;
+    locate(c, CONTRAST_MIN, m_dc, m_nContrast, ic, wc);
+    locate(u, RATIO_MIN, m_du, m_nRatio, iu, wu);
+
+    size_t i00 = static_cast<size_t>(ic) * m_nRatio + iu;
+    size_t i10 = i00 + m_nRatio;
+    double w00 = (1.0 - wc) * (1.0 - wu);
+    double w01 = (1.0 - wc) * wu;
+    double w10 = wc * (1.0 - wu);
+    double w11 = wc * wu;
+    re = w00 * m_tableRe[i00] + w01 * m_tableRe[i00 + 1] + w10 * m_tableRe[i10] + w11 * m_tableRe[i10 + 1];
+    im = w00 * m_tableIm[i00] + w01 * m_tableIm[i00 + 1] + w10 * m_tableIm[i10] + w11 * m_tableIm[i10 + 1];
+}
+
+bool LookupTableForwardSolver::inTableRange(const std::vector<double>& mLogRho,
+                                            const std::vector<double>& omega,
+                                            const std::vector<double>& layerThicknesses) const {
+    int M = static_cast<int>(mLogRho.size());
+    if (M < 1 || M > 3 || layerThicknesses.size() != static_cast<size_t>(M)) {
+        return false;
+    }
+    for (int i = 0; i < M; i++) {
+        if (!std::isfinite(mLogRho[i])) {
+            return false;
+        }
+        if (i < M - 1 && !(layerThicknesses[i] > 0.0 && std::isfinite(layerThicknesses[i]))) {
+            return false;
+        }
+        if (i > 0) {
+            double c = mLogRho[i] - mLogRho[i - 1];
+            if (c < CONTRAST_MIN || c > CONTRAST_MAX) {
+                return false;
+            }
+        }
+    }
+    for (size_t f = 0; f < omega.size(); f++) {
+        if (!(omega[f] > 0.0) || !std::isfinite(omega[f])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LookupTableForwardSolver::solve(const std::vector<double>& mLogRho,
+                                     const std::vector<double>& omega,
+                                     const std::vector<double>& layerThicknesses,
+                                     std::vector<double>& dataOut) {
+    int M = static_cast<int>(mLogRho.size());
+    int nFreq = static_cast<int>(omega.size());
+
+    // 1. 只有1~3层且参数在表格范围内时查表；否则直接用基类的递推阻抗换算
+    //    （不能经由ForwardSolver::solve()，它会调用本类重写的computeImpedance()）
+    if (!inTableRange(mLogRho, omega, layerThicknesses)) {
+        m_nFallbacks++;
+        std::vector<MKL_Complex16> Z;
+        ForwardSolver::computeImpedance(mLogRho, omega, layerThicknesses, Z);
+        std::vector<double> components;
+        impedanceToComponents(Z, omega, { DataComponent::LOG_RHO_XY, DataComponent::PHASE_XY }, components);
+        dataOut.resize(static_cast<size_t>(nFreq) * 2);
+        for (int f = 0; f < nFreq; f++) {
+            dataOut[2 * f] = components[f];
+            dataOut[2 * f + 1] = components[static_cast<size_t>(nFreq) + f];
+        }
+        return;
+    }
+
+    // 2. 逐频率计算层厚/趋肤深度之比 u = log10(h/δ)，δ = sqrt(2ρ/(ωμ0))
+    //    u = log10(h) - 0.5*log10(2/μ0) - 0.5*log10(ρ) + 0.5*log10(ω)
+    std::vector<double> logOmega(nFreq);
+    for (int f = 0; f < nFreq; f++) {
+        logOmega[f] = log10(omega[f]);
+    }
+    const double logSkinConst = 0.5 * log10(2.0 / MU0);
+
+    std::vector<double> uLayer(static_cast<size_t>(M) * nFreq);
+    for (int i = 0; i < M - 1; i++) {
+        double base = log10(layerThicknesses[i]) - logSkinConst - 0.5 * mLogRho[i];
+        for (int f = 0; f < nFreq; f++) {
+            // 很厚的层等效于半空间；很薄的层在查表函数中使用级数
+            uLayer[static_cast<size_t>(i) * nFreq + f] = std::min(base + 0.5 * logOmega[f], RATIO_MAX);
+        }
+    }
+
+    m_nLookups++;
+    dataOut.resize(static_cast<size_t>(nFreq) * 2);
+
+    const double radToDeg = 180.0 / M_PI;
+    for (int f = 0; f < nFreq; f++) {
+        double re = 0.0, im = 0.0;  // 均匀半空间：R = 1
+        if (M == 2) {
+            lookupLogImpedance(mLogRho[1] - mLogRho[0], uLayer[f], re, im);
+        } else if (M == 3) {
+            // 下两层的归一化阻抗，再换算到第一层的归一化：q = R2 * sqrt(ρ2/ρ1)
+            double re2, im2;
+            lookupLogImpedance(mLogRho[2] - mLogRho[1], uLayer[static_cast<size_t>(nFreq) + f], re2, im2);
+            std::complex<double> q = std::exp(std::complex<double>(re2 + 0.5 * LN10 * (mLogRho[1] - mLogRho[0]), im2));
+
+            double reT, imT;
+            lookupLogTanh(uLayer[f], reT, imT);
+            std::complex<double> t = std::exp(std::complex<double>(reT, imT));
+
+            std::complex<double> logR = std::log((q + t) / (1.0 + q * t));
+            re = logR.real();
+            im = logR.imag();
+        }
+
+        // log10(ρ_a) = log10(ρ1) + 2*ln|R|/ln10，相位 = 45° + arg(R)
+        dataOut[2 * f] = mLogRho[0] + 2.0 * re / LN10;
+        dataOut[2 * f + 1] = 45.0 + im * radToDeg;
+    }
+}
+
+void LookupTableForwardSolver::computeImpedance(const std::vector<double>& mLogRho,
+                                                const std::vector<double>& omega,
+                                                const std::vector<double>& layerThicknesses,
+                                                std::vector<MKL_Complex16>& Z) {
+    if (!inTableRange(mLogRho, omega, layerThicknesses)) {
+        m_nFallbacks++;
+        ForwardSolver::computeImpedance(mLogRho, omega, layerThicknesses, Z);
+        return;
+    }
+    std::vector<double> data;
+    solve(mLogRho, omega, layerThicknesses, data);
+
+    int nFreq = static_cast<int>(omega.size());
+    Z.resize(nFreq);
+    const double degToRad = M_PI / 180.0;
+    for (int f = 0; f < nFreq; f++) {
+        double magnitude = sqrt(pow(10.0, data[2 * f]) * omega[f] * MU0);
+        double phase = data[2 * f + 1] * degToRad;
+        Z[f].real = magnitude * cos(phase);
+        Z[f].imag = magnitude * sin(phase);
+    }
+}
+
+} // namespace MT
@@ -0,0 +1,142 @@
+#ifndef MT_LOOKUP_FORWARD_SOLVER_H
+#define MT_LOOKUP_FORWARD_SOLVER_H
+
+#include "mt_forward_solver.h"
+#include <vector>
+#include <atomic>
+
+/**
+ * MT查表正演求解器模块
+ * 面向1~3层简单模型的快速正演（测站筛选），以预计算的插值表代替递推计算
+ *
+ * 以第一层特征阻抗归一化后，两层模型的地表阻抗只依赖两个无量纲量：
+ *   c = log10(ρ2/ρ1)（电阻率对比度），u = log10(h1/δ1)（层厚与趋肤深度之比）
+ * 二维表存储归一化阻抗的复对数ln R(c, u)，因此
+ *   log10(ρ_a) = log10(ρ1) + 2 Re(ln R)/ln10，相位 = 45° + Im(ln R)
+ * 三层模型用二维表得到下两层的归一化阻抗，再用一维表tanh((1+i)h/δ)向上递推一层。
+ * 表格在构造时按误差界逐级加密。比表格下限更薄的层直接使用tanh级数；
+ * 对比度超出表格范围或超过3层时退回递推解析法。
+ *
+ * 构造后表格只读，计数器为原子变量，同一实例可由多个线程共享。
+ * 反演核心默认使用递推解析法；本后端需通过MTInversionCore::setForwardSolver()显式启用。
+ */
+namespace MT {
+
+class LookupTableForwardSolver : public ForwardSolver {
+public:
+    /**
+     * 构造函数（构造时生成插值表）
+     * @param maxError 归一化阻抗的最大相对插值误差
+     *                （log10(ρ_a)误差约为0.87*maxError，相位误差约为57.3*maxError度）
+     */
+    explicit LookupTableForwardSolver(double maxError = 1e-3);
+    ~LookupTableForwardSolver() override;
+
+    using ForwardSolver::solve;
+
+    /**
+     * 执行正演计算（1~3层模型查表，其余情况使用递推解析法）
+     * @param mLogRho 模型参数（log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param dataOut 输出的MT响应数据（log10(ρ_a)和相位）
+     */
+    void solve(const std::vector<double>& mLogRho,
+               const std::vector<double>& omega,
+               const std::vector<double>& layerThicknesses,
+               std::vector<double>& dataOut) override;
+
+    /**
+     * 计算各频率的地表阻抗（由查表得到的log10(ρ_a)和相位换算：|Z| = sqrt(ρ_a*ωμ0)；
+     * 超出表格范围时直接使用基类的递推解析法）
+     * @param mLogRho 模型参数（log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param Z 输出的地表阻抗
+     */
+    void computeImpedance(const std::vector<double>& mLogRho,
+                          const std::vector<double>& omega,
+                          const std::vector<double>& layerThicknesses,
+                          std::vector<MKL_Complex16>& Z) override;
+
+    /**
+     * 获取要求的误差界
+     * @return 最大相对误差
+     */
+    double getMaxError() const { return m_maxError; }
+
+    /**
+     * 获取表格加密后在检验点上实测的最大相对误差
+     * @return 实测误差
+     */
+    double getAchievedError() const { return m_achievedError; }
+
+    /**
+     * 获取表格尺寸
+     * @param nContrast 对比度方向节点数
+     * @param nRatio 厚度比方向节点数
+     */
+    void getTableSize(int& nContrast, int& nRatio) const {
+        nContrast = m_nContrast;
+        nRatio = m_nRatio;
+    }
+
+    /**
+     * 获取查表次数和退回递推法的次数（用于统计命中率）
+     */
+    long long getLookupCount() const { return m_nLookups.load(); }
+    long long getFallbackCount() const { return m_nFallbacks.load(); }
+
+    // 表格范围（超出范围时退回递推解析法）
+    static constexpr double CONTRAST_MIN = -4.0;  // log10(ρ2/ρ1)下限
+    static constexpr double CONTRAST_MAX = 4.0;   // log10(ρ2/ρ1)上限
+    static constexpr double RATIO_MIN = -4.0;     // log10(h/δ)下限（以下使用tanh级数）
+    static constexpr double RATIO_MAX = 1.2;      // log10(h/δ)上限（以上tanh((1+i)h/δ)与1的差小于1e-9）
+
+private:
+    /**
+     * 判断模型和频率是否在表格适用范围内（1~3层、对比度在表格范围内、角频率为正）
+     */
+    bool inTableRange(const std::vector<double>& mLogRho,
+                      const std::vector<double>& omega,
+                      const std::vector<double>& layerThicknesses) const;
+
+    /**
+     * 按当前节点数生成表格
+     */
+    void buildTables();
+
+    /**
+     * 逐级加密表格，直到检验点误差满足误差界
+     */
+    void refineTables();
+
+    /**
+     * 一维表插值：ln tanh((1+i)x)，u = log10(x)
+     */
+    void lookupLogTanh(double u, double& re, double& im) const;
+
+    /**
+     * 二维表插值：归一化阻抗的复对数ln R(c, u)
+     */
+    void lookupLogImpedance(double c, double u, double& re, double& im) const;
+
+    double m_maxError;        // 要求的误差界
+    double m_achievedError;   // 实测误差
+
+    int m_nTanh;              // 一维表节点数
+    double m_duTanh;          // 一维表步长
+    std::vector<double> m_tanhRe, m_tanhIm;
+
+    int m_nContrast;          // 二维表对比度方向节点数
+    int m_nRatio;             // 二维表厚度比方向节点数
+    double m_dc, m_du;        // 二维表步长
+    std::vector<double> m_tableRe, m_tableIm;  // 行主序：[ic * m_nRatio + iu]
+
+    std::atomic<long long> m_nLookups;     // 查表次数
+    std::atomic<long long> m_nFallbacks;   // 退回递推法次数
+};
+
+} // namespace MT
+
+#endif // MT_LOOKUP_FORWARD_SOLVER_H
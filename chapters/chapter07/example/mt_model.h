@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 /**
  * MT反演数据模型模块
@@ -14,6 +15,48 @@ namespace MT {
 // 常量定义
 constexpr double MU0 = 4e-7 * 3.14159265358979323846;  // 真空磁导率
 
+/**
+ * MT数据分量（一维模型：Z_xy = Z，Z_yx = -Z，Z_xx = Z_yy = 0，倾子为0）
+ * 多分量数据按分量优先存储：data[c * nFreq + f]，所有分量由同一次阻抗递推得到
+ */
+enum class DataComponent {
+    LOG_RHO_XY,   // log10(ρ_a)，由Z_xy计算
+    PHASE_XY,     // 相位（度），由Z_xy计算
+    LOG_RHO_YX,   // log10(ρ_a)，由Z_yx计算
+    PHASE_YX,     // 相位（度），由Z_yx计算
+    RE_ZXY,       // Re(Z_xy)（Ω）
+    IM_ZXY,       // Im(Z_xy)（Ω）
+    RE_ZYX,       // Re(Z_yx)（Ω）
+    IM_ZYX,       // Im(Z_yx)（Ω）
+    LOG_RHO_DET,  // log10(ρ_a)，由行列式不变量Z_det = sqrt(Z_xx*Z_yy - Z_xy*Z_yx)计算
+    PHASE_DET     // 相位（度），由Z_det计算
+};
+
+/**
+ * 反演的模型参数化方式
+ */
+enum class ModelBasis {
+    LAYERS,   // 每层一个log10(ρ)参数
+    BSPLINE,  // log10(深度)上的B样条系数（见ModelParameterization）
+    PCA       // 先验模型样本的均值和主成分系数
+};
+
+/**
+ * 反演迭代引擎
+ */
+enum class InversionEngine {
+    GAUSS_NEWTON,  // 内置高斯-牛顿循环（正则化作用于模型更新量；occam为true时为Occam反演）
+    TRUST_REGION   // MKL信赖域非线性最小二乘（dtrnlsp，数据残差与λ^(1/2)*L*m堆叠，见TrustRegionSolver）
+};
+
+/**
+ * 信赖域引擎的Jacobian来源
+ */
+enum class TrustRegionJacobian {
+    CALCULATOR,   // JacobianCalculator（前向差分，与内置循环相同）
+    MKL_DJACOBI   // MKL djacobix（中心差分，对整个堆叠残差求导）
+};
+
 /**
  * 反演参数结构
  */
@@ -26,6 +69,26 @@ struct InversionParams {
     double lambda = 1.0;                 // 正则化参数
     double firstLayerThickness = 10.0;    // 第一层厚度（米）
     double thicknessGrowth = 1.2;        // 厚度增长系数
+    std::string stationId;               // 测站ID（合成数据噪声流的密钥）
+    double noiseLevel = 0.02;            // 合成数据相对噪声水平（2%）
+    unsigned int noiseSeed = 12345;      // 合成数据噪声随机种子
+    bool adaptivePruning = false;        // 是否启用自适应层裁剪（冻结探测深度以下的低灵敏度层）
+    double pruneThreshold = 0.01;        // 层裁剪的累计灵敏度比例阈值
+    int pruneRecheckInterval = 3;        // 层裁剪的重新检查间隔（迭代次数）
+    bool pruneMergeLayers = false;       // 冻结层是否与最深活动层合并（否则保持当前值）
+    bool occam = false;                  // 是否使用Occam反演（每次迭代搜索λ，取达到目标拟合差的最光滑模型，不使用lambda）
+    double targetMisfit = 0.0;           // Occam目标残差范数（<= 0时由noiseLevel估计期望的噪声残差范数）
+    double occamLambdaMin = 1e-2;        // Occam λ搜索下限
+    double occamLambdaMax = 1e5;         // Occam λ搜索上限
+    bool computeResolution = true;       // 反演结束后是否计算分辨率、后验标准差和探测深度
+    double doiThreshold = 0.1;           // 探测深度的分辨率阈值（相对于分辨率对角元的最大值）
+    std::vector<DataComponent> components; // 数据分量（为空时dObs为log10(ρ_a)和相位交替存储；
+                                           // 非空时dObs按分量优先存储：dObs[c * nFreq + f]）
+    ModelBasis modelBasis = ModelBasis::LAYERS; // 模型参数化方式（非LAYERS时在nBasis维系数空间中反演）
+    int nBasis = 25;                     // 基函数个数（modelBasis非LAYERS时）
+    std::vector<std::vector<double>> priorModels; // 先验模型样本（modelBasis为PCA时，每个为M层的log10(ρ)）
+    InversionEngine engine = InversionEngine::GAUSS_NEWTON; // 迭代引擎（TRUST_REGION不支持occam和adaptivePruning）
+    TrustRegionJacobian trustRegionJacobian = TrustRegionJacobian::CALCULATOR; // 信赖域引擎的Jacobian来源
     
     // 可选：如果提供了观测数据，将使用这些数据而不是生成新的
     std::vector<double> dObs;             // 观测数据（如果为空，将使用默认模型生成）
@@ -42,6 +105,7 @@ struct InversionParams {
 struct InversionResult {
     bool success = false;                    // 是否成功
     int nIterations = 0;                     // 迭代次数
+    std::string stationId;                   // 测站ID
     std::vector<double> mTrue;               // 真实模型（log10(ρ)）
     std::vector<double> mInit;               // 初始模型（log10(ρ)）
     std::vector<double> mFinal;              // 最终反演结果（log10(ρ)）
@@ -49,13 +113,35 @@ struct InversionResult {
     std::vector<double> layerDepths;         // 各层顶部深度（米），从地表0开始
     std::vector<double> periods;             // 周期数组
     std::vector<double> omega;               // 角频率数组
+    std::vector<DataComponent> components;   // 数据分量（为空时为log10(ρ_a)和相位交替存储）
     std::vector<double> dObs;                // 观测数据
     std::vector<double> dSyn;                // 最终合成数据
     std::vector<double> residualHistory;     // 残差历史
     std::vector<double> dmNormHistory;       // 模型更新范数历史
+    std::vector<int> activeLayerHistory;     // 活动层数历史（启用自适应层裁剪时）
+    std::vector<double> lambdaHistory;       // 各次迭代选用的正则化参数（Occam反演时）
+    std::vector<double> resolutionDiag;      // 模型分辨率矩阵对角元（最后一次迭代的线性化）
+    std::vector<double> posteriorStd;        // 后验标准差（log10(ρ)）
+    double doi = 0.0;                        // 由分辨率估计的探测深度（米）
     std::string errorMessage;                // 错误信息
 };
 
+/**
+ * 共享的只读反演结果
+ * 反演结束后结果不再修改，工作线程、界面和测区面板之间只传递引用计数指针，不复制各数据数组
+ */
+using SharedInversionResult = std::shared_ptr<const InversionResult>;
+
+/**
+ * 反演中间快照结构（每次迭代发布一次，用于实时显示）
+ */
+struct InversionSnapshot {
+    int iteration = 0;                       // 迭代序号（从1开始）
+    double residual = 0.0;                   // 当前残差范数
+    std::vector<double> mCurrent;            // 当前模型（log10(ρ)）
+    std::vector<double> dSyn;                // 当前模型的合成数据
+};
+
 /**
  * 模型参数结构
  */
@@ -80,8 +166,9 @@ struct FrequencyParams {
  * 观测数据结构
  */
 struct ObservationData {
-    std::vector<double> data;               // 观测数据（log10(ρ_a)和相位）
-    std::vector<double> dataStd;            // 数据标准差（可选）
+    std::vector<DataComponent> components;  // 数据分量（为空时data为log10(ρ_a)和相位交替存储）
+    std::vector<double> data;               // 观测数据（多分量时按分量优先存储：data[c * nFreq + f]）
+    std::vector<double> dataStd;            // 数据标准差（可选，与data布局相同）
     int nFreq = 0;                          // 频率点数
 };
 
@@ -0,0 +1,235 @@
+#include "mt_model_parameterization.h"
+#include <mkl.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace MT {
+
+ModelParameterization::ModelParameterization()
+    : m_type(Type::BSPLINE)
+    , m_M(0)
+    , m_K(0) {
+}
+
+ModelParameterization::~ModelParameterization() {
+}
+
+bool ModelParameterization::setupBSpline(const std::vector<double>& layerDepths,
+                                         const std::vector<double>& layerThicknesses,
+                                         int K) {
+    int M = static_cast<int>(layerDepths.size());
+    if (M < 2 || layerThicknesses.size() != static_cast<size_t>(M) || K < 2 || K > M) {
+        return false;
+    }
+
+    // 自变量：层中点深度的对数
+    std::vector<double> x(M);
+    for (int i = 0; i < M; i++) {
+        double z = layerDepths[i] + 0.5 * layerThicknesses[i];
+        if (!(z > 0.0) || !std::isfinite(z)) {
+            return false;
+        }
+        x[i] = log10(z);
+    }
+    double xMin = *std::min_element(x.begin(), x.end());
+    double xMax = *std::max_element(x.begin(), x.end());
+    if (!(xMax > xMin)) {
+        return false;
+    }
+
+    // 端点重复deg+1次的节点向量（K个基函数，K+deg+1个节点）
+    // 内部节点取层中点的分位数，保证每个基函数的支撑内都有层（否则B^T*B奇异）
+    const int deg = std::min(3, K - 1);
+    std::vector<double> sorted(x);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<double> t(K + deg + 1);
+    for (int j = 0; j <= deg; j++) {
+        t[j] = xMin;
+        t[K + j] = xMax;
+    }
+    for (int j = 1; j < K - deg; j++) {
+        double pos = static_cast<double>(j) * (M - 1) / (K - deg);
+        int i0 = static_cast<int>(pos);
+        double w = pos - i0;
+        t[deg + j] = i0 + 1 < M ? (1.0 - w) * sorted[i0] + w * sorted[i0 + 1] : sorted[M - 1];
+    }
+
+    // Cox–de Boor递推
+    m_basis.assign(static_cast<size_t>(M) * K, 0.0);
+    std::vector<double> N(K + deg);
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < K + deg; j++) {
+            N[j] = (t[j] <= x[i] && x[i] < t[j + 1]) ? 1.0 : 0.0;
+        }
+        if (x[i] >= xMax) {
+            N[K - 1] = 1.0;  // 右端点属于最后一个非退化区间
+        }
+        for (int p = 1; p <= deg; p++) {
+            for (int j = 0; j < K + deg - p; j++) {
+                double left = t[j + p] - t[j];
+                double right = t[j + p + 1] - t[j + 1];
+                double a = left > 0.0 ? (x[i] - t[j]) / left * N[j] : 0.0;
+                double b = right > 0.0 ? (t[j + p + 1] - x[i]) / right * N[j + 1] : 0.0;
+                N[j] = a + b;
+            }
+        }
+        std::copy(N.begin(), N.begin() + K, m_basis.begin() + static_cast<size_t>(i) * K);
+    }
+
+    m_type = Type::BSPLINE;
+    m_M = M;
+    m_K = K;
+    return true;
+}
+
+bool ModelParameterization::setupPCA(const std::vector<std::vector<double>>& priorModels, int K) {
+    int nSamples = static_cast<int>(priorModels.size());
+    if (nSamples < 2) {
+        return false;
+    }
+    int M = static_cast<int>(priorModels[0].size());
+    if (M < 1 || K < 2 || K > std::min(nSamples, M)) {
+        return false;
+    }
+    for (const std::vector<double>& model : priorModels) {
+        if (model.size() != static_cast<size_t>(M)) {
+            return false;
+        }
+    }
+
+    // 样本均值和去均值后的样本矩阵X（nSamples×M）
+    std::vector<double> mean(M, 0.0);
+    for (const std::vector<double>& model : priorModels) {
+        cblas_daxpy(M, 1.0 / nSamples, model.data(), 1, mean.data(), 1);
+    }
+    std::vector<double> X(static_cast<size_t>(nSamples) * M);
+    for (int s = 0; s < nSamples; s++) {
+        for (int i = 0; i < M; i++) {
+            X[static_cast<size_t>(s) * M + i] = priorModels[s][i] - mean[i];
+        }
+    }
+
+    // 样本协方差C = X^T*X / (n-1)，特征值按升序排列
+    std::vector<double> C(static_cast<size_t>(M) * M, 0.0);
+    cblas_dsyrk(CblasRowMajor, CblasUpper, CblasTrans, M, nSamples,
+                1.0 / (nSamples - 1), X.data(), M, 0.0, C.data(), M);
+    std::vector<double> eigenvalues(M);
+    if (LAPACKE_dsyev(LAPACK_ROW_MAJOR, 'V', 'U', M, C.data(), M, eigenvalues.data()) != 0) {
+        return false;
+    }
+    // 样本必须张成K-1维子空间
+    double largest = eigenvalues[M - 1];
+    if (!(largest > 0.0) || !(eigenvalues[M - K + 1] > 1e-12 * largest)) {
+        return false;
+    }
+
+    // 第一列为均值，其余为按特征值降序排列的主成分
+    m_basis.assign(static_cast<size_t>(M) * K, 0.0);
+    for (int i = 0; i < M; i++) {
+        m_basis[static_cast<size_t>(i) * K] = mean[i];
+        for (int k = 1; k < K; k++) {
+            m_basis[static_cast<size_t>(i) * K + k] = C[static_cast<size_t>(i) * M + (M - k)];
+        }
+    }
+
+    m_type = Type::PCA;
+    m_M = M;
+    m_K = K;
+    return true;
+}
+
+void ModelParameterization::toModel(const std::vector<double>& p, std::vector<double>& m) const {
+    if (p.size() != static_cast<size_t>(m_K)) {
+        throw std::invalid_argument("Coefficient vector size does not match the parameterization");
+    }
+    m.resize(m_M);
+    cblas_dgemv(CblasRowMajor, CblasNoTrans, m_M, m_K, 1.0, m_basis.data(), m_K,
+                p.data(), 1, 0.0, m.data(), 1);
+}
+
+bool ModelParameterization::project(const std::vector<double>& m, std::vector<double>& p) const {
+    if (m_K == 0 || m.size() != static_cast<size_t>(m_M)) {
+        return false;
+    }
+    // 正规方程B^T*B * p = B^T * m（K×K，Cholesky分解）
+    std::vector<double> G(static_cast<size_t>(m_K) * m_K, 0.0);
+    cblas_dsyrk(CblasRowMajor, CblasLower, CblasTrans, m_K, m_M,
+                1.0, m_basis.data(), m_K, 0.0, G.data(), m_K);
+    p.assign(m_K, 0.0);
+    cblas_dgemv(CblasRowMajor, CblasTrans, m_M, m_K, 1.0, m_basis.data(), m_K,
+                m.data(), 1, 0.0, p.data(), 1);
+    if (LAPACKE_dpotrf(LAPACK_ROW_MAJOR, 'L', m_K, G.data(), m_K) != 0) {
+        return false;
+    }
+    return LAPACKE_dpotrs(LAPACK_ROW_MAJOR, 'L', m_K, 1, G.data(), m_K, p.data(), 1) == 0;
+}
+
+void ModelParameterization::reduceMatrix(const std::vector<std::vector<double>>& A,
+                                         std::vector<std::vector<double>>& reduced) const {
+    if (A.size() != static_cast<size_t>(m_M)) {
+        throw std::invalid_argument("Matrix size does not match the parameterization");
+    }
+    std::vector<double> Aflat(static_cast<size_t>(m_M) * m_M);
+    for (int i = 0; i < m_M; i++) {
+        std::copy(A[i].begin(), A[i].begin() + m_M, Aflat.begin() + static_cast<size_t>(i) * m_M);
+    }
+
+    // AB = A * B（M×K），reduced = B^T * AB（K×K）
+    std::vector<double> AB(static_cast<size_t>(m_M) * m_K);
+    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m_M, m_K, m_M,
+                1.0, Aflat.data(), m_M, m_basis.data(), m_K, 0.0, AB.data(), m_K);
+    std::vector<double> R(static_cast<size_t>(m_K) * m_K);
+    cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, m_K, m_K, m_M,
+                1.0, m_basis.data(), m_K, AB.data(), m_K, 0.0, R.data(), m_K);
+
+    reduced.resize(m_K);
+    for (int i = 0; i < m_K; i++) {
+        reduced[i].assign(R.begin() + static_cast<size_t>(i) * m_K,
+                          R.begin() + static_cast<size_t>(i + 1) * m_K);
+    }
+}
+
+ParameterizedForwardSolver::ParameterizedForwardSolver(ForwardSolver* backend,
+                                                       const ModelParameterization* parameterization)
+    : m_backend(backend)
+    , m_parameterization(parameterization) {
+    if (!m_backend) {
+        throw std::invalid_argument("ParameterizedForwardSolver: backend must not be null");
+    }
+    if (!m_parameterization || m_parameterization->getParameterCount() == 0) {
+        throw std::invalid_argument("ParameterizedForwardSolver: parameterization must be set up");
+    }
+}
+
+ParameterizedForwardSolver::~ParameterizedForwardSolver() {
+}
+
+void ParameterizedForwardSolver::solve(const std::vector<double>& coefficients,
+                                       const std::vector<double>& omega,
+                                       const std::vector<double>& layerThicknesses,
+                                       std::vector<double>& dataOut) {
+    m_parameterization->toModel(coefficients, m_model);
+    m_backend->solve(m_model, omega, layerThicknesses, dataOut);
+}
+
+void ParameterizedForwardSolver::solveBatch(const std::vector<std::vector<double>>& coefficients,
+                                            const std::vector<double>& omega,
+                                            const std::vector<double>& layerThicknesses,
+                                            std::vector<std::vector<double>>& dataOut) {
+    std::vector<std::vector<double>> models(coefficients.size());
+    for (size_t k = 0; k < coefficients.size(); k++) {
+        m_parameterization->toModel(coefficients[k], models[k]);
+    }
+    m_backend->solveBatch(models, omega, layerThicknesses, dataOut);
+}
+
+void ParameterizedForwardSolver::computeImpedance(const std::vector<double>& coefficients,
+                                                  const std::vector<double>& omega,
+                                                  const std::vector<double>& layerThicknesses,
+                                                  std::vector<MKL_Complex16>& Z) {
+    m_parameterization->toModel(coefficients, m_model);
+    m_backend->computeImpedance(m_model, omega, layerThicknesses, Z);
+}
+
+} // namespace MT
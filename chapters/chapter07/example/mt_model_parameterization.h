@@ -0,0 +1,145 @@
+#ifndef MT_MODEL_PARAMETERIZATION_H
+#define MT_MODEL_PARAMETERIZATION_H
+
+#include "mt_model.h"
+#include "mt_forward_solver.h"
+#include <vector>
+
+/**
+ * MT模型降维参数化模块
+ * 把M层的log10(ρ)表示为K（K << M）个基函数的线性组合：m = B * p，B为M×K矩阵
+ *
+ * - B样条（BSPLINE）：以层中点深度的对数log10(z)为自变量的三次B样条（K < 4时降为K-1次），
+ *   内部节点取层中点的分位数（层厚按几何级数增长时近似为log10(z)上的均匀节点）。
+ *   B样条构成单位分解，均匀模型可精确表示。
+ * - 主成分（PCA）：由先验模型样本学习，第一列为样本均值，其余K-1列为样本协方差的前K-1个特征向量。
+ *
+ * 反演在K维系数空间中进行：ParameterizedForwardSolver把系数映射为层模型后交给正演后端，
+ * 因此Jacobian只需K+1次正演，正规方程为K×K；正则化矩阵取B^T * L^T*L * B，即仍约束层模型的粗糙度。
+ */
+namespace MT {
+
+class ModelParameterization {
+public:
+    /**
+     * 基函数类型
+     */
+    enum class Type {
+        BSPLINE,  // log10(深度)上的B样条
+        PCA       // 先验模型样本的均值和主成分
+    };
+
+    ModelParameterization();
+    ~ModelParameterization();
+
+    /**
+     * 生成log10(深度)上的B样条基
+     * @param layerDepths 各层顶部深度（米）
+     * @param layerThicknesses 各层厚度（米）
+     * @param K 基函数个数（2 <= K <= M）
+     * @return 是否成功
+     */
+    bool setupBSpline(const std::vector<double>& layerDepths,
+                      const std::vector<double>& layerThicknesses,
+                      int K);
+
+    /**
+     * 由先验模型样本生成主成分基
+     * @param priorModels 先验模型样本（每个为M层的log10(ρ)，至少2个）
+     * @param K 基函数个数（均值加K-1个主成分，2 <= K <= min(样本数, M)）
+     * @return 是否成功
+     */
+    bool setupPCA(const std::vector<std::vector<double>>& priorModels, int K);
+
+    /**
+     * 由系数计算层模型m = B * p
+     * @param p 系数（K维）
+     * @param m 输出的层模型（M维）
+     */
+    void toModel(const std::vector<double>& p, std::vector<double>& m) const;
+
+    /**
+     * 求最接近给定层模型的系数（最小二乘：B^T*B * p = B^T * m）
+     * @param m 层模型（M维）
+     * @param p 输出的系数（K维）
+     * @return 是否成功
+     */
+    bool project(const std::vector<double>& m, std::vector<double>& p) const;
+
+    /**
+     * 把层空间的对称矩阵变换到系数空间：B^T * A * B
+     * @param A M×M矩阵
+     * @param reduced 输出的K×K矩阵
+     */
+    void reduceMatrix(const std::vector<std::vector<double>>& A,
+                      std::vector<std::vector<double>>& reduced) const;
+
+    Type getType() const { return m_type; }
+    int getLayerCount() const { return m_M; }
+    int getParameterCount() const { return m_K; }
+
+    /**
+     * 获取基函数矩阵（M×K，行主序）
+     */
+    const std::vector<double>& getBasis() const { return m_basis; }
+
+private:
+    Type m_type;
+    int m_M;                      // 层数
+    int m_K;                      // 基函数个数
+    std::vector<double> m_basis;  // 基函数矩阵B（M×K，行主序）
+};
+
+/**
+ * 降维参数化正演适配器
+ * solve()等接口接收K维系数，映射为层模型后交给正演后端（层厚度原样传递）
+ */
+class ParameterizedForwardSolver : public ForwardSolver {
+public:
+    /**
+     * 构造函数
+     * @param backend 正演后端（必须有效，生命周期由调用方保证）
+     * @param parameterization 参数化（必须有效，生命周期由调用方保证）
+     */
+    ParameterizedForwardSolver(ForwardSolver* backend, const ModelParameterization* parameterization);
+    ~ParameterizedForwardSolver() override;
+
+    using ForwardSolver::solve;
+
+    /**
+     * 执行正演计算
+     * @param coefficients 基函数系数（K维）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组（M层）
+     * @param dataOut 输出的MT响应数据
+     */
+    void solve(const std::vector<double>& coefficients,
+               const std::vector<double>& omega,
+               const std::vector<double>& layerThicknesses,
+               std::vector<double>& dataOut) override;
+
+    /**
+     * 批量正演（映射后交给后端的solveBatch()，保留后端的批量优化）
+     */
+    void solveBatch(const std::vector<std::vector<double>>& coefficients,
+                    const std::vector<double>& omega,
+                    const std::vector<double>& layerThicknesses,
+                    std::vector<std::vector<double>>& dataOut) override;
+
+    /**
+     * 计算各频率的地表阻抗（映射后交给后端）
+     */
+    void computeImpedance(const std::vector<double>& coefficients,
+                          const std::vector<double>& omega,
+                          const std::vector<double>& layerThicknesses,
+                          std::vector<MKL_Complex16>& Z) override;
+
+private:
+    ForwardSolver* m_backend;
+    const ModelParameterization* m_parameterization;
+    std::vector<double> m_model;  // 映射后的层模型（复用内存）
+};
+
+} // namespace MT
+
+#endif // MT_MODEL_PARAMETERIZATION_H
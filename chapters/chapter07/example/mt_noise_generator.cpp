@@ -0,0 +1,81 @@
+#include "mt_noise_generator.h"
+#include <mkl_vsl.h>
+#include <cmath>
+#include <stdexcept>
+
+namespace MT {
+
+NoiseGenerator::NoiseGenerator(unsigned int seed)
+    : m_seed(seed) {
+}
+
+NoiseGenerator::~NoiseGenerator() {
+}
+
+void NoiseGenerator::setSeed(unsigned int seed) {
+    m_seed = seed;
+}
+
+unsigned long long NoiseGenerator::streamKey(unsigned int seed, const std::string& stationId,
+                                             unsigned int realization) {
+    // FNV-1a散列测站ID
+    unsigned long long h = 1469598103934665603ULL;
+    for (unsigned char c : stationId) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+
+    // 混入种子和实现序号（splitmix64终结函数，保证相近输入得到差异很大的密钥）
+    h ^= (static_cast<unsigned long long>(seed) << 32) | realization;
+    h += 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    h = h ^ (h >> 31);
+    return h;
+}
+
+void NoiseGenerator::generateGaussian(const std::string& stationId, int n, double* out,
+                                      unsigned int realization) const {
+    if (n <= 0) {
+        return;
+    }
+    if (!out) {
+        throw std::invalid_argument("噪声生成错误：输出数组不能为空");
+    }
+
+    // Philox4x32-10是计数器型生成器：密钥决定整条序列，不同密钥的流互相独立
+    unsigned long long key = streamKey(m_seed, stationId, realization);
+    const unsigned int params[2] = {
+        static_cast<unsigned int>(key & 0xFFFFFFFFULL),
+        static_cast<unsigned int>(key >> 32)
+    };
+
+    VSLStreamStatePtr stream;
+    int errcode = vslNewStreamEx(&stream, VSL_BRNG_PHILOX4X32X10, 2, params);
+    if (errcode != VSL_STATUS_OK) {
+        throw std::runtime_error("噪声生成错误：无法创建随机数流");
+    }
+
+    errcode = vdRngGaussian(VSL_RNG_METHOD_GAUSSIAN_BOXMULLER2, stream, n, out, 0.0, 1.0);
+    vslDeleteStream(&stream);
+    if (errcode != VSL_STATUS_OK) {
+        throw std::runtime_error("噪声生成错误：vdRngGaussian失败");
+    }
+}
+
+void NoiseGenerator::addRelativeNoise(const std::string& stationId, double noiseLevel,
+                                      std::vector<double>& data, unsigned int realization) const {
+    int n = static_cast<int>(data.size());
+    if (n <= 0 || noiseLevel <= 0.0 || !std::isfinite(noiseLevel)) {
+        return;
+    }
+
+    std::vector<double> noise(n);
+    generateGaussian(stationId, n, noise.data(), realization);
+
+    for (int i = 0; i < n; i++) {
+        data[i] += noise[i] * noiseLevel * fabs(data[i]);
+    }
+}
+
+} // namespace MT
@@ -0,0 +1,75 @@
+#ifndef MT_NOISE_GENERATOR_H
+#define MT_NOISE_GENERATOR_H
+
+#include "mt_model.h"
+#include <vector>
+#include <string>
+
+/**
+ * MT噪声生成模块
+ * 为合成观测数据添加可复现的高斯噪声
+ *
+ * 每次调用都会根据（种子，测站ID，实现序号）创建独立的计数器型随机数流
+ * （MKL VSL Philox4x32-10），不依赖任何全局或静态状态，
+ * 因此多个线程可以同时使用同一个对象，结果与线程数和调度顺序无关。
+ */
+namespace MT {
+
+class NoiseGenerator {
+public:
+    /**
+     * 构造函数
+     * @param seed 全局随机种子
+     */
+    explicit NoiseGenerator(unsigned int seed = 12345);
+    ~NoiseGenerator();
+
+    /**
+     * 生成标准正态分布随机数（使用vdRngGaussian向量化生成）
+     * @param stationId 测站ID（决定随机数流的密钥）
+     * @param n 随机数个数
+     * @param out 输出数组（至少n个元素）
+     * @param realization 实现序号（同一测站的多次独立噪声实现）
+     */
+    void generateGaussian(const std::string& stationId, int n, double* out,
+                          unsigned int realization = 0) const;
+
+    /**
+     * 添加相对高斯噪声：d_i += N(0, (noiseLevel * |d_i|)^2)
+     * @param stationId 测站ID
+     * @param noiseLevel 相对噪声水平（例如0.02表示2%）
+     * @param data 输入输出数据
+     * @param realization 实现序号
+     */
+    void addRelativeNoise(const std::string& stationId, double noiseLevel,
+                          std::vector<double>& data, unsigned int realization = 0) const;
+
+    /**
+     * 设置全局随机种子
+     * @param seed 随机种子
+     */
+    void setSeed(unsigned int seed);
+
+    /**
+     * 获取全局随机种子
+     * @return 随机种子
+     */
+    unsigned int getSeed() const { return m_seed; }
+
+    /**
+     * 计算随机数流密钥（64位，FNV-1a散列后再做混合）
+     * @param seed 全局随机种子
+     * @param stationId 测站ID
+     * @param realization 实现序号
+     * @return 64位密钥
+     */
+    static unsigned long long streamKey(unsigned int seed, const std::string& stationId,
+                                        unsigned int realization);
+
+private:
+    unsigned int m_seed;  // 全局随机种子（只读配置，不保存随机数状态）
+};
+
+} // namespace MT
+
+#endif // MT_NOISE_GENERATOR_H
@@ -0,0 +1,378 @@
+#include "mt_occam_search.h"
+#include "mt_thread_policy.h"
+#include <mkl.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace MT {
+
+OccamSearch::OccamSearch()
+    : m_lambdaMin(1e-2)
+    , m_lambdaMax(1e5)
+    , m_gridPoints(8)
+    , m_refineSteps(6)
+    , m_M(0) {
+}
+
+OccamSearch::~OccamSearch() {
+}
+
+void OccamSearch::setLambdaRange(double lambdaMin, double lambdaMax) {
+    if (!(lambdaMin > 0.0) || !(lambdaMax > lambdaMin) || !std::isfinite(lambdaMax)) {
+        throw std::invalid_argument("Occam lambda range must satisfy 0 < lambdaMin < lambdaMax");
+    }
+    m_lambdaMin = lambdaMin;
+    m_lambdaMax = lambdaMax;
+}
+
+void OccamSearch::setSearchSteps(int gridPoints, int refineSteps) {
+    if (gridPoints < 2 || refineSteps < 0) {
+        throw std::invalid_argument("Occam search needs at least 2 grid points");
+    }
+    m_gridPoints = gridPoints;
+    m_refineSteps = refineSteps;
+}
+
+bool OccamSearch::factorize(const std::vector<std::vector<double>>& JTJ,
+                            const std::vector<std::vector<double>>& LTL,
+                            const std::vector<double>& JTr,
+                            const std::vector<double>& mCurrent,
+                            const std::vector<bool>& activeParameters,
+                            const std::vector<double>& roughnessGradient) {
+    int M = static_cast<int>(JTr.size());
+    if (M <= 0 || JTJ.size() != static_cast<size_t>(M) || LTL.size() != static_cast<size_t>(M) ||
+        mCurrent.size() != static_cast<size_t>(M) ||
+        (!roughnessGradient.empty() && roughnessGradient.size() != static_cast<size_t>(M))) {
+        return false;
+    }
+    m_M = M;
+
+    // 只对活动参数建立方程（冻结参数更新量为0，其行列直接去掉）
+    m_activeIndex.clear();
+    for (int i = 0; i < M; i++) {
+        if (activeParameters.size() != static_cast<size_t>(M) || activeParameters[i]) {
+            m_activeIndex.push_back(i);
+        }
+    }
+    int Ma = static_cast<int>(m_activeIndex.size());
+    if (Ma == 0) {
+        return false;
+    }
+
+    // 拍平成row-major数组：A = (J^T*J)_aa，B = (L^T*L)_aa + δI
+    std::vector<double> A(Ma * Ma), U(Ma * Ma);
+    std::vector<double> g(Ma), h(Ma);
+    double maxDiag = 0.0;
+    for (int i = 0; i < Ma; i++) {
+        int ai = m_activeIndex[i];
+        if (JTJ[ai].size() != static_cast<size_t>(M) || LTL[ai].size() != static_cast<size_t>(M)) {
+            return false;
+        }
+        for (int j = 0; j < Ma; j++) {
+            int aj = m_activeIndex[j];
+            A[i * Ma + j] = JTJ[ai][aj];
+            U[i * Ma + j] = LTL[ai][aj];
+        }
+        maxDiag = std::max(maxDiag, LTL[ai][ai]);
+
+        g[i] = JTr[ai];
+        // 整个模型的粗糙度梯度：(L^T*L*m)_a，冻结参数也参与
+        h[i] = roughnessGradient.empty() ? cblas_ddot(M, LTL[ai].data(), 1, mCurrent.data(), 1)
+                                         : roughnessGradient[ai];
+    }
+    for (int idx = 0; idx < Ma * Ma; idx++) {
+        if (!std::isfinite(A[idx]) || !std::isfinite(U[idx])) {
+            return false;
+        }
+    }
+    for (int i = 0; i < Ma; i++) {
+        if (!std::isfinite(g[i]) || !std::isfinite(h[i])) {
+            return false;
+        }
+    }
+
+    // 岭参数：使L^T*L在零空间上正定，相对大小保证Cholesky条件数可控
+    double delta = 1e-8 * (maxDiag > 0.0 ? maxDiag : 1.0);
+    for (int i = 0; i < Ma; i++) {
+        U[i * Ma + i] += delta;
+    }
+
+    // 步骤1～4的主要开销为dsyev（求特征向量约9Ma³次浮点运算）和三角求解（约3Ma³次）
+    MklThreadScope threads(12.0 * Ma * Ma * static_cast<double>(Ma));
+
+    // 1. B = U^T*U（上三角Cholesky因子）
+    if (LAPACKE_dpotrf(LAPACK_ROW_MAJOR, 'U', Ma, U.data(), Ma) != 0) {
+        return false;
+    }
+
+    // 2. C = U^-T * A * U^-1：先解U^T*X = A，再利用A对称解U^T*C = X^T
+    if (LAPACKE_dtrtrs(LAPACK_ROW_MAJOR, 'U', 'T', 'N', Ma, Ma, U.data(), Ma, A.data(), Ma) != 0) {
+        return false;
+    }
+    for (int i = 0; i < Ma; i++) {
+        for (int j = i + 1; j < Ma; j++) {
+            std::swap(A[i * Ma + j], A[j * Ma + i]);
+        }
+    }
+    if (LAPACKE_dtrtrs(LAPACK_ROW_MAJOR, 'U', 'T', 'N', Ma, Ma, U.data(), Ma, A.data(), Ma) != 0) {
+        return false;
+    }
+    for (int i = 0; i < Ma; i++) {
+        for (int j = i + 1; j < Ma; j++) {
+            double s = 0.5 * (A[i * Ma + j] + A[j * Ma + i]);
+            A[i * Ma + j] = s;
+            A[j * Ma + i] = s;
+        }
+    }
+
+    // 3. C = V*Θ*V^T（A被特征向量覆盖，第k列为第k个特征向量）
+    m_theta.assign(Ma, 0.0);
+    if (LAPACKE_dsyev(LAPACK_ROW_MAJOR, 'V', 'U', Ma, A.data(), Ma, m_theta.data()) != 0) {
+        return false;
+    }
+    for (int k = 0; k < Ma; k++) {
+        // C半正定，舍入误差可能产生很小的负特征值
+        m_theta[k] = std::max(0.0, m_theta[k]);
+    }
+
+    // 4. W = U^-1 * V
+    m_W = A;
+    if (LAPACKE_dtrtrs(LAPACK_ROW_MAJOR, 'U', 'N', 'N', Ma, Ma, U.data(), Ma, m_W.data(), Ma) != 0) {
+        return false;
+    }
+
+    // 5. 右端项投影：ĝ = V^T * U^-T * g，ĥ = V^T * U^-T * h
+    if (LAPACKE_dtrtrs(LAPACK_ROW_MAJOR, 'U', 'T', 'N', Ma, 1, U.data(), Ma, g.data(), 1) != 0 ||
+        LAPACKE_dtrtrs(LAPACK_ROW_MAJOR, 'U', 'T', 'N', Ma, 1, U.data(), Ma, h.data(), 1) != 0) {
+        return false;
+    }
+    m_gHat.assign(Ma, 0.0);
+    m_hHat.assign(Ma, 0.0);
+    cblas_dgemv(CblasRowMajor, CblasTrans, Ma, Ma, 1.0, A.data(), Ma, g.data(), 1, 0.0, m_gHat.data(), 1);
+    cblas_dgemv(CblasRowMajor, CblasTrans, Ma, Ma, 1.0, A.data(), Ma, h.data(), 1, 0.0, m_hHat.data(), 1);
+    return true;
+}
+
+void OccamSearch::computeUpdate(double lambda, std::vector<double>& dm) const {
+    int Ma = static_cast<int>(m_activeIndex.size());
+    dm.assign(m_M, 0.0);
+    if (Ma == 0) {
+        return;
+    }
+
+    // y = (Θ + λI)^-1 * (ĝ - λĥ)，δm_a = W * y
+    std::vector<double> y(Ma), dmActive(Ma);
+    for (int k = 0; k < Ma; k++) {
+        y[k] = (m_gHat[k] - lambda * m_hHat[k]) / (m_theta[k] + lambda);
+    }
+    cblas_dgemv(CblasRowMajor, CblasNoTrans, Ma, Ma, 1.0, m_W.data(), Ma, y.data(), 1, 0.0, dmActive.data(), 1);
+    for (int i = 0; i < Ma; i++) {
+        dm[m_activeIndex[i]] = dmActive[i];
+    }
+}
+
+bool OccamSearch::selectedInverse(double lambda, int bandwidth, std::vector<double>& band) const {
+    int Ma = static_cast<int>(m_activeIndex.size());
+    if (Ma == 0 || bandwidth < 0 || !(lambda > 0.0)) {
+        return false;
+    }
+    const int width = 2 * bandwidth + 1;
+
+    // 冻结参数对应单位行列
+    band.assign(static_cast<size_t>(m_M) * width, 0.0);
+    for (int i = 0; i < m_M; i++) {
+        band[i * width + bandwidth] = 1.0;
+    }
+
+    std::vector<double> scale(Ma), wi(Ma);
+    for (int k = 0; k < Ma; k++) {
+        scale[k] = 1.0 / (m_theta[k] + lambda);
+    }
+    for (int a = 0; a < Ma; a++) {
+        int i = m_activeIndex[a];
+        vdMul(Ma, &m_W[a * Ma], scale.data(), wi.data());
+        for (int b = a; b < Ma && m_activeIndex[b] <= i + bandwidth; b++) {
+            int j = m_activeIndex[b];
+            double z = cblas_ddot(Ma, wi.data(), 1, &m_W[b * Ma], 1);
+            band[i * width + (j - i + bandwidth)] = z;
+            band[j * width + (i - j + bandwidth)] = z;
+        }
+    }
+    return true;
+}
+
+void OccamSearch::evaluate(ForwardSolver* forwardSolver,
+                           const std::vector<double>& logLambdas,
+                           const std::vector<double>& mCurrent,
+                           const std::vector<double>& omega,
+                           const std::vector<double>& layerThicknesses,
+                           const std::vector<double>& dObs,
+                           const LayerPruner* pruner,
+                           std::vector<OccamStep>& steps) const {
+    int n = static_cast<int>(logLambdas.size());
+    steps.assign(n, OccamStep());
+
+    std::vector<std::vector<double>> models(n);
+    std::vector<bool> diverged(n, false);
+    for (int k = 0; k < n; k++) {
+        OccamStep& step = steps[k];
+        step.lambda = pow(10.0, logLambdas[k]);
+        computeUpdate(step.lambda, step.dm);
+        if (pruner) {
+            pruner->applyMerge(step.dm);
+        }
+        models[k] = mCurrent;
+        for (int i = 0; i < m_M; i++) {
+            if (!std::isfinite(step.dm[i])) {
+                diverged[k] = true;
+            }
+            models[k][i] += step.dm[i];
+        }
+    }
+
+    std::vector<std::vector<double>> data;
+    forwardSolver->solveBatch(models, omega, layerThicknesses, data);
+    for (int k = 0; k < n; k++) {
+        steps[k].dSyn.swap(data[k]);
+        for (size_t i = 0; i < steps[k].dSyn.size() && !diverged[k]; i++) {
+            diverged[k] = !std::isfinite(steps[k].dSyn[i]);
+        }
+        // 更新量或合成数据含无效值的候选不可行（拟合差记为+inf，不会被选中）
+        steps[k].misfit = diverged[k] ? std::numeric_limits<double>::infinity()
+                                      : residualNorm(dObs, steps[k].dSyn);
+    }
+}
+
+bool OccamSearch::search(ForwardSolver* forwardSolver,
+                         const std::vector<double>& mCurrent,
+                         const std::vector<double>& omega,
+                         const std::vector<double>& layerThicknesses,
+                         const std::vector<double>& dObs,
+                         double targetMisfit,
+                         const LayerPruner* pruner,
+                         OccamStep& step) const {
+    if (!forwardSolver || m_activeIndex.empty() || mCurrent.size() != static_cast<size_t>(m_M)) {
+        return false;
+    }
+
+    const double muMin = log10(m_lambdaMin);
+    const double muMax = log10(m_lambdaMax);
+    int nForward = 0;
+
+    // 1. 对数网格，一次批量正演
+    std::vector<double> grid(m_gridPoints);
+    for (int k = 0; k < m_gridPoints; k++) {
+        grid[k] = muMin + (muMax - muMin) * k / (m_gridPoints - 1);
+    }
+    std::vector<OccamStep> gridSteps;
+    evaluate(forwardSolver, grid, mCurrent, omega, layerThicknesses, dObs, pruner, gridSteps);
+    nForward += m_gridPoints;
+
+    int feasible = -1;
+    int best = 0;
+    for (int k = 0; k < m_gridPoints; k++) {
+        if (gridSteps[k].misfit <= targetMisfit) {
+            feasible = k;
+        }
+        if (gridSteps[k].misfit < gridSteps[best].misfit) {
+            best = k;
+        }
+    }
+
+    std::vector<double> mu(1);
+    std::vector<OccamStep> trial;
+
+    if (feasible >= 0) {
+        // 2a. 达到目标：在最大可行λ与其右邻之间二分，保留可行端
+        step = gridSteps[feasible];
+        if (feasible < m_gridPoints - 1) {
+            double lo = grid[feasible];
+            double hi = grid[feasible + 1];
+            for (int s = 0; s < m_refineSteps; s++) {
+                mu[0] = 0.5 * (lo + hi);
+                evaluate(forwardSolver, mu, mCurrent, omega, layerThicknesses, dObs, pruner, trial);
+                nForward++;
+                if (trial[0].misfit <= targetMisfit) {
+                    lo = mu[0];
+                    step = trial[0];
+                } else {
+                    hi = mu[0];
+                }
+            }
+        }
+        step.targetReached = true;
+    } else {
+        // 2b. 未达到目标：在网格最小值两侧黄金分割，取拟合差最小的λ
+        step = gridSteps[best];
+        const double ratio = 0.5 * (sqrt(5.0) - 1.0);
+        double a = grid[std::max(0, best - 1)];
+        double b = grid[std::min(m_gridPoints - 1, best + 1)];
+        if (m_refineSteps >= 2) {
+            std::vector<double> cd = { b - ratio * (b - a), a + ratio * (b - a) };
+            std::vector<OccamStep> pair;
+            evaluate(forwardSolver, cd, mCurrent, omega, layerThicknesses, dObs, pruner, pair);
+            nForward += 2;
+            OccamStep stepC = pair[0];
+            OccamStep stepD = pair[1];
+            for (int s = 2; s < m_refineSteps; s++) {
+                if (stepC.misfit < stepD.misfit) {
+                    b = cd[1];
+                    cd[1] = cd[0];
+                    stepD = stepC;
+                    cd[0] = b - ratio * (b - a);
+                    mu[0] = cd[0];
+                    evaluate(forwardSolver, mu, mCurrent, omega, layerThicknesses, dObs, pruner, trial);
+                    stepC = trial[0];
+                } else {
+                    a = cd[0];
+                    cd[0] = cd[1];
+                    stepC = stepD;
+                    cd[1] = a + ratio * (b - a);
+                    mu[0] = cd[1];
+                    evaluate(forwardSolver, mu, mCurrent, omega, layerThicknesses, dObs, pruner, trial);
+                    stepD = trial[0];
+                }
+                nForward++;
+            }
+            if (stepC.misfit < step.misfit) {
+                step = stepC;
+            }
+            if (stepD.misfit < step.misfit) {
+                step = stepD;
+            }
+        }
+        step.targetReached = false;
+    }
+
+    // 所有候选都发散时搜索失败
+    if (!std::isfinite(step.misfit)) {
+        return false;
+    }
+    step.nForward = nForward;
+    return true;
+}
+
+double OccamSearch::residualNorm(const std::vector<double>& dObs, const std::vector<double>& dSyn) {
+    int nData = static_cast<int>(std::min(dObs.size(), dSyn.size()));
+    std::vector<double> r(nData);
+    vdSub(nData, dObs.data(), dSyn.data(), r.data());
+    for (int i = 0; i < nData; i++) {
+        if (!std::isfinite(r[i])) {
+            r[i] = 0.0;
+        }
+    }
+    double norm = cblas_dnrm2(nData, r.data(), 1);
+    return std::isfinite(norm) ? norm : 0.0;
+}
+
+double OccamSearch::expectedNoiseNorm(const std::vector<double>& dObs, double noiseLevel) {
+    if (!(noiseLevel > 0.0) || dObs.empty()) {
+        return 0.0;
+    }
+    // 与NoiseGenerator::addRelativeNoise一致：第i个数据的噪声标准差为noiseLevel*|d_i|
+    return noiseLevel * cblas_dnrm2(static_cast<int>(dObs.size()), dObs.data(), 1);
+}
+
+} // namespace MT
@@ -0,0 +1,160 @@
+#ifndef MT_OCCAM_SEARCH_H
+#define MT_OCCAM_SEARCH_H
+
+#include "mt_model.h"
+#include "mt_forward_solver.h"
+#include "mt_layer_pruner.h"
+#include <vector>
+
+/**
+ * MT Occam反演λ搜索模块
+ * 每次迭代在log10(λ)直线上搜索，取达到目标拟合差的最光滑模型（Constable等，1987）
+ *
+ * 模型更新以整个模型的粗糙度为约束（而不是更新量）：
+ *   (J^T*J + λ*L^T*L) * δm = J^T*r - λ*L^T*L*m
+ * 对同一次迭代，J^T*J、L^T*L和右端项都与λ无关。令B = L^T*L + δI = U^T*U（Cholesky），
+ * C = U^-T * J^T*J * U^-1 = V*Θ*V^T（对称特征分解），则
+ *   δm(λ) = U^-1 * V * (Θ + λI)^-1 * V^T * U^-T * (J^T*r - λ*L^T*L*m)
+ * 分解每次迭代只做一次，之后每个λ的求解只需O(M²)。δ为很小的岭参数，保证L^T*L零空间上B正定。
+ *
+ * 搜索策略：
+ * - 先在[λmin, λmax]上取对数均匀网格，所有候选模型一次批量正演（ForwardSolver::solveBatch）
+ * - 若有候选达到目标拟合差：在最大的可行λ与其右邻之间二分，取达到目标的最大λ（最光滑模型）
+ * - 否则：在网格最小值两侧用黄金分割搜索拟合差最小的λ
+ * 更新量或合成数据含NaN/Inf的候选视为不可行（拟合差为+inf），所有候选都不可行时搜索失败。
+ */
+namespace MT {
+
+/**
+ * 单次迭代的搜索结果
+ */
+struct OccamStep {
+    double lambda = 0.0;             // 选定的正则化参数
+    double misfit = 0.0;             // 选定模型的残差范数
+    bool targetReached = false;      // 是否达到目标拟合差
+    int nForward = 0;                // 本次搜索的正演次数
+    std::vector<double> dm;          // 模型更新量
+    std::vector<double> dSyn;        // 更新后模型的合成数据
+};
+
+class OccamSearch {
+public:
+    OccamSearch();
+    ~OccamSearch();
+
+    /**
+     * 设置λ搜索范围
+     * @param lambdaMin 最小正则化参数（> 0）
+     * @param lambdaMax 最大正则化参数（> lambdaMin）
+     */
+    void setLambdaRange(double lambdaMin, double lambdaMax);
+
+    /**
+     * 设置搜索的网格点数和细化步数
+     * @param gridPoints 对数网格点数（>= 2）
+     * @param refineSteps 黄金分割/二分细化步数（>= 0）
+     */
+    void setSearchSteps(int gridPoints, int refineSteps);
+
+    /**
+     * 分解当前迭代的正规方程（每次迭代调用一次）
+     * @param JTJ J^T*J矩阵（M×M）
+     * @param LTL L^T*L矩阵（M×M）
+     * @param JTr J^T*r向量（M维）
+     * @param mCurrent 当前模型（log10(ρ)）
+     * @param activeParameters 活动参数掩码（为空表示所有参数都活动；冻结参数更新量为0）
+     * @param roughnessGradient 粗糙度梯度L^T*L*m（M维；为空时由LTL和mCurrent计算，
+     *                          层合并时应传入合并后的P^T*L^T*L*m）
+     * @return 是否成功
+     */
+    bool factorize(const std::vector<std::vector<double>>& JTJ,
+                   const std::vector<std::vector<double>>& LTL,
+                   const std::vector<double>& JTr,
+                   const std::vector<double>& mCurrent,
+                   const std::vector<bool>& activeParameters,
+                   const std::vector<double>& roughnessGradient = std::vector<double>());
+
+    /**
+     * 计算给定λ的模型更新量（需先调用factorize）
+     * @param lambda 正则化参数
+     * @param dm 输出的模型更新量（M维）
+     */
+    void computeUpdate(double lambda, std::vector<double>& dm) const;
+
+    /**
+     * 由当前分解计算(J^T*J + λ*(L^T*L + δI))^-1在带宽内的元素（需先调用factorize）
+     * A^-1 = W * (Θ + λI)^-1 * W^T，每个元素O(M)；冻结参数对应单位行列
+     * @param lambda 正则化参数
+     * @param bandwidth 带宽（|i - j| <= bandwidth的元素）
+     * @param band 输出的带状元素（M×(2*bandwidth+1)，band[i*(2b+1) + (j-i+b)] = (A^-1)_ij）
+     * @return 是否成功
+     */
+    bool selectedInverse(double lambda, int bandwidth, std::vector<double>& band) const;
+
+    /**
+     * 搜索λ（需先调用factorize）
+     * @param forwardSolver 正演求解器（用于评价候选模型）
+     * @param mCurrent 当前模型（log10(ρ)）
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param dObs 观测数据
+     * @param targetMisfit 目标残差范数
+     * @param pruner 层裁剪器（合并模式下修正冻结层更新量；可为nullptr）
+     * @param step 输出的搜索结果
+     * @return 是否成功（所有候选都发散时返回false）
+     */
+    bool search(ForwardSolver* forwardSolver,
+                const std::vector<double>& mCurrent,
+                const std::vector<double>& omega,
+                const std::vector<double>& layerThicknesses,
+                const std::vector<double>& dObs,
+                double targetMisfit,
+                const LayerPruner* pruner,
+                OccamStep& step) const;
+
+    /**
+     * 计算残差范数||dObs - dSyn||（无效值按0处理，用于报告；候选模型的比较不使用此规则）
+     * @param dObs 观测数据
+     * @param dSyn 合成数据
+     * @return 残差范数
+     */
+    static double residualNorm(const std::vector<double>& dObs, const std::vector<double>& dSyn);
+
+    /**
+     * 由相对噪声水平估计期望的噪声残差范数sqrt(Σ(noiseLevel*|d_i|)²)
+     * @param dObs 观测数据
+     * @param noiseLevel 相对噪声水平
+     * @return 期望残差范数
+     */
+    static double expectedNoiseNorm(const std::vector<double>& dObs, double noiseLevel);
+
+private:
+    /**
+     * 计算一组λ对应的候选模型并批量正演
+     */
+    void evaluate(ForwardSolver* forwardSolver,
+                  const std::vector<double>& logLambdas,
+                  const std::vector<double>& mCurrent,
+                  const std::vector<double>& omega,
+                  const std::vector<double>& layerThicknesses,
+                  const std::vector<double>& dObs,
+                  const LayerPruner* pruner,
+                  std::vector<OccamStep>& steps) const;
+
+    double m_lambdaMin;
+    double m_lambdaMax;
+    int m_gridPoints;
+    int m_refineSteps;
+
+    // 当前迭代的分解结果（只含活动参数，Ma个）
+    int m_M;                          // 模型参数总数
+    std::vector<int> m_activeIndex;   // 活动参数序号
+    std::vector<double> m_theta;      // C的特征值（Ma个）
+    std::vector<double> m_W;          // U^-1 * V（Ma×Ma，行主序）
+    std::vector<double> m_gHat;       // V^T * U^-T * J^T*r
+    std::vector<double> m_hHat;       // V^T * U^-T * L^T*L*m
+};
+
+} // namespace MT
+
+#endif // MT_OCCAM_SEARCH_H
@@ -1,4 +1,5 @@
 #include "mt_optimizer.h"
+#include "mt_thread_policy.h"
 #include <mkl.h>
 #include <mkl_lapacke.h>
 #include <mkl_blas.h>
@@ -9,7 +10,8 @@
 namespace MT {
 
 Optimizer::Optimizer()
-    : m_solverType("cholesky") {
+    : m_solverType("cholesky")
+    , m_factorSize(0) {
 }
 
 Optimizer::~Optimizer() {
@@ -22,6 +24,9 @@ bool Optimizer::solve(const std::vector<std::vector<double>>& JTJ,
                       std::vector<double>& dm) {
     int M = static_cast<int>(JTr.size());
 
+    // 上一次的分解在本次求解成功后才会被替换
+    m_factorSize = 0;
+
     // 检查矩阵维度
     if (M <= 0 || JTJ.size() != static_cast<size_t>(M) || LTL.size() != static_cast<size_t>(M)) {
         return false;
@@ -72,12 +77,36 @@ bool Optimizer::solve(const std::vector<std::vector<double>>& JTJ,
     // 右端项
     dm = JTr;
 
-    // 求解正规方程
+    // 5. 冻结参数：对应行列置为单位阵、右端项置零，使其更新量为0
+    if (m_activeParameters.size() == static_cast<size_t>(M)) {
+        for (int i = 0; i < M; i++) {
+            if (m_activeParameters[i]) {
+                continue;
+            }
+            for (int j = 0; j < M; j++) {
+                A_reg_flat[i * M + j] = 0.0;
+                A_reg_flat[j * M + i] = 0.0;
+            }
+            A_reg_flat[i * M + i] = 1.0;
+            dm[i] = 0.0;
+        }
+    }
+
+    // 求解正规方程（Cholesky约M³/3次浮点运算，LU约2M³/3次）
+    const double n = static_cast<double>(M);
+    MklThreadScope threads((m_solverType == "lu" ? 2.0 : 1.0) * n * n * n / 3.0);
     int info = 0;
     if (m_solverType == "cholesky") {
-        // 使用Cholesky分解（对称正定矩阵）
-        info = LAPACKE_dposv(LAPACK_ROW_MAJOR, 'L', M, 1,
-                             A_reg_flat.data(), M, dm.data(), 1);
+        // 使用Cholesky分解（对称正定矩阵）；分解和回代分开，保留因子供反演后分析使用
+        info = LAPACKE_dpotrf(LAPACK_ROW_MAJOR, 'L', M, A_reg_flat.data(), M);
+        if (info == 0) {
+            info = LAPACKE_dpotrs(LAPACK_ROW_MAJOR, 'L', M, 1,
+                                  A_reg_flat.data(), M, dm.data(), 1);
+        }
+        if (info == 0) {
+            m_factor.swap(A_reg_flat);
+            m_factorSize = M;
+        }
     } else if (m_solverType == "lu") {
         // 使用LU分解（通用矩阵）
         std::vector<int> ipiv(M);
@@ -101,8 +130,9 @@ void Optimizer::computeJTJ(const std::vector<std::vector<double>>& J,
         }
     }
 
-    // 计算JTJ（使用cblas_dsyrk）
+    // 计算JTJ（使用cblas_dsyrk，约nData*M²次浮点运算）
     std::vector<double> JTJ_flat(M * M, 0.0);
+    MklThreadScope threads(static_cast<double>(nData) * M * M);
     cblas_dsyrk(CblasRowMajor, CblasUpper, CblasTrans,
                 M,      // 结果矩阵的阶数
                 nData,  // J^T的列数（J的行数）
@@ -151,6 +181,39 @@ void Optimizer::computeJTr(const std::vector<std::vector<double>>& J,
                 0.0, JTr.data(), 1);
 }
 
+bool Optimizer::selectedInverse(int bandwidth, std::vector<double>& band) const {
+    const int M = m_factorSize;
+    if (M <= 0 || bandwidth < 0) {
+        return false;
+    }
+    const int width = 2 * bandwidth + 1;
+
+    // X = L^-1（下三角，原地求逆，不形成完整的A^-1 = L^-T * L^-1）
+    std::vector<double> X = m_factor;
+    for (int i = 0; i < M; i++) {
+        for (int j = i + 1; j < M; j++) {
+            X[i * M + j] = 0.0;
+        }
+    }
+    {
+        MklThreadScope threads(static_cast<double>(M) * M * M / 3.0);
+        if (LAPACKE_dtrtri(LAPACK_ROW_MAJOR, 'L', 'N', M, X.data(), M) != 0) {
+            return false;
+        }
+    }
+
+    // (A^-1)_ij = Σ_{k >= max(i,j)} X_ki * X_kj，只计算|i - j| <= bandwidth的元素
+    band.assign(static_cast<size_t>(M) * width, 0.0);
+    for (int i = 0; i < M; i++) {
+        for (int j = i; j < M && j <= i + bandwidth; j++) {
+            double z = cblas_ddot(M - j, &X[j * M + i], M, &X[j * M + j], M);
+            band[i * width + (j - i + bandwidth)] = z;
+            band[j * width + (i - j + bandwidth)] = z;
+        }
+    }
+    return true;
+}
+
 void Optimizer::setSolverType(const std::string& type) {
     if (type == "cholesky" || type == "lu") {
         m_solverType = type;
@@ -159,5 +222,9 @@ void Optimizer::setSolverType(const std::string& type) {
     }
 }
 
+void Optimizer::setActiveParameters(const std::vector<bool>& activeParameters) {
+    m_activeParameters = activeParameters;
+}
+
 } // namespace MT
 
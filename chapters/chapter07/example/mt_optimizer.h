@@ -3,6 +3,7 @@
 
 #include "mt_model.h"
 #include <vector>
+#include <string>
 
 /**
  * MT优化求解器模块
@@ -54,8 +55,32 @@ public:
      */
     void setSolverType(const std::string& type);
 
+    /**
+     * 设置冻结参数：冻结参数对应的行列替换为单位阵，其更新量固定为0
+     * @param activeParameters 活动参数掩码（为空表示所有参数都活动）
+     */
+    void setActiveParameters(const std::vector<bool>& activeParameters);
+
+    /**
+     * 是否保留了最近一次成功求解的Cholesky因子（LU求解器不保留）
+     * @return 是否有可用的分解
+     */
+    bool hasFactorization() const { return m_factorSize > 0; }
+
+    /**
+     * 由最近一次的Cholesky因子计算(J^T*J + λ*L^T*L)^-1在带宽内的元素（选择性求逆）
+     * 只对因子做一次三角求逆，再按带宽取列内积，不形成完整的逆矩阵
+     * @param bandwidth 带宽（|i - j| <= bandwidth的元素）
+     * @param band 输出的带状元素（M×(2*bandwidth+1)，band[i*(2b+1) + (j-i+b)] = (A^-1)_ij）
+     * @return 是否成功
+     */
+    bool selectedInverse(int bandwidth, std::vector<double>& band) const;
+
 private:
     std::string m_solverType;  // 求解器类型
+    std::vector<bool> m_activeParameters;  // 活动参数掩码
+    std::vector<double> m_factor;  // 最近一次的Cholesky因子L（row-major，下三角有效）
+    int m_factorSize;              // 因子阶数（0表示没有可用的分解）
 };
 
 } // namespace MT
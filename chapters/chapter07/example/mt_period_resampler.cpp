@@ -0,0 +1,265 @@
+#include "mt_period_resampler.h"
+#include "mt_frequency_generator.h"
+#include <mkl.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace MT {
+
+namespace {
+
+// 目标周期允许超出测站周期范围的容差（log10(T)，吸收网格端点的舍入误差）
+const double RANGE_TOLERANCE = 1e-9;
+
+/**
+ * Data Fitting任务句柄（离开作用域时释放）
+ */
+struct DataFittingTask {
+    DFTaskPtr task = nullptr;
+    ~DataFittingTask() {
+        if (task) {
+            dfDeleteTask(&task);
+        }
+    }
+};
+
+std::string stationName(const InversionParams& station, size_t index) {
+    return station.stationId.empty() ? "#" + std::to_string(index) : station.stationId;
+}
+
+} // namespace
+
+PeriodResampler::PeriodResampler()
+    : m_lastBatchCount(0) {
+}
+
+PeriodResampler::~PeriodResampler() {
+}
+
+void PeriodResampler::setTargetPeriods(const std::vector<double>& periods) {
+    m_targetPeriods = periods;
+    m_targetLogPeriods.resize(periods.size());
+    for (size_t i = 0; i < periods.size(); i++) {
+        m_targetLogPeriods[i] = log10(periods[i]);
+    }
+}
+
+void PeriodResampler::setTargetGrid(int nFreq, double T_min, double T_max) {
+    std::vector<double> periods, omega;
+    FrequencyGenerator().generate(nFreq, T_min, T_max, periods, omega);
+    setTargetPeriods(periods);
+}
+
+bool PeriodResampler::sortStation(const InversionParams& station, SortedStation& sorted,
+                                  std::string& errorMessage) {
+    std::vector<double> periods = station.periods;
+    if (periods.empty()) {
+        for (double w : station.omega) {
+            periods.push_back(2.0 * M_PI / w);
+        }
+    }
+    const int nFreq = static_cast<int>(periods.size());
+    const int nComp = station.components.empty() ? 2 : static_cast<int>(station.components.size());
+    if (nFreq < 2) {
+        errorMessage = "needs at least 2 periods";
+        return false;
+    }
+    if (station.dObs.size() != static_cast<size_t>(nComp) * nFreq) {
+        errorMessage = "observed data size does not match the period count";
+        return false;
+    }
+
+    std::vector<int> order(nFreq);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return periods[a] < periods[b]; });
+
+    sorted.nComp = nComp;
+    sorted.logPeriods.resize(nFreq);
+    sorted.rows.resize(static_cast<size_t>(nComp) * nFreq);
+    for (int k = 0; k < nFreq; k++) {
+        int f = order[k];
+        if (!(periods[f] > 0.0) || !std::isfinite(periods[f])) {
+            errorMessage = "periods must be positive";
+            return false;
+        }
+        sorted.logPeriods[k] = log10(periods[f]);
+        if (k > 0 && !(sorted.logPeriods[k] > sorted.logPeriods[k - 1])) {
+            errorMessage = "duplicate period";
+            return false;
+        }
+        for (int c = 0; c < nComp; c++) {
+            // 无分量时为log10(ρ_a)/相位交替存储，否则按分量优先存储
+            double value = station.components.empty() ? station.dObs[2 * f + c]
+                                                      : station.dObs[static_cast<size_t>(c) * nFreq + f];
+            if (!std::isfinite(value)) {
+                errorMessage = "observed data contain NaN or Inf";
+                return false;
+            }
+            sorted.rows[static_cast<size_t>(c) * nFreq + k] = value;
+        }
+    }
+    return true;
+}
+
+bool PeriodResampler::resample(std::vector<InversionParams>& stations, std::string& errorMessage) {
+    m_lastBatchCount = 0;
+    const int nTarget = static_cast<int>(m_targetLogPeriods.size());
+    if (nTarget < 2) {
+        errorMessage = "target period grid is not set";
+        return false;
+    }
+    for (int k = 0; k < nTarget; k++) {
+        if (!std::isfinite(m_targetLogPeriods[k])) {
+            errorMessage = "target periods must be positive";
+            return false;
+        }
+    }
+    const double targetMin = *std::min_element(m_targetLogPeriods.begin(), m_targetLogPeriods.end());
+    const double targetMax = *std::max_element(m_targetLogPeriods.begin(), m_targetLogPeriods.end());
+
+    // 1. 整理各测站并检查目标周期都在测站的周期范围内
+    std::vector<SortedStation> sorted(stations.size());
+    for (size_t s = 0; s < stations.size(); s++) {
+        std::string reason;
+        if (!sortStation(stations[s], sorted[s], reason)) {
+            errorMessage = "station " + stationName(stations[s], s) + ": " + reason;
+            return false;
+        }
+        if (targetMin < sorted[s].logPeriods.front() - RANGE_TOLERANCE ||
+            targetMax > sorted[s].logPeriods.back() + RANGE_TOLERANCE) {
+            errorMessage = "station " + stationName(stations[s], s) +
+                           ": target periods lie outside the observed period range";
+            return false;
+        }
+    }
+
+    // 2. 周期点和分量都相同的测站归为一组
+    std::vector<std::vector<size_t>> groups;
+    for (size_t s = 0; s < stations.size(); s++) {
+        bool placed = false;
+        for (std::vector<size_t>& group : groups) {
+            size_t first = group.front();
+            if (sorted[first].logPeriods == sorted[s].logPeriods &&
+                stations[first].components == stations[s].components) {
+                group.push_back(s);
+                placed = true;
+                break;
+            }
+        }
+        if (!placed) {
+            groups.push_back({ s });
+        }
+    }
+
+    // 3. 每组一次批量样条构造和求值：组内各测站的各分量为同一分割上的ny个函数（按行存储）
+    std::vector<std::vector<double>> resampled(stations.size());
+    for (const std::vector<size_t>& group : groups) {
+        const SortedStation& first = sorted[group.front()];
+        const int nx = static_cast<int>(first.logPeriods.size());
+        const int nComp = first.nComp;
+        const int ny = nComp * static_cast<int>(group.size());
+
+        std::vector<double> y;
+        y.reserve(static_cast<size_t>(ny) * nx);
+        for (size_t s : group) {
+            y.insert(y.end(), sorted[s].rows.begin(), sorted[s].rows.end());
+        }
+
+        DataFittingTask task;
+        std::vector<double> coefficients(static_cast<size_t>(ny) * (nx - 1) * DF_PP_CUBIC);
+        std::vector<double> r(static_cast<size_t>(ny) * nTarget);
+        const MKL_INT dorder[1] = { 1 };  // 只求函数值
+        int status = dfdNewTask1D(&task.task, nx, first.logPeriods.data(), DF_NON_UNIFORM_PARTITION,
+                                  ny, y.data(), DF_MATRIX_STORAGE_ROWS);
+        if (status == DF_STATUS_OK) {
+            status = dfdEditPPSpline1D(task.task, DF_PP_CUBIC, DF_PP_NATURAL, DF_BC_FREE_END, nullptr,
+                                       DF_NO_IC, nullptr, coefficients.data(), DF_NO_HINT);
+        }
+        if (status == DF_STATUS_OK) {
+            status = dfdConstruct1D(task.task, DF_PP_SPLINE, DF_METHOD_STD);
+        }
+        if (status == DF_STATUS_OK) {
+            status = dfdInterpolate1D(task.task, DF_INTERP, DF_METHOD_PP, nTarget, m_targetLogPeriods.data(),
+                                      DF_NO_HINT, 1, dorder, nullptr, r.data(), DF_MATRIX_STORAGE_ROWS,
+                                      nullptr);
+        }
+        if (status != DF_STATUS_OK) {
+            errorMessage = "station " + stationName(stations[group.front()], group.front()) +
+                           ": spline interpolation failed (MKL Data Fitting status " +
+                           std::to_string(status) + ")";
+            return false;
+        }
+        m_lastBatchCount++;
+
+        // r按函数存储：第g个测站第c个分量的结果为r[(g * nComp + c) * nTarget + k]
+        for (size_t g = 0; g < group.size(); g++) {
+            const InversionParams& station = stations[group[g]];
+            std::vector<double>& data = resampled[group[g]];
+            data.resize(static_cast<size_t>(nComp) * nTarget);
+            for (int c = 0; c < nComp; c++) {
+                const double* row = &r[(g * nComp + c) * static_cast<size_t>(nTarget)];
+                for (int k = 0; k < nTarget; k++) {
+                    if (station.components.empty()) {
+                        data[2 * k + c] = row[k];
+                    } else {
+                        data[static_cast<size_t>(c) * nTarget + k] = row[k];
+                    }
+                }
+            }
+        }
+    }
+
+    // 4. 全部成功后再写回
+    std::vector<double> omega(nTarget);
+    for (int k = 0; k < nTarget; k++) {
+        omega[k] = 2.0 * M_PI / m_targetPeriods[k];
+    }
+    for (size_t s = 0; s < stations.size(); s++) {
+        stations[s].nFreq = nTarget;
+        stations[s].periods = m_targetPeriods;
+        stations[s].omega = omega;
+        stations[s].dObs.swap(resampled[s]);
+    }
+    return true;
+}
+
+bool PeriodResampler::resample(InversionParams& station, std::string& errorMessage) {
+    std::vector<InversionParams> stations(1);
+    stations[0] = std::move(station);
+    bool ok = resample(stations, errorMessage);
+    station = std::move(stations[0]);
+    return ok;
+}
+
+bool PeriodResampler::commonPeriodRange(const std::vector<InversionParams>& stations,
+                                        double& T_min, double& T_max) {
+    T_min = 0.0;
+    T_max = std::numeric_limits<double>::infinity();
+    if (stations.empty()) {
+        return false;
+    }
+    for (const InversionParams& station : stations) {
+        double lo = std::numeric_limits<double>::infinity();
+        double hi = 0.0;
+        if (!station.periods.empty()) {
+            lo = *std::min_element(station.periods.begin(), station.periods.end());
+            hi = *std::max_element(station.periods.begin(), station.periods.end());
+        } else {
+            for (double w : station.omega) {
+                lo = std::min(lo, 2.0 * M_PI / w);
+                hi = std::max(hi, 2.0 * M_PI / w);
+            }
+        }
+        T_min = std::max(T_min, lo);
+        T_max = std::min(T_max, hi);
+    }
+    return T_min > 0.0 && T_min < T_max;
+}
+
+} // namespace MT
@@ -0,0 +1,92 @@
+#ifndef MT_PERIOD_RESAMPLER_H
+#define MT_PERIOD_RESAMPLER_H
+
+#include "mt_model.h"
+#include <vector>
+#include <string>
+
+/**
+ * MT周期重采样模块
+ * 野外测站的周期点各不相同，而反演要求periods/omega与nFreq一致。本模块在反演前把各测站的观测数据
+ * （log10(ρ_a)、相位或components指定的各分量）重采样到统一的周期网格上。
+ *
+ * 以log10(T)为自变量做自然三次样条插值（MKL Data Fitting，两端二阶导数为零）。
+ * 周期点完全相同（且分量相同）的测站归为一组，组内所有测站的所有分量作为同一分割上的多个函数，
+ * 一次dfdConstruct1D/dfdInterpolate1D完成，野外常见的"多台仪器同一采样方案"只需一次批量调用。
+ * 不做外推：目标周期超出某个测站的周期范围时该测站重采样失败（commonPeriodRange()给出所有测站的公共范围）。
+ *
+ * 重采样后各测站的omega完全相同，反演服务按omega分批、正演中与频率有关的预计算都可以在整个测区内共用。
+ */
+namespace MT {
+
+class PeriodResampler {
+public:
+    PeriodResampler();
+    ~PeriodResampler();
+
+    /**
+     * 设置目标周期
+     * @param periods 目标周期（秒，任意顺序，必须为正且互不相同）
+     */
+    void setTargetPeriods(const std::vector<double>& periods);
+
+    /**
+     * 设置对数等间隔的目标周期网格（与FrequencyGenerator的网格一致）
+     * @param nFreq 频率点数（>= 2）
+     * @param T_min 最小周期（秒）
+     * @param T_max 最大周期（秒）
+     */
+    void setTargetGrid(int nFreq, double T_min, double T_max);
+
+    const std::vector<double>& getTargetPeriods() const { return m_targetPeriods; }
+
+    /**
+     * 把一组测站重采样到目标周期（就地修改nFreq、periods、omega和dObs）
+     * 周期点相同的测站合并为一次批量样条计算；失败时所有测站保持不变
+     * @param stations 测站反演参数（dObs为观测数据；periods为空时由omega计算）
+     * @param errorMessage 失败时的错误信息（含测站ID）
+     * @return 是否成功
+     */
+    bool resample(std::vector<InversionParams>& stations, std::string& errorMessage);
+
+    /**
+     * 重采样单个测站
+     */
+    bool resample(InversionParams& station, std::string& errorMessage);
+
+    /**
+     * 计算所有测站周期范围的交集
+     * @param stations 测站反演参数
+     * @param T_min 输出的公共最小周期
+     * @param T_max 输出的公共最大周期
+     * @return 交集是否非空
+     */
+    static bool commonPeriodRange(const std::vector<InversionParams>& stations,
+                                  double& T_min, double& T_max);
+
+    /**
+     * 获取上一次resample()的批量调用次数（周期点不同的测站组数）
+     */
+    int getLastBatchCount() const { return m_lastBatchCount; }
+
+private:
+    /**
+     * 按log10(T)升序整理后的测站数据
+     */
+    struct SortedStation {
+        std::vector<double> logPeriods;  // 升序的log10(T)
+        std::vector<double> rows;        // 各分量按行存储（nComp × nFreq，与logPeriods同序）
+        int nComp = 0;
+    };
+
+    static bool sortStation(const InversionParams& station, SortedStation& sorted,
+                            std::string& errorMessage);
+
+    std::vector<double> m_targetPeriods;
+    std::vector<double> m_targetLogPeriods;
+    int m_lastBatchCount;
+};
+
+} // namespace MT
+
+#endif // MT_PERIOD_RESAMPLER_H
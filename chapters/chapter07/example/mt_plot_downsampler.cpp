@@ -0,0 +1,137 @@
+#include "mt_plot_downsampler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MT {
+
+void PlotDownsampler::visibleRange(const std::vector<double>& x, double xMin, double xMax,
+                                   int& first, int& last) {
+    int n = static_cast<int>(x.size());
+    first = n;
+    last = -1;
+    for (int i = 0; i < n; i++) {
+        if (x[i] >= xMin && x[i] <= xMax) {
+            first = std::min(first, i);
+            last = std::max(last, i);
+        }
+    }
+    if (last < first) {
+        // 可见范围落在两个相邻点之间时保留这两个点
+        for (int i = 0; i + 1 < n; i++) {
+            double lo = std::min(x[i], x[i + 1]);
+            double hi = std::max(x[i], x[i + 1]);
+            if (lo < xMin && hi > xMax) {
+                first = i;
+                last = i + 1;
+                return;
+            }
+        }
+        return;
+    }
+    first = std::max(0, first - 1);
+    last = std::min(n - 1, last + 1);
+}
+
+std::vector<int> PlotDownsampler::lttb(const std::vector<double>& x, const std::vector<double>& y,
+                                       int first, int last, int nOut) {
+    std::vector<int> indices;
+    int n = last - first + 1;
+    if (n <= 0) {
+        return indices;
+    }
+    if (nOut >= n || nOut < 3) {
+        indices.resize(n);
+        for (int i = 0; i < n; i++) {
+            indices[i] = first + i;
+        }
+        return indices;
+    }
+
+    indices.reserve(nOut);
+    indices.push_back(first);
+
+    // 首末点固定，中间n-2个点等分为nOut-2个桶，每个桶选出与前一选中点、
+    // 下一个桶均值点构成的三角形面积最大的点
+    double bucketSize = static_cast<double>(n - 2) / (nOut - 2);
+    int a = first;
+    for (int b = 0; b < nOut - 2; b++) {
+        int start = first + 1 + static_cast<int>(std::floor(b * bucketSize));
+        int end = first + 1 + static_cast<int>(std::floor((b + 1) * bucketSize));
+        end = std::min(end, last);
+
+        // 下一个桶的均值点（最后一个桶的下一个"桶"是末点）
+        int nextStart = end;
+        int nextEnd = first + 1 + static_cast<int>(std::floor((b + 2) * bucketSize));
+        nextEnd = std::min(std::max(nextEnd, nextStart + 1), last + 1);
+        double avgX = 0.0, avgY = 0.0;
+        for (int i = nextStart; i < nextEnd; i++) {
+            avgX += x[i];
+            avgY += y[i];
+        }
+        avgX /= (nextEnd - nextStart);
+        avgY /= (nextEnd - nextStart);
+
+        double maxArea = -1.0;
+        int selected = start;
+        for (int i = start; i < end; i++) {
+            // 三角形面积的两倍（比较大小时省略1/2）
+            double area = std::abs((x[a] - avgX) * (y[i] - y[a]) -
+                                   (x[a] - x[i]) * (avgY - y[a]));
+            if (area > maxArea) {
+                maxArea = area;
+                selected = i;
+            }
+        }
+        indices.push_back(selected);
+        a = selected;
+    }
+
+    indices.push_back(last);
+    return indices;
+}
+
+std::vector<int> PlotDownsampler::minMax(const std::vector<double>& x, const std::vector<double>& y,
+                                         int first, int last, int nBuckets) {
+    std::vector<int> indices;
+    int n = last - first + 1;
+    if (n <= 0) {
+        return indices;
+    }
+    double span = x[last] - x[first];
+    if (nBuckets < 1 || n <= 4 * nBuckets || span == 0.0) {
+        indices.resize(n);
+        for (int i = 0; i < n; i++) {
+            indices[i] = first + i;
+        }
+        return indices;
+    }
+
+    indices.reserve(4 * nBuckets);
+    double scale = nBuckets / span;
+
+    // x单调，同一像素列的点是连续的一段
+    int runStart = first;
+    while (runStart <= last) {
+        int bucket = std::min(nBuckets - 1, static_cast<int>((x[runStart] - x[first]) * scale));
+        int runEnd = runStart;
+        int iMin = runStart, iMax = runStart;
+        while (runEnd + 1 <= last &&
+               std::min(nBuckets - 1, static_cast<int>((x[runEnd + 1] - x[first]) * scale)) == bucket) {
+            runEnd++;
+            if (y[runEnd] < y[iMin]) iMin = runEnd;
+            if (y[runEnd] > y[iMax]) iMax = runEnd;
+        }
+
+        // 按下标顺序输出首、极值、末点（去重）
+        int candidates[4] = {runStart, std::min(iMin, iMax), std::max(iMin, iMax), runEnd};
+        for (int c : candidates) {
+            if (indices.empty() || indices.back() < c) {
+                indices.push_back(c);
+            }
+        }
+        runStart = runEnd + 1;
+    }
+    return indices;
+}
+
+} // namespace MT
@@ -0,0 +1,58 @@
+#ifndef MT_PLOT_DOWNSAMPLER_H
+#define MT_PLOT_DOWNSAMPLER_H
+
+#include <vector>
+
+/**
+ * MT绘图降采样模块
+ * 在反演结果和图表序列之间按控件像素尺寸抽稀曲线，绘制的点数与数据量无关
+ *
+ * - LTTB（Largest-Triangle-Three-Buckets）：保留视觉形状的平滑曲线抽稀，用于视电阻率/相位曲线
+ * - 最小最大值（M4）：每个像素列保留首、末、最小、最大四个点，阶梯曲线的跳变不会丢失，用于模型剖面
+ *
+ * 所有函数只处理[first, last]区间（可见范围），返回被保留点的下标（升序）。
+ * 对数坐标轴应传入log10变换后的坐标，使分桶与屏幕像素对应。
+ */
+namespace MT {
+
+class PlotDownsampler {
+public:
+    /**
+     * 计算落在坐标范围内的下标区间（两侧各多保留一个点，使曲线延伸到绘图区边缘）
+     * @param x 横坐标（单调递增或递减）
+     * @param xMin 可见范围下限
+     * @param xMax 可见范围上限
+     * @param first 输出的起始下标
+     * @param last 输出的结束下标（无可见点时last < first）
+     */
+    static void visibleRange(const std::vector<double>& x, double xMin, double xMax,
+                             int& first, int& last);
+
+    /**
+     * LTTB降采样
+     * @param x 横坐标
+     * @param y 纵坐标
+     * @param first 起始下标
+     * @param last 结束下标
+     * @param nOut 输出点数（通常取绘图区像素宽度）；区间点数不超过nOut时全部保留
+     * @return 保留点的下标
+     */
+    static std::vector<int> lttb(const std::vector<double>& x, const std::vector<double>& y,
+                                 int first, int last, int nOut);
+
+    /**
+     * 最小最大值降采样（按横坐标等分为nBuckets个像素列）
+     * @param x 分桶坐标（单调递增或递减，允许相邻点相等）
+     * @param y 取极值的坐标
+     * @param first 起始下标
+     * @param last 结束下标
+     * @param nBuckets 像素列数；区间点数不超过4*nBuckets时全部保留
+     * @return 保留点的下标
+     */
+    static std::vector<int> minMax(const std::vector<double>& x, const std::vector<double>& y,
+                                   int first, int last, int nBuckets);
+};
+
+} // namespace MT
+
+#endif // MT_PLOT_DOWNSAMPLER_H
@@ -0,0 +1,386 @@
+#include "mt_pseudo_section_view.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QToolTip>
+#include <QFontMetrics>
+#include <QMetaObject>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 坐标轴和色标的边距（像素）
+const int MARGIN_LEFT = 60;
+const int MARGIN_RIGHT = 80;
+const int MARGIN_TOP = 10;
+const int MARGIN_BOTTOM = 35;
+
+// 对数深度轴的最小深度（米）
+const double LOG_DEPTH_MIN = 1.0;
+
+// 取1、2、5×10^n形式的刻度间隔
+double niceStep(double span, int nTicks) {
+    double raw = span / std::max(1, nTicks);
+    if (raw <= 0.0) {
+        return 1.0;
+    }
+    double magnitude = pow(10.0, std::floor(log10(raw)));
+    double r = raw / magnitude;
+    double nice = r < 1.5 ? 1.0 : (r < 3.0 ? 2.0 : (r < 7.0 ? 5.0 : 10.0));
+    return nice * magnitude;
+}
+
+} // namespace
+
+PseudoSectionView::PseudoSectionView(QWidget* parent)
+    : QWidget(parent)
+    , m_rendering(false)
+    , m_renderPending(false)
+    , m_dragging(false) {
+    m_renderPool.setMaxThreadCount(1);
+    setMouseTracking(true);
+    setMinimumSize(400, 250);
+    setWindowTitle("拟断面（反演电阻率）");
+
+    std::vector<MT::SharedInversionResult> empty;
+    m_rasterizer = std::make_shared<const MT::SectionRasterizer>(empty);
+}
+
+PseudoSectionView::~PseudoSectionView() {
+    // 等待后台绘制结束（其完成回调会随对象一起被丢弃）
+    m_renderPool.waitForDone();
+}
+
+void PseudoSectionView::setResults(const std::vector<MT::SharedInversionResult>& results) {
+    m_rasterizer = std::make_shared<const MT::SectionRasterizer>(results);
+    m_view.colorMin = std::floor(m_rasterizer->getMinLogRho() * 2.0) / 2.0;
+    m_view.colorMax = std::ceil(m_rasterizer->getMaxLogRho() * 2.0) / 2.0;
+    if (m_view.colorMax <= m_view.colorMin) {
+        m_view.colorMax = m_view.colorMin + 1.0;
+    }
+    m_image = QImage();
+    resetView();
+}
+
+void PseudoSectionView::setColorRange(double logRhoMin, double logRhoMax) {
+    m_view.colorMin = logRhoMin;
+    m_view.colorMax = logRhoMax;
+    requestRender();
+}
+
+void PseudoSectionView::setInterpolation(bool enabled) {
+    m_view.interpolate = enabled;
+    requestRender();
+}
+
+void PseudoSectionView::setLogDepth(bool enabled) {
+    m_view.logDepth = enabled;
+    resetView();
+}
+
+void PseudoSectionView::resetView() {
+    int nStations = m_rasterizer->getStationCount();
+    double maxDepth = m_rasterizer->getMaxDepth();
+    m_view.stationBegin = 0.0;
+    m_view.stationEnd = std::max(1, nStations);
+    // 多显示底部半空间的一部分
+    m_view.depthMax = maxDepth > 0.0 ? 1.2 * maxDepth : 1000.0;
+    m_view.depthMin = m_view.logDepth ? LOG_DEPTH_MIN : 0.0;
+    requestRender();
+}
+
+QRect PseudoSectionView::plotRect() const {
+    return QRect(MARGIN_LEFT, MARGIN_TOP,
+                 std::max(1, width() - MARGIN_LEFT - MARGIN_RIGHT),
+                 std::max(1, height() - MARGIN_TOP - MARGIN_BOTTOM));
+}
+
+double PseudoSectionView::stationAtX(double x, const MT::SectionRasterizer::RenderParams& params) const {
+    QRect rect = plotRect();
+    return params.stationBegin + (x - rect.left()) * (params.stationEnd - params.stationBegin) / rect.width();
+}
+
+double PseudoSectionView::depthAtY(double y, const MT::SectionRasterizer::RenderParams& params) const {
+    QRect rect = plotRect();
+    double t = (y - rect.top()) / rect.height();
+    if (params.logDepth) {
+        double logMin = log10(params.depthMin);
+        double logMax = log10(params.depthMax);
+        return pow(10.0, logMin + t * (logMax - logMin));
+    }
+    return params.depthMin + t * (params.depthMax - params.depthMin);
+}
+
+double PseudoSectionView::yAtDepth(double depth, const MT::SectionRasterizer::RenderParams& params) const {
+    QRect rect = plotRect();
+    double t;
+    if (params.logDepth) {
+        double logMin = log10(params.depthMin);
+        double logMax = log10(params.depthMax);
+        t = (log10(std::max(depth, 1e-3)) - logMin) / (logMax - logMin);
+    } else {
+        t = (depth - params.depthMin) / (params.depthMax - params.depthMin);
+    }
+    return rect.top() + t * rect.height();
+}
+
+void PseudoSectionView::requestRender() {
+    if (m_rendering) {
+        m_renderPending = true;  // 完成后只绘制最新的视图
+    } else {
+        startRender();
+    }
+    update();
+}
+
+void PseudoSectionView::startRender() {
+    QRect rect = plotRect();
+    MT::SectionRasterizer::RenderParams params = m_view;
+    params.width = rect.width();
+    params.height = rect.height();
+
+    m_rendering = true;
+    m_renderPending = false;
+    std::shared_ptr<const MT::SectionRasterizer> rasterizer = m_rasterizer;
+    m_renderPool.start([this, rasterizer, params]() {
+        QImage image(params.width, params.height, QImage::Format_RGB32);
+        rasterizer->render(params, reinterpret_cast<uint32_t*>(image.bits()),
+                           static_cast<int>(image.bytesPerLine()));
+        QMetaObject::invokeMethod(this, [this, image, params]() {
+            onRenderFinished(image, params);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PseudoSectionView::onRenderFinished(const QImage& image,
+                                         const MT::SectionRasterizer::RenderParams& params) {
+    m_image = image;
+    m_imageView = params;
+    m_rendering = false;
+    if (m_renderPending) {
+        startRender();
+    }
+    update();
+}
+
+void PseudoSectionView::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    QRect rect = plotRect();
+    if (!m_image.isNull()) {
+        if (m_imageView.stationBegin == m_view.stationBegin && m_imageView.stationEnd == m_view.stationEnd &&
+            m_imageView.depthMin == m_view.depthMin && m_imageView.depthMax == m_view.depthMax &&
+            m_imageView.logDepth == m_view.logDepth) {
+            painter.drawImage(rect, m_image);
+        } else {
+            // 新图像绘制完成前，把旧图像按当前视图拉伸到对应位置
+            double span = m_view.stationEnd - m_view.stationBegin;
+            double x0 = rect.left() + (m_imageView.stationBegin - m_view.stationBegin) / span * rect.width();
+            double x1 = rect.left() + (m_imageView.stationEnd - m_view.stationBegin) / span * rect.width();
+            double y0 = yAtDepth(m_imageView.depthMin, m_view);
+            double y1 = yAtDepth(m_imageView.depthMax, m_view);
+            painter.save();
+            painter.setClipRect(rect);
+            painter.drawImage(QRectF(x0, y0, x1 - x0, y1 - y0), m_image);
+            painter.restore();
+        }
+    }
+
+    drawAxes(painter, rect);
+    drawColorBar(painter, rect);
+}
+
+void PseudoSectionView::drawAxes(QPainter& painter, const QRect& rect) {
+    painter.setPen(QPen(Qt::black, 1));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(rect.adjusted(0, 0, -1, -1));
+
+    QFontMetrics metrics = painter.fontMetrics();
+
+    // 横轴：测站序号（从1开始，刻度在测站中心）
+    double span = m_view.stationEnd - m_view.stationBegin;
+    double step = std::max(1.0, niceStep(span, rect.width() / 80));
+    for (double s = std::ceil(m_view.stationBegin / step) * step; s < m_view.stationEnd; s += step) {
+        double x = rect.left() + (s + 0.5 - m_view.stationBegin) / span * rect.width();
+        if (x < rect.left() || x > rect.right()) {
+            continue;
+        }
+        painter.drawLine(QPointF(x, rect.bottom()), QPointF(x, rect.bottom() + 4));
+        QString label = QString::number(static_cast<int>(s) + 1);
+        painter.drawText(QPointF(x - metrics.horizontalAdvance(label) / 2.0, rect.bottom() + 6 + metrics.ascent()), label);
+    }
+    QString titleX = "测站";
+    painter.drawText(QPointF(rect.center().x() - metrics.horizontalAdvance(titleX) / 2.0, height() - 4), titleX);
+
+    // 纵轴：深度
+    std::vector<double> ticks;
+    if (m_view.logDepth) {
+        for (double d = pow(10.0, std::floor(log10(m_view.depthMin))); d <= m_view.depthMax; d *= 10.0) {
+            if (d >= m_view.depthMin) {
+                ticks.push_back(d);
+            }
+        }
+    } else {
+        double depthStep = niceStep(m_view.depthMax - m_view.depthMin, rect.height() / 50);
+        for (double d = std::ceil(m_view.depthMin / depthStep) * depthStep; d <= m_view.depthMax; d += depthStep) {
+            ticks.push_back(d);
+        }
+    }
+    for (double d : ticks) {
+        double y = yAtDepth(d, m_view);
+        painter.drawLine(QPointF(rect.left() - 4, y), QPointF(rect.left(), y));
+        QString label = QString::number(d, 'g', 4);
+        painter.drawText(QPointF(rect.left() - 6 - metrics.horizontalAdvance(label), y + metrics.ascent() / 2.0), label);
+    }
+    painter.save();
+    painter.translate(12, rect.center().y());
+    painter.rotate(-90);
+    QString titleY = "深度 (m)";
+    painter.drawText(QPointF(-metrics.horizontalAdvance(titleY) / 2.0, 0), titleY);
+    painter.restore();
+}
+
+void PseudoSectionView::drawColorBar(QPainter& painter, const QRect& rect) {
+    QRect bar(rect.right() + 15, rect.top(), 15, rect.height());
+
+    // 色标与像素图使用同一张色表（上方为高电阻率）
+    QImage barImage(1, bar.height(), QImage::Format_RGB32);
+    for (int y = 0; y < bar.height(); y++) {
+        double t = 1.0 - (y + 0.5) / bar.height();
+        barImage.setPixel(0, y, m_rasterizer->colorAt(t));
+    }
+    painter.drawImage(bar, barImage);
+    painter.setPen(QPen(Qt::black, 1));
+    painter.drawRect(bar.adjusted(0, 0, -1, -1));
+
+    QFontMetrics metrics = painter.fontMetrics();
+    double colorSpan = m_view.colorMax - m_view.colorMin;
+    double step = niceStep(colorSpan, 5);
+    for (double v = std::ceil(m_view.colorMin / step) * step; v <= m_view.colorMax + 1e-9; v += step) {
+        double y = bar.bottom() - (v - m_view.colorMin) / colorSpan * bar.height();
+        painter.drawLine(QPointF(bar.right(), y), QPointF(bar.right() + 3, y));
+        QString label = QString::number(pow(10.0, v), 'g', 3);
+        painter.drawText(QPointF(bar.right() + 5, y + metrics.ascent() / 2.0), label);
+    }
+    painter.drawText(QPointF(bar.left() - 5, rect.bottom() + 6 + metrics.ascent()), "Ω·m");
+}
+
+void PseudoSectionView::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    requestRender();
+}
+
+void PseudoSectionView::wheelEvent(QWheelEvent* event) {
+    double factor = pow(1.2, -event->angleDelta().y() / 120.0);
+    QPointF pos = event->position();
+    int nStations = std::max(1, m_rasterizer->getStationCount());
+
+    if (event->modifiers() & Qt::ControlModifier) {
+        // 沿深度方向以鼠标位置为中心缩放
+        double maxDepth = m_rasterizer->getMaxDepth() > 0.0 ? 1.2 * m_rasterizer->getMaxDepth() : 1000.0;
+        if (m_view.logDepth) {
+            double center = log10(depthAtY(pos.y(), m_view));
+            double lo = center - (center - log10(m_view.depthMin)) * factor;
+            double hi = center + (log10(m_view.depthMax) - center) * factor;
+            m_view.depthMin = std::max(LOG_DEPTH_MIN, pow(10.0, lo));
+            m_view.depthMax = std::min(maxDepth, pow(10.0, hi));
+        } else {
+            double center = depthAtY(pos.y(), m_view);
+            m_view.depthMin = std::max(0.0, center - (center - m_view.depthMin) * factor);
+            m_view.depthMax = std::min(maxDepth, center + (m_view.depthMax - center) * factor);
+        }
+        if (m_view.depthMax <= m_view.depthMin * 1.001 + 1e-6) {
+            m_view.depthMax = m_view.depthMin * 1.001 + 1.0;
+        }
+    } else {
+        // 沿测站方向以鼠标位置为中心缩放（至少显示1个测站）
+        double center = stationAtX(pos.x(), m_view);
+        double begin = center - (center - m_view.stationBegin) * factor;
+        double end = center + (m_view.stationEnd - center) * factor;
+        if (end - begin < 1.0) {
+            begin = center - 0.5;
+            end = center + 0.5;
+        }
+        m_view.stationBegin = std::max(0.0, begin);
+        m_view.stationEnd = std::min(static_cast<double>(nStations), end);
+    }
+    requestRender();
+    event->accept();
+}
+
+void PseudoSectionView::mousePressEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        m_dragging = true;
+        m_dragStart = event->pos();
+        m_dragView = m_view;
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void PseudoSectionView::mouseMoveEvent(QMouseEvent* event) {
+    if (m_dragging) {
+        // 平移：测站方向和深度方向同时移动，不超出数据范围
+        QRect rect = plotRect();
+        QPoint delta = event->pos() - m_dragStart;
+        int nStations = std::max(1, m_rasterizer->getStationCount());
+        double span = m_dragView.stationEnd - m_dragView.stationBegin;
+        double shift = -delta.x() * span / rect.width();
+        shift = std::max(-m_dragView.stationBegin, std::min(nStations - m_dragView.stationEnd, shift));
+        m_view.stationBegin = m_dragView.stationBegin + shift;
+        m_view.stationEnd = m_dragView.stationEnd + shift;
+
+        double maxDepth = m_rasterizer->getMaxDepth() > 0.0 ? 1.2 * m_rasterizer->getMaxDepth() : 1000.0;
+        if (m_view.logDepth) {
+            double logShift = -delta.y() * (log10(m_dragView.depthMax) - log10(m_dragView.depthMin)) / rect.height();
+            logShift = std::max(log10(LOG_DEPTH_MIN) - log10(m_dragView.depthMin),
+                                std::min(log10(maxDepth) - log10(m_dragView.depthMax), logShift));
+            m_view.depthMin = m_dragView.depthMin * pow(10.0, logShift);
+            m_view.depthMax = m_dragView.depthMax * pow(10.0, logShift);
+        } else {
+            double depthShift = -delta.y() * (m_dragView.depthMax - m_dragView.depthMin) / rect.height();
+            depthShift = std::max(-m_dragView.depthMin, std::min(maxDepth - m_dragView.depthMax, depthShift));
+            m_view.depthMin = m_dragView.depthMin + depthShift;
+            m_view.depthMax = m_dragView.depthMax + depthShift;
+        }
+        requestRender();
+        return;
+    }
+
+    // 悬停：显示测站和模型值
+    QRect rect = plotRect();
+    if (!rect.contains(event->pos())) {
+        QToolTip::hideText();
+        return;
+    }
+    int station = static_cast<int>(std::floor(stationAtX(event->pos().x(), m_view)));
+    double depth = depthAtY(event->pos().y(), m_view);
+    double logRho = 0.0;
+    if (m_rasterizer->valueAt(station, depth, m_view.interpolate, logRho)) {
+        QToolTip::showText(mapToGlobal(event->pos()),
+                           QString("测站 %1\n深度 %2 m\nρ = %3 Ω·m")
+                               .arg(station + 1)
+                               .arg(depth, 0, 'f', 1)
+                               .arg(pow(10.0, logRho), 0, 'g', 4),
+                           this);
+        emit pointHovered(station, depth, logRho);
+    } else {
+        QToolTip::hideText();
+    }
+}
+
+void PseudoSectionView::mouseReleaseEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton && m_dragging) {
+        m_dragging = false;
+        unsetCursor();
+    }
+}
+
+void PseudoSectionView::mouseDoubleClickEvent(QMouseEvent* event) {
+    Q_UNUSED(event);
+    resetView();
+}
@@ -0,0 +1,122 @@
+#ifndef MT_PSEUDO_SECTION_VIEW_H
+#define MT_PSEUDO_SECTION_VIEW_H
+
+#include <QWidget>
+#include <QImage>
+#include <QThreadPool>
+#include <QPoint>
+#include <QRect>
+#include <memory>
+#include <vector>
+#include "mt_model.h"
+#include "mt_section_rasterizer.h"
+
+/**
+ * MT拟断面栅格视图
+ * 把多个测站的反演模型显示为电阻率-深度色块图（横轴测站，纵轴深度）
+ *
+ * 像素图由MT::SectionRasterizer在后台线程中填充到QImage，paintEvent只负责贴图和绘制坐标轴、色标，
+ * 因此数千个测站也不会阻塞界面。缩放、平移和窗口尺寸变化时先拉伸显示旧图像，
+ * 连续的重绘请求合并为一次，后台绘制完成后替换。
+ *
+ * 交互：滚轮沿测站方向缩放，Ctrl+滚轮沿深度方向缩放，左键拖动平移，双击恢复全图。
+ */
+class PseudoSectionView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit PseudoSectionView(QWidget* parent = nullptr);
+    ~PseudoSectionView();
+
+    /**
+     * 设置测站结果（按剖面顺序），并恢复全图显示
+     * @param results 各测站的共享反演结果（空指针的测站显示为空白列；不复制结果数据）
+     */
+    void setResults(const std::vector<MT::SharedInversionResult>& results);
+
+    /**
+     * 设置色标范围
+     * @param logRhoMin 下限（log10(ρ)）
+     * @param logRhoMax 上限（log10(ρ)）
+     */
+    void setColorRange(double logRhoMin, double logRhoMax);
+
+    /**
+     * 设置是否在层中心之间插值（否则按层显示阶梯）
+     */
+    void setInterpolation(bool enabled);
+
+    /**
+     * 设置深度轴是否为对数坐标
+     */
+    void setLogDepth(bool enabled);
+
+    /**
+     * 恢复全图显示
+     */
+    void resetView();
+
+signals:
+    /**
+     * 鼠标悬停位置的测站和模型值
+     * @param station 测站序号
+     * @param depth 深度（米）
+     * @param logRho log10(ρ)
+     */
+    void pointHovered(int station, double depth, double logRho);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+private:
+    /**
+     * 请求后台重绘（绘制进行中时只记录请求，完成后再绘制最新视图）
+     */
+    void requestRender();
+
+    /**
+     * 启动一次后台绘制
+     */
+    void startRender();
+
+    /**
+     * 后台绘制完成（在界面线程中调用）
+     */
+    void onRenderFinished(const QImage& image, const MT::SectionRasterizer::RenderParams& params);
+
+    /**
+     * 图像区域（扣除坐标轴和色标的边距）
+     */
+    QRect plotRect() const;
+
+    /**
+     * 像素坐标与测站、深度坐标的换算
+     */
+    double stationAtX(double x, const MT::SectionRasterizer::RenderParams& params) const;
+    double depthAtY(double y, const MT::SectionRasterizer::RenderParams& params) const;
+    double yAtDepth(double depth, const MT::SectionRasterizer::RenderParams& params) const;
+
+    void drawAxes(QPainter& painter, const QRect& rect);
+    void drawColorBar(QPainter& painter, const QRect& rect);
+
+    std::shared_ptr<const MT::SectionRasterizer> m_rasterizer;  // 只读，后台线程共享
+    MT::SectionRasterizer::RenderParams m_view;     // 当前视图
+    MT::SectionRasterizer::RenderParams m_imageView; // m_image对应的视图
+    QImage m_image;                                 // 最近一次绘制完成的图像
+
+    QThreadPool m_renderPool;    // 单线程后台绘制
+    bool m_rendering;            // 是否有绘制正在进行
+    bool m_renderPending;        // 绘制期间是否有新的请求
+
+    bool m_dragging;
+    QPoint m_dragStart;
+    MT::SectionRasterizer::RenderParams m_dragView;
+};
+
+#endif // MT_PSEUDO_SECTION_VIEW_H
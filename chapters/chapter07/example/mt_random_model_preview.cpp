@@ -0,0 +1,149 @@
+#include "mt_random_model_preview.h"
+#include "mt_inversion_core.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QPushButton>
+#include <QScrollArea>
+#include <QPainter>
+#include <QtCharts/QChartView>
+#include <QtCharts/QChart>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QLogValueAxis>
+#include <algorithm>
+#include <cmath>
+
+RandomModelCandidate generateRandomModelCandidate(const RandomModelRequest& request) {
+    RandomModelCandidate candidate;
+    candidate.seed = request.seed;
+
+    // 每个任务使用独立的核心对象（正演求解器不在线程间共享）
+    MTInversionCore core;
+    core.generateRandomModelAndForward(request.M, request.nFreq,
+                                       request.minRho, request.maxRho,
+                                       request.firstThickness, request.growthFactor,
+                                       request.filterCutoff, request.seed,
+                                       candidate.mLogRho,
+                                       candidate.layerThicknesses,
+                                       candidate.layerDepths,
+                                       candidate.periods,
+                                       candidate.omega,
+                                       candidate.data);
+    return candidate;
+}
+
+RandomModelPreview::RandomModelPreview(QWidget* parent)
+    : QWidget(parent)
+    , m_gridContainer(nullptr) {
+    setWindowTitle("随机候选模型");
+    resize(1000, 700);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    QScrollArea* scrollArea = new QScrollArea();
+    scrollArea->setWidgetResizable(true);
+    m_gridContainer = new QWidget();
+    new QGridLayout(m_gridContainer);
+    scrollArea->setWidget(m_gridContainer);
+    mainLayout->addWidget(scrollArea);
+}
+
+RandomModelPreview::~RandomModelPreview() {
+}
+
+void RandomModelPreview::setCandidates(const QVector<RandomModelCandidate>& candidates) {
+    m_candidates = candidates;
+
+    // 清除旧的预览面板
+    QGridLayout* grid = static_cast<QGridLayout*>(m_gridContainer->layout());
+    while (QLayoutItem* item = grid->takeAt(0)) {
+        delete item->widget();
+        delete item;
+    }
+
+    int nColumns = candidates.size() <= 2 ? candidates.size() : 2;
+    for (int i = 0; i < candidates.size(); i++) {
+        grid->addWidget(createCandidatePanel(i, candidates[i]), i / nColumns, i % nColumns);
+    }
+}
+
+QWidget* RandomModelPreview::createCandidatePanel(int index, const RandomModelCandidate& candidate) {
+    QGroupBox* panel = new QGroupBox(QString("候选 %1（种子 %2）").arg(index + 1).arg(candidate.seed));
+    QVBoxLayout* layout = new QVBoxLayout(panel);
+    QHBoxLayout* chartLayout = new QHBoxLayout();
+
+    // 电阻率-深度剖面（阶梯状）
+    QChart* modelChart = new QChart();
+    modelChart->legend()->hide();
+    modelChart->setTitle("模型");
+    QLineSeries* modelSeries = new QLineSeries();
+    modelSeries->setPen(QPen(Qt::red, 2));
+    int M = static_cast<int>(candidate.mLogRho.size());
+    double maxDepth = 1.0;
+    for (int i = 0; i < M && i < static_cast<int>(candidate.layerDepths.size()); i++) {
+        double rho = pow(10.0, candidate.mLogRho[i]);
+        double top = std::max(0.01, candidate.layerDepths[i]);
+        double bottom = std::max(0.01, top + candidate.layerThicknesses[i]);
+        modelSeries->append(rho, top);
+        modelSeries->append(rho, bottom);
+        maxDepth = std::max(maxDepth, bottom);
+    }
+    modelChart->addSeries(modelSeries);
+    QLogValueAxis* rhoAxis = new QLogValueAxis();
+    rhoAxis->setLabelFormat("%.0e");
+    rhoAxis->setRange(0.1, 10000.0);
+    QLogValueAxis* depthAxis = new QLogValueAxis();
+    depthAxis->setLabelFormat("%.0f");
+    depthAxis->setReverse(true);
+    depthAxis->setRange(0.01, maxDepth);
+    modelChart->addAxis(rhoAxis, Qt::AlignBottom);
+    modelChart->addAxis(depthAxis, Qt::AlignLeft);
+    modelSeries->attachAxis(rhoAxis);
+    modelSeries->attachAxis(depthAxis);
+    QChartView* modelView = new QChartView(modelChart);
+    modelView->setRenderHint(QPainter::Antialiasing);
+    modelView->setMinimumSize(220, 220);
+    chartLayout->addWidget(modelView);
+
+    // 视电阻率曲线
+    QChart* responseChart = new QChart();
+    responseChart->legend()->hide();
+    responseChart->setTitle("视电阻率");
+    QLineSeries* responseSeries = new QLineSeries();
+    responseSeries->setPen(QPen(QColor(0, 0, 200), 2));
+    for (int i = 0; i < static_cast<int>(candidate.periods.size()); i++) {
+        if (2 * i >= static_cast<int>(candidate.data.size())) {
+            break;
+        }
+        double rhoA = pow(10.0, candidate.data[2 * i]);
+        if (std::isfinite(rhoA) && rhoA > 0.0) {
+            responseSeries->append(candidate.periods[i], rhoA);
+        }
+    }
+    responseChart->addSeries(responseSeries);
+    QLogValueAxis* periodAxis = new QLogValueAxis();
+    periodAxis->setLabelFormat("%.0e");
+    periodAxis->setRange(0.001, 1000.0);
+    QLogValueAxis* rhoAAxis = new QLogValueAxis();
+    rhoAAxis->setLabelFormat("%.0e");
+    rhoAAxis->setRange(0.1, 10000.0);
+    responseChart->addAxis(periodAxis, Qt::AlignBottom);
+    responseChart->addAxis(rhoAAxis, Qt::AlignLeft);
+    responseSeries->attachAxis(periodAxis);
+    responseSeries->attachAxis(rhoAAxis);
+    QChartView* responseView = new QChartView(responseChart);
+    responseView->setRenderHint(QPainter::Antialiasing);
+    responseView->setMinimumSize(220, 220);
+    chartLayout->addWidget(responseView);
+
+    layout->addLayout(chartLayout);
+
+    QPushButton* btnSelect = new QPushButton("选用");
+    connect(btnSelect, &QPushButton::clicked, this, [this, index]() {
+        if (index < m_candidates.size()) {
+            emit candidateSelected(m_candidates[index]);
+        }
+    });
+    layout->addWidget(btnSelect);
+    return panel;
+}
@@ -0,0 +1,79 @@
+#ifndef MT_RANDOM_MODEL_PREVIEW_H
+#define MT_RANDOM_MODEL_PREVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include <QMetaType>
+#include <vector>
+
+/**
+ * 随机模型生成请求（界面参数的快照，在后台线程中使用）
+ */
+struct RandomModelRequest {
+    int M = 40;                        // 模型层数
+    int nFreq = 61;                    // 频率点数
+    double minRho = 1.0;               // 最小电阻率（Ω·m）
+    double maxRho = 1000.0;            // 最大电阻率（Ω·m）
+    double firstThickness = 10.0;      // 第一层厚度（米）
+    double growthFactor = 1.2;         // 厚度增长系数
+    double filterCutoff = 0.2;         // 滤波截止参数
+    unsigned int seed = 0;             // 随机种子（各候选模型不同）
+};
+
+/**
+ * 随机模型生成结果（模型及其正演响应）
+ */
+struct RandomModelCandidate {
+    unsigned int seed = 0;
+    std::vector<double> mLogRho;            // 模型（log10(ρ)）
+    std::vector<double> layerThicknesses;   // 层厚度
+    std::vector<double> layerDepths;        // 层顶深度
+    std::vector<double> periods;            // 周期
+    std::vector<double> omega;              // 角频率
+    std::vector<double> data;               // 正演响应（log10(ρ_a)和相位交替）
+};
+
+Q_DECLARE_METATYPE(RandomModelCandidate)
+
+/**
+ * 生成一个随机模型并正演（线程安全：每次调用使用独立的MTInversionCore，
+ * 可直接作为QtConcurrent::mapped的映射函数）
+ * @param request 生成请求
+ * @return 候选模型
+ */
+RandomModelCandidate generateRandomModelCandidate(const RandomModelRequest& request);
+
+/**
+ * 随机候选模型并排预览窗口
+ * 每个候选模型显示电阻率-深度剖面和视电阻率曲线，点击“选用”后发出candidateSelected
+ */
+class RandomModelPreview : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit RandomModelPreview(QWidget* parent = nullptr);
+    ~RandomModelPreview();
+
+    /**
+     * 显示一组候选模型（替换之前的内容）
+     * @param candidates 候选模型
+     */
+    void setCandidates(const QVector<RandomModelCandidate>& candidates);
+
+signals:
+    /**
+     * 用户选用某个候选模型
+     */
+    void candidateSelected(const RandomModelCandidate& candidate);
+
+private:
+    /**
+     * 创建单个候选模型的预览面板
+     */
+    QWidget* createCandidatePanel(int index, const RandomModelCandidate& candidate);
+
+    QVector<RandomModelCandidate> m_candidates;
+    QWidget* m_gridContainer;
+};
+
+#endif // MT_RANDOM_MODEL_PREVIEW_H
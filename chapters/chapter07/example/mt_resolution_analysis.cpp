@@ -0,0 +1,117 @@
+#include "mt_resolution_analysis.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace MT {
+
+ResolutionAnalysis::ResolutionAnalysis(double doiThreshold)
+    : m_doiThreshold(0.1) {
+    setDOIThreshold(doiThreshold);
+}
+
+ResolutionAnalysis::~ResolutionAnalysis() {
+}
+
+void ResolutionAnalysis::setDOIThreshold(double threshold) {
+    if (!(threshold > 0.0 && threshold < 1.0)) {
+        throw std::invalid_argument("DOI resolution threshold must be in (0, 1)");
+    }
+    m_doiThreshold = threshold;
+}
+
+int ResolutionAnalysis::bandwidth(const std::vector<std::vector<double>>& LTL) {
+    int M = static_cast<int>(LTL.size());
+    int b = 0;
+    for (int i = 0; i < M; i++) {
+        int n = static_cast<int>(LTL[i].size());
+        for (int j = 0; j < n; j++) {
+            if (LTL[i][j] != 0.0) {
+                b = std::max(b, std::abs(i - j));
+            }
+        }
+    }
+    return b;
+}
+
+bool ResolutionAnalysis::compute(const std::vector<double>& inverseBand,
+                                 int bandwidth,
+                                 const std::vector<std::vector<double>>& LTL,
+                                 double lambda,
+                                 const std::vector<bool>& activeParameters,
+                                 double residualNorm,
+                                 int nData,
+                                 std::vector<double>& resolutionDiag,
+                                 std::vector<double>& posteriorStd) const {
+    int M = static_cast<int>(LTL.size());
+    const int width = 2 * bandwidth + 1;
+    if (M <= 0 || bandwidth < 0 || inverseBand.size() != static_cast<size_t>(M) * width ||
+        !(lambda >= 0.0) || !std::isfinite(lambda)) {
+        return false;
+    }
+    auto isActive = [&](int i) {
+        return activeParameters.size() != static_cast<size_t>(M) || activeParameters[i];
+    };
+
+    // R_ii = 1 - λ Σ_j (A^-1)_ij (L^T*L)_ji，j只取带宽内的活动参数
+    resolutionDiag.assign(M, 0.0);
+    double traceR = 0.0;
+    for (int i = 0; i < M; i++) {
+        if (!isActive(i)) {
+            continue;
+        }
+        double s = 0.0;
+        int jMin = std::max(0, i - bandwidth);
+        int jMax = std::min(M - 1, i + bandwidth);
+        for (int j = jMin; j <= jMax; j++) {
+            if (isActive(j)) {
+                s += inverseBand[i * width + (j - i + bandwidth)] * LTL[j][i];
+            }
+        }
+        double r = 1.0 - lambda * s;
+        if (!std::isfinite(r)) {
+            r = 0.0;
+        }
+        resolutionDiag[i] = r;
+        traceR += resolutionDiag[i];
+    }
+
+    // σ² = ||r||² / (N - tr(R))，tr(R)为有效参数个数
+    double dof = std::max(1.0, nData - traceR);
+    double sigma2 = residualNorm * residualNorm / dof;
+
+    posteriorStd.assign(M, 0.0);
+    for (int i = 0; i < M; i++) {
+        double zii = inverseBand[i * width + bandwidth];
+        if (isActive(i) && zii > 0.0 && std::isfinite(zii)) {
+            posteriorStd[i] = sqrt(sigma2 * zii);
+        }
+    }
+    return true;
+}
+
+double ResolutionAnalysis::estimateDOI(const std::vector<double>& resolutionDiag,
+                                       const std::vector<double>& layerDepths,
+                                       const std::vector<double>& layerThicknesses) const {
+    int M = static_cast<int>(std::min(resolutionDiag.size(), layerDepths.size()));
+    if (M == 0) {
+        return 0.0;
+    }
+    double maxR = *std::max_element(resolutionDiag.begin(), resolutionDiag.begin() + M);
+    if (!(maxR > 0.0)) {
+        return 0.0;
+    }
+
+    int deepest = 0;
+    for (int i = 0; i < M; i++) {
+        if (resolutionDiag[i] >= m_doiThreshold * maxR) {
+            deepest = i;
+        }
+    }
+    // 底层为半空间，其顶部即为可给出的最大深度
+    double thickness = (deepest < M - 1 && deepest < static_cast<int>(layerThicknesses.size()))
+                       ? layerThicknesses[deepest] : 0.0;
+    return layerDepths[deepest] + thickness;
+}
+
+} // namespace MT
@@ -0,0 +1,78 @@
+#ifndef MT_RESOLUTION_ANALYSIS_H
+#define MT_RESOLUTION_ANALYSIS_H
+
+#include "mt_model.h"
+#include <vector>
+
+/**
+ * MT反演后分析模块
+ * 由最后一次迭代的正规方程A = J^T*J + λ*L^T*L计算模型分辨率矩阵和后验协方差的对角元，以及探测深度
+ *
+ * 不形成完整的A^-1：L^T*L是带宽为b的带状矩阵（平滑度约束b = 2），因此
+ *   R = A^-1 * J^T*J = I - λ * A^-1 * L^T*L，  R_ii = 1 - λ Σ_{|i-j|<=b} (A^-1)_ij (L^T*L)_ji
+ * 只需要A^-1在带宽b内的元素（由持有分解的Optimizer/OccamSearch通过selectedInverse()给出）。
+ * 后验协方差取C = σ² * A^-1，σ²由最终残差估计：σ² = ||r||² / (N - tr(R))。
+ * 探测深度取分辨率对角元不低于阈值（相对于最大值）的最深层的底部深度。
+ */
+namespace MT {
+
+class ResolutionAnalysis {
+public:
+    /**
+     * 构造函数
+     * @param doiThreshold 探测深度的分辨率阈值（相对于分辨率对角元的最大值）
+     */
+    explicit ResolutionAnalysis(double doiThreshold = 0.1);
+    ~ResolutionAnalysis();
+
+    /**
+     * 计算L^T*L的带宽
+     * @param LTL L^T*L矩阵（M×M）
+     * @return 带宽b（|i - j| > b的元素都为0）
+     */
+    static int bandwidth(const std::vector<std::vector<double>>& LTL);
+
+    /**
+     * 计算分辨率矩阵和后验协方差的对角元
+     * @param inverseBand A^-1在带宽内的元素（M×(2b+1)，见Optimizer::selectedInverse）
+     * @param bandwidth 带宽b
+     * @param LTL L^T*L矩阵（M×M）
+     * @param lambda 正则化参数
+     * @param activeParameters 活动参数掩码（为空表示所有参数都活动；冻结参数的分辨率和标准差为0）
+     * @param residualNorm 最终残差范数
+     * @param nData 数据个数
+     * @param resolutionDiag 输出的分辨率矩阵对角元（M维，通常在[0, 1]内）
+     * @param posteriorStd 输出的后验标准差（M维，log10(ρ)单位）
+     * @return 是否成功
+     */
+    bool compute(const std::vector<double>& inverseBand,
+                 int bandwidth,
+                 const std::vector<std::vector<double>>& LTL,
+                 double lambda,
+                 const std::vector<bool>& activeParameters,
+                 double residualNorm,
+                 int nData,
+                 std::vector<double>& resolutionDiag,
+                 std::vector<double>& posteriorStd) const;
+
+    /**
+     * 由分辨率对角元估计探测深度
+     * @param resolutionDiag 分辨率矩阵对角元
+     * @param layerDepths 层顶深度数组
+     * @param layerThicknesses 层厚度数组
+     * @return 探测深度（米）
+     */
+    double estimateDOI(const std::vector<double>& resolutionDiag,
+                       const std::vector<double>& layerDepths,
+                       const std::vector<double>& layerThicknesses) const;
+
+    void setDOIThreshold(double threshold);
+    double getDOIThreshold() const { return m_doiThreshold; }
+
+private:
+    double m_doiThreshold;  // 探测深度的相对分辨率阈值
+};
+
+} // namespace MT
+
+#endif // MT_RESOLUTION_ANALYSIS_H
@@ -0,0 +1,211 @@
+#include "mt_section_rasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace MT {
+
+namespace {
+
+// 色标控制点（低电阻率红色 → 黄 → 绿 → 青 → 高电阻率蓝色）
+struct ColorStop {
+    double t;
+    int r, g, b;
+};
+
+const ColorStop COLOR_STOPS[] = {
+    {0.00, 200,   0,   0},
+    {0.25, 255, 200,   0},
+    {0.50,   0, 200,   0},
+    {0.75,   0, 200, 255},
+    {1.00,   0,   0, 180},
+};
+
+} // namespace
+
+SectionRasterizer::SectionRasterizer(const std::vector<SharedInversionResult>& results)
+    : m_maxDepth(0.0)
+    , m_minLogRho(std::numeric_limits<double>::max())
+    , m_maxLogRho(-std::numeric_limits<double>::max()) {
+    // 预计算色表
+    for (int i = 0; i < LUT_SIZE; i++) {
+        double t = static_cast<double>(i) / (LUT_SIZE - 1);
+        int s = 0;
+        while (COLOR_STOPS[s + 1].t < t) {
+            s++;
+        }
+        const ColorStop& a = COLOR_STOPS[s];
+        const ColorStop& b = COLOR_STOPS[s + 1];
+        double w = (t - a.t) / (b.t - a.t);
+        int r = static_cast<int>(a.r + w * (b.r - a.r) + 0.5);
+        int g = static_cast<int>(a.g + w * (b.g - a.g) + 0.5);
+        int bl = static_cast<int>(a.b + w * (b.b - a.b) + 0.5);
+        m_lut[i] = 0xFF000000u | (static_cast<uint32_t>(r) << 16) |
+                   (static_cast<uint32_t>(g) << 8) | static_cast<uint32_t>(bl);
+    }
+
+    int nStations = static_cast<int>(results.size());
+    m_stationMesh.assign(nStations, -1);
+    m_stationOffset.assign(nStations, 0);
+
+    for (int s = 0; s < nStations; s++) {
+        if (!results[s]) {
+            continue;
+        }
+        const InversionResult& result = *results[s];
+        int M = static_cast<int>(result.mFinal.size());
+        if (!result.success || M == 0 ||
+            static_cast<int>(result.layerDepths.size()) != M ||
+            static_cast<int>(result.layerThicknesses.size()) != M) {
+            continue;
+        }
+
+        // 与上一个网格比较，相同的层深度共用一套节点
+        int mesh = static_cast<int>(m_meshLayers.size()) - 1;
+        bool sameMesh = mesh >= 0 && m_meshLayers[mesh] == M &&
+                        std::equal(result.layerDepths.begin(), result.layerDepths.end(),
+                                   m_meshTops.begin() + m_meshOffset[mesh]);
+        if (!sameMesh) {
+            mesh++;
+            m_meshOffset.push_back(static_cast<int>(m_meshTops.size()));
+            m_meshLayers.push_back(M);
+            for (int k = 0; k < M; k++) {
+                double top = result.layerDepths[k];
+                m_meshTops.push_back(top);
+                // 底层是半空间，插值节点取其层顶
+                m_meshCenters.push_back(k + 1 < M ? top + 0.5 * result.layerThicknesses[k] : top);
+            }
+            m_maxDepth = std::max(m_maxDepth, result.layerDepths[M - 1]);
+        }
+
+        m_stationMesh[s] = mesh;
+        m_stationOffset[s] = static_cast<int>(m_values.size());
+        for (int k = 0; k < M; k++) {
+            m_values.push_back(static_cast<float>(result.mFinal[k]));
+            m_minLogRho = std::min(m_minLogRho, result.mFinal[k]);
+            m_maxLogRho = std::max(m_maxLogRho, result.mFinal[k]);
+        }
+        m_values.push_back(static_cast<float>(result.mFinal[M - 1]));  // m[k+1]在底层仍然有效
+    }
+
+    if (m_minLogRho > m_maxLogRho) {
+        m_minLogRho = 0.0;
+        m_maxLogRho = 4.0;
+    }
+}
+
+SectionRasterizer::~SectionRasterizer() {
+}
+
+void SectionRasterizer::buildRowTable(int mesh, const std::vector<double>& rowDepth, bool interpolate,
+                                      std::vector<int>& rowLayer, std::vector<float>& rowWeight) const {
+    int M = m_meshLayers[mesh];
+    const double* nodes = (interpolate ? m_meshCenters.data() : m_meshTops.data()) + m_meshOffset[mesh];
+    int height = static_cast<int>(rowDepth.size());
+
+    // 行深度单调递增，与节点深度归并，O(height + M)
+    int k = 0;
+    for (int y = 0; y < height; y++) {
+        double z = rowDepth[y];
+        while (k + 1 < M && nodes[k + 1] <= z) {
+            k++;
+        }
+        rowLayer[y] = k;
+        if (!interpolate || k + 1 >= M || z <= nodes[k]) {
+            rowWeight[y] = 0.0f;
+        } else {
+            rowWeight[y] = static_cast<float>((z - nodes[k]) / (nodes[k + 1] - nodes[k]));
+        }
+    }
+}
+
+void SectionRasterizer::render(const RenderParams& params, uint32_t* pixels, int bytesPerLine) const {
+    int width = params.width;
+    int height = params.height;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // 各像素行中心的深度
+    std::vector<double> rowDepth(height);
+    if (params.logDepth) {
+        double logMin = log10(std::max(params.depthMin, 1e-3));
+        double logMax = log10(std::max(params.depthMax, 1e-3));
+        for (int y = 0; y < height; y++) {
+            rowDepth[y] = pow(10.0, logMin + (y + 0.5) * (logMax - logMin) / height);
+        }
+    } else {
+        for (int y = 0; y < height; y++) {
+            rowDepth[y] = params.depthMin + (y + 0.5) * (params.depthMax - params.depthMin) / height;
+        }
+    }
+
+    double colorSpan = params.colorMax - params.colorMin;
+    const float colorMin = static_cast<float>(params.colorMin);
+    const float colorScale = static_cast<float>(colorSpan > 0.0 ? (LUT_SIZE - 1) / colorSpan : 0.0);
+
+    std::vector<int> rowLayer(height);
+    std::vector<float> rowWeight(height);
+    std::vector<uint32_t> column(height);
+    int tableMesh = -1;
+
+    char* base = reinterpret_cast<char*>(pixels);
+    double stationsPerPixel = (params.stationEnd - params.stationBegin) / width;
+    int nStations = getStationCount();
+
+    for (int x = 0; x < width; x++) {
+        double s = params.stationBegin + (x + 0.5) * stationsPerPixel;
+        int station = static_cast<int>(std::floor(s));
+        int mesh = (station >= 0 && station < nStations) ? m_stationMesh[station] : -1;
+
+        if (mesh < 0) {
+            std::fill(column.begin(), column.end(), BACKGROUND);
+        } else {
+            // 相邻测站网格相同时复用行表
+            if (mesh != tableMesh) {
+                buildRowTable(mesh, rowDepth, params.interpolate, rowLayer, rowWeight);
+                tableMesh = mesh;
+            }
+
+            // 无分支内层循环：插值 → 色表下标 → 查表
+            const float* m = m_values.data() + m_stationOffset[station];
+            const int* layer = rowLayer.data();
+            const float* weight = rowWeight.data();
+            uint32_t* out = column.data();
+            for (int y = 0; y < height; y++) {
+                int k = layer[y];
+                float v = m[k] + weight[y] * (m[k + 1] - m[k]);
+                float c = (v - colorMin) * colorScale;
+                c = std::min(std::max(c, 0.0f), static_cast<float>(LUT_SIZE - 1));
+                out[y] = m_lut[static_cast<int>(c + 0.5f)];
+            }
+        }
+
+        for (int y = 0; y < height; y++) {
+            reinterpret_cast<uint32_t*>(base + static_cast<size_t>(y) * bytesPerLine)[x] = column[y];
+        }
+    }
+}
+
+bool SectionRasterizer::valueAt(int station, double depth, bool interpolate, double& logRho) const {
+    if (station < 0 || station >= getStationCount() || m_stationMesh[station] < 0) {
+        return false;
+    }
+    int mesh = m_stationMesh[station];
+    std::vector<double> rowDepth(1, depth);
+    std::vector<int> rowLayer(1);
+    std::vector<float> rowWeight(1);
+    buildRowTable(mesh, rowDepth, interpolate, rowLayer, rowWeight);
+
+    const float* m = m_values.data() + m_stationOffset[station];
+    int k = rowLayer[0];
+    logRho = m[k] + rowWeight[0] * (m[k + 1] - m[k]);
+    return true;
+}
+
+uint32_t SectionRasterizer::colorAt(double t) const {
+    t = std::min(std::max(t, 0.0), 1.0);
+    return m_lut[static_cast<int>(t * (LUT_SIZE - 1) + 0.5)];
+}
+
+} // namespace MT
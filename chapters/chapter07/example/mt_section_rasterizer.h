@@ -0,0 +1,101 @@
+#ifndef MT_SECTION_RASTERIZER_H
+#define MT_SECTION_RASTERIZER_H
+
+#include "mt_model.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * MT拟断面栅格化模块
+ * 把多个测站的反演模型（mFinal）按色标填充成电阻率-深度像素图，不依赖Qt，可在工作线程中调用
+ *
+ * 构造时把各测站模型展平为连续的float数组，层深度相同的相邻测站共用一套深度节点。
+ * 绘制时每个像素列先按深度节点归并出每行的（层号，权重）表（同一网格的相邻列复用），
+ * 然后逐行计算 v = m[k] + t*(m[k+1]-m[k]) 并查预计算的256色表，内层循环没有分支和除法。
+ * 对象构造后只读，多个线程可以同时绘制。
+ */
+namespace MT {
+
+class SectionRasterizer {
+public:
+    /**
+     * 绘制参数
+     */
+    struct RenderParams {
+        int width = 0;                 // 图像宽度（像素）
+        int height = 0;                // 图像高度（像素）
+        double stationBegin = 0.0;     // 左边缘对应的测站坐标（第i个测站占[i, i+1)）
+        double stationEnd = 0.0;       // 右边缘对应的测站坐标
+        double depthMin = 0.0;         // 上边缘深度（米）
+        double depthMax = 1000.0;      // 下边缘深度（米）
+        bool logDepth = false;         // 深度轴是否为对数坐标
+        bool interpolate = true;       // 是否在层中心之间线性插值（否则按层显示阶梯）
+        double colorMin = 0.0;         // 色标下限（log10(ρ)）
+        double colorMax = 4.0;         // 色标上限（log10(ρ)）
+    };
+
+    /**
+     * 构造函数（跳过空指针、未成功或缺少层深度信息的结果，对应的列显示为背景色）
+     * 只读取mFinal、layerDepths和layerThicknesses，构造后不再持有结果
+     * @param results 各测站的共享反演结果（按剖面顺序）
+     */
+    explicit SectionRasterizer(const std::vector<SharedInversionResult>& results);
+    ~SectionRasterizer();
+
+    /**
+     * 绘制到32位像素缓冲区（0xAARRGGBB，与QImage::Format_RGB32/ARGB32一致）
+     * @param params 绘制参数
+     * @param pixels 像素缓冲区（height行，每行bytesPerLine字节）
+     * @param bytesPerLine 每行字节数
+     */
+    void render(const RenderParams& params, uint32_t* pixels, int bytesPerLine) const;
+
+    /**
+     * 查询某测站某深度处的模型值（与绘制使用相同的插值方式）
+     * @param station 测站序号
+     * @param depth 深度（米）
+     * @param interpolate 是否插值
+     * @param logRho 输出的log10(ρ)
+     * @return 测站有有效模型时返回true
+     */
+    bool valueAt(int station, double depth, bool interpolate, double& logRho) const;
+
+    /**
+     * 色表颜色（0xAARRGGBB）
+     * @param t 色标位置[0, 1]，低电阻率为红色，高电阻率为蓝色
+     * @return 颜色
+     */
+    uint32_t colorAt(double t) const;
+
+    int getStationCount() const { return static_cast<int>(m_stationMesh.size()); }
+    double getMaxDepth() const { return m_maxDepth; }
+    double getMinLogRho() const { return m_minLogRho; }
+    double getMaxLogRho() const { return m_maxLogRho; }
+
+    static constexpr int LUT_SIZE = 256;
+    static constexpr uint32_t BACKGROUND = 0xFFFFFFFFu;  // 无数据的像素（白色）
+
+private:
+    /**
+     * 计算某网格在各像素行的（层号，权重）表
+     */
+    void buildRowTable(int mesh, const std::vector<double>& rowDepth, bool interpolate,
+                       std::vector<int>& rowLayer, std::vector<float>& rowWeight) const;
+
+    std::vector<int> m_stationMesh;      // 各测站使用的网格序号（-1表示无数据）
+    std::vector<int> m_stationOffset;    // 各测站模型在m_values中的起始位置
+    std::vector<float> m_values;         // 展平的log10(ρ)，每个测站末尾重复一次最后一层（M+1个）
+
+    std::vector<int> m_meshOffset;       // 各网格在m_meshTops/m_meshCenters中的起始位置
+    std::vector<int> m_meshLayers;       // 各网格的层数
+    std::vector<double> m_meshTops;      // 层顶深度
+    std::vector<double> m_meshCenters;   // 插值节点深度（层中心，底层取层顶）
+
+    uint32_t m_lut[LUT_SIZE];            // 预计算的色表
+    double m_maxDepth;                   // 所有网格的最大插值节点深度
+    double m_minLogRho, m_maxLogRho;     // 模型值范围
+};
+
+} // namespace MT
+
+#endif // MT_SECTION_RASTERIZER_H
@@ -0,0 +1,74 @@
+#ifndef MT_SNAPSHOT_BUFFER_H
+#define MT_SNAPSHOT_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * MT快照缓冲模块
+ * 单生产者单消费者的无锁"最新值"缓冲（三缓冲），用于把反演中间结果交给界面线程
+ *
+ * 写入方总是写自己独占的缓冲区，publish()与中间缓冲区原子交换；
+ * 读取方在update()时把中间缓冲区换成自己的读缓冲区。双方都不会等待对方，
+ * 读取方只看到最新发布的快照，跳过的旧快照直接被覆盖，不会积压。
+ */
+namespace MT {
+
+template <typename T>
+class SnapshotBuffer {
+public:
+    SnapshotBuffer()
+        : m_state(1), m_writeIndex(0), m_readIndex(2) {
+    }
+
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    /**
+     * 获取写缓冲区（只在写入线程中调用）
+     * @return 写缓冲区引用，填充完成后调用publish()
+     */
+    T& writeBuffer() { return m_buffers[m_writeIndex]; }
+
+    /**
+     * 发布写缓冲区中的快照（只在写入线程中调用，不会阻塞）
+     */
+    void publish() {
+        uint8_t previous = m_state.exchange(static_cast<uint8_t>(m_writeIndex | DIRTY_BIT),
+                                            std::memory_order_acq_rel);
+        m_writeIndex = previous & INDEX_MASK;
+    }
+
+    /**
+     * 取出最新快照（只在读取线程中调用，不会阻塞）
+     * @return 自上次调用以来是否有新快照
+     */
+    bool update() {
+        if (!(m_state.load(std::memory_order_relaxed) & DIRTY_BIT)) {
+            return false;
+        }
+        uint8_t previous = m_state.exchange(static_cast<uint8_t>(m_readIndex),
+                                            std::memory_order_acq_rel);
+        m_readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * 获取读缓冲区（只在读取线程中调用，内容在下一次update()之前保持不变）
+     * @return 最近一次update()取得的快照
+     */
+    const T& read() const { return m_buffers[m_readIndex]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t DIRTY_BIT = 0x4;
+
+    T m_buffers[3];
+    alignas(64) std::atomic<uint8_t> m_state;  // 中间缓冲区序号 + 新快照标志
+    alignas(64) int m_writeIndex;              // 写入线程独占
+    alignas(64) int m_readIndex;               // 读取线程独占
+};
+
+} // namespace MT
+
+#endif // MT_SNAPSHOT_BUFFER_H
@@ -0,0 +1,340 @@
+#include "mt_station_pipeline.h"
+#include "mt_thread_policy.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace MT {
+
+namespace {
+
+// 队列满/空时的退避等待：先让出时间片，持续等待时再短暂休眠
+void backoff(int& spins) {
+    if (spins < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    spins++;
+}
+
+// 结果文件表头中的分量名
+const char* componentLabel(DataComponent component) {
+    switch (component) {
+        case DataComponent::LOG_RHO_XY:  return "log10(rho_xy)";
+        case DataComponent::PHASE_XY:    return "phase_xy";
+        case DataComponent::LOG_RHO_YX:  return "log10(rho_yx)";
+        case DataComponent::PHASE_YX:    return "phase_yx";
+        case DataComponent::RE_ZXY:      return "re_zxy";
+        case DataComponent::IM_ZXY:      return "im_zxy";
+        case DataComponent::RE_ZYX:      return "re_zyx";
+        case DataComponent::IM_ZYX:      return "im_zyx";
+        case DataComponent::LOG_RHO_DET: return "log10(rho_det)";
+        case DataComponent::PHASE_DET:   return "phase_det";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+StationPipeline::StationPipeline(int nWorkers, int queueCapacity)
+    : m_nWorkers(nWorkers), m_queueCapacity(queueCapacity), m_periodResampler(nullptr) {
+    if (m_nWorkers <= 0) {
+        // 读取和写出各占一个线程，其余核心用于反演
+        int nCores = static_cast<int>(std::thread::hardware_concurrency());
+        m_nWorkers = std::max(1, nCores - 2);
+    }
+    if (m_queueCapacity <= 0) {
+        m_queueCapacity = 2 * m_nWorkers;
+    }
+}
+
+StationPipeline::~StationPipeline() {
+}
+
+void StationPipeline::setCoreSetup(const CoreSetupFunc& setup) {
+    m_coreSetup = setup;
+}
+
+void StationPipeline::setPeriodResampler(PeriodResampler* resampler) {
+    m_periodResampler = resampler;
+}
+
+StationPipeline::Statistics StationPipeline::run(const ReaderFunc& reader, const WriterFunc& writer) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    BoundedQueue<InversionParams> inputQueue(static_cast<size_t>(m_queueCapacity));
+    BoundedQueue<InversionResult> outputQueue(static_cast<size_t>(m_queueCapacity));
+
+    std::atomic<bool> readerDone(false);
+    std::atomic<int> workersRemaining(m_nWorkers);
+    std::atomic<int> nRead(0), nInverted(0), nFailed(0), nWritten(0);
+
+    // 1. 读取线程：解析测站并放入输入队列（队列满时等待，从而限制内存占用）
+    std::thread readerThread([&]() {
+        InversionParams params;
+        while (reader(params)) {
+            nRead++;
+            int spins = 0;
+            while (!inputQueue.tryPush(std::move(params))) {
+                backoff(spins);
+            }
+            params = InversionParams();
+        }
+        readerDone.store(true, std::memory_order_release);
+    });
+
+    // 2. 反演线程：每个线程持有独立的MTInversionCore（反演核心不是线程安全的）
+    std::vector<std::thread> workerThreads;
+    workerThreads.reserve(m_nWorkers);
+    for (int w = 0; w < m_nWorkers; w++) {
+        workerThreads.emplace_back([&]() {
+            MTInversionCore core;
+            if (m_coreSetup) {
+                m_coreSetup(core);
+            }
+
+            InversionParams params;
+            int spins = 0;
+            for (;;) {
+                if (!inputQueue.tryPop(params)) {
+                    // 读取线程结束后再检查一次队列，确保不丢失最后入队的测站
+                    if (readerDone.load(std::memory_order_acquire)) {
+                        if (!inputQueue.tryPop(params)) {
+                            break;
+                        }
+                    } else {
+                        backoff(spins);
+                        continue;
+                    }
+                }
+                spins = 0;
+
+                InversionResult result;
+                {
+                    ParallelTaskScope task;
+                    result = core.invert(params);
+                }
+                if (result.success) {
+                    nInverted++;
+                } else {
+                    nFailed++;
+                }
+
+                int pushSpins = 0;
+                while (!outputQueue.tryPush(std::move(result))) {
+                    backoff(pushSpins);
+                }
+            }
+            workersRemaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    // 3. 写出线程：序列化结果
+    std::thread writerThread([&]() {
+        InversionResult result;
+        int spins = 0;
+        for (;;) {
+            if (!outputQueue.tryPop(result)) {
+                if (workersRemaining.load(std::memory_order_acquire) == 0) {
+                    if (!outputQueue.tryPop(result)) {
+                        break;
+                    }
+                } else {
+                    backoff(spins);
+                    continue;
+                }
+            }
+            spins = 0;
+            writer(result);
+            nWritten++;
+        }
+    });
+
+    readerThread.join();
+    for (std::thread& t : workerThreads) {
+        t.join();
+    }
+    writerThread.join();
+
+    Statistics stats;
+    stats.nRead = nRead.load();
+    stats.nInverted = nInverted.load();
+    stats.nFailed = nFailed.load();
+    stats.nWritten = nWritten.load();
+    stats.elapsedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    return stats;
+}
+
+StationPipeline::Statistics StationPipeline::runFiles(const std::vector<std::string>& stationFiles,
+                                                      std::ostream& out,
+                                                      const InversionParams& baseParams) {
+    size_t nextFile = 0;
+    int nReadErrors = 0;
+
+    ReaderFunc reader = [&](InversionParams& params) {
+        while (nextFile < stationFiles.size()) {
+            params = baseParams;
+            std::string errorMessage;
+            if (readStationFile(stationFiles[nextFile++], params) &&
+                (!m_periodResampler || m_periodResampler->resample(params, errorMessage))) {
+                return true;
+            }
+            nReadErrors++;  // 跳过无法解析或无法重采样的文件
+        }
+        return false;
+    };
+
+    WriterFunc writer = [&](const InversionResult& result) {
+        writeResult(out, result);
+    };
+
+    Statistics stats = run(reader, writer);
+    stats.nFailed += nReadErrors;
+    return stats;
+}
+
+bool StationPipeline::readStationFile(const std::string& path, InversionParams& params) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string stationId = path;
+    std::vector<double> periods;
+    std::vector<double> values;  // 按行读入：values[i * nComponents + c]
+    const size_t nComponents = params.components.empty() ? 2 : params.components.size();
+
+    std::string line;
+    while (std::getline(file, line)) {
+        // 跳过空行和注释
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        std::istringstream iss(line.substr(first));
+        // "station"关键字后必须是空白或行尾（"stationX ..."不是关键字）
+        const size_t keywordEnd = first + 7;
+        if (line.compare(first, 7, "station") == 0 &&
+            (keywordEnd == line.size() || std::isspace(static_cast<unsigned char>(line[keywordEnd])))) {
+            std::string keyword;
+            iss >> keyword >> stationId;
+            continue;
+        }
+
+        double period;
+        if (!(iss >> period) || !(period > 0.0)) {
+            return false;
+        }
+        for (size_t c = 0; c < nComponents; c++) {
+            double value;
+            if (!(iss >> value) || !std::isfinite(value)) {
+                return false;
+            }
+            values.push_back(value);
+        }
+        std::string extra;
+        if (iss >> extra) {
+            return false;  // 值的个数与分量数不一致
+        }
+        periods.push_back(period);
+    }
+
+    int nFreq = static_cast<int>(periods.size());
+    if (nFreq < 2) {
+        return false;
+    }
+
+    // 未指定分量时log10(ρ_a)和相位交替存储（即按行存储），否则按分量优先存储
+    std::vector<double> dObs(values.size());
+    for (int i = 0; i < nFreq; i++) {
+        for (size_t c = 0; c < nComponents; c++) {
+            size_t index = params.components.empty() ? i * nComponents + c : c * nFreq + i;
+            dObs[index] = values[i * nComponents + c];
+        }
+    }
+
+    params.stationId = stationId;
+    params.nFreq = nFreq;
+    params.periods = periods;
+    params.omega.resize(nFreq);
+    for (int i = 0; i < nFreq; i++) {
+        params.omega[i] = 2.0 * M_PI / periods[i];
+    }
+    params.dObs = dObs;
+    return true;
+}
+
+void StationPipeline::writeResult(std::ostream& out, const InversionResult& result) {
+    std::ostringstream oss;  // 先格式化到缓冲区，再一次性写出
+    oss << "station " << result.stationId << "\n";
+    oss << "# success " << (result.success ? 1 : 0)
+        << " iterations " << result.nIterations << "\n";
+    if (!result.success) {
+        oss << "# error " << result.errorMessage << "\n";
+    }
+    if (!result.residualHistory.empty()) {
+        oss << "# residual " << std::setprecision(10) << result.residualHistory.back() << "\n";
+    }
+
+    oss << "# layer depth(m) thickness(m) log10(rho)\n";
+    oss << std::setprecision(10);
+    for (size_t i = 0; i < result.mFinal.size(); i++) {
+        double depth = i < result.layerDepths.size() ? result.layerDepths[i] : 0.0;
+        double thickness = i < result.layerThicknesses.size() ? result.layerThicknesses[i] : 0.0;
+        oss << "model " << i + 1 << " " << depth << " " << thickness << " " << result.mFinal[i] << "\n";
+    }
+
+    if (result.components.empty()) {
+        oss << "# period(s) obs_log10(rho_a) obs_phase syn_log10(rho_a) syn_phase\n";
+        for (size_t i = 0; i < result.periods.size(); i++) {
+            if (2 * i + 1 >= result.dObs.size() || 2 * i + 1 >= result.dSyn.size()) {
+                break;
+            }
+            oss << "data " << result.periods[i] << " "
+                << result.dObs[2 * i] << " " << result.dObs[2 * i + 1] << " "
+                << result.dSyn[2 * i] << " " << result.dSyn[2 * i + 1] << "\n";
+        }
+    } else {
+        // 按分量优先存储：第c个分量在第i个周期的值为data[c * nFreq + i]
+        const size_t nFreq = result.periods.size();
+        const size_t nData = result.components.size() * nFreq;
+        oss << "# period(s)";
+        for (const char* prefix : { " obs_", " syn_" }) {
+            for (DataComponent component : result.components) {
+                oss << prefix << componentLabel(component);
+            }
+        }
+        oss << "\n";
+        if (result.dObs.size() >= nData && result.dSyn.size() >= nData) {
+            for (size_t i = 0; i < nFreq; i++) {
+                oss << "data " << result.periods[i];
+                for (const std::vector<double>* data : { &result.dObs, &result.dSyn }) {
+                    for (size_t c = 0; c < result.components.size(); c++) {
+                        oss << " " << (*data)[c * nFreq + i];
+                    }
+                }
+                oss << "\n";
+            }
+        }
+    }
+    oss << "end\n";
+
+    out << oss.str();
+    out.flush();
+}
+
+} // namespace MT
@@ -0,0 +1,124 @@
+#ifndef MT_STATION_PIPELINE_H
+#define MT_STATION_PIPELINE_H
+
+#include "mt_model.h"
+#include "mt_bounded_queue.h"
+#include "mt_inversion_core.h"
+#include "mt_period_resampler.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <iosfwd>
+
+/**
+ * MT测站流水线模块
+ * 面向测区规模的三级流水线：读取 → 反演 → 写出
+ *
+ * 一个读取线程解析测站文件，N个反演线程各自持有一个MTInversionCore，
+ * 一个写出线程序列化InversionResult。各级之间使用有界无锁队列连接，
+ * 内存占用只与队列容量和线程数有关，与测站总数无关，且I/O与计算重叠。
+ */
+namespace MT {
+
+class StationPipeline {
+public:
+    /**
+     * 读取函数：填充下一个测站的反演参数，没有更多测站时返回false
+     */
+    using ReaderFunc = std::function<bool(InversionParams& params)>;
+
+    /**
+     * 写出函数：处理一个测站的反演结果（只在写出线程中调用）
+     */
+    using WriterFunc = std::function<void(const InversionResult& result)>;
+
+    /**
+     * 反演核心初始化函数：在每个反演线程启动时调用，用于定制各模块
+     */
+    using CoreSetupFunc = std::function<void(MTInversionCore& core)>;
+
+    /**
+     * 流水线运行统计
+     */
+    struct Statistics {
+        int nRead = 0;              // 读取的测站数
+        int nInverted = 0;          // 完成反演的测站数
+        int nFailed = 0;            // 反演失败的测站数
+        int nWritten = 0;           // 写出的测站数
+        double elapsedSeconds = 0;  // 总耗时（秒）
+    };
+
+    /**
+     * 构造函数
+     * @param nWorkers 反演线程数（<=0表示按CPU核数自动选择）
+     * @param queueCapacity 每个队列的容量（<=0表示使用2*nWorkers）
+     */
+    explicit StationPipeline(int nWorkers = 0, int queueCapacity = 0);
+    ~StationPipeline();
+
+    /**
+     * 运行流水线（阻塞直到所有测站写出）
+     * 结果按完成顺序写出，可用InversionResult::stationId区分测站
+     * @param reader 读取函数
+     * @param writer 写出函数
+     * @return 运行统计
+     */
+    Statistics run(const ReaderFunc& reader, const WriterFunc& writer);
+
+    /**
+     * 运行流水线：依次读取测站文件，结果写入输出流
+     * @param stationFiles 测站文件路径列表
+     * @param out 输出流
+     * @param baseParams 反演参数模板（M、λ等），数据部分由测站文件覆盖
+     * @return 运行统计
+     */
+    Statistics runFiles(const std::vector<std::string>& stationFiles, std::ostream& out,
+                        const InversionParams& baseParams = InversionParams());
+
+    /**
+     * 设置反演核心初始化函数
+     * @param setup 初始化函数
+     */
+    void setCoreSetup(const CoreSetupFunc& setup);
+
+    /**
+     * 设置周期重采样器：runFiles()读取测站文件后把观测数据重采样到统一的周期网格，
+     * 重采样失败的测站按读取失败处理
+     * @param resampler 重采样器（为空表示不重采样；只在读取线程中使用，生命周期由调用方保证）
+     */
+    void setPeriodResampler(PeriodResampler* resampler);
+
+    /**
+     * 获取反演线程数
+     * @return 线程数
+     */
+    int getWorkerCount() const { return m_nWorkers; }
+
+    /**
+     * 读取测站文件
+     * 文本格式：以#开头的行为注释；"station <ID>"指定测站ID；
+     * 其余每行为"周期(s) log10(ρ_a) 相位(度)"；params.components非空时为"周期(s)"加各分量的值，
+     * dObs按分量优先存储（c * nFreq + i）
+     * @param path 文件路径
+     * @param params 输入输出：components决定每行的分量；输出stationId、nFreq、periods、omega、dObs
+     * @return 是否成功
+     */
+    static bool readStationFile(const std::string& path, InversionParams& params);
+
+    /**
+     * 写出反演结果（文本格式，与readStationFile的注释风格一致；数据行按result.components逐分量写出）
+     * @param out 输出流
+     * @param result 反演结果
+     */
+    static void writeResult(std::ostream& out, const InversionResult& result);
+
+private:
+    int m_nWorkers;          // 反演线程数
+    int m_queueCapacity;     // 队列容量
+    CoreSetupFunc m_coreSetup;
+    PeriodResampler* m_periodResampler;
+};
+
+} // namespace MT
+
+#endif // MT_STATION_PIPELINE_H
@@ -0,0 +1,465 @@
+#include "mt_survey_dashboard.h"
+#include "mt_station_pipeline.h"
+#include "mt_thread_policy.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QMutexLocker>
+#include <QThread>
+#include <QColor>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+// ==================== SurveyTableModel ====================
+
+SurveyTableModel::SurveyTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_flushTimer(new QTimer(this)) {
+    // 每200ms合并一次工作线程提交的更新
+    connect(m_flushTimer, &QTimer::timeout, this, &SurveyTableModel::flushUpdates);
+    m_flushTimer->start(200);
+}
+
+void SurveyTableModel::resetStations(const QVector<QString>& stationIds) {
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        m_pending.clear();
+    }
+    beginResetModel();
+    m_rows.clear();
+    m_rows.reserve(stationIds.size());
+    for (const QString& id : stationIds) {
+        Row row;
+        row.stationId = id;
+        m_rows.append(row);
+    }
+    endResetModel();
+}
+
+void SurveyTableModel::postUpdate(int row, const Row& data) {
+    QMutexLocker locker(&m_pendingMutex);
+    m_pending.insert(row, data);  // 覆盖同一行尚未显示的旧状态
+}
+
+void SurveyTableModel::flushUpdates() {
+    QHash<int, Row> pending;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        if (m_pending.isEmpty()) {
+            return;
+        }
+        pending.swap(m_pending);
+    }
+
+    int firstRow = std::numeric_limits<int>::max();
+    int lastRow = -1;
+    for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+        int row = it.key();
+        if (row < 0 || row >= m_rows.size()) {
+            continue;
+        }
+        m_rows[row] = it.value();
+        firstRow = std::min(firstRow, row);
+        lastRow = std::max(lastRow, row);
+    }
+
+    // 对受影响的行区间只发出一次dataChanged
+    if (lastRow >= 0) {
+        emit dataChanged(index(firstRow, 0), index(lastRow, ColumnCount - 1));
+    }
+}
+
+int SurveyTableModel::countStatus(Status status) const {
+    int n = 0;
+    for (const Row& row : m_rows) {
+        if (row.status == status) {
+            n++;
+        }
+    }
+    return n;
+}
+
+int SurveyTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int SurveyTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant SurveyTableModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+    const Row& row = m_rows[index.row()];
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case ColStation:
+            return row.stationId;
+        case ColStatus:
+            return statusText(row.status);
+        case ColIteration:
+            return row.iteration;
+        case ColResidual:
+            return row.iteration > 0 ? QString::number(row.residual, 'e', 3) : QString();
+        case ColDmNorm:
+            return row.iteration > 0 ? QString::number(row.dmNorm, 'e', 3) : QString();
+        case ColElapsed:
+            return row.status == Status::Queued ? QString() : QString::number(row.elapsedSeconds, 'f', 1);
+        default:
+            break;
+        }
+    } else if (role == Qt::ForegroundRole && index.column() == ColStatus) {
+        switch (row.status) {
+        case Status::Running:
+            return QColor(0, 0, 200);
+        case Status::Finished:
+            return QColor(0, 128, 0);
+        case Status::Failed:
+            return QColor(200, 0, 0);
+        default:
+            break;
+        }
+    } else if (role == Qt::TextAlignmentRole && index.column() != ColStation) {
+        return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant SurveyTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case ColStation:   return QString("测站");
+    case ColStatus:    return QString("状态");
+    case ColIteration: return QString("迭代");
+    case ColResidual:  return QString("残差");
+    case ColDmNorm:    return QString("模型更新");
+    case ColElapsed:   return QString("用时(s)");
+    default:           return QVariant();
+    }
+}
+
+QString SurveyTableModel::statusText(Status status) {
+    switch (status) {
+    case Status::Queued:    return "排队中";
+    case Status::Running:   return "反演中";
+    case Status::Finished:  return "已完成";
+    case Status::Failed:    return "失败";
+    case Status::Cancelled: return "已取消";
+    }
+    return QString();
+}
+
+// ==================== SurveyDashboard ====================
+
+namespace {
+
+// 单个测站反演的回调上下文
+struct StationTaskContext {
+    SurveyTableModel* model;
+    int row;
+    SurveyTableModel::Row state;
+    QElapsedTimer timer;
+    std::shared_ptr<std::atomic<bool>> cancelFlag;
+};
+
+} // namespace
+
+SurveyDashboard::SurveyDashboard(const MT::InversionParams& baseParams, QWidget* parent)
+    : QWidget(parent)
+    , m_baseParams(baseParams)
+    , m_cancelFlag(std::make_shared<std::atomic<bool>>(false))
+    , m_running(false)
+    , m_model(new SurveyTableModel(this))
+    , m_summaryTimer(new QTimer(this)) {
+    setWindowTitle("测区批量反演");
+    resize(800, 600);
+
+    // 线程池大小等于CPU核数
+    m_pool.setMaxThreadCount(QThread::idealThreadCount());
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    QHBoxLayout* toolLayout = new QHBoxLayout();
+    m_btnLoad = new QPushButton("加载测站文件");
+    m_btnSynthetic = new QPushButton("添加合成测站");
+    m_spinSynthetic = new QSpinBox();
+    m_spinSynthetic->setRange(1, 10000);
+    m_spinSynthetic->setValue(32);
+    m_spinThreads = new QSpinBox();
+    m_spinThreads->setRange(1, std::max(1, QThread::idealThreadCount()));
+    m_spinThreads->setValue(std::max(1, QThread::idealThreadCount()));
+    m_btnStart = new QPushButton("开始");
+    m_btnCancel = new QPushButton("取消");
+    m_btnSection = new QPushButton("拟断面");
+    toolLayout->addWidget(m_btnLoad);
+    toolLayout->addWidget(m_btnSynthetic);
+    toolLayout->addWidget(m_spinSynthetic);
+    toolLayout->addStretch();
+    toolLayout->addWidget(new QLabel("线程数:"));
+    toolLayout->addWidget(m_spinThreads);
+    toolLayout->addWidget(m_btnStart);
+    toolLayout->addWidget(m_btnCancel);
+    toolLayout->addWidget(m_btnSection);
+    mainLayout->addLayout(toolLayout);
+
+    m_table = new QTableView();
+    m_table->setModel(m_model);
+    m_table->setAlternatingRowColors(true);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    m_table->verticalHeader()->setDefaultSectionSize(20);
+    mainLayout->addWidget(m_table, 1);
+
+    m_summaryLabel = new QLabel("请加载测站文件或添加合成测站");
+    mainLayout->addWidget(m_summaryLabel);
+
+    connect(m_btnLoad, &QPushButton::clicked, this, &SurveyDashboard::onLoadStationFiles);
+    connect(m_btnSynthetic, &QPushButton::clicked, this, &SurveyDashboard::onAddSyntheticStations);
+    connect(m_btnStart, &QPushButton::clicked, this, &SurveyDashboard::onStart);
+    connect(m_btnCancel, &QPushButton::clicked, this, &SurveyDashboard::onCancel);
+    connect(m_btnSection, &QPushButton::clicked, this, &SurveyDashboard::onShowPseudoSection);
+    connect(m_table, &QTableView::doubleClicked, this, &SurveyDashboard::onRowDoubleClicked);
+    connect(m_summaryTimer, &QTimer::timeout, this, &SurveyDashboard::onRefreshSummary);
+
+    setRunning(false);
+}
+
+SurveyDashboard::~SurveyDashboard() {
+    // 取消排队的任务并等待正在运行的任务结束（任务会在下一次迭代回调时退出）
+    m_cancelFlag->store(true);
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void SurveyDashboard::setBaseParams(const MT::InversionParams& baseParams) {
+    m_baseParams = baseParams;
+}
+
+MT::SharedInversionResult SurveyDashboard::resultAt(int row) const {
+    QMutexLocker locker(&m_resultMutex);
+    if (row < 0 || row >= m_results.size()) {
+        return MT::SharedInversionResult();
+    }
+    return m_results[row];
+}
+
+void SurveyDashboard::onLoadStationFiles() {
+    QStringList files = QFileDialog::getOpenFileNames(this, "选择测站文件");
+    if (files.isEmpty()) {
+        return;
+    }
+
+    int nFailed = 0;
+    for (const QString& file : files) {
+        MT::InversionParams params = m_baseParams;
+        if (MT::StationPipeline::readStationFile(file.toStdString(), params)) {
+            m_stations.append(params);
+        } else {
+            nFailed++;
+        }
+    }
+    if (nFailed > 0) {
+        QMessageBox::warning(this, "警告", QString("%1个测站文件无法解析，已跳过").arg(nFailed));
+    }
+
+    QVector<QString> ids;
+    for (const MT::InversionParams& params : m_stations) {
+        ids.append(QString::fromStdString(params.stationId));
+    }
+    m_model->resetStations(ids);
+    onRefreshSummary();
+}
+
+void SurveyDashboard::onAddSyntheticStations() {
+    // 合成测站使用默认模型，噪声由测站ID决定，因此每个测站的数据不同且可复现
+    int n = m_spinSynthetic->value();
+    int first = m_stations.size();
+    for (int i = 0; i < n; i++) {
+        MT::InversionParams params = m_baseParams;
+        params.stationId = QString("SYN-%1").arg(first + i + 1, 4, 10, QChar('0')).toStdString();
+        params.dObs.clear();
+        params.mTrue.clear();
+        m_stations.append(params);
+    }
+
+    QVector<QString> ids;
+    for (const MT::InversionParams& params : m_stations) {
+        ids.append(QString::fromStdString(params.stationId));
+    }
+    m_model->resetStations(ids);
+    onRefreshSummary();
+}
+
+void SurveyDashboard::onStart() {
+    if (m_running || m_stations.isEmpty()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_resultMutex);
+        m_results = QVector<MT::SharedInversionResult>(m_stations.size());
+    }
+    QVector<QString> ids;
+    for (const MT::InversionParams& params : m_stations) {
+        ids.append(QString::fromStdString(params.stationId));
+    }
+    m_model->resetStations(ids);
+
+    // 新批次使用新的取消标志，已取消批次中仍在收尾的任务不受影响
+    m_cancelFlag = std::make_shared<std::atomic<bool>>(false);
+    m_pool.setMaxThreadCount(m_spinThreads->value());
+    m_batchTimer.start();
+    setRunning(true);
+
+    // 提交任务时按值捕获本批次的取消标志（工作线程不读取m_cancelFlag成员）
+    std::shared_ptr<std::atomic<bool>> cancelFlag = m_cancelFlag;
+    for (int row = 0; row < m_stations.size(); row++) {
+        m_pool.start([this, row, cancelFlag]() { runStation(row, cancelFlag); });
+    }
+}
+
+void SurveyDashboard::onCancel() {
+    if (!m_running) {
+        return;
+    }
+    m_cancelFlag->store(true);
+    m_pool.clear();  // 移除尚未开始的任务
+
+    // 被移除的任务不会运行，直接标记为已取消；
+    // 正在运行的任务会在下一次迭代回调时结束并自行更新状态
+    QMutexLocker locker(&m_resultMutex);
+    for (int row = 0; row < m_stations.size(); row++) {
+        if (!m_results[row]) {
+            SurveyTableModel::Row state;
+            state.stationId = QString::fromStdString(m_stations[row].stationId);
+            state.status = SurveyTableModel::Status::Cancelled;
+            m_model->postUpdate(row, state);
+        }
+    }
+}
+
+void SurveyDashboard::runStation(int row, std::shared_ptr<std::atomic<bool>> cancelFlag) {
+    if (cancelFlag->load()) {
+        return;
+    }
+
+    StationTaskContext context;
+    context.model = m_model;
+    context.row = row;
+    context.state.stationId = QString::fromStdString(m_stations[row].stationId);
+    context.state.status = SurveyTableModel::Status::Running;
+    context.cancelFlag = cancelFlag;
+    context.timer.start();
+    m_model->postUpdate(row, context.state);
+
+    MTInversionCore core;
+    core.setProgressCallback([](int iteration, double residual, double dmNorm, void* userData) {
+        StationTaskContext* ctx = static_cast<StationTaskContext*>(userData);
+        if (ctx->cancelFlag->load()) {
+            // 反演核心捕获异常后返回失败结果，从而提前结束迭代
+            throw std::runtime_error("反演被用户取消");
+        }
+        ctx->state.iteration = iteration;
+        ctx->state.residual = residual;
+        ctx->state.dmNorm = dmNorm;
+        ctx->state.elapsedSeconds = ctx->timer.elapsed() / 1000.0;
+        ctx->model->postUpdate(ctx->row, ctx->state);
+    }, &context);
+
+    // 登记为外层并行任务：MKL线程数按同时运行的测站数分配，避免过度订阅
+    MT::InversionResult result;
+    {
+        MT::ParallelTaskScope task;
+        result = core.invert(m_stations[row]);
+    }
+    result.stationId = m_stations[row].stationId;
+
+    context.state.elapsedSeconds = context.timer.elapsed() / 1000.0;
+    if (result.success) {
+        context.state.status = SurveyTableModel::Status::Finished;
+        context.state.iteration = result.nIterations;
+        if (!result.residualHistory.empty()) context.state.residual = result.residualHistory.back();
+        if (!result.dmNormHistory.empty()) context.state.dmNorm = result.dmNormHistory.back();
+    } else {
+        context.state.status = cancelFlag->load() ? SurveyTableModel::Status::Cancelled
+                                                  : SurveyTableModel::Status::Failed;
+    }
+    m_model->postUpdate(row, context.state);
+
+    // 结果移动到共享对象中，之后只读；查看结果和断面时只复制指针
+    MT::SharedInversionResult shared = std::make_shared<const MT::InversionResult>(std::move(result));
+    QMutexLocker locker(&m_resultMutex);
+    m_results[row] = std::move(shared);
+}
+
+void SurveyDashboard::onRefreshSummary() {
+    int nQueued = m_model->countStatus(SurveyTableModel::Status::Queued);
+    int nRunning = m_model->countStatus(SurveyTableModel::Status::Running);
+    int nFinished = m_model->countStatus(SurveyTableModel::Status::Finished);
+    int nFailed = m_model->countStatus(SurveyTableModel::Status::Failed);
+    int nCancelled = m_model->countStatus(SurveyTableModel::Status::Cancelled);
+
+    QString text = QString("测站 %1：排队 %2 / 反演中 %3 / 完成 %4 / 失败 %5 / 取消 %6")
+                       .arg(m_stations.size()).arg(nQueued).arg(nRunning)
+                       .arg(nFinished).arg(nFailed).arg(nCancelled);
+    if (m_running) {
+        text += QString("，线程 %1，用时 %2 s")
+                    .arg(m_pool.maxThreadCount())
+                    .arg(m_batchTimer.elapsed() / 1000.0, 0, 'f', 1);
+        // 线程池空闲且表格已收到所有更新时批次结束
+        if (m_pool.activeThreadCount() == 0 && nQueued == 0 && nRunning == 0) {
+            setRunning(false);
+        }
+    }
+    m_summaryLabel->setText(text);
+}
+
+void SurveyDashboard::onRowDoubleClicked(const QModelIndex& index) {
+    MT::SharedInversionResult result = resultAt(index.row());
+    if (result && result->success) {
+        emit stationResultSelected(result);
+    }
+}
+
+void SurveyDashboard::onShowPseudoSection() {
+    // 按表格顺序排列测站，未完成的测站（空指针）在断面中显示为空白列；只复制共享指针
+    std::vector<MT::SharedInversionResult> results;
+    {
+        QMutexLocker locker(&m_resultMutex);
+        results.assign(m_results.begin(), m_results.end());
+    }
+    if (results.empty()) {
+        QMessageBox::information(this, "提示", "还没有反演结果");
+        return;
+    }
+
+    if (!m_sectionView) {
+        m_sectionView = new PseudoSectionView(this);
+        m_sectionView->setWindowFlags(Qt::Window);
+        m_sectionView->resize(1000, 500);
+    }
+    m_sectionView->setResults(results);
+    m_sectionView->show();
+    m_sectionView->raise();
+}
+
+void SurveyDashboard::setRunning(bool running) {
+    m_running = running;
+    m_btnStart->setEnabled(!running);
+    m_btnCancel->setEnabled(running);
+    m_btnLoad->setEnabled(!running);
+    m_btnSynthetic->setEnabled(!running);
+    m_spinThreads->setEnabled(!running);
+    if (running) {
+        m_summaryTimer->start(500);
+    } else {
+        m_summaryTimer->stop();
+    }
+}
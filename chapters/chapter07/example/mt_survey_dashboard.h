@@ -0,0 +1,191 @@
+#ifndef MT_SURVEY_DASHBOARD_H
+#define MT_SURVEY_DASHBOARD_H
+
+#include <QWidget>
+#include <QAbstractTableModel>
+#include <QThreadPool>
+#include <QTableView>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QLabel>
+#include <QTimer>
+#include <QMutex>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <atomic>
+#include <memory>
+#include "mt_inversion_core.h"
+#include "mt_pseudo_section_view.h"
+
+/**
+ * 测区反演状态表格模型
+ * 每行对应一个测站，显示状态、迭代次数和拟合差
+ *
+ * 工作线程通过postUpdate()写入待处理更新（加锁，只保留每行最新状态），
+ * 界面线程的定时器定期合并所有待处理更新，并对受影响的行区间只发出一次dataChanged，
+ * 避免数百个测站的逐迭代信号淹没事件循环。
+ */
+class SurveyTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+     * 测站状态
+     */
+    enum class Status {
+        Queued,     // 排队中
+        Running,    // 反演中
+        Finished,   // 已完成
+        Failed,     // 失败
+        Cancelled   // 已取消
+    };
+
+    /**
+     * 表格列
+     */
+    enum Column {
+        ColStation = 0,
+        ColStatus,
+        ColIteration,
+        ColResidual,
+        ColDmNorm,
+        ColElapsed,
+        ColumnCount
+    };
+
+    /**
+     * 一行的显示数据
+     */
+    struct Row {
+        QString stationId;
+        Status status = Status::Queued;
+        int iteration = 0;
+        double residual = 0.0;
+        double dmNorm = 0.0;
+        double elapsedSeconds = 0.0;
+    };
+
+    explicit SurveyTableModel(QObject* parent = nullptr);
+
+    /**
+     * 重置测站列表（所有测站为排队状态）
+     * @param stationIds 测站ID列表
+     */
+    void resetStations(const QVector<QString>& stationIds);
+
+    /**
+     * 提交一行的最新状态（线程安全，可在工作线程中调用）
+     * @param row 行号
+     * @param data 最新状态
+     */
+    void postUpdate(int row, const Row& data);
+
+    /**
+     * 合并所有待处理更新（在界面线程中由定时器调用）
+     */
+    void flushUpdates();
+
+    /**
+     * 统计各状态的测站数
+     * @param status 状态
+     * @return 测站数
+     */
+    int countStatus(Status status) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    static QString statusText(Status status);
+
+private:
+    QVector<Row> m_rows;           // 界面线程使用的行数据
+    QMutex m_pendingMutex;         // 保护待处理更新
+    QHash<int, Row> m_pending;     // 待处理更新（每行只保留最新状态）
+    QTimer* m_flushTimer;          // 批量刷新定时器
+};
+
+/**
+ * 测区批量反演面板
+ * 把多个测站排入QThreadPool（线程数等于CPU核数），每个任务使用独立的MTInversionCore，
+ * 表格实时显示各测站的状态、迭代次数和拟合差
+ */
+class SurveyDashboard : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * 构造函数
+     * @param baseParams 反演参数模板（M、λ、最大迭代次数等）
+     * @param parent 父窗口
+     */
+    explicit SurveyDashboard(const MT::InversionParams& baseParams, QWidget* parent = nullptr);
+    ~SurveyDashboard();
+
+    /**
+     * 设置反演参数模板（只影响之后开始的反演）
+     * @param baseParams 参数模板
+     */
+    void setBaseParams(const MT::InversionParams& baseParams);
+
+    /**
+     * 获取已完成测站的结果
+     * @param row 行号
+     * @return 共享的只读结果（未完成时为空指针）
+     */
+    MT::SharedInversionResult resultAt(int row) const;
+
+signals:
+    /**
+     * 用户双击已完成的测站时发出
+     */
+    void stationResultSelected(const MT::SharedInversionResult& result);
+
+private slots:
+    void onLoadStationFiles();
+    void onAddSyntheticStations();
+    void onStart();
+    void onCancel();
+    void onRefreshSummary();
+    void onRowDoubleClicked(const QModelIndex& index);
+    void onShowPseudoSection();
+
+private:
+    /**
+     * 运行一个测站的反演（在线程池线程中执行）
+     * @param row 行号
+     * @param cancelFlag 提交任务时所属批次的取消标志
+     */
+    void runStation(int row, std::shared_ptr<std::atomic<bool>> cancelFlag);
+
+    void setRunning(bool running);
+
+    MT::InversionParams m_baseParams;
+    QVector<MT::InversionParams> m_stations;   // 测站输入
+    QVector<MT::SharedInversionResult> m_results;  // 测站结果（按行号，各任务只写自己的行；未完成为空）
+    mutable QMutex m_resultMutex;              // 保护m_results
+
+    QThreadPool m_pool;
+    std::shared_ptr<std::atomic<bool>> m_cancelFlag;  // 当前批次的取消标志
+    QElapsedTimer m_batchTimer;
+    bool m_running;
+
+    SurveyTableModel* m_model;
+    QTableView* m_table;
+    QPushButton* m_btnLoad;
+    QPushButton* m_btnSynthetic;
+    QPushButton* m_btnStart;
+    QPushButton* m_btnCancel;
+    QPushButton* m_btnSection;
+    QSpinBox* m_spinSynthetic;
+    QSpinBox* m_spinThreads;
+    QLabel* m_summaryLabel;
+    QTimer* m_summaryTimer;
+    QPointer<PseudoSectionView> m_sectionView;  // 拟断面窗口
+};
+
+#endif // MT_SURVEY_DASHBOARD_H
@@ -0,0 +1,84 @@
+#include "mt_thread_policy.h"
+#include <mkl.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace MT {
+
+namespace {
+
+std::atomic<int> g_coreCount(0);     // 0表示使用硬件线程数
+std::atomic<int> g_activeTasks(0);
+thread_local int t_taskDepth = 0;    // 本线程嵌套的ParallelTaskScope层数
+
+} // namespace
+
+int ThreadPolicy::coreCount() {
+    int n = g_coreCount.load(std::memory_order_relaxed);
+    if (n > 0) {
+        return n;
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void ThreadPolicy::setCoreCount(int nCores) {
+    g_coreCount.store(std::max(0, nCores), std::memory_order_relaxed);
+}
+
+int ThreadPolicy::mklThreadLimit() {
+    // 查询全局设置：临时取消本线程的局部设置（0表示使用全局值）
+    static const int limit = []() {
+        int previous = mkl_set_num_threads_local(0);
+        int n = mkl_get_max_threads();
+        mkl_set_num_threads_local(previous);
+        return std::max(1, n);
+    }();
+    return limit;
+}
+
+int ThreadPolicy::activeTasks() {
+    return g_activeTasks.load(std::memory_order_relaxed);
+}
+
+int ThreadPolicy::availableThreads() {
+    int busy = activeTasks() + (t_taskDepth == 0 ? 1 : 0);
+    return std::max(1, coreCount() / std::max(1, busy));
+}
+
+int ThreadPolicy::threadsForWork(double flops) {
+    double byWork = flops / MIN_FLOPS_PER_THREAD;
+    int n = std::min(availableThreads(), mklThreadLimit());
+    if (byWork < n) {
+        n = static_cast<int>(byWork);
+    }
+    return std::max(1, n);
+}
+
+ParallelTaskScope::ParallelTaskScope()
+    : m_outermost(t_taskDepth++ == 0)
+    , m_previousThreads(0) {
+    if (m_outermost) {
+        g_activeTasks.fetch_add(1, std::memory_order_relaxed);
+        m_previousThreads = mkl_set_num_threads_local(1);
+    }
+}
+
+ParallelTaskScope::~ParallelTaskScope() {
+    t_taskDepth--;
+    if (m_outermost) {
+        mkl_set_num_threads_local(m_previousThreads);
+        g_activeTasks.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+MklThreadScope::MklThreadScope(double flops)
+    : m_threads(ThreadPolicy::threadsForWork(flops))
+    , m_previousThreads(mkl_set_num_threads_local(m_threads)) {
+}
+
+MklThreadScope::~MklThreadScope() {
+    mkl_set_num_threads_local(m_previousThreads);
+}
+
+} // namespace MT
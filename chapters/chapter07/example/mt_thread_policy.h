@@ -0,0 +1,100 @@
+#ifndef MT_THREAD_POLICY_H
+#define MT_THREAD_POLICY_H
+
+/**
+ * MKL线程策略模块
+ * 外层并行（测站流水线、反演服务、测区面板、有限差分正演的频率分块）与MKL内部线程共用同一组CPU核心。
+ * 外层任务全部串行调用MKL会在任务数少于核数时闲置核心，全部用多线程MKL又会在任务数多时过度订阅。
+ *
+ * - ParallelTaskScope：外层线程池的每个任务在执行期间登记为活动任务，并把本线程的MKL线程数设为1
+ *   （未标注的小规模调用保持串行）。
+ * - MklThreadScope：在计算量大的调用点（cblas_dsyrk、dpotrf/dgesv、dsyev等）按计算量和当前活动任务数
+ *   临时设置本线程的MKL线程数（mkl_set_num_threads_local），离开作用域时恢复。
+ *
+ * 每个任务可用的线程数为 核数 / 活动任务数（向下取整，至少1），因此测区末尾只剩少数测站时
+ * 这些测站自动使用空出的核心。链接串行MKL（mkl_sequential）时MKL线程数恒为1，策略不改变结果。
+ */
+namespace MT {
+
+class ThreadPolicy {
+public:
+    /**
+     * 每个MKL线程至少分到的浮点运算量；低于此值时线程同步开销超过并行收益
+     */
+    static constexpr double MIN_FLOPS_PER_THREAD = 1e6;
+
+    /**
+     * 可用的CPU核数（默认为硬件线程数）
+     */
+    static int coreCount();
+
+    /**
+     * 设置可用的CPU核数（<= 0表示恢复为硬件线程数），用于与其他进程共享机器
+     */
+    static void setCoreCount(int nCores);
+
+    /**
+     * MKL允许的最大线程数（首次调用时查询全局设置，串行MKL为1）
+     */
+    static int mklThreadLimit();
+
+    /**
+     * 当前活动的外层并行任务数
+     */
+    static int activeTasks();
+
+    /**
+     * 当前线程可用的线程数：核数 / 活动任务数（当前线程不在外层任务中时也计为一个任务）
+     */
+    static int availableThreads();
+
+    /**
+     * 给定计算量的MKL调用应使用的线程数
+     * @param flops 调用的浮点运算量估计
+     * @return 线程数（1 <= n <= min(availableThreads(), mklThreadLimit())）
+     */
+    static int threadsForWork(double flops);
+};
+
+/**
+ * 外层并行任务作用域
+ * 构造时登记为活动任务并把本线程的MKL线程数设为1，析构时注销并恢复；同一线程内嵌套时只登记一次
+ */
+class ParallelTaskScope {
+public:
+    ParallelTaskScope();
+    ~ParallelTaskScope();
+
+    ParallelTaskScope(const ParallelTaskScope&) = delete;
+    ParallelTaskScope& operator=(const ParallelTaskScope&) = delete;
+
+private:
+    bool m_outermost;
+    int m_previousThreads;
+};
+
+/**
+ * MKL调用点的线程数作用域
+ * 构造时按ThreadPolicy::threadsForWork()设置本线程的MKL线程数，析构时恢复
+ */
+class MklThreadScope {
+public:
+    /**
+     * @param flops 作用域内MKL调用中最大一次的浮点运算量估计
+     */
+    explicit MklThreadScope(double flops);
+    ~MklThreadScope();
+
+    MklThreadScope(const MklThreadScope&) = delete;
+    MklThreadScope& operator=(const MklThreadScope&) = delete;
+
+    int getThreadCount() const { return m_threads; }
+
+private:
+    int m_threads;
+    int m_previousThreads;
+};
+
+} // namespace MT
+
+#endif // MT_THREAD_POLICY_H
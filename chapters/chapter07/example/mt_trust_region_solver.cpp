@@ -0,0 +1,282 @@
+#include "mt_trust_region_solver.h"
+#include <mkl.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace MT {
+
+namespace {
+
+// dtrnlsp其余停止准则的容差：信赖域半径、Jacobian列范数、预测下降量、试探步求解精度
+const double DEFAULT_TOLERANCE = 1e-10;
+
+/**
+ * dtrnlsp句柄（离开作用域时释放）
+ */
+struct TrustRegionHandle {
+    _TRNSP_HANDLE_t handle = nullptr;
+    bool initialized = false;
+    ~TrustRegionHandle() {
+        if (initialized) {
+            dtrnlsp_delete(&handle);
+        }
+    }
+};
+
+/**
+ * 堆叠残差问题（也是djacobix回调的userData）
+ */
+struct StackedProblem {
+    ForwardSolver* forwardSolver = nullptr;
+    const std::vector<double>* omega = nullptr;
+    const std::vector<double>* layerThicknesses = nullptr;
+    const std::vector<double>* dObs = nullptr;
+    std::vector<double> scaledR;    // λ^(1/2)*R（nRows×n，行主序）
+    int n = 0;
+    int nData = 0;
+    int nRows = 0;
+    int nEvaluations = 0;
+    // 最近一次正演的参数和合成数据（接受点的Jacobian请求通常就在该点的残差计算之后）
+    std::vector<double> lastX;
+    std::vector<double> lastDSyn;
+
+    void forward(const double* x) {
+        if (!lastX.empty() && std::equal(lastX.begin(), lastX.end(), x)) {
+            return;
+        }
+        lastX.assign(x, x + n);
+        forwardSolver->solve(lastX, *omega, *layerThicknesses, lastDSyn);
+        lastDSyn.resize(nData);
+    }
+
+    void evaluate(const double* x, double* f) {
+        forward(x);
+        nEvaluations++;
+        vdSub(nData, lastDSyn.data(), dObs->data(), f);
+        for (int i = 0; i < nData; i++) {
+            if (!std::isfinite(f[i])) {
+                f[i] = 0.0;  // 与内置循环相同：无效数据不计入残差
+            }
+        }
+        if (nRows > 0) {
+            cblas_dgemv(CblasRowMajor, CblasNoTrans, nRows, n, 1.0, scaledR.data(), n, x, 1,
+                        0.0, f + nData, 1);
+        }
+    }
+
+    double dataResidualNorm() const {
+        double sum = 0.0;
+        for (int i = 0; i < nData; i++) {
+            double r = (*dObs)[i] - lastDSyn[i];
+            if (std::isfinite(r)) {
+                sum += r * r;
+            }
+        }
+        return std::sqrt(sum);
+    }
+};
+
+void stackedResidual(MKL_INT* /*m*/, MKL_INT* /*n*/, double* x, double* f, void* userData) {
+    static_cast<StackedProblem*>(userData)->evaluate(x, f);
+}
+
+} // namespace
+
+TrustRegionSolver::TrustRegionSolver(ForwardSolver* forwardSolver, JacobianCalculator* jacobianCalculator)
+    : m_forwardSolver(forwardSolver)
+    , m_jacobianCalculator(jacobianCalculator)
+    , m_jacobianSource(TrustRegionJacobian::CALCULATOR)
+    , m_maxIter(20)
+    , m_maxTrialIter(100)
+    , m_stepTolerance(1e-4)
+    , m_residualTolerance(DEFAULT_TOLERANCE)
+    , m_stepBound(100.0)
+    , m_iterationCallback(nullptr)
+    , m_iterationUserData(nullptr) {
+    if (!forwardSolver) {
+        throw std::invalid_argument("ForwardSolver pointer cannot be null");
+    }
+}
+
+TrustRegionSolver::~TrustRegionSolver() {
+}
+
+void TrustRegionSolver::setIterationLimits(int maxIter, int maxTrialIter) {
+    m_maxIter = std::max(1, maxIter);
+    m_maxTrialIter = std::max(1, maxTrialIter);
+}
+
+void TrustRegionSolver::setTolerances(double stepTolerance, double residualTolerance) {
+    m_stepTolerance = stepTolerance;
+    m_residualTolerance = residualTolerance;
+}
+
+void TrustRegionSolver::setIterationCallback(IterationCallback callback, void* userData) {
+    m_iterationCallback = callback;
+    m_iterationUserData = userData;
+}
+
+bool TrustRegionSolver::solve(const std::vector<double>& omega,
+                              const std::vector<double>& layerThicknesses,
+                              const std::vector<double>& dObs,
+                              const std::vector<std::vector<double>>& R,
+                              double lambda,
+                              double epsilon,
+                              std::vector<double>& m,
+                              TrustRegionReport& report,
+                              std::string& errorMessage) {
+    report = TrustRegionReport();
+    const int n = static_cast<int>(m.size());
+    if (n == 0 || dObs.empty()) {
+        errorMessage = "empty model or data";
+        return false;
+    }
+    if (m_jacobianSource == TrustRegionJacobian::CALCULATOR && !m_jacobianCalculator) {
+        errorMessage = "Jacobian calculator is not set";
+        return false;
+    }
+    if (!(epsilon > 0.0)) {
+        errorMessage = "finite-difference step must be positive";
+        return false;
+    }
+
+    // 1. 堆叠残差：数据残差在前，λ^(1/2)*R*m在后（lambda <= 0时只有数据残差）
+    StackedProblem problem;
+    problem.forwardSolver = m_forwardSolver;
+    problem.omega = &omega;
+    problem.layerThicknesses = &layerThicknesses;
+    problem.dObs = &dObs;
+    problem.n = n;
+    problem.nData = static_cast<int>(dObs.size());
+    if (lambda > 0.0) {
+        problem.nRows = static_cast<int>(R.size());
+        problem.scaledR.resize(static_cast<size_t>(problem.nRows) * n);
+        const double scale = std::sqrt(lambda);
+        for (int r = 0; r < problem.nRows; r++) {
+            if (R[r].size() != static_cast<size_t>(n)) {
+                errorMessage = "regularization operator does not match the parameter count";
+                return false;
+            }
+            for (int j = 0; j < n; j++) {
+                problem.scaledR[static_cast<size_t>(r) * n + j] = scale * R[r][j];
+            }
+        }
+    }
+    const int nResiduals = problem.nData + problem.nRows;
+    if (nResiduals < n) {
+        errorMessage = "fewer residuals than parameters (use lambda > 0)";
+        return false;
+    }
+
+    // 2. 初始化dtrnlsp（x由求解器就地更新；fjac为nResiduals×n列主序）
+    std::vector<double> x = m;
+    std::vector<double> fvec(nResiduals, 0.0);
+    std::vector<double> fjac(static_cast<size_t>(nResiduals) * n, 0.0);
+    double eps[6] = { DEFAULT_TOLERANCE, m_residualTolerance, DEFAULT_TOLERANCE,
+                      m_stepTolerance, DEFAULT_TOLERANCE, DEFAULT_TOLERANCE };
+    MKL_INT mklN = n;
+    MKL_INT mklM = nResiduals;
+    MKL_INT iter1 = m_maxIter;
+    MKL_INT iter2 = m_maxTrialIter;
+    double rs = m_stepBound;
+    TrustRegionHandle handle;
+    if (dtrnlsp_init(&handle.handle, &mklN, &mklM, x.data(), eps, &iter1, &iter2, &rs) != TR_SUCCESS) {
+        errorMessage = "dtrnlsp_init failed";
+        return false;
+    }
+    handle.initialized = true;
+    MKL_INT info[6];
+    if (dtrnlsp_check(&handle.handle, &mklN, &mklM, fjac.data(), fvec.data(), eps, info) != TR_SUCCESS
+        || info[0] != 0 || info[1] != 0 || info[2] != 0 || info[3] != 0) {
+        errorMessage = "dtrnlsp_check rejected the problem setup";
+        return false;
+    }
+
+    // 每个接受点记录一次数据残差并调用回调（同一点只报告一次）
+    std::vector<double> xAccepted;
+    auto accept = [&]() {
+        if (!xAccepted.empty() && xAccepted == x) {
+            return;
+        }
+        xAccepted = x;
+        problem.forward(x.data());
+        double residualNorm = problem.dataResidualNorm();
+        report.residualHistory.push_back(residualNorm);
+        if (m_iterationCallback) {
+            m_iterationCallback(static_cast<int>(report.residualHistory.size()) - 1, residualNorm,
+                                xAccepted, problem.lastDSyn, m_iterationUserData);
+        }
+    };
+
+    // 3. 反向通信循环：1 = 在x处计算F，2 = 在x处计算Jacobian，< 0 = 满足停止准则
+    std::vector<std::vector<double>> J;
+    MKL_INT request = 0;
+    while (true) {
+        if (dtrnlsp_solve(&handle.handle, fvec.data(), fjac.data(), &request) != TR_SUCCESS) {
+            errorMessage = "dtrnlsp_solve failed";
+            return false;
+        }
+        if (request < 0) {
+            break;
+        }
+        if (request == 1) {
+            problem.evaluate(x.data(), fvec.data());
+        } else if (request == 2) {
+            accept();
+            report.nJacobianEvaluations++;
+            if (m_jacobianSource == TrustRegionJacobian::MKL_DJACOBI) {
+                double jacobianEps = epsilon;
+                if (djacobix(stackedResidual, &mklN, &mklM, fjac.data(), x.data(), &jacobianEps,
+                             &problem) != TR_SUCCESS) {
+                    errorMessage = "djacobix failed";
+                    return false;
+                }
+            } else {
+                // J_F的数据部分为∂g/∂m，正则化部分为常数λ^(1/2)*R
+                m_jacobianCalculator->compute(x, omega, problem.lastDSyn, layerThicknesses, epsilon, J);
+                for (int j = 0; j < n; j++) {
+                    double* column = &fjac[static_cast<size_t>(j) * nResiduals];
+                    for (int i = 0; i < problem.nData; i++) {
+                        column[i] = J[i][j];
+                    }
+                    for (int r = 0; r < problem.nRows; r++) {
+                        column[problem.nData + r] = problem.scaledR[static_cast<size_t>(r) * n + j];
+                    }
+                }
+            }
+        }
+    }
+    accept();
+
+    // 4. 读取迭代统计
+    MKL_INT iterations = 0;
+    MKL_INT stopCriterion = 0;
+    double r1 = 0.0;
+    double r2 = 0.0;
+    if (dtrnlsp_get(&handle.handle, &iterations, &stopCriterion, &r1, &r2) != TR_SUCCESS) {
+        errorMessage = "dtrnlsp_get failed";
+        return false;
+    }
+    report.nIterations = static_cast<int>(iterations);
+    report.stopCriterion = static_cast<int>(stopCriterion);
+    report.nResidualEvaluations = problem.nEvaluations;
+    report.initialNorm = r1;
+    report.finalNorm = r2;
+    m.swap(x);
+    return true;
+}
+
+const char* TrustRegionSolver::stopReason(int stopCriterion) {
+    switch (stopCriterion) {
+        case 1: return "iteration limit reached";
+        case 2: return "trust region radius below tolerance";
+        case 3: return "residual norm below tolerance";
+        case 4: return "Jacobian is singular";
+        case 5: return "trial step below tolerance";
+        case 6: return "predicted reduction below tolerance";
+        default: return "unknown";
+    }
+}
+
+} // namespace MT
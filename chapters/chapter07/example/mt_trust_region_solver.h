@@ -0,0 +1,131 @@
+#ifndef MT_TRUST_REGION_SOLVER_H
+#define MT_TRUST_REGION_SOLVER_H
+
+#include "mt_model.h"
+#include "mt_forward_solver.h"
+#include "mt_jacobian_calculator.h"
+#include <vector>
+#include <string>
+
+/**
+ * MT信赖域反演模块
+ * 用MKL的信赖域非线性最小二乘求解器（dtrnlsp_*，反向通信接口）代替内置的高斯-牛顿循环。
+ * 正演和正则化写成堆叠残差
+ *   F(m) = [ g(m) - dObs      ]     J_F = [ J          ]
+ *          [ λ^(1/2) * R * m  ]           [ λ^(1/2)*R  ]
+ * 求min ||F(m)||²，即||dObs - g(m)||² + λ||R*m||²（正则化作用于模型本身，而内置循环作用于更新量）。
+ * 步长由信赖域半径控制，不需要内置循环的固定λ阻尼；接受/拒绝试探步和半径调整都在MKL内部完成。
+ *
+ * Jacobian来源：
+ * - CALCULATOR：JacobianCalculator（前向差分，复用当前模型的合成数据，M次正演）
+ * - MKL_DJACOBI：MKL djacobix对整个F做中心差分（2M次残差计算，不依赖JacobianCalculator）
+ *
+ * 每个被接受的迭代点调用一次迭代回调，便于与内置循环比较收敛所需的迭代次数和耗时。
+ */
+namespace MT {
+
+/**
+ * 信赖域求解报告
+ */
+struct TrustRegionReport {
+    int nIterations = 0;                 // 接受的迭代步数
+    int stopCriterion = 0;               // dtrnlsp的停止准则（1-6，见stopReason()）
+    int nResidualEvaluations = 0;        // 堆叠残差计算次数（含试探步和djacobix内部的计算）
+    int nJacobianEvaluations = 0;        // Jacobian计算次数
+    double initialNorm = 0.0;            // 初始堆叠残差范数||F(m0)||
+    double finalNorm = 0.0;              // 最终堆叠残差范数||F(m)||
+    std::vector<double> residualHistory; // 各接受点的数据残差范数||dObs - g(m)||（含初始点和终点）
+};
+
+class TrustRegionSolver {
+public:
+    /**
+     * 迭代回调：每个被接受的迭代点调用一次（iteration从0开始，0为初始模型）
+     * @param residual 数据残差范数||dObs - g(m)||
+     * @param m 当前参数
+     * @param dSyn 当前参数的合成数据
+     */
+    typedef void (*IterationCallback)(int iteration, double residual,
+                                      const std::vector<double>& m,
+                                      const std::vector<double>& dSyn,
+                                      void* userData);
+
+    /**
+     * 构造函数
+     * @param forwardSolver 正演求解器指针（必须有效）
+     * @param jacobianCalculator Jacobian计算器（使用CALCULATOR来源时必须有效，应与forwardSolver一致）
+     */
+    TrustRegionSolver(ForwardSolver* forwardSolver, JacobianCalculator* jacobianCalculator);
+    ~TrustRegionSolver();
+
+    /**
+     * 设置Jacobian来源
+     */
+    void setJacobianSource(TrustRegionJacobian source) { m_jacobianSource = source; }
+
+    /**
+     * 设置迭代次数上限
+     * @param maxIter 最大迭代步数（>= 1）
+     * @param maxTrialIter 每步最多试探次数（>= 1）
+     */
+    void setIterationLimits(int maxIter, int maxTrialIter);
+
+    /**
+     * 设置停止容差（对应dtrnlsp的eps[3]和eps[1]，其余准则使用默认值）
+     * @param stepTolerance 试探步范数容差||s||
+     * @param residualTolerance 堆叠残差范数容差||F||
+     */
+    void setTolerances(double stepTolerance, double residualTolerance);
+
+    /**
+     * 设置确定初始信赖域半径的系数（MKL建议取值0.1~100）
+     */
+    void setInitialStepBound(double stepBound) { m_stepBound = stepBound; }
+
+    void setIterationCallback(IterationCallback callback, void* userData = nullptr);
+
+    /**
+     * 求解
+     * @param omega 角频率数组
+     * @param layerThicknesses 层厚度数组
+     * @param dObs 观测数据
+     * @param R 正则化算子（nRows行×nParams列；lambda <= 0时不参与）
+     * @param lambda 正则化参数
+     * @param epsilon 有限差分步长
+     * @param m 输入初始参数，输出最终参数（nParams维）
+     * @param report 输出的求解报告
+     * @param errorMessage 失败时的错误信息
+     * @return 是否成功（达到迭代上限也视为成功）
+     */
+    bool solve(const std::vector<double>& omega,
+               const std::vector<double>& layerThicknesses,
+               const std::vector<double>& dObs,
+               const std::vector<std::vector<double>>& R,
+               double lambda,
+               double epsilon,
+               std::vector<double>& m,
+               TrustRegionReport& report,
+               std::string& errorMessage);
+
+    /**
+     * 停止准则的说明
+     * @param stopCriterion dtrnlsp_get返回的st_cr
+     */
+    static const char* stopReason(int stopCriterion);
+
+private:
+    ForwardSolver* m_forwardSolver;
+    JacobianCalculator* m_jacobianCalculator;
+    TrustRegionJacobian m_jacobianSource;
+    int m_maxIter;
+    int m_maxTrialIter;
+    double m_stepTolerance;
+    double m_residualTolerance;
+    double m_stepBound;
+    IterationCallback m_iterationCallback;
+    void* m_iterationUserData;
+};
+
+} // namespace MT
+
+#endif // MT_TRUST_REGION_SOLVER_H
@@ -0,0 +1,75 @@
+#ifndef MT_TEST_HARNESS_H
+#define MT_TEST_HARNESS_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cmath>
+
+/**
+ * MT示例的最小测试框架（无第三方依赖）
+ * MT_TEST定义并注册测试函数，MT_CHECK系列宏记录失败但不中断当前测试。
+ * 测试程序：mt_example_tests [--update-golden] [--update-baseline] [名称前缀...]
+ */
+namespace MTTest {
+
+/**
+ * 运行选项（由命令行和环境变量设置）
+ */
+struct Options {
+    bool updateGolden = false;       // 重新生成黄金结果文件
+    bool updateBaseline = false;     // 重新生成性能基线文件
+    double goldenTolerance = 1e-6;   // 黄金结果的相对容差（MT_GOLDEN_RTOL，0表示逐位相同）
+    double perfTolerance = 0.5;      // 允许的耗时增长比例（MT_PERF_TOLERANCE）
+    bool runPerf = false;            // 检查性能阈值（MT_RUN_PERF=1；默认跳过，基线与机器相关）
+    std::string dataDir;             // 黄金结果和性能基线目录（MT_TEST_DATA_DIR）
+};
+
+Options& options();
+
+typedef void (*TestFunc)();
+
+struct Registrar {
+    Registrar(const char* name, TestFunc func);
+};
+
+/**
+ * 记录一次检查失败（当前测试标记为失败，继续执行）
+ */
+void reportFailure(const char* file, int line, const std::string& message);
+
+/**
+ * 相对误差检查：|actual - expected| <= tolerance * max(1, |expected|)
+ */
+inline bool near(double actual, double expected, double tolerance) {
+    return std::fabs(actual - expected) <= tolerance * std::fmax(1.0, std::fabs(expected));
+}
+
+} // namespace MTTest
+
+#define MT_TEST(name)                                                   \
+    static void name();                                                 \
+    static MTTest::Registrar name##_registrar(#name, &name);            \
+    static void name()
+
+#define MT_CHECK(condition)                                             \
+    do {                                                                \
+        if (!(condition)) {                                             \
+            MTTest::reportFailure(__FILE__, __LINE__, #condition);      \
+        }                                                               \
+    } while (0)
+
+#define MT_CHECK_NEAR(actual, expected, tolerance)                      \
+    do {                                                                \
+        double mtActual_ = (actual);                                    \
+        double mtExpected_ = (expected);                                \
+        if (!MTTest::near(mtActual_, mtExpected_, (tolerance))) {       \
+            std::ostringstream mtMessage_;                              \
+            mtMessage_.precision(17);                                   \
+            mtMessage_ << #actual << " = " << mtActual_ << ", expected " \
+                       << mtExpected_ << " (tolerance " << (tolerance) << ")"; \
+            MTTest::reportFailure(__FILE__, __LINE__, mtMessage_.str()); \
+        }                                                               \
+    } while (0)
+
+#endif // MT_TEST_HARNESS_H
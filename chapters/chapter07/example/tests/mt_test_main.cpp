@@ -0,0 +1,101 @@
+#include "mt_test_harness.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+namespace MTTest {
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    TestFunc func;
+};
+
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+int g_failures = 0;  // 当前测试的失败检查数
+
+} // namespace
+
+Options& options() {
+    static Options opts;
+    return opts;
+}
+
+Registrar::Registrar(const char* name, TestFunc func) {
+    registry().push_back({ name, func });
+}
+
+void reportFailure(const char* file, int line, const std::string& message) {
+    fprintf(stderr, "  %s:%d: check failed: %s\n", file, line, message.c_str());
+    g_failures++;
+}
+
+} // namespace MTTest
+
+int main(int argc, char* argv[]) {
+    MTTest::Options& opts = MTTest::options();
+#ifdef MT_TEST_DATA_DIR
+    opts.dataDir = MT_TEST_DATA_DIR;
+#endif
+    if (const char* dir = getenv("MT_TEST_DATA_DIR")) {
+        opts.dataDir = dir;
+    }
+    if (const char* tolerance = getenv("MT_GOLDEN_RTOL")) {
+        opts.goldenTolerance = atof(tolerance);
+    }
+    if (const char* tolerance = getenv("MT_PERF_TOLERANCE")) {
+        opts.perfTolerance = atof(tolerance);
+    }
+    if (const char* runPerf = getenv("MT_RUN_PERF")) {
+        opts.runPerf = strcmp(runPerf, "") != 0 && strcmp(runPerf, "0") != 0;
+    }
+
+    std::vector<std::string> prefixes;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update-golden") == 0) {
+            opts.updateGolden = true;
+        } else if (strcmp(argv[i], "--update-baseline") == 0) {
+            opts.updateBaseline = true;
+        } else {
+            prefixes.push_back(argv[i]);
+        }
+    }
+
+    int nRun = 0;
+    int nFailed = 0;
+    for (const MTTest::TestCase& test : MTTest::registry()) {
+        bool selected = prefixes.empty();
+        for (const std::string& prefix : prefixes) {
+            selected = selected || strncmp(test.name, prefix.c_str(), prefix.size()) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        printf("[ RUN  ] %s\n", test.name);
+        fflush(stdout);
+        MTTest::g_failures = 0;
+        try {
+            test.func();
+        } catch (const std::exception& e) {
+            MTTest::reportFailure(__FILE__, __LINE__, std::string("exception: ") + e.what());
+        }
+        nRun++;
+        if (MTTest::g_failures > 0) {
+            nFailed++;
+            printf("[ FAIL ] %s\n", test.name);
+        } else {
+            printf("[  OK  ] %s\n", test.name);
+        }
+        fflush(stdout);
+    }
+
+    printf("%d test(s) run, %d failed\n", nRun, nFailed);
+    return (nRun == 0 || nFailed > 0) ? 1 : 0;
+}
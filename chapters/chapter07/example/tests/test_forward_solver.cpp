@@ -0,0 +1,145 @@
+#include "mt_test_harness.h"
+#include "mt_forward_solver.h"
+#include "mt_lookup_forward_solver.h"
+#include "mt_fd_forward_solver.h"
+#include "mt_frequency_generator.h"
+#include <complex>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// 两层模型地表阻抗的解析解（e^{iωt}约定）：Z = Z1 (Z2 + Z1 tanh(k1 h)) / (Z1 + Z2 tanh(k1 h))
+std::complex<double> twoLayerImpedance(double rho1, double rho2, double h, double omega) {
+    const std::complex<double> i(0.0, 1.0);
+    std::complex<double> Z1 = std::sqrt(i * omega * MT::MU0 * rho1);
+    std::complex<double> Z2 = std::sqrt(i * omega * MT::MU0 * rho2);
+    std::complex<double> k1 = std::sqrt(i * omega * MT::MU0 / rho1);
+    std::complex<double> t = std::tanh(k1 * h);
+    return Z1 * (Z2 + Z1 * t) / (Z1 + Z2 * t);
+}
+
+void impedanceToData(const std::complex<double>& Z, double omega, double& logRho, double& phase) {
+    logRho = log10(std::norm(Z) / (omega * MT::MU0));
+    phase = std::arg(Z) * 180.0 / PI;
+}
+
+void frequencies(int nFreq, std::vector<double>& omega) {
+    std::vector<double> periods;
+    MT::FrequencyGenerator().generate(nFreq, periods, omega);
+}
+
+} // namespace
+
+MT_TEST(forward_halfspace) {
+    // 均匀半空间：ρ_a = ρ，相位 = 45°（所有频率）
+    std::vector<double> omega;
+    frequencies(61, omega);
+    MT::ForwardSolver solver;
+    for (double rho : { 1.0, 100.0, 1e4 }) {
+        std::vector<double> m(5, log10(rho));
+        std::vector<double> thicknesses(5, 50.0);
+        std::vector<double> data;
+        solver.solve(m, omega, thicknesses, data);
+        MT_CHECK(data.size() == 2 * omega.size());
+        for (size_t f = 0; f < omega.size(); f++) {
+            MT_CHECK_NEAR(data[2 * f], log10(rho), 1e-12);
+            MT_CHECK_NEAR(data[2 * f + 1], 45.0, 1e-10);
+        }
+    }
+}
+
+MT_TEST(forward_two_layer) {
+    std::vector<double> omega;
+    frequencies(61, omega);
+    MT::ForwardSolver solver;
+    struct Case { double rho1, rho2, h; };
+    for (const Case& c : { Case{ 100.0, 10.0, 500.0 }, Case{ 10.0, 1000.0, 2000.0 }, Case{ 1.0, 1e4, 30.0 } }) {
+        std::vector<double> m = { log10(c.rho1), log10(c.rho2) };
+        std::vector<double> thicknesses = { c.h, 1000.0 };  // 最后一层为半空间，厚度不参与计算
+        std::vector<double> data;
+        solver.solve(m, omega, thicknesses, data);
+        for (size_t f = 0; f < omega.size(); f++) {
+            double logRho = 0.0, phase = 0.0;
+            impedanceToData(twoLayerImpedance(c.rho1, c.rho2, c.h, omega[f]), omega[f], logRho, phase);
+            MT_CHECK_NEAR(data[2 * f], logRho, 1e-10);
+            MT_CHECK_NEAR(data[2 * f + 1], phase, 1e-8);
+        }
+    }
+}
+
+MT_TEST(forward_backends_agree) {
+    // 查表法和有限差分法与递推解析法一致（在各自的精度范围内）
+    std::vector<double> omega;
+    frequencies(41, omega);
+    std::vector<double> m = { 2.0, 1.0, 3.0 };
+    std::vector<double> thicknesses = { 300.0, 1500.0, 1000.0 };
+    std::vector<double> reference, lookup, fd;
+    MT::ForwardSolver().solve(m, omega, thicknesses, reference);
+    MT::LookupTableForwardSolver(1e-3).solve(m, omega, thicknesses, lookup);
+    MT::FiniteDifferenceForwardSolver(MT::FiniteDifferenceForwardSolver::Profile::LAYERED, 40.0, 1)
+        .solve(m, omega, thicknesses, fd);
+    MT_CHECK(lookup.size() == reference.size() && fd.size() == reference.size());
+    for (size_t f = 0; f < omega.size(); f++) {
+        MT_CHECK(std::fabs(lookup[2 * f] - reference[2 * f]) < 2e-3);
+        MT_CHECK(std::fabs(lookup[2 * f + 1] - reference[2 * f + 1]) < 0.1);
+        MT_CHECK(std::fabs(fd[2 * f] - reference[2 * f]) < 1e-3);
+        MT_CHECK(std::fabs(fd[2 * f + 1] - reference[2 * f + 1]) < 0.05);
+    }
+}
+
+MT_TEST(forward_batch_matches_single) {
+    std::vector<double> omega;
+    frequencies(31, omega);
+    std::vector<double> thicknesses(20, 100.0);
+    std::vector<std::vector<double>> models(4, std::vector<double>(20));
+    for (size_t k = 0; k < models.size(); k++) {
+        for (int i = 0; i < 20; i++) {
+            models[k][i] = 1.5 + 0.5 * sin(0.3 * i + static_cast<double>(k));
+        }
+    }
+    MT::ForwardSolver solver;
+    std::vector<std::vector<double>> batch;
+    solver.solveBatch(models, omega, thicknesses, batch);
+    MT_CHECK(batch.size() == models.size());
+    for (size_t k = 0; k < models.size(); k++) {
+        std::vector<double> single;
+        solver.solve(models[k], omega, thicknesses, single);
+        MT_CHECK(batch[k] == single);
+    }
+}
+
+MT_TEST(forward_lookup_fallback) {
+    // 超过3层或对比度超出表格范围时退回递推解析法，结果与基类逐位相同（solve和computeImpedance两条路径）
+    std::vector<double> omega;
+    frequencies(31, omega);
+    MT::LookupTableForwardSolver lookup(1e-3);
+    struct Case { std::vector<double> m; std::vector<double> thicknesses; };
+    for (const Case& c : { Case{ { 2.0, 1.0, 3.0, 1.5, 2.5 }, { 200.0, 400.0, 800.0, 1600.0, 1000.0 } },
+                           Case{ { 0.0, 4.5 }, { 300.0, 1000.0 } } }) {
+        std::vector<double> reference, data;
+        MT::ForwardSolver().solve(c.m, omega, c.thicknesses, reference);
+        lookup.solve(c.m, omega, c.thicknesses, data);
+        MT_CHECK(data == reference);
+
+        std::vector<MKL_Complex16> Zreference, Z;
+        MT::ForwardSolver().computeImpedance(c.m, omega, c.thicknesses, Zreference);
+        lookup.computeImpedance(c.m, omega, c.thicknesses, Z);
+        MT_CHECK(Z.size() == Zreference.size());
+        for (size_t f = 0; f < Z.size() && f < Zreference.size(); f++) {
+            MT_CHECK(Z[f].real == Zreference[f].real && Z[f].imag == Zreference[f].imag);
+        }
+
+        // 多分量正演经由computeImpedance()
+        std::vector<double> components;
+        lookup.solveComponents(c.m, omega, c.thicknesses,
+                               { MT::DataComponent::LOG_RHO_XY, MT::DataComponent::PHASE_XY }, components);
+        MT_CHECK(components.size() == reference.size());
+        for (size_t f = 0; f < omega.size() && 2 * f + 1 < components.size(); f++) {
+            MT_CHECK(components[f] == reference[2 * f]);
+            MT_CHECK(components[omega.size() + f] == reference[2 * f + 1]);
+        }
+    }
+    MT_CHECK(lookup.getLookupCount() == 0);
+    MT_CHECK(lookup.getFallbackCount() == 6);
+}
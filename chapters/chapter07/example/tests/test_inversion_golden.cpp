@@ -0,0 +1,154 @@
+#include "mt_test_harness.h"
+#include "mt_inversion_core.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+/**
+ * 黄金结果回归测试
+ * 固定种子的合成数据反演，最终模型、合成数据、残差历史与tests/data/golden_<名称>.txt比较。
+ * 有意改变数值结果时用--update-golden重新生成，并在提交中说明原因。
+ */
+namespace {
+
+typedef std::map<std::string, std::vector<double>> GoldenRecord;
+
+void addRecord(GoldenRecord& record, const MT::InversionResult& result) {
+    record["success"] = { result.success ? 1.0 : 0.0 };
+    record["nIterations"] = { static_cast<double>(result.nIterations) };
+    record["mFinal"] = result.mFinal;
+    record["dSyn"] = result.dSyn;
+    record["residualHistory"] = result.residualHistory;
+    record["lambdaHistory"] = result.lambdaHistory;
+    record["posteriorStd"] = result.posteriorStd;
+    record["doi"] = { result.doi };
+}
+
+std::string goldenPath(const std::string& name) {
+    return MTTest::options().dataDir + "/golden_" + name + ".txt";
+}
+
+bool writeGolden(const std::string& name, const GoldenRecord& record) {
+    FILE* file = fopen(goldenPath(name).c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "# golden result: %s\n", name.c_str());
+    for (const auto& entry : record) {
+        fprintf(file, "%s %zu", entry.first.c_str(), entry.second.size());
+        for (double value : entry.second) {
+            fprintf(file, " %.17g", value);
+        }
+        fprintf(file, "\n");
+    }
+    return fclose(file) == 0;
+}
+
+bool readGolden(const std::string& name, GoldenRecord& record) {
+    std::ifstream file(goldenPath(name));
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream stream(line);
+        std::string key;
+        size_t n = 0;
+        if (!(stream >> key >> n)) {
+            return false;
+        }
+        std::vector<double>& values = record[key];
+        values.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            if (!(stream >> values[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * 与黄金结果比较（--update-golden时改为写入）
+ */
+void checkGolden(const std::string& name, const MT::InversionResult& result) {
+    GoldenRecord actual;
+    addRecord(actual, result);
+    if (MTTest::options().updateGolden) {
+        MT_CHECK(writeGolden(name, actual));
+        printf("  updated %s\n", goldenPath(name).c_str());
+        return;
+    }
+
+    GoldenRecord expected;
+    if (!readGolden(name, expected)) {
+        MTTest::reportFailure(__FILE__, __LINE__, "cannot read " + goldenPath(name) +
+                              " (run with --update-golden to create it)");
+        return;
+    }
+    const double tolerance = MTTest::options().goldenTolerance;
+    for (const auto& entry : expected) {
+        auto it = actual.find(entry.first);
+        if (it == actual.end() || it->second.size() != entry.second.size()) {
+            MTTest::reportFailure(__FILE__, __LINE__, "size mismatch in " + entry.first);
+            continue;
+        }
+        for (size_t i = 0; i < entry.second.size(); i++) {
+            bool same = tolerance > 0.0 ? MTTest::near(it->second[i], entry.second[i], tolerance)
+                                        : it->second[i] == entry.second[i];
+            if (!same) {
+                std::ostringstream message;
+                message.precision(17);
+                message << name << ": " << entry.first << "[" << i << "] = " << it->second[i]
+                        << ", golden " << entry.second[i];
+                MTTest::reportFailure(__FILE__, __LINE__, message.str());
+                break;  // 每个数组只报告第一处差异
+            }
+        }
+    }
+}
+
+} // namespace
+
+MT_TEST(golden_occam_m40) {
+    MT::InversionParams params;
+    params.occam = true;
+    MT::InversionResult result = MTInversionCore().invert(params);
+    MT_CHECK(result.success);
+    checkGolden("occam_m40", result);
+}
+
+MT_TEST(golden_fixed_lambda) {
+    MT::InversionParams params;
+    params.M = 30;
+    params.nFreq = 41;
+    params.lambda = 10.0;
+    params.maxIter = 8;
+    params.computeResolution = false;
+    MT::InversionResult result = MTInversionCore().invert(params);
+    checkGolden("fixed_lambda", result);
+}
+
+MT_TEST(golden_multi_component) {
+    MT::InversionParams params;
+    params.occam = true;
+    params.components = { MT::DataComponent::LOG_RHO_DET, MT::DataComponent::PHASE_DET,
+                          MT::DataComponent::RE_ZXY, MT::DataComponent::IM_ZXY };
+    MT::InversionResult result = MTInversionCore().invert(params);
+    MT_CHECK(result.success);
+    checkGolden("multi_component", result);
+}
+
+MT_TEST(golden_bspline) {
+    MT::InversionParams params;
+    params.M = 80;
+    params.occam = true;
+    params.modelBasis = MT::ModelBasis::BSPLINE;
+    params.nBasis = 15;
+    MT::InversionResult result = MTInversionCore().invert(params);
+    MT_CHECK(result.success);
+    checkGolden("bspline", result);
+}
@@ -0,0 +1,96 @@
+#include "mt_test_harness.h"
+#include "mt_inversion_server.h"
+#include <cstdio>
+
+namespace {
+
+MT::InversionParams serverParams() {
+    MT::InversionParams params;
+    params.M = 20;
+    params.nFreq = 25;
+    params.maxIter = 5;
+    params.computeResolution = false;
+    return params;
+}
+
+} // namespace
+
+MT_TEST(server_request_round_trip) {
+    MT::InversionParams params = serverParams();
+    params.components = { MT::DataComponent::RE_ZXY, MT::DataComponent::IM_ZXY, MT::DataComponent::PHASE_DET };
+    params.engine = MT::InversionEngine::TRUST_REGION;
+    params.trustRegionJacobian = MT::TrustRegionJacobian::MKL_DJACOBI;
+    params.modelBasis = MT::ModelBasis::PCA;
+    params.nBasis = 3;
+    params.priorModels.assign(4, std::vector<double>(params.M, 2.0));
+    params.adaptivePruning = true;
+    params.pruneMergeLayers = true;
+    params.pruneThreshold = 0.05;
+    params.pruneRecheckInterval = 2;
+    params.omega.assign(params.nFreq, 1.0);
+    params.dObs.assign(3 * params.nFreq, 0.5);
+
+    std::vector<unsigned char> payload;
+    MT::Protocol::encodeRequest(params, payload);
+    MT::InversionParams decoded;
+    MT_CHECK(MT::Protocol::decodeRequest(payload, decoded));
+    MT_CHECK(decoded.components == params.components);
+    MT_CHECK(decoded.engine == params.engine);
+    MT_CHECK(decoded.trustRegionJacobian == params.trustRegionJacobian);
+    MT_CHECK(decoded.modelBasis == params.modelBasis);
+    MT_CHECK(decoded.nBasis == params.nBasis);
+    MT_CHECK(decoded.priorModels == params.priorModels);
+    MT_CHECK(decoded.adaptivePruning && decoded.pruneMergeLayers);
+    MT_CHECK(decoded.pruneThreshold == params.pruneThreshold);
+    MT_CHECK(decoded.pruneRecheckInterval == params.pruneRecheckInterval);
+    MT_CHECK(decoded.dObs == params.dObs);
+
+    // 数据长度按分量数检查：两个分量的交替布局长度不再被接受
+    params.dObs.assign(2 * params.nFreq, 0.5);
+    MT::Protocol::encodeRequest(params, payload);
+    MT_CHECK(!MT::Protocol::decodeRequest(payload, decoded));
+}
+
+MT_TEST(server_parallel_same_mesh_requests) {
+    // 同一网格的请求在有空闲线程时并行执行，全部返回结果
+    MT::InversionServer::Options options;
+    options.nWorkers = 2;
+    options.maxBatchSize = 8;
+    MT::InversionServer server(options);
+    std::string error;
+    MT_CHECK(server.start(error));
+    if (!server.isRunning()) {
+        printf("  server start failed: %s\n", error.c_str());
+        return;
+    }
+
+    MT::InversionClient client;
+    MT_CHECK(client.connectTcp(server.getTcpPort()));
+    const int nRequests = 4;
+    MT::InversionParams params = serverParams();
+    for (int r = 0; r < nRequests; r++) {
+        params.noiseSeed = 100 + r;
+        MT_CHECK(client.sendRequest(static_cast<uint32_t>(r + 1), params));
+    }
+    int nResults = 0;
+    MT::Protocol::FrameHeader header;
+    std::vector<unsigned char> payload;
+    while (nResults < nRequests && client.readFrame(header, payload)) {
+        if (header.type == MT::Protocol::MessageType::RESULT) {
+            MT::InversionResult result;
+            MT_CHECK(MT::Protocol::decodeResult(payload, result));
+            MT_CHECK(result.success);
+            MT_CHECK(result.mFinal.size() == static_cast<size_t>(params.M));
+            nResults++;
+        }
+    }
+    MT_CHECK(nResults == nRequests);
+
+    MT::Protocol::Statistics stats;
+    MT_CHECK(client.queryStatistics(stats));
+    MT_CHECK(stats.nReceived == static_cast<uint64_t>(nRequests));
+    MT_CHECK(stats.nRejected == 0);
+    MT_CHECK(stats.meanBatchSize <= 2.0);
+    client.close();
+    server.stop();
+}
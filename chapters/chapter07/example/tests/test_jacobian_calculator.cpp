@@ -0,0 +1,178 @@
+#include "mt_test_harness.h"
+#include "mt_forward_solver.h"
+#include "mt_jacobian_calculator.h"
+#include "mt_frequency_generator.h"
+#include "mt_inversion_core.h"
+#include "mt_layer_pruner.h"
+#include "mt_optimizer.h"
+#include "mt_regularization.h"
+
+namespace {
+
+struct JacobianCase {
+    std::vector<double> m;
+    std::vector<double> omega;
+    std::vector<double> thicknesses;
+    std::vector<double> dSyn;
+};
+
+JacobianCase makeCase(int M, int nFreq) {
+    JacobianCase c;
+    std::vector<double> periods, depths;
+    MT::FrequencyGenerator().generate(nFreq, periods, c.omega);
+    MTInversionCore().computeLayerThicknesses(M, 10.0, 1.2, c.thicknesses, depths);
+    c.m.resize(M);
+    for (int i = 0; i < M; i++) {
+        c.m[i] = 2.0 + 0.8 * sin(0.25 * i);
+    }
+    MT::ForwardSolver().solve(c.m, c.omega, c.thicknesses, c.dSyn);
+    return c;
+}
+
+} // namespace
+
+MT_TEST(jacobian_forward_vs_central) {
+    // 前向差分误差O(ε)，中心差分误差O(ε²)：两者之差应为O(ε)量级
+    JacobianCase c = makeCase(30, 41);
+    MT::ForwardSolver solver;
+    MT::JacobianCalculator calculator(&solver);
+    const double epsilon = 1e-5;
+
+    std::vector<std::vector<double>> Jforward, Jcentral;
+    calculator.setPerturbationMethod("forward");
+    calculator.compute(c.m, c.omega, c.dSyn, c.thicknesses, epsilon, Jforward);
+    calculator.setPerturbationMethod("central");
+    calculator.compute(c.m, c.omega, c.dSyn, c.thicknesses, epsilon, Jcentral);
+
+    MT_CHECK(Jforward.size() == c.dSyn.size() && Jcentral.size() == c.dSyn.size());
+    double maxEntry = 0.0, maxDiff = 0.0;
+    for (size_t i = 0; i < Jcentral.size(); i++) {
+        MT_CHECK(Jforward[i].size() == c.m.size() && Jcentral[i].size() == c.m.size());
+        for (size_t j = 0; j < c.m.size(); j++) {
+            maxEntry = std::fmax(maxEntry, std::fabs(Jcentral[i][j]));
+            maxDiff = std::fmax(maxDiff, std::fabs(Jforward[i][j] - Jcentral[i][j]));
+        }
+    }
+    MT_CHECK(maxEntry > 0.0);
+    // 相位列以度为单位，二阶导数约为1e2量级
+    MT_CHECK(maxDiff < 1e3 * epsilon * std::fmax(1.0, maxEntry));
+}
+
+MT_TEST(jacobian_active_layer_mask) {
+    // 活动层的列与不加掩码时相同，冻结层的列为零
+    JacobianCase c = makeCase(30, 41);
+    MT::ForwardSolver solver;
+    MT::JacobianCalculator calculator(&solver);
+    std::vector<std::vector<double>> Jfull, Jmasked;
+    calculator.compute(c.m, c.omega, c.dSyn, c.thicknesses, 1e-5, Jfull);
+
+    std::vector<bool> active(c.m.size(), true);
+    for (size_t j = 20; j < active.size(); j++) {
+        active[j] = false;
+    }
+    active[5] = false;
+    calculator.setActiveLayers(active);
+    calculator.compute(c.m, c.omega, c.dSyn, c.thicknesses, 1e-5, Jmasked);
+
+    MT_CHECK(Jmasked.size() == Jfull.size());
+    for (size_t i = 0; i < Jfull.size(); i++) {
+        for (size_t j = 0; j < c.m.size(); j++) {
+            if (active[j]) {
+                MT_CHECK(Jmasked[i][j] == Jfull[i][j]);
+            } else {
+                MT_CHECK(Jmasked[i][j] == 0.0);
+            }
+        }
+    }
+}
+
+MT_TEST(jacobian_halfspace_phase_insensitive) {
+    // 均匀半空间中整体平移log10(ρ)：视电阻率导数之和为1，相位导数之和为0
+    JacobianCase c = makeCase(25, 31);
+    std::fill(c.m.begin(), c.m.end(), 2.0);
+    MT::ForwardSolver solver;
+    solver.solve(c.m, c.omega, c.thicknesses, c.dSyn);
+    MT::JacobianCalculator calculator(&solver);
+    calculator.setPerturbationMethod("central");
+    std::vector<std::vector<double>> J;
+    calculator.compute(c.m, c.omega, c.dSyn, c.thicknesses, 1e-5, J);
+    for (size_t f = 0; f < c.omega.size(); f++) {
+        double sumRho = 0.0, sumPhase = 0.0;
+        for (size_t j = 0; j < c.m.size(); j++) {
+            sumRho += J[2 * f][j];
+            sumPhase += J[2 * f + 1][j];
+        }
+        MT_CHECK_NEAR(sumRho, 1.0, 1e-6);
+        MT_CHECK_NEAR(sumPhase, 0.0, 1e-4);
+    }
+}
+
+MT_TEST(jacobian_merged_block_step) {
+    // 合并模式：块扰动的列等于完整Jacobian中块内各列之和，合并后求得的块更新量降低残差
+    // 深部网格远超低阻半空间的探测深度，底部若干层被冻结
+    JacobianCase c = makeCase(50, 41);
+    const int M = static_cast<int>(c.m.size());
+    std::vector<double> dObs = c.dSyn;
+    std::vector<double> m(M, 1.0);
+    MT::ForwardSolver solver;
+    std::vector<double> dSyn;
+    solver.solve(m, c.omega, c.thicknesses, dSyn);
+
+    MT::JacobianCalculator calculator(&solver);
+    std::vector<std::vector<double>> Jfull, J;
+    calculator.compute(m, c.omega, dSyn, c.thicknesses, 1e-5, Jfull);
+    MT::LayerPruner pruner(0.05, 3);
+    pruner.setMode(MT::LayerPruner::Mode::MERGE);
+    pruner.update(m, c.omega, c.thicknesses, Jfull);
+    const int k = pruner.getActiveCount();
+    MT_CHECK(pruner.isMerging());
+    MT_CHECK(k > 0 && k < M);
+
+    calculator.setActiveLayers(pruner.getActiveLayers());
+    calculator.setMergeFrozenLayers(true);
+    calculator.compute(m, c.omega, dSyn, c.thicknesses, 1e-5, J);
+    std::vector<std::vector<double>> JfullMerged = Jfull;
+    pruner.mergeJacobian(JfullMerged);
+    double maxEntry = 0.0, maxDiff = 0.0;
+    for (size_t i = 0; i < J.size(); i++) {
+        for (int j = 0; j < M; j++) {
+            maxEntry = std::fmax(maxEntry, std::fabs(JfullMerged[i][j]));
+            maxDiff = std::fmax(maxDiff, std::fabs(J[i][j] - JfullMerged[i][j]));
+        }
+    }
+    MT_CHECK(maxDiff < 1e-2 * std::fmax(1.0, maxEntry));
+
+    std::vector<double> r(dObs.size());
+    for (size_t i = 0; i < r.size(); i++) {
+        r[i] = dObs[i] - dSyn[i];
+    }
+    std::vector<std::vector<double>> JTJ, L, LTL;
+    std::vector<double> JTr, dm;
+    MT::Optimizer optimizer;
+    optimizer.setActiveParameters(pruner.getActiveLayers());
+    optimizer.computeJTJ(J, JTJ);
+    optimizer.computeJTr(J, r, JTr);
+    MT::Regularization regularization;
+    regularization.buildLMatrix(M, L);
+    regularization.computeLTL(L, LTL);
+    pruner.mergeMatrix(LTL);
+    MT_CHECK(optimizer.solve(JTJ, LTL, 1.0, JTr, dm));
+    pruner.applyMerge(dm);
+    for (int j = k; j < M; j++) {
+        MT_CHECK(dm[j] == dm[k - 1]);
+    }
+
+    auto misfit = [&](const std::vector<double>& d) {
+        double sum = 0.0;
+        for (size_t i = 0; i < d.size(); i++) {
+            sum += (dObs[i] - d[i]) * (dObs[i] - d[i]);
+        }
+        return std::sqrt(sum);
+    };
+    std::vector<double> mNext = m, dNext;
+    for (int j = 0; j < M; j++) {
+        mNext[j] += dm[j];
+    }
+    solver.solve(mNext, c.omega, c.thicknesses, dNext);
+    MT_CHECK(misfit(dNext) < misfit(dSyn));
+}
@@ -0,0 +1,92 @@
+#include "mt_test_harness.h"
+#include "mt_inversion_core.h"
+
+namespace {
+
+/**
+ * 剖面上的K个测站（同一合成模型，噪声流由测站ID决定，各站数据不同）
+ */
+std::vector<MT::InversionParams> makeProfile(int K) {
+    std::vector<MT::InversionParams> stations(K);
+    for (int k = 0; k < K; k++) {
+        MT::InversionParams& params = stations[k];
+        params.M = 30;
+        params.nFreq = 41;
+        params.lambda = 100.0;
+        params.maxIter = 3;
+        params.tolDm = 0.0;  // 固定迭代次数，逐站反演与联合反演走相同的迭代
+        params.computeResolution = false;
+        params.stationId = "P" + std::to_string(k);
+    }
+    return stations;
+}
+
+double lateralRoughness(const std::vector<MT::InversionResult>& results) {
+    double sum = 0.0;
+    for (size_t k = 0; k + 1 < results.size(); k++) {
+        for (size_t i = 0; i < results[k].mFinal.size(); i++) {
+            double d = results[k + 1].mFinal[i] - results[k].mFinal[i];
+            sum += d * d;
+        }
+    }
+    return std::sqrt(sum);
+}
+
+} // namespace
+
+MT_TEST(lateral_zero_lambda_matches_single_station) {
+    // λ_h = 0时联合正规方程块对角，与逐站invert()的结果相同（仅PCG与直接分解的舍入差别）
+    std::vector<MT::InversionParams> stations = makeProfile(3);
+    MTInversionCore core;
+    std::vector<MT::InversionResult> joint = core.invertProfile(stations, 0.0);
+    MT_CHECK(joint.size() == stations.size());
+    for (size_t k = 0; k < stations.size() && k < joint.size(); k++) {
+        MT::InversionResult single = core.invert(stations[k]);
+        MT_CHECK(joint[k].success && single.success);
+        MT_CHECK(joint[k].nIterations == single.nIterations);
+        MT_CHECK(joint[k].mFinal.size() == single.mFinal.size());
+        for (size_t i = 0; i < single.mFinal.size() && i < joint[k].mFinal.size(); i++) {
+            MT_CHECK_NEAR(joint[k].mFinal[i], single.mFinal[i], 1e-6);
+        }
+        MT_CHECK(joint[k].dSyn.size() == single.dSyn.size());
+        for (size_t i = 0; i < single.dSyn.size() && i < joint[k].dSyn.size(); i++) {
+            MT_CHECK_NEAR(joint[k].dSyn[i], single.dSyn[i], 1e-6);
+        }
+    }
+}
+
+MT_TEST(lateral_smoothing_couples_stations) {
+    // 横向平滑使相邻测站的模型更接近
+    std::vector<MT::InversionParams> stations = makeProfile(4);
+    MTInversionCore core;
+    std::vector<MT::InversionResult> independent = core.invertProfile(stations, 0.0);
+    std::vector<MT::InversionResult> coupled = core.invertProfile(stations, 10.0);
+    for (size_t k = 0; k < stations.size(); k++) {
+        MT_CHECK(independent[k].success && coupled[k].success);
+    }
+    double roughIndependent = lateralRoughness(independent);
+    MT_CHECK(roughIndependent > 0.0);
+    MT_CHECK(lateralRoughness(coupled) < 0.5 * roughIndependent);
+}
+
+MT_TEST(lateral_rejects_mismatched_settings) {
+    // 联合反演只有一组设置和一套网格：与第一个测站不一致时全部失败
+    MTInversionCore core;
+    std::vector<MT::InversionParams> stations = makeProfile(3);
+    stations[2].lambda = 2.0;
+    for (const MT::InversionResult& result : core.invertProfile(stations, 1.0)) {
+        MT_CHECK(!result.success && !result.errorMessage.empty());
+    }
+
+    stations = makeProfile(3);
+    stations[1].thicknessGrowth = 1.3;
+    for (const MT::InversionResult& result : core.invertProfile(stations, 1.0)) {
+        MT_CHECK(!result.success && !result.errorMessage.empty());
+    }
+
+    stations = makeProfile(3);
+    stations[1].maxIter = 2;
+    for (const MT::InversionResult& result : core.invertProfile(stations, 1.0)) {
+        MT_CHECK(!result.success && !result.errorMessage.empty());
+    }
+}
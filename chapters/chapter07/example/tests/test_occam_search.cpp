@@ -0,0 +1,126 @@
+#include "mt_test_harness.h"
+#include "mt_occam_search.h"
+#include "mt_forward_solver.h"
+#include "mt_jacobian_calculator.h"
+#include "mt_optimizer.h"
+#include "mt_regularization.h"
+#include <limits>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+/**
+ * 与指定模型的距离不超过radius的模型返回NaN数据，模拟发散的候选
+ */
+class DivergingForwardSolver : public MT::ForwardSolver {
+public:
+    DivergingForwardSolver(const std::vector<double>& center, double radius) : m_center(center), m_radius(radius) {}
+
+    void solve(const std::vector<double>& mLogRho,
+               const std::vector<double>& omega,
+               const std::vector<double>& layerThicknesses,
+               std::vector<double>& dataOut) override {
+        MT::ForwardSolver::solve(mLogRho, omega, layerThicknesses, dataOut);
+        double sum = 0.0;
+        for (size_t i = 0; i < mLogRho.size(); i++) {
+            sum += (mLogRho[i] - m_center[i]) * (mLogRho[i] - m_center[i]);
+        }
+        if (std::sqrt(sum) <= m_radius) {
+            dataOut.assign(dataOut.size(), std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+
+private:
+    std::vector<double> m_center;
+    double m_radius;
+};
+
+/**
+ * 均匀半空间初始模型上的一次Occam迭代（观测数据来自含低阻层的模型）
+ */
+struct OccamProblem {
+    std::vector<double> omega;
+    std::vector<double> thicknesses;
+    std::vector<double> dObs;
+    std::vector<double> mCurrent;
+    MT::OccamSearch occam;
+
+    OccamProblem() {
+        const int M = 20;
+        const int nFreq = 25;
+        for (int f = 0; f < nFreq; f++) {
+            double period = pow(10.0, -2.0 + 5.0 * f / (nFreq - 1));
+            omega.push_back(2.0 * PI / period);
+        }
+        double thickness = 10.0;
+        for (int i = 0; i < M; i++) {
+            thicknesses.push_back(thickness);
+            thickness *= 1.3;
+        }
+        std::vector<double> mTrue(M, 2.0);
+        for (int i = 8; i < 12; i++) {
+            mTrue[i] = 0.5;
+        }
+        MT::ForwardSolver solver;
+        solver.solve(mTrue, omega, thicknesses, dObs);
+        mCurrent.assign(M, 2.0);
+
+        std::vector<double> dSyn;
+        solver.solve(mCurrent, omega, thicknesses, dSyn);
+        std::vector<double> r(dObs.size());
+        for (size_t i = 0; i < r.size(); i++) {
+            r[i] = dObs[i] - dSyn[i];
+        }
+        std::vector<std::vector<double>> J, JTJ, L, LTL;
+        MT::JacobianCalculator(&solver).compute(mCurrent, omega, dSyn, thicknesses, 1e-5, J);
+        MT::Optimizer optimizer;
+        optimizer.computeJTJ(J, JTJ);
+        std::vector<double> JTr;
+        optimizer.computeJTr(J, r, JTr);
+        MT::Regularization regularization;
+        regularization.buildLMatrix(M, L);
+        regularization.computeLTL(L, LTL);
+        factorized = occam.factorize(JTJ, LTL, JTr, mCurrent, std::vector<bool>());
+    }
+
+    bool factorized = false;
+};
+
+} // namespace
+
+MT_TEST(occam_skips_diverged_candidates) {
+    OccamProblem problem;
+    MT_CHECK(problem.factorized);
+
+    // 不可达的目标：正常情况下选中拟合差最小的候选
+    MT::ForwardSolver solver;
+    MT::OccamStep reference;
+    MT_CHECK(problem.occam.search(&solver, problem.mCurrent, problem.omega, problem.thicknesses,
+                                  problem.dObs, 0.0, nullptr, reference));
+    std::vector<double> mReference = problem.mCurrent;
+    for (size_t i = 0; i < mReference.size(); i++) {
+        mReference[i] += reference.dm[i];
+    }
+
+    // 该候选发散：原先无效残差按0计，它会以拟合差0被选中；现在应选其余候选中拟合差最小的
+    DivergingForwardSolver diverging(mReference, 1e-12);
+    for (double target : { 0.0, 1e-3 }) {
+        MT::OccamStep step;
+        MT_CHECK(problem.occam.search(&diverging, problem.mCurrent, problem.omega, problem.thicknesses,
+                                      problem.dObs, target, nullptr, step));
+        MT_CHECK(std::isfinite(step.misfit));
+        MT_CHECK(step.misfit >= reference.misfit);
+        MT_CHECK(!step.targetReached);
+        MT_CHECK(step.lambda != reference.lambda);
+        for (double value : step.dSyn) {
+            MT_CHECK(std::isfinite(value));
+        }
+    }
+
+    // 所有候选都发散时搜索失败
+    DivergingForwardSolver allDiverging(problem.mCurrent, std::numeric_limits<double>::infinity());
+    MT::OccamStep failed;
+    MT_CHECK(!problem.occam.search(&allDiverging, problem.mCurrent, problem.omega, problem.thicknesses,
+                                   problem.dObs, 0.0, nullptr, failed));
+}
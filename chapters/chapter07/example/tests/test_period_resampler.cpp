@@ -0,0 +1,142 @@
+#include "mt_test_harness.h"
+#include "mt_period_resampler.h"
+#include "mt_forward_solver.h"
+#include "mt_frequency_generator.h"
+#include <algorithm>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+/**
+ * 三层模型在给定周期上的合成观测数据（log10(ρ_a)/相位交替存储）
+ */
+MT::InversionParams makeStation(const std::string& id, const std::vector<double>& periods) {
+    MT::InversionParams station;
+    station.stationId = id;
+    station.nFreq = static_cast<int>(periods.size());
+    station.periods = periods;
+    station.omega.resize(periods.size());
+    for (size_t f = 0; f < periods.size(); f++) {
+        station.omega[f] = 2.0 * PI / periods[f];
+    }
+    std::vector<double> m = { 2.0, 0.8, 2.7 };
+    std::vector<double> thicknesses = { 400.0, 2500.0, 1000.0 };
+    MT::ForwardSolver().solve(m, station.omega, thicknesses, station.dObs);
+    return station;
+}
+
+std::vector<double> logGrid(int n, double tMin, double tMax) {
+    std::vector<double> periods, omega;
+    MT::FrequencyGenerator().generate(n, tMin, tMax, periods, omega);
+    return periods;
+}
+
+} // namespace
+
+MT_TEST(resample_matches_forward_response) {
+    // 密集采样的光滑响应插值到稀疏网格：与直接正演的差别在样条误差范围内
+    std::vector<MT::InversionParams> stations = { makeStation("A", logGrid(81, 1e-3, 1e3)) };
+    MT::PeriodResampler resampler;
+    resampler.setTargetGrid(31, 1e-2, 1e2);
+    std::string error;
+    MT_CHECK(resampler.resample(stations, error));
+    MT::InversionParams expected = makeStation("A", resampler.getTargetPeriods());
+    MT_CHECK(stations[0].nFreq == 31);
+    MT_CHECK(stations[0].omega == expected.omega);
+    MT_CHECK(stations[0].dObs.size() == expected.dObs.size());
+    for (size_t i = 0; i < expected.dObs.size(); i += 2) {
+        MT_CHECK(std::fabs(stations[0].dObs[i] - expected.dObs[i]) < 2e-3);
+        MT_CHECK(std::fabs(stations[0].dObs[i + 1] - expected.dObs[i + 1]) < 0.1);
+    }
+}
+
+MT_TEST(resample_reproduces_nodes_and_sorts) {
+    // 目标周期等于测站周期时数据不变；测站周期为降序时先排序
+    std::vector<double> periods = logGrid(25, 1e-2, 1e2);
+    std::reverse(periods.begin(), periods.end());
+    MT::InversionParams station = makeStation("B", periods);
+    std::vector<double> original = station.dObs;
+    MT::PeriodResampler resampler;
+    resampler.setTargetPeriods(periods);
+    std::string error;
+    MT_CHECK(resampler.resample(station, error));
+    MT_CHECK(station.dObs.size() == original.size());
+    for (size_t i = 0; i < original.size(); i++) {
+        MT_CHECK_NEAR(station.dObs[i], original[i], 1e-12);
+    }
+}
+
+MT_TEST(resample_batches_identical_period_sets) {
+    std::vector<double> setA = logGrid(40, 1e-3, 1e3);
+    std::vector<double> setB = logGrid(55, 5e-3, 5e2);
+    std::vector<MT::InversionParams> stations = {
+        makeStation("S1", setA), makeStation("S2", setB), makeStation("S3", setA), makeStation("S4", setA)
+    };
+    stations[2].dObs[10] += 0.05;  // 同一周期组内的测站数据不同
+
+    MT::PeriodResampler resampler;
+    resampler.setTargetGrid(21, 1e-2, 1e2);
+    std::vector<MT::InversionParams> batched = stations;
+    std::string error;
+    MT_CHECK(resampler.resample(batched, error));
+    MT_CHECK(resampler.getLastBatchCount() == 2);
+
+    // 批量结果与逐个测站重采样一致
+    for (size_t s = 0; s < stations.size(); s++) {
+        MT::InversionParams single = stations[s];
+        MT_CHECK(resampler.resample(single, error));
+        MT_CHECK(single.dObs.size() == batched[s].dObs.size());
+        for (size_t i = 0; i < single.dObs.size(); i++) {
+            MT_CHECK_NEAR(batched[s].dObs[i], single.dObs[i], 1e-12);
+        }
+        MT_CHECK(batched[s].omega == batched[0].omega);
+    }
+}
+
+MT_TEST(resample_rejects_out_of_range) {
+    std::vector<MT::InversionParams> stations = {
+        makeStation("wide", logGrid(40, 1e-3, 1e3)), makeStation("narrow", logGrid(30, 1e-2, 1e1))
+    };
+    double tMin = 0.0, tMax = 0.0;
+    MT_CHECK(MT::PeriodResampler::commonPeriodRange(stations, tMin, tMax));
+    MT_CHECK_NEAR(tMin, 1e-2, 1e-9);
+    MT_CHECK_NEAR(tMax, 1e1, 1e-9);
+
+    // 超出narrow测站范围时失败，且所有测站保持不变
+    std::vector<MT::InversionParams> copy = stations;
+    MT::PeriodResampler resampler;
+    resampler.setTargetGrid(21, 1e-2, 1e2);
+    std::string error;
+    MT_CHECK(!resampler.resample(copy, error));
+    MT_CHECK(error.find("narrow") != std::string::npos);
+    MT_CHECK(copy[0].dObs == stations[0].dObs && copy[1].dObs == stations[1].dObs);
+
+    // 公共范围内成功
+    resampler.setTargetGrid(21, tMin, tMax);
+    MT_CHECK(resampler.resample(copy, error));
+}
+
+MT_TEST(resample_multi_component) {
+    // 按分量优先存储的数据：每个分量独立插值
+    std::vector<double> periods = logGrid(30, 1e-2, 1e2);
+    MT::InversionParams station = makeStation("C", periods);
+    station.components = { MT::DataComponent::LOG_RHO_XY, MT::DataComponent::PHASE_XY,
+                           MT::DataComponent::RE_ZXY };
+    std::vector<double> interleaved = station.dObs;
+    station.dObs.assign(3 * periods.size(), 0.0);
+    for (size_t f = 0; f < periods.size(); f++) {
+        station.dObs[f] = interleaved[2 * f];
+        station.dObs[periods.size() + f] = interleaved[2 * f + 1];
+        station.dObs[2 * periods.size() + f] = static_cast<double>(f);  // 对log10(T)线性
+    }
+    MT::PeriodResampler resampler;
+    resampler.setTargetPeriods(periods);
+    std::string error;
+    MT_CHECK(resampler.resample(station, error));
+    MT_CHECK(station.dObs.size() == 3 * periods.size());
+    for (size_t f = 0; f < periods.size(); f++) {
+        MT_CHECK_NEAR(station.dObs[f], interleaved[2 * f], 1e-12);
+        MT_CHECK_NEAR(station.dObs[2 * periods.size() + f], static_cast<double>(f), 1e-12);
+    }
+}
@@ -0,0 +1,160 @@
+#include "mt_test_harness.h"
+#include "mt_resolution_analysis.h"
+#include "mt_optimizer.h"
+#include "mt_occam_search.h"
+#include "mt_regularization.h"
+#include "mt_forward_solver.h"
+#include "mt_jacobian_calculator.h"
+#include "mt_frequency_generator.h"
+#include "mt_inversion_core.h"
+
+namespace {
+
+/**
+ * 小规模正规方程（M = 12），用显式的稠密逆作为参考
+ */
+struct SmallSystem {
+    int M = 12;
+    int nData = 0;
+    double residualNorm = 0.0;
+    std::vector<std::vector<double>> JTJ, LTL;
+    std::vector<double> JTr;
+
+    SmallSystem() {
+        std::vector<double> periods, omega, thicknesses, depths;
+        MT::FrequencyGenerator().generate(15, periods, omega);
+        MTInversionCore().computeLayerThicknesses(M, 20.0, 1.4, thicknesses, depths);
+        std::vector<double> m(M), mTrue(M), dSyn, dObs;
+        for (int i = 0; i < M; i++) {
+            m[i] = 2.0;
+            mTrue[i] = 2.0 + 0.7 * sin(0.6 * i);
+        }
+        MT::ForwardSolver solver;
+        solver.solve(m, omega, thicknesses, dSyn);
+        solver.solve(mTrue, omega, thicknesses, dObs);
+        nData = static_cast<int>(dObs.size());
+        std::vector<double> r(nData);
+        for (int i = 0; i < nData; i++) {
+            r[i] = dObs[i] - dSyn[i];
+            residualNorm += r[i] * r[i];
+        }
+        residualNorm = std::sqrt(residualNorm);
+
+        std::vector<std::vector<double>> J, L;
+        MT::JacobianCalculator(&solver).compute(m, omega, dSyn, thicknesses, 1e-5, J);
+        MT::Optimizer optimizer;
+        optimizer.computeJTJ(J, JTJ);
+        optimizer.computeJTr(J, r, JTr);
+        MT::Regularization regularization;
+        regularization.buildLMatrix(M, L);
+        regularization.computeLTL(L, LTL);
+    }
+
+    // (J^T*J + λ*(L^T*L + δI))^-1，Gauss-Jordan消元（部分选主元）
+    std::vector<std::vector<double>> denseInverse(double lambda, double delta = 0.0) const {
+        std::vector<std::vector<double>> a(M, std::vector<double>(2 * M, 0.0));
+        for (int i = 0; i < M; i++) {
+            for (int j = 0; j < M; j++) {
+                a[i][j] = JTJ[i][j] + lambda * LTL[i][j];
+            }
+            a[i][i] += lambda * delta;
+            a[i][M + i] = 1.0;
+        }
+        for (int col = 0; col < M; col++) {
+            int pivot = col;
+            for (int i = col + 1; i < M; i++) {
+                if (std::fabs(a[i][col]) > std::fabs(a[pivot][col])) {
+                    pivot = i;
+                }
+            }
+            std::swap(a[col], a[pivot]);
+            double p = a[col][col];
+            for (double& v : a[col]) {
+                v /= p;
+            }
+            for (int i = 0; i < M; i++) {
+                if (i != col) {
+                    double f = a[i][col];
+                    for (int j = 0; j < 2 * M; j++) {
+                        a[i][j] -= f * a[col][j];
+                    }
+                }
+            }
+        }
+        std::vector<std::vector<double>> inverse(M, std::vector<double>(M));
+        for (int i = 0; i < M; i++) {
+            for (int j = 0; j < M; j++) {
+                inverse[i][j] = a[i][M + j];
+            }
+        }
+        return inverse;
+    }
+
+    // 比较带状元素、分辨率对角元R = A^-1*J^T*J和后验标准差
+    void checkAgainstDense(const std::vector<double>& band, int bandwidth, double lambda,
+                           const std::vector<std::vector<double>>& inverse, double tolerance) const {
+        const int width = 2 * bandwidth + 1;
+        MT_CHECK(band.size() == static_cast<size_t>(M) * width);
+        if (band.size() != static_cast<size_t>(M) * width) {
+            return;
+        }
+        double scale = 0.0;
+        for (int i = 0; i < M; i++) {
+            scale = std::fmax(scale, std::fabs(inverse[i][i]));
+        }
+        for (int i = 0; i < M; i++) {
+            for (int j = std::max(0, i - bandwidth); j <= std::min(M - 1, i + bandwidth); j++) {
+                MT_CHECK(std::fabs(band[i * width + (j - i + bandwidth)] - inverse[i][j]) <= tolerance * scale);
+            }
+        }
+
+        std::vector<double> resolutionDiag, posteriorStd;
+        MT_CHECK(MT::ResolutionAnalysis().compute(band, bandwidth, LTL, lambda, std::vector<bool>(),
+                                                  residualNorm, nData, resolutionDiag, posteriorStd));
+        double traceR = 0.0;
+        std::vector<double> expectedR(M);
+        for (int i = 0; i < M; i++) {
+            for (int k = 0; k < M; k++) {
+                expectedR[i] += inverse[i][k] * JTJ[k][i];
+            }
+            traceR += expectedR[i];
+        }
+        double sigma2 = residualNorm * residualNorm / std::max(1.0, nData - traceR);
+        for (int i = 0; i < M; i++) {
+            MT_CHECK_NEAR(resolutionDiag[i], expectedR[i], tolerance);
+            MT_CHECK_NEAR(posteriorStd[i], std::sqrt(sigma2 * inverse[i][i]), tolerance);
+        }
+    }
+};
+
+} // namespace
+
+MT_TEST(resolution_optimizer_matches_dense_inverse) {
+    SmallSystem system;
+    const double lambda = 3.0;
+    int bandwidth = MT::ResolutionAnalysis::bandwidth(system.LTL);
+    MT_CHECK(bandwidth >= 1 && bandwidth < system.M - 1);
+
+    MT::Optimizer optimizer;
+    std::vector<double> dm, band;
+    MT_CHECK(optimizer.solve(system.JTJ, system.LTL, lambda, system.JTr, dm));
+    MT_CHECK(optimizer.selectedInverse(bandwidth, band));
+    system.checkAgainstDense(band, bandwidth, lambda, system.denseInverse(lambda), 1e-8);
+}
+
+MT_TEST(resolution_occam_matches_dense_inverse) {
+    // Occam分解的B = L^T*L + δI（δ = 1e-8*max(L^T*L)_ii），参考逆包含同样的δ
+    SmallSystem system;
+    const double lambda = 3.0;
+    int bandwidth = MT::ResolutionAnalysis::bandwidth(system.LTL);
+    double maxDiag = 0.0;
+    for (int i = 0; i < system.M; i++) {
+        maxDiag = std::fmax(maxDiag, system.LTL[i][i]);
+    }
+
+    MT::OccamSearch occam;
+    std::vector<double> mCurrent(system.M, 2.0), band;
+    MT_CHECK(occam.factorize(system.JTJ, system.LTL, system.JTr, mCurrent, std::vector<bool>()));
+    MT_CHECK(occam.selectedInverse(lambda, bandwidth, band));
+    system.checkAgainstDense(band, bandwidth, lambda, system.denseInverse(lambda, 1e-8 * maxDiag), 1e-6);
+}
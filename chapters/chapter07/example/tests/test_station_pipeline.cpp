@@ -0,0 +1,112 @@
+#include "mt_test_harness.h"
+#include "mt_station_pipeline.h"
+#include "mt_forward_solver.h"
+#include "mt_frequency_generator.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+MT_TEST(pipeline_component_round_trip) {
+    // 非默认分量：测站文件逐行给出各分量，dObs按分量优先存储，结果文件按同一顺序写出
+    const std::vector<MT::DataComponent> components = {
+        MT::DataComponent::RE_ZXY, MT::DataComponent::IM_ZXY, MT::DataComponent::LOG_RHO_DET };
+    const size_t nComponents = components.size();
+    std::vector<double> periods, omega, data;
+    MT::FrequencyGenerator().generate(12, 1e-2, 1e2, periods, omega);
+    const size_t nFreq = periods.size();
+    std::vector<double> m = { 2.0, 0.8, 2.7 };
+    std::vector<double> thicknesses = { 400.0, 2500.0, 1000.0 };
+    MT::ForwardSolver().solveComponents(m, omega, thicknesses, components, data);
+    MT_CHECK(data.size() == nComponents * nFreq);
+
+    const std::string path = "mt_pipeline_component_station.txt";
+    {
+        std::ofstream file(path);
+        file << "# period re_zxy im_zxy log10(rho_det)\n";
+        file << "station S1\n";
+        file << std::setprecision(17);
+        for (size_t i = 0; i < nFreq; i++) {
+            file << periods[i];
+            for (size_t c = 0; c < nComponents; c++) {
+                file << " " << data[c * nFreq + i];
+            }
+            file << "\n";
+        }
+    }
+
+    MT::InversionParams params;
+    params.components = components;
+    MT_CHECK(MT::StationPipeline::readStationFile(path, params));
+    MT_CHECK(params.stationId == "S1");
+    MT_CHECK(params.nFreq == static_cast<int>(nFreq));
+    MT_CHECK(params.dObs == data);
+
+    // 分量数与每行的值数不一致时拒绝
+    MT::InversionParams defaultParams;
+    MT_CHECK(!MT::StationPipeline::readStationFile(path, defaultParams));
+
+    MT::InversionParams baseParams;
+    baseParams.M = 15;
+    baseParams.maxIter = 2;
+    baseParams.components = components;
+    MT::StationPipeline pipeline(1, 2);
+    std::ostringstream out;
+    MT::StationPipeline::Statistics stats = pipeline.runFiles({ path }, out, baseParams);
+    std::remove(path.c_str());
+    MT_CHECK(stats.nRead == 1 && stats.nWritten == 1);
+
+    std::istringstream in(out.str());
+    std::string line;
+    bool haveHeader = false;
+    size_t nDataLines = 0;
+    while (std::getline(in, line)) {
+        if (line.find("obs_re_zxy obs_im_zxy obs_log10(rho_det) syn_re_zxy") != std::string::npos) {
+            haveHeader = true;
+        }
+        if (line.compare(0, 5, "data ") != 0) {
+            continue;
+        }
+        std::istringstream iss(line.substr(5));
+        double period = 0.0;
+        iss >> period;
+        MT_CHECK(nDataLines < nFreq);
+        if (nDataLines >= nFreq) {
+            break;
+        }
+        MT_CHECK(MTTest::near(period, periods[nDataLines], 1e-9));
+        for (size_t c = 0; c < nComponents; c++) {
+            double obs = 0.0;
+            MT_CHECK(iss >> obs);
+            MT_CHECK(MTTest::near(obs, data[c * nFreq + nDataLines], 1e-9));
+        }
+        for (size_t c = 0; c < nComponents; c++) {
+            double syn = 0.0;
+            MT_CHECK(iss >> syn);
+            MT_CHECK(std::isfinite(syn));
+        }
+        nDataLines++;
+    }
+    MT_CHECK(haveHeader);
+    MT_CHECK(nDataLines == nFreq);
+}
+
+MT_TEST(pipeline_station_keyword) {
+    // "station"后必须是空白或行尾；"stationX ..."不是关键字，按数据行解析失败
+    const std::string path = "mt_pipeline_keyword_station.txt";
+    {
+        std::ofstream file(path);
+        file << "station\tA7\n1.0 2.0 45.0\n10.0 2.1 40.0\n";
+    }
+    MT::InversionParams params;
+    MT_CHECK(MT::StationPipeline::readStationFile(path, params));
+    MT_CHECK(params.stationId == "A7");
+
+    {
+        std::ofstream file(path);
+        file << "stationX B1\n1.0 2.0 45.0\n10.0 2.1 40.0\n";
+    }
+    MT::InversionParams rejected;
+    MT_CHECK(!MT::StationPipeline::readStationFile(path, rejected));
+    std::remove(path.c_str());
+}
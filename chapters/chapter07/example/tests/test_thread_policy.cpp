@@ -0,0 +1,67 @@
+#include "mt_test_harness.h"
+#include "mt_thread_policy.h"
+#include <mkl.h>
+#include <atomic>
+#include <thread>
+
+MT_TEST(policy_thread_share) {
+    MT::ThreadPolicy::setCoreCount(8);
+    const int baseTasks = MT::ThreadPolicy::activeTasks();
+    MT_CHECK(MT::ThreadPolicy::availableThreads() == 8);
+    {
+        MT::ParallelTaskScope task;
+        MT::ParallelTaskScope nested;  // 同一线程嵌套只登记一次
+        MT_CHECK(MT::ThreadPolicy::activeTasks() == baseTasks + 1);
+        MT_CHECK(MT::ThreadPolicy::availableThreads() == 8);
+
+        // 另外3个任务同时运行时每个任务分到8 / 4 = 2个线程
+        std::atomic<int> started(0);
+        std::atomic<bool> release(false);
+        std::vector<std::thread> others;
+        for (int t = 0; t < 3; t++) {
+            others.emplace_back([&]() {
+                MT::ParallelTaskScope other;
+                started++;
+                while (!release.load()) {
+                    std::this_thread::yield();
+                }
+            });
+        }
+        while (started.load() < 3) {
+            std::this_thread::yield();
+        }
+        MT_CHECK(MT::ThreadPolicy::activeTasks() == baseTasks + 4);
+        MT_CHECK(MT::ThreadPolicy::availableThreads() == 2);
+        release.store(true);
+        for (std::thread& t : others) {
+            t.join();
+        }
+        MT_CHECK(MT::ThreadPolicy::availableThreads() == 8);
+    }
+    MT_CHECK(MT::ThreadPolicy::activeTasks() == baseTasks);
+    MT::ThreadPolicy::setCoreCount(0);
+}
+
+MT_TEST(policy_threads_for_work) {
+    MT::ThreadPolicy::setCoreCount(8);
+    const int limit = std::min(8, MT::ThreadPolicy::mklThreadLimit());
+    MT_CHECK(MT::ThreadPolicy::threadsForWork(0.0) == 1);
+    MT_CHECK(MT::ThreadPolicy::threadsForWork(0.5 * MT::ThreadPolicy::MIN_FLOPS_PER_THREAD) == 1);
+    MT_CHECK(MT::ThreadPolicy::threadsForWork(1e15) == limit);
+    MT_CHECK(MT::ThreadPolicy::threadsForWork(3.5 * MT::ThreadPolicy::MIN_FLOPS_PER_THREAD) == std::min(3, limit));
+    MT::ThreadPolicy::setCoreCount(0);
+}
+
+MT_TEST(policy_scopes_restore_mkl_threads) {
+    int before = mkl_get_max_threads();
+    {
+        MT::ParallelTaskScope task;
+        MT_CHECK(mkl_get_max_threads() == 1);
+        {
+            MT::MklThreadScope threads(1e15);
+            MT_CHECK(mkl_get_max_threads() == threads.getThreadCount());
+        }
+        MT_CHECK(mkl_get_max_threads() == 1);
+    }
+    MT_CHECK(mkl_get_max_threads() == before);
+}
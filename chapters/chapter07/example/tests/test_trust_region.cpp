@@ -0,0 +1,131 @@
+#include "mt_test_harness.h"
+#include "mt_inversion_core.h"
+#include "mt_occam_search.h"
+#include "mt_regularization.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+MT::InversionParams trustRegionParams() {
+    MT::InversionParams params;
+    params.M = 30;
+    params.nFreq = 41;
+    params.maxIter = 30;
+    params.engine = MT::InversionEngine::TRUST_REGION;
+    return params;
+}
+
+double dataMisfit(const MT::InversionResult& result) {
+    return MT::OccamSearch::residualNorm(result.dObs, result.dSyn);
+}
+
+/**
+ * 信赖域引擎最小化的目标函数||dObs - g(m)||² + λ||L*m||²
+ */
+double tikhonovObjective(const MT::InversionResult& result, double lambda) {
+    std::vector<std::vector<double>> L;
+    MT::Regularization().buildLMatrix(static_cast<int>(result.mFinal.size()), L);
+    double roughness = 0.0;
+    for (const std::vector<double>& row : L) {
+        double value = 0.0;
+        for (size_t j = 0; j < row.size(); j++) {
+            value += row[j] * result.mFinal[j];
+        }
+        roughness += value * value;
+    }
+    double misfit = dataMisfit(result);
+    return misfit * misfit + lambda * roughness;
+}
+
+} // namespace
+
+MT_TEST(trust_reduces_misfit) {
+    MT::InversionParams params = trustRegionParams();
+    MT::InversionResult result = MTInversionCore().invert(params);
+    MT_CHECK(result.success);
+    MT_CHECK(result.nIterations > 0);
+    MT_CHECK(result.residualHistory.size() == static_cast<size_t>(result.nIterations));
+    MT_CHECK(result.dmNormHistory.size() == static_cast<size_t>(result.nIterations));
+    MT_CHECK(result.resolutionDiag.empty());
+    if (!result.residualHistory.empty()) {
+        MT_CHECK(dataMisfit(result) < 0.5 * result.residualHistory.front());
+    }
+    for (double value : result.mFinal) {
+        MT_CHECK(std::isfinite(value));
+    }
+}
+
+MT_TEST(trust_djacobi_matches_calculator) {
+    // 两种Jacobian来源收敛到同一个正则化问题的解
+    MT::InversionParams params = trustRegionParams();
+    params.noiseLevel = 0.0;
+    params.lambda = 0.1;
+    MT::InversionResult calculator = MTInversionCore().invert(params);
+    params.trustRegionJacobian = MT::TrustRegionJacobian::MKL_DJACOBI;
+    MT::InversionResult djacobi = MTInversionCore().invert(params);
+    MT_CHECK(calculator.success);
+    MT_CHECK(djacobi.success);
+    MT_CHECK(calculator.mFinal.size() == djacobi.mFinal.size());
+    if (calculator.mFinal.size() == djacobi.mFinal.size()) {
+        double maxDiff = 0.0;
+        for (size_t i = 0; i < calculator.mFinal.size(); i++) {
+            maxDiff = std::max(maxDiff, std::fabs(calculator.mFinal[i] - djacobi.mFinal[i]));
+        }
+        MT_CHECK(maxDiff < 0.05);
+    }
+    MT_CHECK_NEAR(dataMisfit(djacobi), dataMisfit(calculator), 0.05);
+}
+
+MT_TEST(trust_compared_with_gauss_newton) {
+    // 同一测站切换引擎：报告迭代次数和耗时。内置循环的λ约束更新量，两者的解不同，
+    // 但信赖域的结果在它所最小化的目标函数上不应差于内置循环的结果
+    MT::InversionParams params = trustRegionParams();
+    params.lambda = 10.0;
+    params.maxIter = 60;
+    params.computeResolution = false;
+
+    auto run = [&](MT::InversionEngine engine, double& seconds) {
+        params.engine = engine;
+        auto start = std::chrono::steady_clock::now();
+        MT::InversionResult result = MTInversionCore().invert(params);
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    };
+    double gnSeconds = 0.0;
+    double trSeconds = 0.0;
+    MT::InversionResult gaussNewton = run(MT::InversionEngine::GAUSS_NEWTON, gnSeconds);
+    MT::InversionResult trustRegion = run(MT::InversionEngine::TRUST_REGION, trSeconds);
+    const double gnObjective = tikhonovObjective(gaussNewton, params.lambda);
+    const double trObjective = tikhonovObjective(trustRegion, params.lambda);
+    printf("  gauss-newton: %d iterations, misfit %.4f, objective %.4f, %.1f ms\n",
+           gaussNewton.nIterations, dataMisfit(gaussNewton), gnObjective, gnSeconds * 1e3);
+    printf("  trust-region: %d iterations, misfit %.4f, objective %.4f, %.1f ms\n",
+           trustRegion.nIterations, dataMisfit(trustRegion), trObjective, trSeconds * 1e3);
+    MT_CHECK(gaussNewton.success);
+    MT_CHECK(trustRegion.success);
+    MT_CHECK(trustRegion.nIterations < params.maxIter);
+    MT_CHECK(trObjective <= gnObjective);
+}
+
+MT_TEST(trust_bspline_basis) {
+    MT::InversionParams params = trustRegionParams();
+    params.M = 60;
+    params.modelBasis = MT::ModelBasis::BSPLINE;
+    params.nBasis = 12;
+    MT::InversionResult result = MTInversionCore().invert(params);
+    MT_CHECK(result.success);
+    MT_CHECK(result.mFinal.size() == static_cast<size_t>(params.M));
+    if (!result.residualHistory.empty()) {
+        MT_CHECK(dataMisfit(result) < result.residualHistory.front());
+    }
+}
+
+MT_TEST(trust_rejects_occam) {
+    MT::InversionParams params = trustRegionParams();
+    params.occam = true;
+    MT::InversionResult result = MTInversionCore().invert(params);
+    MT_CHECK(!result.success);
+    MT_CHECK(!result.errorMessage.empty());
+}